@@ -0,0 +1,223 @@
+#include <stddef.h>
+#include <string.h>
+#include "em_core.h"
+#include "em_adc.h"
+#include "em_prs.h"
+#include "em_timer.h"
+#include "sleep.h"
+#include "bsp.h"
+#include "adcscan.h"
+
+#if (12 + ADCSCAN_CIC_ORDER * ADCSCAN_DECIMATION_LOG2) > 32
+#error CIC gain does not fit 32 bits, reduce ADCSCAN_CIC_ORDER or decimation
+#endif
+
+#define HALF_SAMPLES (ADCSCAN_HALF_SCANS * ADC_SCAN_CHANNELS)
+#define ADC_CLOCK    7000000U /* ADC clock [Hz], 13 MHz max */
+#define SLEEP_TAG_ADCSCAN SLEEP_TAG('A', 'D', 'C', 'S')
+
+/* CIC filter of one channel, integrators at the scan rate, combs at the
+* output rate. modulo 2^32 arithmetic, so wrapping integrators are fine */
+typedef struct {
+    uint32_t integ[ADCSCAN_CIC_ORDER];
+    uint32_t comb[ADCSCAN_CIC_ORDER]; /* comb inputs of the last output */
+} Cic;
+
+static uint16_t l_ring[2][HALF_SAMPLES]; /* primary, alternate half */
+static Cic l_cic[ADC_SCAN_CHANNELS];
+static uint8_t l_phase; /* scans since the last output frame */
+static ADCSCAN_Output l_output;
+static uint32_t l_rate;
+static bool l_running;
+static volatile uint8_t l_pending; /* halves posted, not yet processed */
+static volatile uint8_t l_stale;   /* events of stopped runs still queued */
+static volatile uint32_t l_overruns;
+static CMU_ClockChangeSubscriber_TypeDef l_clockChange;
+
+static void halfDone(unsigned int channel, bool primary, void *user);
+static DMA_CB_TypeDef l_dmaCb = { halfDone, NULL, 0 };
+
+/* DMA callback, runs in the DMA interrupt once per ring half */
+static void halfDone(unsigned int channel, bool primary, void *user) {
+  (void)user;
+  /* the DMA fills the other half now, this one follows it */
+  DMA_RefreshPingPong(channel, primary, false, NULL, NULL,
+                      HALF_SAMPLES - 1U, false);
+  if (l_pending != 0U) {
+    l_overruns++; /* the other half is refilled before it was processed */
+  }
+  if (SCHED_post(TASK_ADC, primary ? SIG_ADC_PRIMARY : SIG_ADC_ALTERNATE)) {
+    l_pending++;
+  } else {
+    l_overruns++; /* the task queue is full, this half is skipped */
+  }
+}
+
+/* TIMER0 overflows at l_rate, prescaled to fit the 16 bit TOP */
+static void timerSet(void) {
+  TIMER_Init_TypeDef init = TIMER_INIT_DEFAULT;
+  uint32_t ticks = CMU_ClockFreqGet(cmuClock_TIMER0) / l_rate;
+  uint32_t presc = 0U;
+
+  while (ticks > 0x10000U && presc < (uint32_t)timerPrescale1024) {
+    ticks >>= 1;
+    presc++;
+  }
+  if (ticks == 0U) {
+    ticks = 1U;
+  }
+  init.prescale = (TIMER_Prescale_TypeDef)presc;
+  init.enable = false;
+  TIMER_Init(TIMER0, &init);
+  TIMER_TopSet(TIMER0, ticks - 1U);
+  TIMER_Enable(TIMER0, true);
+}
+
+static void clockChanged(void *user) {
+  (void)user;
+  timerSet();
+}
+
+bool ADCSCAN_start(uint32_t rate, ADCSCAN_Output output) {
+  ADC_Init_TypeDef init = ADC_INIT_DEFAULT;
+  ADC_InitScan_TypeDef scan = ADC_INITSCAN_DEFAULT;
+  DMA_CfgChannel_TypeDef chnlCfg;
+  DMA_CfgDescr_TypeDef descrCfg;
+
+  if (l_running || rate == 0U || output == NULL) {
+    return false;
+  }
+  l_output = output;
+  l_rate = rate;
+  memset(l_cic, 0, sizeof(l_cic));
+  l_phase = 0U;
+  l_pending = 0U;
+  l_overruns = 0U;
+
+  CMU_ClockEnable(cmuClock_ADC0, true);
+  CMU_ClockEnable(cmuClock_TIMER0, true);
+  CMU_ClockEnable(cmuClock_PRS, true);
+
+  init.timebase = ADC_TimebaseCalc(0);
+  init.prescale = ADC_PrescaleCalc(ADC_CLOCK, 0);
+  ADC_Init(ADC0, &init);
+  scan.prsSel = ADC_PRS_SEL;
+  scan.prsEnable = true;
+  scan.acqTime = adcAcqTime4;
+  scan.reference = adcRefVDD;
+  scan.input = ADC_SCAN_INPUTS;
+  ADC_InitScan(ADC0, &scan);
+  PRS_SourceSignalSet(ADC_PRS_CH, PRS_CH_CTRL_SOURCESEL_TIMER0,
+                      PRS_CH_CTRL_SIGSEL_TIMER0OF, prsEdgeOff);
+
+  /* one 16 bit transfer per conversion, SCANDATA to the ring */
+  chnlCfg.highPri = false;
+  chnlCfg.enableInt = true;
+  chnlCfg.select = DMAREQ_ADC0_SCAN;
+  chnlCfg.cb = &l_dmaCb;
+  DMA_CfgChannel(DMA_CH_ADC, &chnlCfg);
+  descrCfg.dstInc = dmaDataInc2;
+  descrCfg.srcInc = dmaDataIncNone;
+  descrCfg.size = dmaDataSize2;
+  descrCfg.arbRate = dmaArbitrate1;
+  descrCfg.hprot = 0;
+  DMA_CfgDescr(DMA_CH_ADC, true, &descrCfg);
+  DMA_CfgDescr(DMA_CH_ADC, false, &descrCfg);
+  DMA_ActivatePingPong(DMA_CH_ADC, false,
+                       l_ring[0], (void *)&ADC0->SCANDATA, HALF_SAMPLES - 1U,
+                       l_ring[1], (void *)&ADC0->SCANDATA, HALF_SAMPLES - 1U);
+
+  /* ADC, TIMER0 and the DMA stop in EM2 */
+  SLEEP_SleepBlockBeginTagged(sleepEM2, SLEEP_TAG_ADCSCAN);
+  l_running = true;
+  timerSet();
+  CMU_ClockChangeSubscribe(&l_clockChange, clockChanged, NULL);
+  return true;
+}
+
+void ADCSCAN_stop(void) {
+  CORE_DECLARE_IRQ_STATE;
+
+  if (!l_running) {
+    return;
+  }
+  CMU_ClockChangeUnsubscribe(&l_clockChange);
+  TIMER_Enable(TIMER0, false);
+  DMA_ChannelEnable(DMA_CH_ADC, false);
+  PRS_SourceSignalSet(ADC_PRS_CH, 0U, 0U, prsEdgeOff);
+  ADC_Reset(ADC0);
+  CMU_ClockEnable(cmuClock_ADC0, false);
+  CMU_ClockEnable(cmuClock_TIMER0, false);
+  SLEEP_SleepBlockEndTagged(sleepEM2, SLEEP_TAG_ADCSCAN);
+  l_running = false;
+  /* the DMA is off, no more posts. the queued events of this run are
+  * dispatched ahead of those of a new run and are dropped */
+  CORE_ENTER_ATOMIC();
+  l_stale += l_pending;
+  l_pending = 0U;
+  CORE_EXIT_ATOMIC();
+}
+
+uint32_t ADCSCAN_overruns(void) {
+  return l_overruns;
+}
+
+/* demultiplex and decimate one ring half. the scan converts the inputs in
+* channel order, so sample n of a half is channel n % ADC_SCAN_CHANNELS */
+static void halfProcess(uint16_t const *half) {
+  uint16_t frame[ADC_SCAN_CHANNELS];
+  uint32_t x;
+  uint32_t y;
+  uint8_t scan;
+  uint8_t ch;
+  uint8_t i;
+  Cic *c;
+
+  for (scan = 0U; scan < ADCSCAN_HALF_SCANS; scan++) {
+    for (ch = 0U; ch < ADC_SCAN_CHANNELS; ch++) {
+      c = &l_cic[ch];
+      x = *half++;
+      for (i = 0U; i < ADCSCAN_CIC_ORDER; i++) {
+        c->integ[i] += x;
+        x = c->integ[i];
+      }
+    }
+    if (++l_phase < ADCSCAN_DECIMATION) {
+      continue;
+    }
+    l_phase = 0U;
+    for (ch = 0U; ch < ADC_SCAN_CHANNELS; ch++) {
+      c = &l_cic[ch];
+      x = c->integ[ADCSCAN_CIC_ORDER - 1];
+      for (i = 0U; i < ADCSCAN_CIC_ORDER; i++) {
+        y = x - c->comb[i];
+        c->comb[i] = x;
+        x = y;
+      }
+      /* gain is ADCSCAN_DECIMATION^ADCSCAN_CIC_ORDER */
+      frame[ch] = (uint16_t)(x >> (ADCSCAN_CIC_ORDER * ADCSCAN_DECIMATION_LOG2));
+    }
+    l_output(frame);
+  }
+}
+
+void ADCSCAN_task(uint8_t sig) {
+  bool stale;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  stale = (l_stale != 0U);
+  if (stale) {
+    l_stale--;
+  }
+  CORE_EXIT_ATOMIC();
+  if (stale || l_pending == 0U) {
+    return; /* posted before ADCSCAN_stop() */
+  }
+  halfProcess(l_ring[sig == SIG_ADC_PRIMARY ? 0 : 1]);
+  CORE_ENTER_ATOMIC();
+  if (l_pending != 0U) {
+    l_pending--;
+  }
+  CORE_EXIT_ATOMIC();
+}
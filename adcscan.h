@@ -0,0 +1,35 @@
+#ifndef __ADCSCAN_H__
+#define __ADCSCAN_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* continuous ADC scan acquisition
+* TIMER0 overflows trigger a scan of the ADC_SCAN_INPUTS channels through
+* PRS and the DMA moves the results into a ping-pong ring. the CPU only
+* sees the ring halves: the DMA interrupt re-arms a completed half and
+* posts it to the ADC task, which demultiplexes the half by channel and
+* decimates it with a CIC filter. the first ADCSCAN_CIC_ORDER output
+* frames are the filter settling */
+
+#define ADCSCAN_HALF_SCANS      16 /* scans per ring half */
+#define ADCSCAN_DECIMATION_LOG2 4  /* 2^n scans per output frame */
+#define ADCSCAN_CIC_ORDER       2  /* 1 is a boxcar average */
+
+#define ADCSCAN_DECIMATION (1U << ADCSCAN_DECIMATION_LOG2)
+
+/* one decimated 12 bit value per scanned channel, lowest channel first */
+typedef void (*ADCSCAN_Output)(uint16_t const *frame);
+
+/* start scanning at rate [scans/s], output is called from ADCSCAN_task().
+* the DMA, TIMER0 and ADC block EM2 while scanning */
+bool ADCSCAN_start(uint32_t rate, ADCSCAN_Output output);
+void ADCSCAN_stop(void);
+
+/* ring halves overwritten before the ADC task had processed them */
+uint32_t ADCSCAN_overruns(void);
+
+/* ADC task event handler: SIG_ADC_PRIMARY or SIG_ADC_ALTERNATE */
+void ADCSCAN_task(uint8_t sig);
+
+#endif // __ADCSCAN_H__
@@ -1,13 +1,46 @@
 #include <stdint.h>  /* Standard integers. WG14/N843 C99 Standard */
 #include "bsp.h"
+#include "inmon.h"
+#ifdef BSP_BENCH
+#include <stdio.h>
+#endif
+#ifdef EMDRV_TRACE
+#include "em_leuart.h"
+#endif
+#ifdef BSP_RAM_VECTORS
+#include "em_assert.h"
+#include "em_core.h"
+#endif
 
 
 static uint32_t volatile l_tickCtr;
+/* DMA channel control block, primary and alternate descriptors */
+static DMA_DESCRIPTOR_TypeDef l_dmaCtrl[DMA_CHAN_COUNT * 2]
+  __attribute__ ((aligned (256)));
 extern int DELAY;
-int counter = 0;
+
+#ifdef BSP_RAM_VECTORS
+/* the flash vector table of startup_efm32.c */
+extern uint32_t const __vector_table[];
+
+/* RAM copy of the vector table, VTOR needs it aligned to its size
+* rounded up to a power of 2 */
+static uint32_t l_ramVectors[CORE_DEFAULT_VECTOR_TABLE_ENTRIES]
+  __attribute__ ((aligned (256)));
+#endif
 
 void BSP_init(void) {
+    DMA_Init_TypeDef dmaInit;
 
+#ifdef BSP_RAM_VECTORS
+    /* exception entry fetches the vector from RAM, not through the flash
+    * wait states */
+    CORE_InitNvicVectorTable((uint32_t *)__vector_table,
+                             CORE_DEFAULT_VECTOR_TABLE_ENTRIES,
+                             l_ramVectors,
+                             CORE_DEFAULT_VECTOR_TABLE_ENTRIES,
+                             NULL, true);
+#endif
     CMU_ClockEnable(cmuClock_CORELE, true);
     CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFRCO);
     CMU->HFPERCLKEN0 = (1U << 7) | (1U);
@@ -20,11 +53,11 @@ void BSP_init(void) {
     //GPIO->P[2].DOUTSET |= (1<<10|1<<11);
     GPIO->P[4].MODEH |= (1<<10) | (3<<12) | (1<<18) | (3<<20); //PE10 OUTPUT, PE11 INPUT PE 12 OUT, PE 13 IN
     GPIO->P[4].DOUTSET |= (1<<10) | (1<<12);
-    GPIO->EXTIPSELH |= (1<<14) | (1<<22);
-    GPIO->EXTIRISE |= (1<<11);
-    GPIO->EXTIFALL |= (1<<13);
-    GPIO->IEN |= (1<<11) | (1<<13);
-    NVIC_EnableIRQ(GPIO_ODD_IRQn);
+    /* PE11 and PE13 edge interrupts are set up by INMON_start() */
+
+    dmaInit.hprot = 0;
+    dmaInit.controlBlock = l_dmaCtrl;
+    DMA_Init(&dmaInit);
 
    
     //SystemCoreClockUpdate();
@@ -67,20 +100,53 @@ void SysTick_Handler(void) {
   while(1) {}
 }
 
-void GPIO_ODD_IRQHandler(void) {
-  if(GPIO->IF&(1<<13)) {
-    counter = RTC->CNT;
-  }
-  if(GPIO->IF&(1<<11)) {
-    number = RTC->CNT - counter;
-    updateMatrix(((float)number)/32000,matrix);
-  }
-  GPIO->IFC = (1<<11) | (1<<13);
+#ifdef BSP_RAM_VECTORS
+BSP_Handler BSP_setHandler(IRQn_Type irq, BSP_Handler handler) {
+  BSP_Handler old;
+
+  /* a handler set while VTOR points elsewhere would never run */
+  EFM_ASSERT(SCB->VTOR == (uint32_t)l_ramVectors);
+  CORE_ATOMIC_SECTION(
+    old = (BSP_Handler)CORE_GetNvicRamTableHandler(irq);
+    CORE_SetNvicRamTableHandler(irq, (void *)handler);
+  )
+  return old;
+}
+#endif
+
+/* the capture edges: handlers and INMON_irq() run from RAM with
+* BSP_RAM_VECTORS */
+BSP_FAST void GPIO_ODD_IRQHandler(void) {
+#ifdef BSP_BENCH
+  uint32_t start = BSP_cycleCtr();
+#endif
+#ifdef EMDRV_TRACE
+  EMDRV_TRACE_IRQ_ENTER();
+#endif
+  /* decoding runs here, the capture task only sees decoded events */
+  INMON_irq(GPIO_IntGetEnabled() & 0xAAAAU);
+#ifdef BSP_BENCH
+  BSP_benchAdd(&BSP_bench[BSP_BENCH_GPIO_ISR], start);
+#endif
+#ifdef EMDRV_TRACE
+  EMDRV_TRACE_IRQ_EXIT();
+#endif
+}
+
+BSP_FAST void GPIO_EVEN_IRQHandler(void) {
+#ifdef EMDRV_TRACE
+  EMDRV_TRACE_IRQ_ENTER();
+#endif
+  INMON_irq(GPIO_IntGetEnabled() & 0x5555U);
+#ifdef EMDRV_TRACE
+  EMDRV_TRACE_IRQ_EXIT();
+#endif
 }
 
-void BSP_delay(uint32_t ticks) {
+void BSP_delay(uint32_t ms) {
+    uint32_t ticks = (uint32_t)RTCDRV_MsecsToTicks(ms);
     uint32_t start = BSP_tickCtr();
-    while (((BSP_tickCtr() - start)) < ticks) {
+    while (((BSP_tickCtr() - start) & _RTC_CNT_MASK) < ticks) {
     }
 }
 
@@ -97,4 +163,281 @@ void BSP_setLED2(void) {
 
 void BSP_clearLED2(void) {
   GPIO->P[2].DOUTCLR |= (1<<11);
-}
\ No newline at end of file
+}
+
+void BSP_cycleInit(void) {
+  SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL = 0;
+  /* core clock, no interrupt: SysTick_Handler() traps */
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+uint32_t BSP_cycleCtr(void) {
+  /* SysTick counts down */
+  return SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+}
+
+uint32_t BSP_cycleSince(uint32_t start) {
+  return (BSP_cycleCtr() - start) & SysTick_LOAD_RELOAD_Msk;
+}
+
+#ifdef BSP_BENCH
+BSP_Bench BSP_bench[BSP_BENCH_MAX] = {
+  { "updateMatrix", 0, UINT32_MAX, 0, 0 },
+  { "drawMatrix",   0, UINT32_MAX, 0, 0 },
+  { "gpioOddIsr",   0, UINT32_MAX, 0, 0 },
+  { "irqFlash",     0, UINT32_MAX, 0, 0 },
+  { "irqRam",       0, UINT32_MAX, 0, 0 },
+};
+
+#define BENCH_IRQ_RUNS 8
+
+/* SysTick->VAL at the first instruction of the bench handler */
+static uint32_t volatile l_irqStamp;
+static bool volatile l_irqDone;
+
+static void benchRecord(BSP_Bench *bench, uint32_t cycles) {
+  if (cycles < bench->min) {
+    bench->min = cycles;
+  }
+  if (cycles > bench->max) {
+    bench->max = cycles;
+  }
+  bench->total += cycles;
+  bench->runs++;
+}
+
+void BSP_benchAdd(BSP_Bench *bench, uint32_t start) {
+  benchRecord(bench, BSP_cycleSince(start));
+}
+
+/* bench handlers of BENCH_IRQn, SysTick read directly so no flash call
+* is timed */
+void TIMER1_IRQHandler(void) {
+  l_irqStamp = SysTick->VAL;
+  l_irqDone = true;
+}
+
+#ifdef BSP_RAM_VECTORS
+BSP_FAST static void benchIrqRam(void) {
+  l_irqStamp = SysTick->VAL;
+  l_irqDone = true;
+}
+#endif
+
+/* pend BENCH_IRQn and time until its handler runs */
+static void benchIrq(BSP_Bench *bench) {
+  uint32_t start;
+  int i;
+
+  for (i = 0; i < BENCH_IRQ_RUNS; i++) {
+    l_irqDone = false;
+    start = BSP_cycleCtr();
+    NVIC_SetPendingIRQ(BENCH_IRQn);
+    while (!l_irqDone) {
+    }
+    benchRecord(bench, (SysTick_LOAD_RELOAD_Msk - l_irqStamp - start)
+                       & SysTick_LOAD_RELOAD_Msk);
+  }
+}
+
+void BSP_benchRun(void) {
+  static char benchMatrix[8];
+#ifdef BSP_RAM_VECTORS
+  BSP_Handler old;
+#endif
+  uint32_t primask;
+  uint32_t start;
+  int i;
+
+  /* every digit in every position: 0.000 .. 9.999 */
+  for (i = 0; i < 10000; i += 1111) {
+    start = BSP_cycleCtr();
+    updateMatrix((float)i / 1000, benchMatrix);
+    BSP_benchAdd(&BSP_bench[BSP_BENCH_UPDATE_MATRIX], start);
+  }
+  /* first and last row change, so every frame is sent whole */
+  for (i = 0; i < 4; i++) {
+    benchMatrix[0] = (char)~benchMatrix[0];
+    benchMatrix[7] = (char)~benchMatrix[7];
+    BSP_delay(16); /* the previous frame is out */
+    start = BSP_cycleCtr();
+    drawMatrix(benchMatrix);
+    BSP_benchAdd(&BSP_bench[BSP_BENCH_DRAW_MATRIX], start);
+  }
+
+  /* interrupt entry, flash vector table and handler against the RAM
+  * ones. BENCH_IRQn has no source, so only the pend reaches it */
+  primask = __get_PRIMASK();
+  NVIC_ClearPendingIRQ(BENCH_IRQn);
+  NVIC_EnableIRQ(BENCH_IRQn);
+  __enable_irq();
+#ifdef BSP_RAM_VECTORS
+  __disable_irq();
+  SCB->VTOR = (uint32_t)__vector_table;
+  __DSB();
+  __enable_irq();
+#endif
+  benchIrq(&BSP_bench[BSP_BENCH_IRQ_FLASH]);
+#ifdef BSP_RAM_VECTORS
+  __disable_irq();
+  SCB->VTOR = (uint32_t)l_ramVectors;
+  __DSB();
+  __enable_irq();
+  old = BSP_setHandler(BENCH_IRQn, benchIrqRam);
+  benchIrq(&BSP_bench[BSP_BENCH_IRQ_RAM]);
+  BSP_setHandler(BENCH_IRQn, old);
+#endif
+  NVIC_DisableIRQ(BENCH_IRQn);
+  __set_PRIMASK(primask);
+}
+
+/* length after n more characters at len, a truncated write fills buf */
+static int benchJsonLen(int len, int n, int size) {
+  return (n < 0 || n >= size - len) ? size - 1 : len + n;
+}
+
+int BSP_benchJson(char *buf, int size) {
+  int len;
+  int i;
+
+  if (size <= 0) {
+    return 0;
+  }
+  len = benchJsonLen(0, snprintf(buf, size, "{\"clock\":%lu,\"benches\":[",
+                                 (unsigned long)SystemCoreClock), size);
+  for (i = 0; i < BSP_BENCH_MAX && len < size - 1; i++) {
+    BSP_Bench const *b = &BSP_bench[i];
+    len = benchJsonLen(len, snprintf(&buf[len], size - len,
+                    "%s{\"name\":\"%s\",\"runs\":%lu,\"min\":%lu,\"max\":%lu,\"avg\":%lu}",
+                    (i == 0) ? "" : ",", b->name,
+                    (unsigned long)b->runs,
+                    (unsigned long)(b->runs ? b->min : 0),
+                    (unsigned long)b->max,
+                    (unsigned long)(b->runs ? b->total / b->runs : 0)), size);
+  }
+  if (len < size - 1) {
+    len = benchJsonLen(len, snprintf(&buf[len], size - len, "]}"), size);
+  }
+  return len;
+}
+#endif
+
+#ifdef EMDRV_TRACE
+/* nesting depth of traced handlers, M0+ has 4 priority levels */
+#define TRACE_NEST 4
+
+static BSP_TraceRecord l_trace[BSP_TRACE_SIZE];
+static uint16_t l_traceHead; /* next record to write */
+static uint16_t l_traceCount;
+static uint32_t l_traceEnterRtc[TRACE_NEST];
+static uint32_t l_traceEnterCycle[TRACE_NEST];
+static uint8_t l_traceDepth;
+static uint32_t l_traceSleepRtc;
+static uint8_t l_traceDumpInit;
+
+static void traceRecord(uint32_t time, uint32_t duration,
+                        uint8_t type, uint8_t id) {
+  BSP_TraceRecord *r = &l_trace[l_traceHead];
+
+  r->time = time;
+  r->duration = (duration > 0xFFFFU) ? 0xFFFFU : (uint16_t)duration;
+  r->type = type;
+  r->id = id;
+  l_traceHead = (l_traceHead + 1U) % BSP_TRACE_SIZE;
+  if (l_traceCount < BSP_TRACE_SIZE) {
+    l_traceCount++;
+  }
+}
+
+void EMDRV_TraceEvent(uint8_t type, uint8_t id) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  switch (type) {
+    case EMDRV_TRACE_EVENT_IRQ_ENTER:
+      if (l_traceDepth < TRACE_NEST) {
+        l_traceEnterRtc[l_traceDepth] = RTC->CNT;
+        l_traceEnterCycle[l_traceDepth] = BSP_cycleCtr();
+      }
+      l_traceDepth++;
+      break;
+
+    case EMDRV_TRACE_EVENT_IRQ_EXIT:
+      if (l_traceDepth > 0U) {
+        l_traceDepth--;
+        if (l_traceDepth < TRACE_NEST) {
+          traceRecord(l_traceEnterRtc[l_traceDepth],
+                      BSP_cycleSince(l_traceEnterCycle[l_traceDepth]),
+                      type, id);
+        }
+      }
+      break;
+
+    case EMDRV_TRACE_EVENT_SLEEP:
+      l_traceSleepRtc = RTC->CNT;
+      break;
+
+    case EMDRV_TRACE_EVENT_WAKE:
+      traceRecord(l_traceSleepRtc,
+                  (RTC->CNT - l_traceSleepRtc) & _RTC_CNT_MASK,
+                  type, id);
+      break;
+
+    default:
+      break;
+  }
+  __set_PRIMASK(primask);
+}
+
+static void traceTx(void const *data, uint32_t len) {
+  uint8_t const *p = data;
+
+  /* little endian core, fields go out as they are in memory */
+  while (len--) {
+    LEUART_Tx(TRACE_LEUART, *p++);
+  }
+}
+
+void BSP_traceDump(void) {
+  BSP_TraceRecord r;
+  uint16_t count;
+  uint16_t tail;
+  uint32_t primask;
+  uint32_t rtcHz;
+
+  if (!l_traceDumpInit) {
+    LEUART_Init_TypeDef init = LEUART_INIT_DEFAULT;
+
+    CMU_ClockSelectSet(cmuClock_LFB, cmuSelect_LFRCO);
+    CMU_ClockEnable(TRACE_LEUART_CLOCK, true);
+    CMU_ClockEnable(cmuClock_GPIO, true);
+    LEUART_Init(TRACE_LEUART, &init);
+    TRACE_LEUART->ROUTE = LEUART_ROUTE_TXPEN | TRACE_LEUART_LOCATION;
+    GPIO_PinModeSet(TRACE_TX_PORT, TRACE_TX_PIN, gpioModePushPull, 1);
+    l_traceDumpInit = 1U;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  count = l_traceCount;
+  __set_PRIMASK(primask);
+
+  traceTx("TR", 2U);
+  traceTx(&count, sizeof(count));
+  traceTx(&SystemCoreClock, sizeof(SystemCoreClock));
+  rtcHz = CMU_ClockFreqGet(cmuClock_RTC);
+  traceTx(&rtcHz, sizeof(rtcHz));
+
+  /* take records one at a time, new ones may arrive while sending */
+  while (count--) {
+    primask = __get_PRIMASK();
+    __disable_irq();
+    tail = (l_traceHead + BSP_TRACE_SIZE - l_traceCount) % BSP_TRACE_SIZE;
+    r = l_trace[tail];
+    l_traceCount--;
+    __set_PRIMASK(primask);
+    traceTx(&r, sizeof(r));
+  }
+}
+#endif
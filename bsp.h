@@ -11,6 +11,39 @@
 #define SPI_LOCATION     USART_ROUTE_LOCATION_LOC3 
 #define SPI_USART_CLOCK  cmuClock_USART1
 
+/* DMA channels of the application */
+#define DMA_CH_DISPLAY   0 /* MAX7219 command scripts to SPI_USART */
+#define DMA_CH_ADC       1 /* ADC scan results to the adcscan ring */
+#define DMA_CH_LOG       2 /* deferred log ring to TRACE_LEUART */
+
+/* ADC scan inputs, CH5 PD5 and CH6 PD6. ADC_SCAN_CHANNELS is the number
+* of inputs in ADC_SCAN_INPUTS. scans are triggered by TIMER0 on PRS */
+#define ADC_SCAN_INPUTS   (ADC_SCANCTRL_INPUTMASK_CH5 | ADC_SCANCTRL_INPUTMASK_CH6)
+#define ADC_SCAN_CHANNELS 2
+#define ADC_PRS_CH        0
+#define ADC_PRS_SEL       adcPRSSELCh0
+
+/* HT16K33 display on I2C0, SDA PA0, SCL PA1. define BSP_DISPLAY_HT16K33
+* to drive it instead of the MAX7219 */
+#define DISPLAY_I2C          I2C0
+#define DISPLAY_I2C_LOCATION _I2C_ROUTE_LOCATION_LOC0
+#define HT16K33_ADDR         (0x70 << 1) /* A2..A0 open */
+
+/* unused interrupt line pended by the interrupt latency bench */
+#define BENCH_IRQn TIMER1_IRQn
+
+/* trace dump port, LEUART0 TX on PD4. the deferred log (BSP_LOG) sends
+* on the same port */
+#define TRACE_LEUART          LEUART0
+#define TRACE_LEUART_LOCATION LEUART_ROUTE_LOCATION_LOC0
+#define TRACE_LEUART_CLOCK    cmuClock_LEUART0
+#define TRACE_TX_PORT         gpioPortD
+#define TRACE_TX_PIN          4
+
+#if defined(BSP_LOG) && defined(EMDRV_TRACE)
+#error BSP_LOG and EMDRV_TRACE share TRACE_LEUART
+#endif
+
 
 
 #include "stdint.h"
@@ -21,12 +54,48 @@
 #include "em_pcnt.h"
 #include "em_usart.h"
 #include "max7129.h"
+#include "display.h"
 #include "em_gpio.h"
 //#include "system_efm32zg.c"
-extern int counter;
 extern int number;
 //#include "em_system.c"
 #include "em_chip.h"
+#include "sched.h"
+
+/* scheduler tasks of the application, by priority */
+enum {
+    TASK_TELEMETRY,
+    TASK_DISPLAY,
+    TASK_CAPTURE,
+    TASK_ADC
+};
+
+/* scheduler signals */
+enum {
+    SIG_TICK,
+    SIG_CAPTURE,
+    SIG_ADC_PRIMARY,   /* primary ring half filled */
+    SIG_ADC_ALTERNATE  /* alternate ring half filled */
+};
+
+/* define BSP_RAM_VECTORS to run exceptions from a RAM copy of the vector
+* table. BSP_FAST places a hot interrupt handler in RAM with it, in the
+* em_ramfunc section (IAR __ramfunc, GCC .ram) */
+#ifdef BSP_RAM_VECTORS
+#include "em_ramfunc.h"
+#define BSP_FAST SL_RAMFUNC_DEFINITION_BEGIN
+
+typedef void (*BSP_Handler)(void);
+
+/* replace the RAM table handler of irq, returns the previous one. handlers
+* can be swapped at run time, e.g. per operating mode. BSP_benchRun()
+* points VTOR at the flash table while it times the flash entry: for that
+* time the startup handlers run in place of the swapped in ones, and
+* BSP_setHandler() must not be called */
+BSP_Handler BSP_setHandler(IRQn_Type irq, BSP_Handler handler);
+#else
+#define BSP_FAST
+#endif
 
 /* system clock tick [Hz] */
 void BSP_init(void);
@@ -36,11 +105,13 @@ void BSP_clearLED(void);
 void BSP_setLED2(void);
 void BSP_clearLED2(void);
 
-/* get the current value of the clock tick counter (returns immedately) */
+/* get the current value of the clock tick counter (returns immedately).
+* the tick counter is the 24 bit RTC count. SCHED_init() sets the RTC up
+* through RTCDRV, convert ticks with RTCDRV_TicksToMsec() */
 uint32_t BSP_tickCtr(void);
 
-/* delay for a specified number of system clock ticks (polling) */
-void BSP_delay(uint32_t ticks);
+/* delay for a number of milliseconds (polling), after SCHED_init() */
+void BSP_delay(uint32_t ms);
 
 void BSP_display(int number);
 void BSP_setSegment(int segment);
@@ -49,4 +120,71 @@ void BSP_write(int number);
 void BSP_writeDigit(int digit);
 void initSpi3Wire(void);
 void writeSpiByte(uint8_t addr,uint8_t data);
+
+/* core clock cycle counter, SysTick running free without interrupt
+* (Cortex-M0+ has no DWT cycle counter). 24 bits, so a measured
+* section must be shorter than 2^24 cycles */
+void BSP_cycleInit(void);
+uint32_t BSP_cycleCtr(void);
+uint32_t BSP_cycleSince(uint32_t start);
+
+#ifdef BSP_BENCH
+/* timing result of one benchmarked code path [core clock cycles] */
+typedef struct {
+    char const *name;
+    uint32_t runs;
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;
+} BSP_Bench;
+
+enum {
+    BSP_BENCH_UPDATE_MATRIX, /* updateMatrix(), digit conversion */
+    BSP_BENCH_DRAW_MATRIX,   /* drawMatrix(), one display frame */
+    BSP_BENCH_GPIO_ISR,      /* GPIO_ODD_IRQHandler() */
+    BSP_BENCH_IRQ_FLASH,     /* pend to handler, flash vectors and handler */
+    BSP_BENCH_IRQ_RAM,       /* pend to handler, RAM vectors and handler */
+    BSP_BENCH_MAX
+};
+
+extern BSP_Bench BSP_bench[BSP_BENCH_MAX];
+
+/* add the run started at cycle counter value start to the bench */
+void BSP_benchAdd(BSP_Bench *bench, uint32_t start);
+
+/* run the benches that can be called directly. drawMatrix() is timed on
+* the display, call after DISPLAY_init() */
+void BSP_benchRun(void);
+
+/* write all results as a JSON array into buf, returns the length. output
+* that does not fit is cut at size - 1 characters, the result is always
+* terminated */
+int BSP_benchJson(char *buf, int size);
+#endif
+
+#ifdef EMDRV_TRACE
+#include "emdrv_trace.h"
+
+/* number of trace records kept, oldest are overwritten */
+#define BSP_TRACE_SIZE 64
+
+/* one trace record, 8 bytes little endian in the dump:
+* IRQ:   type EMDRV_TRACE_EVENT_IRQ_EXIT, id exception number,
+*        time RTC count at entry, duration core clock cycles
+* sleep: type EMDRV_TRACE_EVENT_WAKE, id energy mode,
+*        time RTC count at sleep, duration RTC ticks
+* durations saturate at 0xFFFF */
+typedef struct {
+    uint32_t time;
+    uint16_t duration;
+    uint8_t type;
+    uint8_t id;
+} BSP_TraceRecord;
+
+/* send the recorded trace over TRACE_LEUART and empty it:
+* 'T' 'R' count(16 bit) SystemCoreClock(32 bit) RTC frequency(32 bit)
+* count records. test/tools/traceview prints the handler durations and
+* the CPU load of a dump */
+void BSP_traceDump(void);
+#endif
 #endif // __BSP_H__
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include <stddef.h>
+#include <string.h>
+#include "display.h"
+
+static DISPLAY_Backend const *l_backend;
+static uint8_t l_shown[DISPLAY_ROWS]; /* rows the display shows */
+static bool l_shownValid;             /* false until the first full flush */
+static volatile bool l_invalid;       /* a flush was lost, see DISPLAY_invalidate() */
+static volatile uint32_t l_lost;
+
+void DISPLAY_init(DISPLAY_Backend const *backend) {
+  l_backend = backend;
+  l_shownValid = false;
+  l_invalid = false;
+  l_lost = 0U;
+  l_backend->init();
+}
+
+void DISPLAY_flush(uint8_t const *fb) {
+  uint8_t first = 0U;
+  uint8_t last = DISPLAY_ROWS - 1U;
+
+  if (l_backend == NULL) {
+    return; /* before DISPLAY_init() */
+  }
+  /* cleared before the backend is called: a flush lost from here on sets
+  * it again for the next call */
+  if (l_invalid) {
+    l_invalid = false;
+    l_shownValid = false;
+  }
+  if (l_shownValid) {
+    while (first < DISPLAY_ROWS && fb[first] == l_shown[first]) {
+      first++;
+    }
+    if (first == DISPLAY_ROWS) {
+      return; /* nothing changed */
+    }
+    while (fb[last] == l_shown[last]) {
+      last--;
+    }
+  }
+
+  /* rows stay dirty when the backend is busy, the next flush sends them */
+  if (l_backend->flush(fb, first, last)) {
+    memcpy(l_shown, fb, DISPLAY_ROWS);
+    l_shownValid = true;
+  }
+}
+
+void DISPLAY_invalidate(void) {
+  l_invalid = true;
+  l_lost++;
+}
+
+uint32_t DISPLAY_lost(void) {
+  return l_lost;
+}
+
+void DISPLAY_brightness(uint8_t level) {
+  if (level > DISPLAY_BRIGHT_MAX) {
+    level = DISPLAY_BRIGHT_MAX;
+  }
+  l_backend->brightness(level);
+}
+
+bool DISPLAY_blink(uint8_t rate) {
+  if (l_backend->blink == NULL) {
+    return false;
+  }
+  l_backend->blink(rate & 3U);
+  return true;
+}
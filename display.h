@@ -0,0 +1,47 @@
+#ifndef __DISPLAY_H__
+#define __DISPLAY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 8x8 dot matrix framebuffer, one byte per row, sent to the controller as
+* it is. the render code (updateMatrix) draws into a framebuffer and
+* DISPLAY_flush() sends the rows that changed through a display backend */
+
+#define DISPLAY_ROWS       8
+#define DISPLAY_BRIGHT_MAX 15
+
+/* display backend, one per controller and transport */
+typedef struct {
+    /* set the controller up: display on, full brightness, no blink */
+    void (*init)(void);
+    /* start sending rows first..last of fb, returns false if the previous
+    * flush is still being sent. fb is copied, it can change on return */
+    bool (*flush)(uint8_t const *fb, uint8_t first, uint8_t last);
+    /* 0..DISPLAY_BRIGHT_MAX */
+    void (*brightness)(uint8_t level);
+    /* 0 off, 1 2 Hz, 2 1 Hz, 3 0.5 Hz, NULL if the controller can not blink */
+    void (*blink)(uint8_t rate);
+} DISPLAY_Backend;
+
+extern DISPLAY_Backend const DISPLAY_max7219; /* MAX7219 on SPI_USART, see max7129.c */
+extern DISPLAY_Backend const DISPLAY_ht16k33; /* HT16K33 on DISPLAY_I2C, see ht16k33.c */
+
+void DISPLAY_init(DISPLAY_Backend const *backend);
+
+/* send the rows of fb that differ from what the display shows */
+void DISPLAY_flush(uint8_t const *fb);
+
+/* called by a backend, also from interrupts, when a flush it had accepted
+* did not reach the display: the next DISPLAY_flush() sends every row */
+void DISPLAY_invalidate(void);
+
+/* accepted flushes that did not reach the display */
+uint32_t DISPLAY_lost(void);
+
+void DISPLAY_brightness(uint8_t level);
+
+/* returns false if the backend can not blink */
+bool DISPLAY_blink(uint8_t rate);
+
+#endif // __DISPLAY_H__
@@ -0,0 +1,121 @@
+#include <stddef.h>
+#include "em_core.h"
+#include "em_leuart.h"
+#include "bsp.h"
+#include "dlog.h"
+
+#if (DLOG_RING_SIZE & (DLOG_RING_SIZE - 1)) || (DLOG_RING_SIZE > 1024)
+#error DLOG_RING_SIZE must be a power of 2 up to 1024, one DMA cycle
+#endif
+
+#define HEADER_SIZE 8U
+
+static uint8_t l_ring[DLOG_RING_SIZE];
+static uint16_t l_head; /* bytes appended, free running */
+static uint16_t l_tail; /* bytes sent, free running */
+static uint16_t l_busy; /* bytes of the running DMA cycle */
+static uint8_t l_seq;
+static volatile uint32_t l_lost;
+
+static void runDone(unsigned int channel, bool primary, void *user);
+static DMA_CB_TypeDef l_dmaCb = { runDone, NULL, 0 };
+
+/* send the next contiguous run of the ring, interrupts masked */
+static void runStart(void) {
+  uint16_t offset = l_tail % DLOG_RING_SIZE;
+  uint16_t len = (uint16_t)(l_head - l_tail);
+
+  if (l_busy != 0U || len == 0U) {
+    return;
+  }
+  if (len > DLOG_RING_SIZE - offset) {
+    len = DLOG_RING_SIZE - offset; /* up to the end, the rest follows */
+  }
+  l_busy = len;
+  DMA_ActivateBasic(DMA_CH_LOG, true, false,
+                    (void *)&TRACE_LEUART->TXDATA,
+                    (void const *)&l_ring[offset],
+                    len - 1U);
+}
+
+/* DMA callback, runs in the DMA interrupt */
+static void runDone(unsigned int channel, bool primary, void *user) {
+  (void)channel;
+  (void)primary;
+  (void)user;
+  l_tail += l_busy;
+  l_busy = 0U;
+  runStart();
+}
+
+void DLOG_init(void) {
+  LEUART_Init_TypeDef init = LEUART_INIT_DEFAULT;
+  DMA_CfgChannel_TypeDef chnlCfg;
+  DMA_CfgDescr_TypeDef descrCfg;
+
+  CMU_ClockSelectSet(cmuClock_LFB, cmuSelect_LFRCO);
+  CMU_ClockEnable(TRACE_LEUART_CLOCK, true);
+  CMU_ClockEnable(cmuClock_GPIO, true);
+  init.enable = leuartDisable;
+  LEUART_Init(TRACE_LEUART, &init);
+  TRACE_LEUART->ROUTE = LEUART_ROUTE_TXPEN | TRACE_LEUART_LOCATION;
+  GPIO_PinModeSet(TRACE_TX_PORT, TRACE_TX_PIN, gpioModePushPull, 1);
+  /* TXDMAWU is only changed with the transmitter off */
+  LEUART_TxDmaInEM2Enable(TRACE_LEUART, true);
+  LEUART_Enable(TRACE_LEUART, leuartEnableTx);
+
+  chnlCfg.highPri = false;
+  chnlCfg.enableInt = true;
+  chnlCfg.select = DMAREQ_LEUART0_TXBL;
+  chnlCfg.cb = &l_dmaCb;
+  DMA_CfgChannel(DMA_CH_LOG, &chnlCfg);
+  descrCfg.dstInc = dmaDataIncNone;
+  descrCfg.srcInc = dmaDataInc1;
+  descrCfg.size = dmaDataSize1;
+  descrCfg.arbRate = dmaArbitrate1;
+  descrCfg.hprot = 0;
+  DMA_CfgDescr(DMA_CH_LOG, true, &descrCfg);
+}
+
+static void put(uint16_t *at, void const *data, uint8_t len) {
+  uint8_t const *p = data;
+
+  /* little endian core, fields go out as they are in memory */
+  while (len--) {
+    l_ring[(*at)++ % DLOG_RING_SIZE] = *p++;
+  }
+}
+
+void DLOG_write(DLOG_Id id, uint8_t argc, uint32_t const *args) {
+  CORE_DECLARE_IRQ_STATE;
+  uint8_t header[4];
+  uint32_t time;
+  uint16_t size;
+
+  if (argc > DLOG_MAX_ARGS) {
+    argc = DLOG_MAX_ARGS;
+  }
+  size = HEADER_SIZE + 4U * argc;
+  header[0] = DLOG_SYNC;
+  header[1] = argc;
+  header[2] = (uint8_t)id;
+  header[3] = (uint8_t)((uint16_t)id >> 8);
+
+  /* the Cortex-M0+ has no exclusive access, so the append is a short
+  * critical section: at most 20 bytes copied */
+  CORE_ENTER_ATOMIC();
+  time = (RTC->CNT & _RTC_CNT_MASK) | ((uint32_t)l_seq++ << 24);
+  if ((uint16_t)(l_head - l_tail) + size > DLOG_RING_SIZE) {
+    l_lost++;
+  } else {
+    put(&l_head, header, sizeof(header));
+    put(&l_head, &time, sizeof(time));
+    put(&l_head, args, 4U * argc);
+    runStart();
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+uint32_t DLOG_lost(void) {
+  return l_lost;
+}
@@ -0,0 +1,56 @@
+#ifndef __DLOG_H__
+#define __DLOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* deferred binary log
+* records carry a format ID and raw 32 bit arguments instead of text, the
+* host formats them with the strings of dlog_formats.h (test/tools/dlogview
+* image.elf capture). records are
+* appended to a RAM ring and sent by the DMA to TRACE_LEUART. the LEUART
+* wakes the DMA in EM2, so the log drains while the core sleeps and the
+* core only wakes for the DMA completion of each ring run.
+*
+* record on the wire, little endian:
+* 'L' argc id(16 bit) time(32 bit) argc * arg(32 bit)
+* time is the RTC count in bits 23..0, at the RTCDRV tick rate of
+* LFCLK / 8 (RTC_DIVIDER in rtcdriver.c), and a record sequence number in
+* bits 31..24. records dropped on a full ring still take a sequence
+* number, so the host sees the gap */
+
+#define DLOG_RING_SIZE 256 /* bytes, power of 2 */
+#define DLOG_MAX_ARGS  3
+#define DLOG_SYNC      'L'
+
+typedef enum {
+#define DLOG_FORMAT(id, format) id,
+#include "dlog_formats.h"
+#undef DLOG_FORMAT
+    DLOG_FORMAT_COUNT
+} DLOG_Id;
+
+/* LEUART at 9600 baud from LFRCO and the DMA channel DMA_CH_LOG */
+void DLOG_init(void);
+
+/* append a record, any context. argc up to DLOG_MAX_ARGS */
+void DLOG_write(DLOG_Id id, uint8_t argc, uint32_t const *args);
+
+#define DLOG0(id_) DLOG_write((id_), 0U, (uint32_t const *)0)
+#define DLOG1(id_, a_) do { \
+    uint32_t const args_[] = { (uint32_t)(a_) }; \
+    DLOG_write((id_), 1U, args_); \
+} while (0)
+#define DLOG2(id_, a_, b_) do { \
+    uint32_t const args_[] = { (uint32_t)(a_), (uint32_t)(b_) }; \
+    DLOG_write((id_), 2U, args_); \
+} while (0)
+#define DLOG3(id_, a_, b_, c_) do { \
+    uint32_t const args_[] = { (uint32_t)(a_), (uint32_t)(b_), (uint32_t)(c_) }; \
+    DLOG_write((id_), 3U, args_); \
+} while (0)
+
+/* records dropped because the ring was full */
+uint32_t DLOG_lost(void);
+
+#endif // __DLOG_H__
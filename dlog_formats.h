@@ -0,0 +1,11 @@
+/* deferred log formats, included by dlog.h only
+* DLOG_FORMAT(id, format): the record ID is the position in this list and
+* the format string is only read by the host decoder, it is not compiled
+* into the image. append new formats at the end so old logs still decode.
+* arguments are 32 bit, printf conversions %u %d %x. a %s argument is the
+* address of a string in the image, dlogview reads it from the ELF file */
+DLOG_FORMAT(DLOG_BOOT,          "boot, core clock %u Hz")
+DLOG_FORMAT(DLOG_CAPTURE,       "capture %u RTC ticks")
+DLOG_FORMAT(DLOG_CAPTURE_LOST,  "capture events lost %u")
+DLOG_FORMAT(DLOG_ADC_OVERRUNS,  "adc ring overruns %u")
+DLOG_FORMAT(DLOG_CORE_SITE,     "critical section %s:%u, max %u cycles")
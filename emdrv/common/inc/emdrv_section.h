@@ -0,0 +1,117 @@
+/***************************************************************************//**
+ * @file emdrv_section.h
+ * @brief Energy Aware drivers critical sections.
+ * @version 5.5.0
+ *******************************************************************************
+ * # License
+ * <b>(C) Copyright 2015 Silicon Labs, www.silabs.com</b>
+ *******************************************************************************
+ *
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ *
+ ******************************************************************************/
+#ifndef __SILICON_LABS_EMDRV_SECTION_H__
+#define __SILICON_LABS_EMDRV_SECTION_H__
+
+#include <stdint.h>
+#include "em_device.h"
+#include "em_core.h"
+
+/***************************************************************************//**
+ * @addtogroup emdrv
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup EMDRV_SECTION
+ * @brief Driver critical sections.
+ * @details
+ *  Drivers protect their state with the EMDRV_xxx_SECTION() macros. By
+ *  default these are ATOMIC sections. With EMDRV_NVIC_SECTIONS defined
+ *  they are NVIC mask sections, which disable only the interrupts that
+ *  touch the driver state. All other interrupts, e.g. GPIO edge
+ *  interrupts, stay live.
+ *
+ *  Each driver lists the interrupts touching its state as an IRQ list
+ *  macro, `#define LIST(X, w) X(I2C0_IRQn, w) X(DMA_IRQn, w)`.
+ *  @ref EMDRV_SECTION_MASK() expands the list into a constant
+ *  CORE_nvicMask_t initializer at compile time. The interrupts of the
+ *  driver itself are listed by the driver. Interrupts of the application
+ *  that call the driver API must be added with the driver's
+ *  EMDRV_xxx_SECTION_EXTRA_IRQS configuration macro. Otherwise the state
+ *  is not protected against them.
+ * @{
+ ******************************************************************************/
+
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+#define EMDRV_SECTION_IRQ_BIT(irq, w) \
+  | ((((uint32_t)(irq) >> 5) == (w)) ? (1UL << ((uint32_t)(irq) & 31U)) : 0UL)
+#define EMDRV_SECTION_WORD(irqs, w)   (0UL irqs(EMDRV_SECTION_IRQ_BIT, w))
+/// An empty IRQ list.
+#define EMDRV_SECTION_NO_IRQS(X, w)
+/// @endcond
+
+/// Constant NVIC mask initializer with the interrupts of an IRQ list.
+#if (CORE_NVIC_REG_WORDS == 1)
+#define EMDRV_SECTION_MASK(irqs) \
+  { { EMDRV_SECTION_WORD(irqs, 0U) } }
+#elif (CORE_NVIC_REG_WORDS == 2)
+#define EMDRV_SECTION_MASK(irqs) \
+  { { EMDRV_SECTION_WORD(irqs, 0U), EMDRV_SECTION_WORD(irqs, 1U) } }
+#else
+#define EMDRV_SECTION_MASK(irqs)                                \
+  { { EMDRV_SECTION_WORD(irqs, 0U), EMDRV_SECTION_WORD(irqs, 1U), \
+      EMDRV_SECTION_WORD(irqs, 2U) } }
+#endif
+
+#if defined(EMDRV_NVIC_SECTIONS)
+
+/***************************************************************************//**
+ * @brief
+ *   Enter an NVIC mask section.
+ *
+ * @details
+ *   Unlike CORE_ENTER_NVIC(), only the interrupts in mask are re-enabled
+ *   on exit. Interrupts outside the mask may be enabled or disabled by
+ *   interrupt handlers while the section runs.
+ *
+ * @param[out] state
+ *   The interrupts of mask enabled prior to section entry.
+ *
+ * @param[in] mask
+ *   The interrupts to disable within the section.
+ ******************************************************************************/
+__STATIC_INLINE void EMDRV_EnterSection(CORE_nvicMask_t *state,
+                                        const CORE_nvicMask_t *mask)
+{
+  uint32_t i;
+
+  CORE_EnterNvicMask(state, mask);
+  for (i = 0U; i < CORE_NVIC_REG_WORDS; i++) {
+    state->a[i] &= mask->a[i];
+  }
+}
+
+/// Allocate storage for the section state.
+#define EMDRV_DECLARE_SECTION_STATE   CORE_nvicMask_t sectionState
+/// Enter a section, disables the interrupts in mask.
+#define EMDRV_ENTER_SECTION(mask)     EMDRV_EnterSection(&sectionState, (mask))
+/// Exit a section.
+#define EMDRV_EXIT_SECTION()          CORE_NvicEnableMask(&sectionState)
+
+#else
+
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+#define EMDRV_DECLARE_SECTION_STATE   CORE_DECLARE_IRQ_STATE
+#define EMDRV_ENTER_SECTION(mask)     CORE_ENTER_ATOMIC()
+#define EMDRV_EXIT_SECTION()          CORE_EXIT_ATOMIC()
+/// @endcond
+
+#endif
+
+/** @} (end addtogroup EMDRV_SECTION) */
+/** @} (end addtogroup emdrv) */
+
+#endif // __SILICON_LABS_EMDRV_SECTION_H__
@@ -0,0 +1,87 @@
+/***************************************************************************//**
+ * @file emdrv_trace.h
+ * @brief Energy Aware drivers interrupt and sleep trace hooks.
+ * @version 5.5.0
+ *******************************************************************************
+ * # License
+ * <b>(C) Copyright 2015 Silicon Labs, www.silabs.com</b>
+ *******************************************************************************
+ *
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ *
+ ******************************************************************************/
+#ifndef __SILICON_LABS_EMDRV_TRACE_H__
+#define __SILICON_LABS_EMDRV_TRACE_H__
+
+#include <stdint.h>
+#include "em_device.h"
+
+/***************************************************************************//**
+ * @addtogroup emdrv
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup EMDRV_TRACE
+ * @brief Interrupt and sleep trace hooks.
+ * @details
+ *  Interrupt handlers and sleep transitions of the drivers are marked with
+ *  the EMDRV_TRACE_xxx() macros. The macros are empty unless EMDRV_TRACE is
+ *  defined. With EMDRV_TRACE defined, every marked event calls
+ *  EMDRV_TraceEvent(), which must be implemented by the application, e.g.
+ *  to record the events with a timestamp into a trace buffer.
+ *
+ *  The event id is the active exception number (IPSR) for interrupt events,
+ *  and the energy mode for sleep events.
+ * @{
+ ******************************************************************************/
+
+#define EMDRV_TRACE_EVENT_IRQ_ENTER   0U    ///< Interrupt handler entered.
+#define EMDRV_TRACE_EVENT_IRQ_EXIT    1U    ///< Interrupt handler left.
+#define EMDRV_TRACE_EVENT_SLEEP       2U    ///< Energy mode about to be entered.
+#define EMDRV_TRACE_EVENT_WAKE        3U    ///< Woken up from the energy mode.
+
+#if defined(EMDRV_TRACE)
+
+/***************************************************************************//**
+ * @brief
+ *   Trace event handler, implemented by the application.
+ *
+ * @details
+ *   Called from interrupt handlers and with interrupts disabled, so it must
+ *   be short and must not block.
+ *
+ * @param[in] type
+ *   Event type, one of the EMDRV_TRACE_EVENT_xxx values.
+ *
+ * @param[in] id
+ *   Exception number or energy mode.
+ ******************************************************************************/
+void EMDRV_TraceEvent(uint8_t type, uint8_t id);
+
+/// Mark the entry of an interrupt handler.
+#define EMDRV_TRACE_IRQ_ENTER()     EMDRV_TraceEvent(EMDRV_TRACE_EVENT_IRQ_ENTER, (uint8_t)__get_IPSR())
+/// Mark the exit of an interrupt handler.
+#define EMDRV_TRACE_IRQ_EXIT()      EMDRV_TraceEvent(EMDRV_TRACE_EVENT_IRQ_EXIT, (uint8_t)__get_IPSR())
+/// Mark entering an energy mode.
+#define EMDRV_TRACE_SLEEP(eMode)    EMDRV_TraceEvent(EMDRV_TRACE_EVENT_SLEEP, (uint8_t)(eMode))
+/// Mark waking up from an energy mode.
+#define EMDRV_TRACE_WAKE(eMode)     EMDRV_TraceEvent(EMDRV_TRACE_EVENT_WAKE, (uint8_t)(eMode))
+
+#else
+
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+#define EMDRV_TRACE_IRQ_ENTER()
+#define EMDRV_TRACE_IRQ_EXIT()
+#define EMDRV_TRACE_SLEEP(eMode)
+#define EMDRV_TRACE_WAKE(eMode)
+/// @endcond
+
+#endif
+
+/** @} (end addtogroup EMDRV_TRACE) */
+/** @} (end addtogroup emdrv) */
+
+#endif // __SILICON_LABS_EMDRV_TRACE_H__
@@ -0,0 +1,63 @@
+/***************************************************************************//**
+ * @file i2cdrv_config.h
+ * @brief I2CDRV configuration file.
+ * @version 5.5.0
+ *******************************************************************************
+ * # License
+ * <b>(C) Copyright 2015 Silicon Labs, www.silabs.com</b>
+ *******************************************************************************
+ *
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ *
+ ******************************************************************************/
+#ifndef __SILICON_LABS_I2CDRV_CONFIG_H__
+#define __SILICON_LABS_I2CDRV_CONFIG_H__
+
+/***************************************************************************//**
+ * @addtogroup emdrv
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup I2CDRV
+ * @{
+ ******************************************************************************/
+
+#warning "This configuration file is deprecated and marked for removal in a later release. Please use the new configuration template file in emdrv\i2cdrv\config instead."
+
+/// I2CDRV configuration option. Number of transaction descriptors queued in
+/// each driver instance, see @ref I2CDRV_QueueTransfer().
+#ifndef EMDRV_I2CDRV_QUEUE_SIZE
+#define EMDRV_I2CDRV_QUEUE_SIZE 4
+#endif
+
+/// I2CDRV configuration option. Write segments of at least this many bytes
+/// are transferred by DMA, using one DMADRV channel per driver instance.
+/// Set to 0 to transfer all data from the interrupt handler and exclude
+/// the DMADRV dependency.
+#ifndef EMDRV_I2CDRV_DMA_THRESHOLD
+#define EMDRV_I2CDRV_DMA_THRESHOLD 0
+#endif
+
+/// I2CDRV configuration option. Use this define to block EM2 with the SLEEP
+/// driver while transactions are queued.
+#if defined(DOXY_DOC_ONLY)
+#define EMDRV_I2CDRV_SLEEPDRV_INTEGRATION
+#else
+//#define EMDRV_I2CDRV_SLEEPDRV_INTEGRATION
+#endif
+
+/// I2CDRV configuration option. With EMDRV_NVIC_SECTIONS defined, the
+/// driver sections disable only the I2C and DMA interrupts. List here the
+/// other interrupts whose handlers call the I2CDRV API, see
+/// @ref EMDRV_SECTION.
+#ifndef EMDRV_I2CDRV_SECTION_EXTRA_IRQS
+#define EMDRV_I2CDRV_SECTION_EXTRA_IRQS(X, w)
+#endif
+
+/** @} (end addtogroup I2CDRV) */
+/** @} (end addtogroup emdrv) */
+
+#endif /* __SILICON_LABS_I2CDRV_CONFIG_H__ */
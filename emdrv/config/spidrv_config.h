@@ -30,6 +30,22 @@
 /// SPIDRV configuration option. Use this define to include the slave part of the SPIDRV API.
 #define EMDRV_SPIDRV_INCLUDE_SLAVE
 
+/// SPIDRV configuration option. Use this define to make the blocking transfer
+/// functions wait for DMA completion in EM1 (using the SLEEP driver) instead of
+/// busy-waiting in EM0.
+#if defined(DOXY_DOC_ONLY)
+#define EMDRV_SPIDRV_BLOCKING_SLEEP
+#else
+//#define EMDRV_SPIDRV_BLOCKING_SLEEP
+#endif
+
+/// SPIDRV configuration option. Number of transaction descriptors in each
+/// driver instance for the queued master transfer API, see
+/// @ref SPIDRV_MQueueTransfer(). Set to 0 to exclude the queued API.
+#ifndef EMDRV_SPIDRV_QUEUE_SIZE
+#define EMDRV_SPIDRV_QUEUE_SIZE 4
+#endif
+
 /** @} (end addtogroup SPIDRV) */
 /** @} (end addtogroup emdrv) */
 
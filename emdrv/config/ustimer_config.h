@@ -30,6 +30,10 @@
 /// USTIMER configuration option. Use this define to select a TIMER resource.
 #define USTIMER_TIMER USTIMER_TIMER0
 
+/// USTIMER configuration option. Number of callback timers multiplexed on the
+/// TIMER resource. Callback timers are disabled when not defined or 0.
+//#define USTIMER_NUM_TIMERS 4
+
 /** @} (end addtogroup USTIMER) */
 /** @} (end addtogroup emdrv) */
 
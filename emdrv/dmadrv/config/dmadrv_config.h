@@ -54,6 +54,14 @@
 #define EMDRV_DMADRV_DMA_CH_COUNT DMA_CHAN_COUNT
 #endif
 
+/// DMADRV scatter-gather configuration option.
+/// Maximum number of buffers in one scatter-gather transfer. Each channel gets
+/// a static table of this many alternate descriptors (16 bytes each).
+/// Set to 0 to exclude the scatter-gather API. Only used on DMA (not LDMA).
+#ifndef EMDRV_DMADRV_SG_MAX_BUFFERS
+#define EMDRV_DMADRV_SG_MAX_BUFFERS 4
+#endif
+
 /// DMADRV native API configuration option.
 /// Use the native emlib api of the DMA controller, but still use DMADRV
 /// housekeeping functions as AllocateChannel/FreeChannel etc.
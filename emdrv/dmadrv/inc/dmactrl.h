@@ -0,0 +1,38 @@
+/***************************************************************************//**
+ * @file dmactrl.h
+ * @brief DMA control data block.
+ * @version 5.5.0
+ *******************************************************************************
+ * # License
+ * <b>(C) Copyright 2014 Silicon Labs, www.silabs.com</b>
+ *******************************************************************************
+ *
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ *
+ ******************************************************************************/
+
+#ifndef __DMACTRL_H
+#define __DMACTRL_H
+
+#include "em_device.h"
+
+#if defined(DMA_PRESENT) && (DMA_COUNT == 1)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The DMA control block DMADRV_Init() hands to DMA_Init(), primary and
+/// alternate descriptors. Not used when the application set the controller
+/// up before, DMADRV then shares its control block.
+extern DMA_DESCRIPTOR_TypeDef dmaControlBlock[];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* defined(DMA_PRESENT) && (DMA_COUNT == 1) */
+
+#endif /* __DMACTRL_H */
@@ -33,6 +33,10 @@
 
 #include "dmadrv_config.h"
 
+#if !defined(EMDRV_DMADRV_SG_MAX_BUFFERS)
+#define EMDRV_DMADRV_SG_MAX_BUFFERS 0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -754,6 +758,15 @@ typedef enum {
 
 #endif /* defined( LDMA_PRESENT ) && ( LDMA_COUNT == 1 ) */
 
+#if (defined(EMDRV_DMADRV_UDMA) && (EMDRV_DMADRV_SG_MAX_BUFFERS > 0) \
+     && !defined(EMDRV_DMADRV_USE_NATIVE_API)) || defined(DOXY_DOC_ONLY)
+/// One buffer of a scatter-gather transfer.
+typedef struct {
+  void *buf;                            ///< Buffer start address.
+  int  len;                             ///< Number of items in the buffer, max @ref DMADRV_MAX_XFER_COUNT.
+} DMADRV_Buffer_t;
+#endif
+
 Ecode_t DMADRV_AllocateChannel(unsigned int *channelId, void *capabilities);
 Ecode_t DMADRV_DeInit(void);
 Ecode_t DMADRV_FreeChannel(unsigned int channelId);
@@ -800,6 +813,26 @@ Ecode_t DMADRV_PeripheralMemoryPingPong(unsigned int          channelId,
                                         void                  *cbUserParam);
 #endif
 
+#if (defined(EMDRV_DMADRV_UDMA) && (EMDRV_DMADRV_SG_MAX_BUFFERS > 0) \
+     && !defined(EMDRV_DMADRV_USE_NATIVE_API)) || defined(DOXY_DOC_ONLY)
+Ecode_t DMADRV_MemoryPeripheralScatterGather(unsigned int          channelId,
+                                             DMADRV_PeripheralSignal_t peripheralSignal,
+                                             void                  *dst,
+                                             const DMADRV_Buffer_t *srcList,
+                                             int                   count,
+                                             DMADRV_DataSize_t     size,
+                                             DMADRV_Callback_t     callback,
+                                             void                  *cbUserParam);
+Ecode_t DMADRV_PeripheralMemoryScatterGather(unsigned int          channelId,
+                                             DMADRV_PeripheralSignal_t peripheralSignal,
+                                             const DMADRV_Buffer_t *dstList,
+                                             int                   count,
+                                             void                  *src,
+                                             DMADRV_DataSize_t     size,
+                                             DMADRV_Callback_t     callback,
+                                             void                  *cbUserParam);
+#endif
+
 #if defined(EMDRV_DMADRV_LDMA) && defined(EMDRV_DMADRV_USE_NATIVE_API)
 
 Ecode_t DMADRV_LdmaStartTransfer(
@@ -0,0 +1,51 @@
+/***************************************************************************//**
+ * @file dmactrl.c
+ * @brief DMA control data block.
+ * @version 5.5.0
+ *******************************************************************************
+ * # License
+ * <b>(C) Copyright 2014 Silicon Labs, www.silabs.com</b>
+ *******************************************************************************
+ *
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include "em_device.h"
+#include "dmactrl.h"
+
+#if defined(DMA_PRESENT) && (DMA_COUNT == 1)
+
+// The control block is aligned to its size, rounded up to a power of 2.
+#if (DMA_CHAN_COUNT > 0) && (DMA_CHAN_COUNT <= 4)
+#define DMACTRL_CH_CNT      4
+#define DMACTRL_ALIGNMENT   128
+
+#elif (DMA_CHAN_COUNT > 4) && (DMA_CHAN_COUNT <= 8)
+#define DMACTRL_CH_CNT      8
+#define DMACTRL_ALIGNMENT   256
+
+#elif (DMA_CHAN_COUNT > 8) && (DMA_CHAN_COUNT <= 16)
+#define DMACTRL_CH_CNT      16
+#define DMACTRL_ALIGNMENT   512
+
+#else
+#error "Unsupported DMA channel count (dmactrl.c)."
+#endif
+
+#if defined(__ICCARM__)
+#pragma data_alignment=DMACTRL_ALIGNMENT
+DMA_DESCRIPTOR_TypeDef dmaControlBlock[DMACTRL_CH_CNT * 2];
+
+#elif defined(__CC_ARM) || defined(__GNUC__)
+DMA_DESCRIPTOR_TypeDef dmaControlBlock[DMACTRL_CH_CNT * 2]
+__attribute__ ((aligned(DMACTRL_ALIGNMENT)));
+
+#else
+#error "Undefined toolchain."
+#endif
+
+#endif /* defined(DMA_PRESENT) && (DMA_COUNT == 1) */
@@ -23,7 +23,7 @@
 #include "dmadrv.h"
 
 #if defined(EMDRV_DMADRV_UDMA)
-#include "efm32zg_dmactrl.h"
+#include "dmactrl.h"
 #endif
 
 /// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
@@ -74,10 +74,23 @@ typedef struct {
 static bool initialized = false;
 static ChTable_t chTable[EMDRV_DMADRV_DMA_CH_COUNT];
 
+#if defined(EMDRV_DMADRV_UDMA)
+// The DMA controller was enabled by the application, not by DMADRV_Init().
+static bool sharedController = false;
+#endif
+
 #if defined(EMDRV_DMADRV_UDMA) && !defined(EMDRV_DMADRV_USE_NATIVE_API)
 static DMA_CB_TypeDef dmaCallBack[EMDRV_DMADRV_DMA_CH_COUNT];
 #endif
 
+#if defined(EMDRV_DMADRV_UDMA) && !defined(EMDRV_DMADRV_USE_NATIVE_API) \
+  && (EMDRV_DMADRV_SG_MAX_BUFFERS > 0)
+#define DMADRV_SCATTER_GATHER
+// Alternate descriptor tables for scatter-gather transfers, one per channel.
+static DMA_DESCRIPTOR_TypeDef sgDescr[EMDRV_DMADRV_DMA_CH_COUNT]
+[EMDRV_DMADRV_SG_MAX_BUFFERS];
+#endif
+
 #if defined(EMDRV_DMADRV_LDMA) && !defined(EMDRV_DMADRV_USE_NATIVE_API)
 const LDMA_TransferCfg_t xferCfg = LDMA_TRANSFER_CFG_PERIPHERAL(0);
 const LDMA_Descriptor_t m2p = LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(NULL, NULL, 1UL);
@@ -106,6 +119,19 @@ static Ecode_t StartTransfer(DmaMode_t             mode,
                              void                  *cbUserParam);
 #endif
 
+#if defined(DMADRV_SCATTER_GATHER)
+static Ecode_t StartScatterGather(DmaDirection_t        direction,
+                                  unsigned int          channelId,
+                                  DMADRV_PeripheralSignal_t
+                                  peripheralSignal,
+                                  const DMADRV_Buffer_t *bufList,
+                                  int                   count,
+                                  void                  *periph,
+                                  DMADRV_DataSize_t     size,
+                                  DMADRV_Callback_t     callback,
+                                  void                  *cbUserParam);
+#endif
+
 /// @endcond
 
 /***************************************************************************//**
@@ -182,10 +208,13 @@ Ecode_t DMADRV_DeInit(void)
 
   if ( !inUse ) {
 #if defined(EMDRV_DMADRV_UDMA)
-    NVIC_DisableIRQ(DMA_IRQn);
-    DMA->IEN    = _DMA_IEN_RESETVALUE;
-    DMA->CONFIG = _DMA_CONFIG_RESETVALUE;
-    CMU_ClockEnable(cmuClock_DMA, false);
+    // A shared controller still runs the application's channels.
+    if ( !sharedController ) {
+      NVIC_DisableIRQ(DMA_IRQn);
+      DMA->IEN    = _DMA_IEN_RESETVALUE;
+      DMA->CONFIG = _DMA_CONFIG_RESETVALUE;
+      CMU_ClockEnable(cmuClock_DMA, false);
+    }
 #elif defined(EMDRV_DMADRV_LDMA)
     LDMA_DeInit();
 #endif
@@ -237,7 +266,11 @@ Ecode_t DMADRV_FreeChannel(unsigned int channelId)
  *  Initialize DMADRV.
  *
  * @details
- *  The DMA hardware is initialized.
+ *  The DMA hardware is initialized. On UDMA, a DMA controller already
+ *  enabled by the application with emlib DMA_Init() is kept as it is, with
+ *  the application's control block. The application then must keep the
+ *  channels it drives itself out of DMADRV's range, channel 0 to
+ *  @ref EMDRV_DMADRV_DMA_CH_COUNT - 1.
  *
  * @return
  *  @ref ECODE_EMDRV_DMADRV_OK on success. On failure, an appropriate
@@ -271,10 +304,13 @@ Ecode_t DMADRV_Init(void)
   }
 
 #if defined(EMDRV_DMADRV_UDMA)
-  NVIC_SetPriority(DMA_IRQn, EMDRV_DMADRV_DMA_IRQ_PRIORITY);
-  dmaInit.hprot        = 0;
-  dmaInit.controlBlock = dmaControlBlock;
-  DMA_Init(&dmaInit);
+  sharedController = (DMA->CONFIG & DMA_CONFIG_EN) != 0;
+  if ( !sharedController ) {
+    NVIC_SetPriority(DMA_IRQn, EMDRV_DMADRV_DMA_IRQ_PRIORITY);
+    dmaInit.hprot        = 0;
+    dmaInit.controlBlock = dmaControlBlock;
+    DMA_Init(&dmaInit);
+  }
 #elif defined(EMDRV_DMADRV_LDMA)
   dmaInit.ldmaInitIrqPriority = EMDRV_DMADRV_DMA_IRQ_PRIORITY;
   LDMA_Init(&dmaInit);
@@ -609,6 +645,139 @@ Ecode_t DMADRV_PeripheralMemoryPingPong(
 }
 #endif /* !defined( EMDRV_DMADRV_USE_NATIVE_API ) */
 
+#if defined(DMADRV_SCATTER_GATHER) || defined(DOXY_DOC_ONLY)
+/***************************************************************************//**
+ * @brief
+ *  Start a scatter-gather DMA transfer from a list of memory buffers to a
+ *  peripheral.
+ *
+ * @details
+ *  The buffers are transferred in list order as one DMA sequence. The
+ *  alternate descriptor table is built from the list in a static per-channel
+ *  table, so no data is copied and the callback is called once, when the
+ *  last buffer is done.
+ *
+ * @note
+ *  @ref DMADRV_TransferRemainingCount() is not meaningful for scatter-gather
+ *  transfers.
+ *
+ * @param[in] channelId
+ *  The channel ID to use for the transfer.
+ *
+ * @param[in] peripheralSignal
+ *  Selects which peripheral/peripheralsignal to use.
+ *
+ * @param[in] dst
+ *  A destination (peripheral register) memory address.
+ *
+ * @param[in] srcList
+ *  A list of source memory buffers. The list is only read by this function.
+ *
+ * @param[in] count
+ *  A number of buffers in @a srcList, max @ref EMDRV_DMADRV_SG_MAX_BUFFERS.
+ *
+ * @param[in] size
+ *  An item size, byte, halfword or word.
+ *
+ * @param[in] callback
+ *  A function to call on DMA completion, use NULL if not needed.
+ *
+ * @param[in] cbUserParam
+ *  An optional user parameter to feed to the callback function. Use NULL if
+ *  not needed.
+ *
+ * @return
+ *   @ref ECODE_EMDRV_DMADRV_OK on success. On failure, an appropriate
+ *   DMADRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t DMADRV_MemoryPeripheralScatterGather(
+  unsigned int          channelId,
+  DMADRV_PeripheralSignal_t
+  peripheralSignal,
+  void                  *dst,
+  const DMADRV_Buffer_t *srcList,
+  int                   count,
+  DMADRV_DataSize_t     size,
+  DMADRV_Callback_t     callback,
+  void                  *cbUserParam)
+{
+  return StartScatterGather(dmaDirectionMemToPeripheral,
+                            channelId,
+                            peripheralSignal,
+                            srcList,
+                            count,
+                            dst,
+                            size,
+                            callback,
+                            cbUserParam);
+}
+
+/***************************************************************************//**
+ * @brief
+ *  Start a scatter-gather DMA transfer from a peripheral to a list of memory
+ *  buffers.
+ *
+ * @details
+ *  The buffers are filled in list order as one DMA sequence. The callback is
+ *  called once, when the last buffer is full.
+ *
+ * @note
+ *  @ref DMADRV_TransferRemainingCount() is not meaningful for scatter-gather
+ *  transfers.
+ *
+ * @param[in] channelId
+ *  The channel ID to use for the transfer.
+ *
+ * @param[in] peripheralSignal
+ *  Selects which peripheral/peripheralsignal to use.
+ *
+ * @param[in] dstList
+ *  A list of destination memory buffers. The list is only read by this
+ *  function.
+ *
+ * @param[in] count
+ *  A number of buffers in @a dstList, max @ref EMDRV_DMADRV_SG_MAX_BUFFERS.
+ *
+ * @param[in] src
+ *  A source memory (peripheral register) address.
+ *
+ * @param[in] size
+ *  An item size, byte, halfword or word.
+ *
+ * @param[in] callback
+ *  A function to call on DMA completion, use NULL if not needed.
+ *
+ * @param[in] cbUserParam
+ *  An optional user parameter to feed to the callback function. Use NULL if
+ *  not needed.
+ *
+ * @return
+ *   @ref ECODE_EMDRV_DMADRV_OK on success. On failure, an appropriate
+ *   DMADRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t DMADRV_PeripheralMemoryScatterGather(
+  unsigned int          channelId,
+  DMADRV_PeripheralSignal_t
+  peripheralSignal,
+  const DMADRV_Buffer_t *dstList,
+  int                   count,
+  void                  *src,
+  DMADRV_DataSize_t     size,
+  DMADRV_Callback_t     callback,
+  void                  *cbUserParam)
+{
+  return StartScatterGather(dmaDirectionPeripheralToMem,
+                            channelId,
+                            peripheralSignal,
+                            dstList,
+                            count,
+                            src,
+                            size,
+                            callback,
+                            cbUserParam);
+}
+#endif /* defined( DMADRV_SCATTER_GATHER ) */
+
 /***************************************************************************//**
  * @brief
  *  Pause an ongoing DMA transfer.
@@ -842,7 +1011,7 @@ Ecode_t DMADRV_TransferDone(unsigned int channelId, bool *done)
 #if defined(EMDRV_DMADRV_UDMA)
   CORE_ATOMIC_SECTION(
     /* This works for primary channel only ! */
-    remaining = (dmaControlBlock[channelId].CTRL
+    remaining = (((DMA_DESCRIPTOR_TypeDef *)(DMA->CTRLBASE))[channelId].CTRL
                  & _DMA_CTRL_N_MINUS_1_MASK)
                 >> _DMA_CTRL_N_MINUS_1_SHIFT;
     iflag = DMA->IF;
@@ -868,7 +1037,9 @@ Ecode_t DMADRV_TransferDone(unsigned int channelId, bool *done)
  *  This function does not take into account that a DMA transfer with
  *  a chain of linked transfers might be ongoing. It will only check the
  *  count for the current transfer.
- *  On UDMA, it will only work on the primary channel.
+ *  On UDMA, the count is read from the descriptor (primary or alternate)
+ *  that is currently active. For ping-pong transfers this is the buffer
+ *  being filled or emptied.
  *
  * @param[in] channelId
  *  The channel ID of the transfer to check.
@@ -884,6 +1055,7 @@ Ecode_t DMADRV_TransferRemainingCount(unsigned int channelId,
                                       int *remaining)
 {
 #if defined(EMDRV_DMADRV_UDMA)
+  DMA_DESCRIPTOR_TypeDef *descr;
   uint32_t remain, iflag;
 #endif
 
@@ -902,8 +1074,12 @@ Ecode_t DMADRV_TransferRemainingCount(unsigned int channelId,
 
 #if defined(EMDRV_DMADRV_UDMA)
   CORE_ATOMIC_SECTION(
-    /* This works for the primary channel only ! */
-    remain = (dmaControlBlock[channelId].CTRL
+    if ( DMA->CHALTS & (1 << channelId) ) {
+      descr = ((DMA_DESCRIPTOR_TypeDef *)(DMA->ALTCTRLBASE)) + channelId;
+    } else {
+      descr = ((DMA_DESCRIPTOR_TypeDef *)(DMA->CTRLBASE)) + channelId;
+    }
+    remain = (descr->CTRL
               & _DMA_CTRL_N_MINUS_1_MASK)
              >> _DMA_CTRL_N_MINUS_1_SHIFT;
     iflag = DMA->IF;
@@ -1153,6 +1329,108 @@ static Ecode_t StartTransfer(DmaMode_t             mode,
 }
 #endif /* defined( EMDRV_DMADRV_UDMA ) && !defined( EMDRV_DMADRV_USE_NATIVE_API ) */
 
+#if defined(DMADRV_SCATTER_GATHER)
+/***************************************************************************//**
+ * @brief
+ *  Start a UDMA peripheral scatter-gather transfer.
+ ******************************************************************************/
+static Ecode_t StartScatterGather(DmaDirection_t        direction,
+                                  unsigned int          channelId,
+                                  DMADRV_PeripheralSignal_t
+                                  peripheralSignal,
+                                  const DMADRV_Buffer_t *bufList,
+                                  int                   count,
+                                  void                  *periph,
+                                  DMADRV_DataSize_t     size,
+                                  DMADRV_Callback_t     callback,
+                                  void                  *cbUserParam)
+{
+  int i;
+  int total = 0;
+  ChTable_t *ch;
+  DMA_DataInc_TypeDef bufInc;
+  DMA_CfgChannel_TypeDef    chCfg;
+  DMA_CfgDescrSGAlt_TypeDef descrCfg;
+
+  if ( !initialized ) {
+    return ECODE_EMDRV_DMADRV_NOT_INITIALIZED;
+  }
+
+  if ( (channelId >= EMDRV_DMADRV_DMA_CH_COUNT)
+       || (bufList == NULL)
+       || (periph == NULL)
+       || (count <= 0)
+       || (count > EMDRV_DMADRV_SG_MAX_BUFFERS) ) {
+    return ECODE_EMDRV_DMADRV_PARAM_ERROR;
+  }
+
+  for ( i = 0; i < count; i++ ) {
+    if ( (bufList[i].buf == NULL)
+         || (bufList[i].len <= 0)
+         || (bufList[i].len > DMADRV_MAX_XFER_COUNT) ) {
+      return ECODE_EMDRV_DMADRV_PARAM_ERROR;
+    }
+  }
+
+  ch = &chTable[channelId];
+  if ( ch->allocated == false ) {
+    return ECODE_EMDRV_DMADRV_CH_NOT_ALLOCATED;
+  }
+
+  /* Completion is signalled once, after the last alternate descriptor. */
+  dmaCallBack[channelId].cbFunc  = DmaBasicCallback;
+  dmaCallBack[channelId].userPtr = NULL;
+
+  chCfg.highPri   = false;            /* Can't use hi pri with peripherals. */
+  chCfg.enableInt = (callback != NULL);
+  chCfg.select    = peripheralSignal;
+  chCfg.cb        = &dmaCallBack[channelId];
+  DMA_CfgChannel(channelId, &chCfg);
+
+  if ( size == dmadrvDataSize1 ) {
+    bufInc = dmaDataInc1;
+  } else if ( size == dmadrvDataSize2 ) {
+    bufInc = dmaDataInc2;
+  } else { /* dmadrvDataSize4 */
+    bufInc = dmaDataInc4;
+  }
+
+  descrCfg.size       = (DMA_DataSize_TypeDef)size;
+  descrCfg.arbRate    = dmaArbitrate1;
+  descrCfg.hprot      = 0;
+  descrCfg.peripheral = true;
+
+  /* Build the alternate descriptor table from the buffer list. */
+  for ( i = 0; i < count; i++ ) {
+    if ( direction == dmaDirectionMemToPeripheral ) {
+      descrCfg.src    = bufList[i].buf;
+      descrCfg.srcInc = bufInc;
+      descrCfg.dst    = periph;
+      descrCfg.dstInc = dmaDataIncNone;
+    } else {
+      descrCfg.src    = periph;
+      descrCfg.srcInc = dmaDataIncNone;
+      descrCfg.dst    = bufList[i].buf;
+      descrCfg.dstInc = bufInc;
+    }
+    descrCfg.nMinus1 = bufList[i].len - 1;
+    DMA_CfgDescrScatterGather(sgDescr[channelId], i, &descrCfg);
+    total += bufList[i].len;
+  }
+
+  ch->callback      = callback;
+  ch->userParam     = cbUserParam;
+  ch->callbackCount = 0;
+  ch->length        = total;
+
+  DMA->IFC = 1 << channelId;
+
+  DMA_ActivateScatterGather(channelId, false, sgDescr[channelId], count);
+
+  return ECODE_EMDRV_DMADRV_OK;
+}
+#endif /* defined( DMADRV_SCATTER_GATHER ) */
+
 #if defined(EMDRV_DMADRV_LDMA) && !defined(EMDRV_DMADRV_USE_NATIVE_API)
 /***************************************************************************//**
  * @brief
@@ -1289,6 +1567,7 @@ static Ecode_t StartTransfer(DmaMode_t             mode,
    @li A number of DMA channels to support.
    @li Use the native emlib API belonging to the underlying DMA hardware in
       combination with the DMADRV API.
+   @li A maximum number of buffers in a scatter-gather transfer.
 
    Both configuration options will help reduce the driver's RAM footprint.
 
@@ -1347,6 +1626,12 @@ static Ecode_t StartTransfer(DmaMode_t             mode,
    @ref DMADRV_PeripheralMemoryPingPong() @n
     Start a DMA ping-pong transfer from a peripheral to memory.
 
+   @ref DMADRV_MemoryPeripheralScatterGather() @n
+    Start a DMA transfer from a list of memory buffers to a peripheral.
+
+   @ref DMADRV_PeripheralMemoryScatterGather() @n
+    Start a DMA transfer from a peripheral to a list of memory buffers.
+
    @ref DMADRV_LdmaStartTransfer() @n
     Start a DMA transfer on an LDMA controller. This function can only be used
     when configuration option @ref EMDRV_DMADRV_USE_NATIVE_API is defined.
@@ -37,6 +37,9 @@
 #ifndef _EZRADIO_API_LIB_H_
 #define _EZRADIO_API_LIB_H_
 
+#include <stdbool.h>
+#include "ezradiodrv_config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -61,6 +64,11 @@ extern "C" {
 #define EZRADIO_FIFO_SIZE       64
 /// @endcond
 
+/** Number of property values in the RAM shadow, 0 disables the shadow. */
+#if !defined(EZRADIODRV_PROP_SHADOW_SIZE)
+#define EZRADIODRV_PROP_SHADOW_SIZE 0
+#endif
+
 /** EZRadio device configuration return values */
 typedef enum {
   EZRADIO_CONFIG_SUCCESS,         /**< Configuration succeded. */
@@ -88,6 +96,11 @@ void ezradio_set_property(uint8_t group, uint8_t num_props, uint8_t start_prop,
 
 void ezradio_change_state(uint8_t next_state1);
 
+#if (EZRADIODRV_PROP_SHADOW_SIZE > 0)
+void ezradio_prop_shadow_invalidate(void);
+bool ezradio_prop_shadow_check_update(uint8_t group, uint8_t num_props, uint8_t start_prop, const uint8_t *values);
+#endif
+
 #ifdef EZRADIO_DRIVER_EXTENDED_SUPPORT
 /* Extended driver support functions */
 void ezradio_nop(void);
@@ -57,6 +57,39 @@ extern "C" {
 #define EZRADIODRV_MAX_CTS_BUFF_SIZE 257
 #endif
 
+#if defined(EZRADIODRV_COMM_ASYNC)
+#if !defined(EZRADIODRV_COMM_USE_GPIO1_FOR_CTS) || !defined(EZRADIODRV_DISABLE_PTI)
+#error "EZRADIODRV_COMM_ASYNC requires EZRADIODRV_COMM_USE_GPIO1_FOR_CTS and EZRADIODRV_DISABLE_PTI."
+#endif
+
+#include <stdbool.h>
+
+/** Maximum response length of an asynchronous command. */
+#if !defined(EZRADIODRV_COMM_ASYNC_MAX_RESP)
+#define EZRADIODRV_COMM_ASYNC_MAX_RESP 16
+#endif
+
+struct ezradio_comm_AsyncCmd;
+
+/**
+ * Asynchronous command completion callback, called from interrupt context.
+ *
+ * @param cmd   The completed command.
+ * @param cts   CTS value, 0xFF on success.
+ */
+typedef void (*ezradio_comm_AsyncCallback_t)(struct ezradio_comm_AsyncCmd *cmd, uint8_t cts);
+
+/** Asynchronous command queue entry, allocated by the caller. */
+typedef struct ezradio_comm_AsyncCmd {
+  uint8_t                       cmdByteCount;   /**< Number of command bytes. */
+  uint8_t                       *pCmdData;      /**< Command data. */
+  uint8_t                       respByteCount;  /**< Number of response bytes. */
+  uint8_t                       *pRespData;     /**< Response buffer. */
+  ezradio_comm_AsyncCallback_t  callback;       /**< Completion callback. */
+  struct ezradio_comm_AsyncCmd  *next;          /**< Next queued command. */
+} ezradio_comm_AsyncCmd_t;
+#endif
+
 extern uint8_t ezradio_comm_CtsWentHigh;
 
 uint8_t ezradio_comm_GetResp(uint8_t byteCount, uint8_t* pData);
@@ -69,6 +102,14 @@ uint8_t ezradio_comm_SendCmdGetResp(uint8_t cmdByteCount, uint8_t* pCmdData,
                                     uint8_t respByteCount, uint8_t* pRespData);
 void ezradio_comm_ClearCTS(void);
 
+#if defined(EZRADIODRV_COMM_ASYNC)
+bool ezradio_comm_SendCmdGetRespAsync(ezradio_comm_AsyncCmd_t *cmd,
+                                      uint8_t cmdByteCount, uint8_t* pCmdData,
+                                      uint8_t respByteCount, uint8_t* pRespData,
+                                      ezradio_comm_AsyncCallback_t callback);
+bool ezradio_comm_AsyncBusy(void);
+#endif
+
 /** @} (end addtogroup Comm_Layer) */
 /** @} (end addtogroup EZRADIODRV) */
 /** @} (end addtogroup emdrv) */
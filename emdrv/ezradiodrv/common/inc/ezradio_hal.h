@@ -38,6 +38,9 @@ extern "C" {
 #endif
 
 #include "ezradiodrv_config.h"
+#if defined(EZRADIODRV_COMM_ASYNC)
+#include "ecode.h"
+#endif
 
 /***************************************************************************//**
  * @addtogroup emdrv
@@ -76,6 +79,20 @@ void    ezradio_hal_SpiReadData     (uint8_t byteCount, uint8_t* pData);
 
 void ezradio_hal_SpiWriteReadData(uint8_t byteCount, uint8_t* txData, uint8_t* rxData);
 
+#if defined(EZRADIODRV_COMM_ASYNC)
+/** Completion callback of asynchronous SPI transfers. */
+typedef void (*ezradio_hal_SpiCallback_t)(Ecode_t transferStatus);
+
+void    ezradio_hal_Gpio1IrqInit    (GPIOINT_IrqCallbackPtr_t gpio1IrqCallback);
+void    ezradio_hal_Gpio1IrqClear   (void);
+
+void    ezradio_hal_SpiWriteDataAsync(uint8_t byteCount, uint8_t* pData,
+                                      ezradio_hal_SpiCallback_t callback);
+void    ezradio_hal_SpiWriteReadDataAsync(uint8_t byteCount, uint8_t* txData,
+                                          uint8_t* rxData,
+                                          ezradio_hal_SpiCallback_t callback);
+#endif
+
 /** @} (end addtogroup HAL_Layer) */
 /** @} (end addtogroup EZRADIODRV) */
 /** @} (end addtogroup emdrv) */
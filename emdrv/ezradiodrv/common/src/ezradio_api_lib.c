@@ -44,6 +44,37 @@
 #include "ezradio_hal.h"
 #include "ezradio_api_lib.h"
 
+#if (EZRADIODRV_PROP_SHADOW_SIZE > 0)
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+
+/* Property group ID not used by the radio, marks an empty shadow entry. */
+#define EZRADIO_PROP_SHADOW_EMPTY   0xFFu
+
+typedef struct {
+  uint8_t group;
+  uint8_t prop;
+  uint8_t value;
+} ezradio_prop_shadow_t;
+
+static ezradio_prop_shadow_t ezradioPropShadow[EZRADIODRV_PROP_SHADOW_SIZE];
+static uint16_t ezradioPropShadowNext = 0;
+static bool ezradioPropShadowInitialized = false;
+
+static ezradio_prop_shadow_t *ezradio_prop_shadow_find(uint8_t group, uint8_t prop)
+{
+  uint16_t i;
+
+  for (i = 0; i < EZRADIODRV_PROP_SHADOW_SIZE; i++) {
+    if ((ezradioPropShadow[i].group == group) && (ezradioPropShadow[i].prop == prop)) {
+      return &ezradioPropShadow[i];
+    }
+  }
+  return NULL;
+}
+
+/// @endcond
+#endif
+
 /**
  * This functions is used to reset the EZRadio device by applying shutdown and
  * releasing it.  After this function @ref ezradio_power_up or @ref ezradio_configuration_init
@@ -67,6 +98,10 @@ void ezradio_reset(void)
   ezradio_comm_ClearCTS();
   /* Deinit ustimer */
   USTIMER_DeInit();
+#if (EZRADIODRV_PROP_SHADOW_SIZE > 0)
+  /* Properties are back at their reset values. */
+  ezradio_prop_shadow_invalidate();
+#endif
 }
 
 /**
@@ -91,6 +126,10 @@ void ezradio_power_up(uint8_t boot_options, uint8_t xtal_options, uint32_t xo_fr
   ezradioCmd[6] = (uint8_t)(xo_freq);
 
   ezradio_comm_SendCmd(EZRADIO_CMD_ARG_COUNT_POWER_UP, ezradioCmd);
+
+#if (EZRADIODRV_PROP_SHADOW_SIZE > 0)
+  ezradio_prop_shadow_invalidate();
+#endif
 }
 
 /** This function sends the PART_INFO command to the radio and receives the answer
@@ -287,9 +326,78 @@ void ezradio_set_property(uint8_t group, uint8_t num_props, uint8_t start_prop,
   }
   va_end(argList);
 
+#if (EZRADIODRV_PROP_SHADOW_SIZE > 0)
+  if (ezradio_prop_shadow_check_update(group, ezradioCmd[2], start_prop, &ezradioCmd[4])) {
+    /* The radio already holds these values. */
+    return;
+  }
+#endif
+
   ezradio_comm_SendCmd(cmdIndex, ezradioCmd);
 }
 
+#if (EZRADIODRV_PROP_SHADOW_SIZE > 0)
+/**
+ * Forget all property values in the RAM shadow. Must be called when the radio
+ * is reset or powered up outside of this driver.
+ */
+void ezradio_prop_shadow_invalidate(void)
+{
+  uint16_t i;
+
+  for (i = 0; i < EZRADIODRV_PROP_SHADOW_SIZE; i++) {
+    ezradioPropShadow[i].group = EZRADIO_PROP_SHADOW_EMPTY;
+  }
+  ezradioPropShadowNext = 0;
+  ezradioPropShadowInitialized = true;
+}
+
+/**
+ * Check property values against the RAM shadow and update the shadow.
+ *
+ * @param[in] group       Property group.
+ * @param[in] num_props   Number of properties.
+ * @param[in] start_prop  Start sub-property address.
+ * @param[in] values      Property values.
+ *
+ * @return True if the radio already holds all the values and the write can be
+ *         skipped. False if the values must be written; the shadow is updated
+ *         with the new values.
+ */
+bool ezradio_prop_shadow_check_update(uint8_t group, uint8_t num_props, uint8_t start_prop, const uint8_t *values)
+{
+  ezradio_prop_shadow_t *entry;
+  uint8_t cnt;
+
+  if (!ezradioPropShadowInitialized) {
+    ezradio_prop_shadow_invalidate();
+  }
+
+  for (cnt = 0u; cnt < num_props; cnt++) {
+    entry = ezradio_prop_shadow_find(group, start_prop + cnt);
+    if ((NULL == entry) || (entry->value != values[cnt])) {
+      break;
+    }
+  }
+  if (cnt == num_props) {
+    return true;
+  }
+
+  for (cnt = 0u; cnt < num_props; cnt++) {
+    entry = ezradio_prop_shadow_find(group, start_prop + cnt);
+    if (NULL == entry) {
+      /* Replace the oldest entry when the shadow is full. */
+      entry = &ezradioPropShadow[ezradioPropShadowNext];
+      ezradioPropShadowNext = (ezradioPropShadowNext + 1u) % EZRADIODRV_PROP_SHADOW_SIZE;
+      entry->group = group;
+      entry->prop  = start_prop + cnt;
+    }
+    entry->value = values[cnt];
+  }
+  return false;
+}
+#endif
+
 /**
  * Issue a change state command to the radio.
  *
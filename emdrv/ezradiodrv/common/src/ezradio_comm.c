@@ -30,6 +30,7 @@
  *
  ******************************************************************************/
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdarg.h>
 #include "em_gpio.h"
@@ -40,9 +41,190 @@
 #include "ezradio_hal.h"
 #include "ezradio_comm.h"
 
+#if defined(EZRADIODRV_COMM_ASYNC)
+#include "em_core.h"
+#endif
+
 /** Can be used to prevent CTS check before any communication command. */
 uint8_t ezradio_comm_CtsWentHigh = 0;
 
+#if defined(EZRADIODRV_COMM_ASYNC)
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+
+typedef enum {
+  asyncStateIdle,
+  asyncStateWaitCtsCmd,
+  asyncStateSendCmd,
+  asyncStateWaitCtsResp,
+  asyncStateReadResp
+} ezradio_comm_AsyncState_t;
+
+static volatile ezradio_comm_AsyncState_t asyncState = asyncStateIdle;
+static ezradio_comm_AsyncCmd_t *asyncHead = NULL;
+static ezradio_comm_AsyncCmd_t *asyncTail = NULL;
+static bool asyncInitialized = false;
+/* READ_CMD_BUFF attempts left for the response of the head command. */
+static uint16_t asyncRespRetry;
+
+/* READ_CMD_BUFF, CTS byte and the response. */
+static uint8_t asyncTxBuf[EZRADIODRV_COMM_ASYNC_MAX_RESP + 2];
+static uint8_t asyncRxBuf[EZRADIODRV_COMM_ASYNC_MAX_RESP + 2];
+
+static void ezradio_comm_AsyncWaitCts(ezradio_comm_AsyncState_t waitState);
+static void ezradio_comm_AsyncCtsHigh(void);
+static void ezradio_comm_AsyncSpiDone(Ecode_t transferStatus);
+
+/**
+ * Completes the command at the head of the queue and starts the next one.
+ *
+ * @param cts   CTS value to report.
+ */
+static void ezradio_comm_AsyncComplete(uint8_t cts)
+{
+  ezradio_comm_AsyncCmd_t *cmd;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  cmd = asyncHead;
+  asyncHead = cmd->next;
+  if (NULL == asyncHead) {
+    asyncTail = NULL;
+  }
+  cmd->next = NULL;
+  asyncState = asyncStateIdle;
+  CORE_EXIT_ATOMIC();
+
+  if (NULL != asyncHead) {
+    ezradio_comm_AsyncWaitCts(asyncStateWaitCtsCmd);
+  }
+  if (NULL != cmd->callback) {
+    cmd->callback(cmd, cts);
+  }
+}
+
+/**
+ * Continues with the next phase when CTS is high, otherwise waits for the
+ * GPIO1 interrupt.
+ *
+ * @param waitState     asyncStateWaitCtsCmd or asyncStateWaitCtsResp.
+ */
+static void ezradio_comm_AsyncWaitCts(ezradio_comm_AsyncState_t waitState)
+{
+  bool ctsHigh;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  asyncState = waitState;
+  ctsHigh = ezradio_hal_Gpio1Level();
+  CORE_EXIT_ATOMIC();
+
+  if (ctsHigh) {
+    ezradio_comm_AsyncCtsHigh();
+  }
+}
+
+/**
+ * Starts the SPI phase following a CTS wait.
+ */
+static void ezradio_comm_AsyncCtsHigh(void)
+{
+  ezradio_comm_AsyncCmd_t *cmd = asyncHead;
+  uint8_t cnt;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if (asyncStateWaitCtsCmd == asyncState) {
+    asyncState = asyncStateSendCmd;
+  } else if (asyncStateWaitCtsResp == asyncState) {
+    asyncState = asyncStateReadResp;
+  } else {
+    /* CTS edge that nobody waits for. */
+    CORE_EXIT_ATOMIC();
+    return;
+  }
+  CORE_EXIT_ATOMIC();
+
+  ezradio_comm_CtsWentHigh = 1;
+
+#if !defined(EZRADIODRV_SPI_4WIRE_MODE)
+  ezradio_hal_ClearNsel();
+#endif
+  if (asyncStateSendCmd == asyncState) {
+    ezradio_hal_SpiWriteDataAsync(cmd->cmdByteCount, cmd->pCmdData, ezradio_comm_AsyncSpiDone);
+  } else {
+    asyncTxBuf[0] = 0x44;    //read CMD buffer
+    for (cnt = 1; cnt < cmd->respByteCount + 2; cnt++) {
+      asyncTxBuf[cnt] = 0xFF;
+    }
+    ezradio_hal_SpiWriteReadDataAsync(cmd->respByteCount + 2, asyncTxBuf, asyncRxBuf,
+                                      ezradio_comm_AsyncSpiDone);
+  }
+}
+
+/**
+ * GPIO1 rising edge callback.
+ *
+ * @param pin   GPIO pin number.
+ */
+static void ezradio_comm_AsyncCtsIrq(uint8_t pin)
+{
+  (void)pin;
+  ezradio_comm_AsyncCtsHigh();
+}
+
+/**
+ * SPI transfer completion callback.
+ *
+ * @param transferStatus    SPIDRV transfer status.
+ */
+static void ezradio_comm_AsyncSpiDone(Ecode_t transferStatus)
+{
+  ezradio_comm_AsyncCmd_t *cmd = asyncHead;
+  uint8_t cnt;
+
+#if !defined(EZRADIODRV_SPI_4WIRE_MODE)
+  ezradio_hal_SetNsel();
+#endif
+
+  if (asyncStateSendCmd == asyncState) {
+    /* The radio clears CTS on the command. Drop an edge from before it. */
+    ezradio_comm_CtsWentHigh = 0;
+    ezradio_hal_Gpio1IrqClear();
+
+    if ((ECODE_OK == transferStatus) && (cmd->respByteCount > 0)) {
+      asyncRespRetry = EZRADIODRV_COMM_CTS_RETRY;
+      ezradio_comm_AsyncWaitCts(asyncStateWaitCtsResp);
+      return;
+    }
+    ezradio_comm_AsyncComplete((ECODE_OK == transferStatus) ? 0xFF : 0);
+    return;
+  }
+
+  if (ECODE_OK != transferStatus) {
+    ezradio_comm_CtsWentHigh = 0;
+    ezradio_comm_AsyncComplete(0);
+    return;
+  }
+  if (asyncRxBuf[1] != 0xFF) {
+    /* GPIO1 was sampled while the radio had not taken NSEL yet, not ready is
+     * normal here. Read again, bounded as in ezradio_comm_GetResp(). */
+    ezradio_comm_CtsWentHigh = 0;
+    if (--asyncRespRetry != 0) {
+      ezradio_comm_AsyncWaitCts(asyncStateWaitCtsResp);
+    } else {
+      ezradio_comm_AsyncComplete(0);
+    }
+    return;
+  }
+  for (cnt = 0; cnt < cmd->respByteCount; cnt++) {
+    cmd->pRespData[cnt] = asyncRxBuf[cnt + 2];
+  }
+  ezradio_comm_AsyncComplete(0xFF);
+}
+
+/// @endcond
+#endif
+
 /**
  * Gets a command response from the radio chip
  *
@@ -280,3 +462,75 @@ uint8_t ezradio_comm_SendCmdGetResp(uint8_t cmdByteCount, uint8_t* pCmdData, uin
   ezradio_comm_SendCmd(cmdByteCount, pCmdData);
   return ezradio_comm_GetResp(respByteCount, pRespData);
 }
+
+#if defined(EZRADIODRV_COMM_ASYNC)
+/**
+ * Queues a command to the radio chip and gets its response without blocking.
+ *
+ * The command waits for CTS on the GPIO1 interrupt and the SPI transfers are
+ * done by DMA, so the MCU can sleep between command phases. Commands are
+ * processed in order. The blocking functions of this layer must not be used
+ * while ezradio_comm_AsyncBusy() returns true.
+ *
+ * @param cmd           Queue entry, must be valid until the callback.
+ * @param cmdByteCount  Number of bytes in the command to send to the radio device
+ * @param pCmdData      Pointer to the command data, must be valid until the callback
+ * @param respByteCount Number of bytes in the response to fetch, max
+ *                      EZRADIODRV_COMM_ASYNC_MAX_RESP
+ * @param pRespData     Pointer to where to put the response data
+ * @param callback      Completion callback, can be NULL
+ *
+ * @return True if the command was queued.
+ */
+bool ezradio_comm_SendCmdGetRespAsync(ezradio_comm_AsyncCmd_t *cmd,
+                                      uint8_t cmdByteCount, uint8_t* pCmdData,
+                                      uint8_t respByteCount, uint8_t* pRespData,
+                                      ezradio_comm_AsyncCallback_t callback)
+{
+  bool start;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ((NULL == cmd) || (0 == cmdByteCount) || (NULL == pCmdData)
+      || (respByteCount > EZRADIODRV_COMM_ASYNC_MAX_RESP)
+      || ((respByteCount > 0) && (NULL == pRespData))) {
+    return false;
+  }
+
+  if (!asyncInitialized) {
+    ezradio_hal_Gpio1IrqInit(ezradio_comm_AsyncCtsIrq);
+    asyncInitialized = true;
+  }
+
+  cmd->cmdByteCount = cmdByteCount;
+  cmd->pCmdData = pCmdData;
+  cmd->respByteCount = respByteCount;
+  cmd->pRespData = pRespData;
+  cmd->callback = callback;
+  cmd->next = NULL;
+
+  CORE_ENTER_ATOMIC();
+  start = (NULL == asyncHead);
+  if (start) {
+    asyncHead = cmd;
+  } else {
+    asyncTail->next = cmd;
+  }
+  asyncTail = cmd;
+  CORE_EXIT_ATOMIC();
+
+  if (start) {
+    ezradio_comm_AsyncWaitCts(asyncStateWaitCtsCmd);
+  }
+  return true;
+}
+
+/**
+ * Checks if asynchronous commands are queued or in progress.
+ *
+ * @return True if the asynchronous command queue is not empty.
+ */
+bool ezradio_comm_AsyncBusy(void)
+{
+  return (NULL != asyncHead);
+}
+#endif
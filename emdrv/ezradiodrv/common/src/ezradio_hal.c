@@ -55,6 +55,14 @@ static SPIDRV_Init_t        ezradioSpiInitData = SPIDRV_MASTER_USARTRF0;
 static SPIDRV_Init_t        ezradioSpiInitData = SPIDRV_MASTER_USART1;
 #endif
 
+#if defined(EZRADIODRV_COMM_ASYNC)
+static ezradio_hal_SpiCallback_t ezradioSpiCallback = NULL;
+
+static void ezradio_hal_SpiTransferDone(SPIDRV_Handle_t handle,
+                                        Ecode_t transferStatus,
+                                        int itemsTransferred);
+#endif
+
 /// @endcond
 
 /**
@@ -173,6 +181,27 @@ uint8_t ezradio_hal_NirqLevel(void)
   return GPIO_PinInGet( (GPIO_Port_TypeDef) RF_INT_PORT, RF_INT_PIN);
 }
 
+#if defined(EZRADIODRV_COMM_ASYNC)
+/**
+ * Enables the rising edge interrupt of the EZRadio GPIO1 (CTS) pin.
+ *
+ * @param[in] gpio1IrqCallback Callback called when CTS goes high.
+ */
+void ezradio_hal_Gpio1IrqInit(GPIOINT_IrqCallbackPtr_t gpio1IrqCallback)
+{
+  GPIOINT_CallbackRegister(RF_GPIO1_PIN, gpio1IrqCallback);
+  GPIO_IntConfig( (GPIO_Port_TypeDef) RF_GPIO1_PORT, RF_GPIO1_PIN, true, false, true);
+}
+
+/**
+ * Clears a pending EZRadio GPIO1 (CTS) pin interrupt.
+ */
+void ezradio_hal_Gpio1IrqClear(void)
+{
+  GPIO_IntClear(1 << RF_GPIO1_PIN);
+}
+#endif
+
 #if defined(EZRADIODRV_DISABLE_PTI) && defined(EZRADIODRV_COMM_USE_GPIO1_FOR_CTS)
 /**
  * Reads GPIO1 pin of the EZRadio device.
@@ -237,3 +266,62 @@ void ezradio_hal_SpiWriteReadData(uint8_t byteCount, uint8_t* txData, uint8_t* r
 {
   SPIDRV_MTransferB(ezradioSpiHandlePtr, txData, rxData, byteCount);
 }
+
+#if defined(EZRADIODRV_COMM_ASYNC)
+/**
+ * Writes byteCount number of bytes to the EZRadio SPI port without blocking.
+ *
+ * @param byteCount Number of bytes to write.
+ * @param pData Pointer to the byte array, must be valid until completion.
+ * @param callback Called from interrupt context when the transfer is done.
+ */
+void ezradio_hal_SpiWriteDataAsync(uint8_t byteCount, uint8_t* pData,
+                                   ezradio_hal_SpiCallback_t callback)
+{
+  Ecode_t retVal;
+
+  ezradioSpiCallback = callback;
+  retVal = SPIDRV_MTransmit(ezradioSpiHandlePtr, pData, byteCount, ezradio_hal_SpiTransferDone);
+  if ((ECODE_EMDRV_SPIDRV_OK != retVal) && (NULL != callback)) {
+    callback(retVal);
+  }
+}
+
+/**
+ * Writes and reads byteCount number of bytes on the EZRadio SPI port without
+ * blocking.
+ *
+ * @param byteCount Number of bytes to transfer.
+ * @param txData Pointer to the transmit array, must be valid until completion.
+ * @param rxData Pointer to the receive array, must be valid until completion.
+ * @param callback Called from interrupt context when the transfer is done.
+ */
+void ezradio_hal_SpiWriteReadDataAsync(uint8_t byteCount, uint8_t* txData,
+                                       uint8_t* rxData,
+                                       ezradio_hal_SpiCallback_t callback)
+{
+  Ecode_t retVal;
+
+  ezradioSpiCallback = callback;
+  retVal = SPIDRV_MTransfer(ezradioSpiHandlePtr, txData, rxData, byteCount, ezradio_hal_SpiTransferDone);
+  if ((ECODE_EMDRV_SPIDRV_OK != retVal) && (NULL != callback)) {
+    callback(retVal);
+  }
+}
+
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+
+static void ezradio_hal_SpiTransferDone(SPIDRV_Handle_t handle,
+                                        Ecode_t transferStatus,
+                                        int itemsTransferred)
+{
+  (void)handle;
+  (void)itemsTransferred;
+
+  if (NULL != ezradioSpiCallback) {
+    ezradioSpiCallback(transferStatus);
+  }
+}
+
+/// @endcond
+#endif
@@ -47,6 +47,9 @@
 /**
  * This function is used to load all properties and commands with a list of NULL terminated commands.
  * Before this function ezradio_reset should be called.
+ * Adjacent SET_PROPERTY commands of one property group are merged. With
+ * EZRADIODRV_PROP_SHADOW_SIZE set, properties already holding the requested
+ * values are not written.
  *
  * @param[in] pSetPropCmd Pointer to the configuration array.
  */
@@ -79,6 +82,39 @@ EZRADIO_ConfigRet_t ezradio_configuration_init(const uint8_t* pSetPropCmd)
       pSetPropCmd++;
     }
 
+    if ((EZRADIO_CMD_ID_SET_PROPERTY == ezradioCmd[0])
+        && (numOfBytes == (ezradioCmd[2] + 4u))) {
+      /* Merge the following SET_PROPERTY commands into this one as long as
+       * they continue the same property group and fit into 12 properties. */
+      while ((pSetPropCmd[0] > 4u)
+             && (EZRADIO_CMD_ID_SET_PROPERTY == pSetPropCmd[1])
+             && (pSetPropCmd[2] == ezradioCmd[1])
+             && (pSetPropCmd[0] == (pSetPropCmd[3] + 4u))
+             && (pSetPropCmd[4] == (uint8_t)(ezradioCmd[3] + ezradioCmd[2]))
+             && ((ezradioCmd[2] + pSetPropCmd[3]) <= 12u)) {
+        for (col = 0u; col < pSetPropCmd[3]; col++) {
+          ezradioCmd[numOfBytes + col] = pSetPropCmd[5u + col];
+        }
+        numOfBytes += pSetPropCmd[3];
+        ezradioCmd[2] += pSetPropCmd[3];
+        pSetPropCmd += pSetPropCmd[0] + 1u;
+      }
+
+#if (EZRADIODRV_PROP_SHADOW_SIZE > 0)
+      if (ezradio_prop_shadow_check_update(ezradioCmd[1], ezradioCmd[2], ezradioCmd[3], &ezradioCmd[4])) {
+        /* The radio already holds these values. */
+        continue;
+      }
+#endif
+    }
+
+#if (EZRADIODRV_PROP_SHADOW_SIZE > 0)
+    if (EZRADIO_CMD_ID_POWER_UP == ezradioCmd[0]) {
+      /* Properties are back at their reset values after power up. */
+      ezradio_prop_shadow_invalidate();
+    }
+#endif
+
     if (ezradio_comm_SendCmdGetResp(numOfBytes, ezradioCmd, 1, &response) != 0xFF) {
       /* Timeout occured */
       return EZRADIO_CONFIG_CTS_TIMEOUT;
@@ -51,6 +51,18 @@
 /// @brief Define to disable packet trace interface.
 //#define EZRADIODRV_DISABLE_PTI
 
+/// @brief Define to enable the asynchronous command interface. CTS is
+///        signalled by a GPIO1 interrupt and SPI transfers are done with
+///        DMA, see ezradio_comm_SendCmdGetRespAsync().
+///        Note: requires EZRADIODRV_COMM_USE_GPIO1_FOR_CTS and
+///        EZRADIODRV_DISABLE_PTI.
+//#define EZRADIODRV_COMM_ASYNC
+
+/// @brief Number of radio property values kept in a RAM shadow. Property
+///        writes that do not change any value are skipped. Each entry
+///        takes 3 bytes of RAM.
+//#define EZRADIODRV_PROP_SHADOW_SIZE 64
+
 /// @brief Define to enable 4-wire SPI communication with the radio.
 ///        Note: 4-wire mode cannot be used in EZR32 devices.
 //#define EZRADIODRV_SPI_4WIRE_MODE
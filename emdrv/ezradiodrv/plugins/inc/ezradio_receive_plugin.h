@@ -65,11 +65,45 @@ extern "C" {
 typedef struct EZRADIODRV_PacketRxHandle{
   EZRADIODRV_Callback_t userCallback;   ///< User callback.
   uint8_t channel;                      ///< Reception channel.
-  uint8_t * pktBuf;                     ///< Pointer to the receive buffer.
+  uint8_t * pktBuf;                     ///< Pointer to the receive buffer, not used with the receive ring.
 } EZRADIODRV_PacketRxHandle_t;
 
 Ecode_t ezradioStartRx(EZRADIODRV_Handle_t radioHandle);
 
+#if defined(EZRADIO_PLUGIN_RECEIVE_RING_SLOTS)
+
+#define ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_RING_EMPTY     (ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_BASE | 0x00000001)  ///< No packet in the receive ring.
+#define ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_RING_OVERFLOW  (ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_BASE | 0x00000002)  ///< Packet dropped, receive ring full or packet too long.
+
+/// Size of the data area of one receive ring slot.
+#if !defined(EZRADIO_PLUGIN_RECEIVE_RING_SLOT_SIZE)
+#define EZRADIO_PLUGIN_RECEIVE_RING_SLOT_SIZE   (RADIO_CONFIG_DATA_MAX_PACKET_LENGTH)
+#endif
+
+/// Timestamp source for received packets, e.g. RTCDRV_GetWallClockTicks32().
+#if !defined(EZRADIO_PLUGIN_RECEIVE_RING_TIMESTAMP)
+#define EZRADIO_PLUGIN_RECEIVE_RING_TIMESTAMP() (0u)
+#endif
+
+#if ((EZRADIO_PLUGIN_RECEIVE_RING_SLOTS) < 1) || ((EZRADIO_PLUGIN_RECEIVE_RING_SLOTS) > 128) \
+  || ((EZRADIO_PLUGIN_RECEIVE_RING_SLOTS) & ((EZRADIO_PLUGIN_RECEIVE_RING_SLOTS) - 1))
+#error EZRADIO_PLUGIN_RECEIVE_RING_SLOTS must be a power of 2 between 1 and 128!
+#endif
+
+/// Receive ring slot, holding one received packet and its metadata.
+typedef struct EZRADIODRV_RxPacket{
+  uint32_t timestamp;                                 ///< EZRADIO_PLUGIN_RECEIVE_RING_TIMESTAMP() when the first bytes were read.
+  uint16_t length;                                    ///< Number of valid bytes in data.
+  uint8_t  rssi;                                      ///< Latched RSSI of the packet.
+  uint8_t  data[EZRADIO_PLUGIN_RECEIVE_RING_SLOT_SIZE]; ///< Packet data, read directly from the RX FIFO.
+} EZRADIODRV_RxPacket_t;
+
+uint8_t ezradioRxRingCount(EZRADIODRV_Handle_t radioHandle);
+Ecode_t ezradioRxRingGet(EZRADIODRV_Handle_t radioHandle, EZRADIODRV_RxPacket_t **packet);
+Ecode_t ezradioRxRingRelease(EZRADIODRV_Handle_t radioHandle);
+
+#endif //#if defined( EZRADIO_PLUGIN_RECEIVE_RING_SLOTS )
+
 /// Configuration data for EzRadio receive plug-in.
 #define EZRADIODRV_RECEIVE_PLUGIN_INIT_DEFAULT                               \
   {                                           /* Packet RX                */ \
@@ -369,6 +369,19 @@ static void GPIO_EZRadio_INT_IRQHandler(uint8_t pin)
           @n If the CRC Error plugin is enabled its configured callback is
           called in case of a packet is received with CRC error.
 
+        ezradioRxRingGet(), ezradioRxRingRelease(), ezradioRxRingCount() @n
+          Available when EZRADIO_PLUGIN_RECEIVE_RING_SLOTS is defined in
+          app-config.h. Received packets are then read from the RX FIFO
+          directly into a ring of EZRADIO_PLUGIN_RECEIVE_RING_SLOTS slots,
+          together with the latched RSSI and a timestamp taken by
+          EZRADIO_PLUGIN_RECEIVE_RING_TIMESTAMP(). The application borrows the
+          oldest packet in place and releases it when done, so bursts of
+          packets are not lost while earlier ones are processed. Packets
+          longer than the RX FIFO are drained on the RX FIFO almost full
+          interrupt, which has to be enabled in the radio configuration.
+          If the ring is full the packet is dropped and the callback is
+          called with @ref ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_RING_OVERFLOW.
+
       @paragraph ezradiodrv_plugin_auto_ack Auto Acknowledge Plugin
         ezradioEnableAutoAck(), ezradioDisableAutoAck() @n
           These functions enables or disables auto acknowledge transmission.
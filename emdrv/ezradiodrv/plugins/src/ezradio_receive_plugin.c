@@ -31,6 +31,7 @@
  ******************************************************************************/
 
 #include <stddef.h>
+#include <stdbool.h>
 #include "em_device.h"
 
 #include "ezradio_cmd.h"
@@ -48,6 +49,24 @@
 Ecode_t ezradioTransmitAutoAck(EZRADIODRV_Handle_t radioHandle);
 #endif
 
+#if defined(EZRADIO_PLUGIN_RECEIVE_RING_SLOTS)
+/* Receive ring slots, filled directly from the RX FIFO. */
+static EZRADIODRV_RxPacket_t rxRing[EZRADIO_PLUGIN_RECEIVE_RING_SLOTS];
+
+/* Free running counters of completed and released packets. The slot index is
+ * the counter modulo the number of slots. */
+static volatile uint8_t rxRingWrite = 0u;
+static volatile uint8_t rxRingRead = 0u;
+
+/* Bytes already read of the packet being received. */
+static uint16_t rxRingFill = 0u;
+
+/* The packet being received does not fit and is discarded. */
+static bool rxRingDrop = false;
+
+static void ezradioRxRingDrain(void);
+#endif
+
 /// @endcond
 
 /**************************************************************************//**
@@ -72,6 +91,80 @@ Ecode_t ezradioStartRx(EZRADIODRV_Handle_t radioHandle)
   return ECODE_EMDRV_EZRADIODRV_OK;
 }
 
+#if defined(EZRADIO_PLUGIN_RECEIVE_RING_SLOTS)
+/**************************************************************************//**
+ * @brief Get the number of received packets in the receive ring.
+ *
+ *  @param radioHandle EzRadio driver instance handler.
+ *
+ *  @return
+ *    Number of packets that can be taken with ezradioRxRingGet().
+ *****************************************************************************/
+uint8_t ezradioRxRingCount(EZRADIODRV_Handle_t radioHandle)
+{
+  (void)radioHandle;
+
+  return (uint8_t)(rxRingWrite - rxRingRead);
+}
+
+/**************************************************************************//**
+ * @brief Borrow the oldest received packet from the receive ring.
+ *
+ * @details
+ *  The packet is not copied, the returned slot stays valid and unchanged until
+ *  it is given back with ezradioRxRingRelease(). Packets are always taken and
+ *  released in the order they were received.
+ *
+ *  @param radioHandle EzRadio driver instance handler.
+ *  @param packet Returns a pointer to the ring slot of the packet.
+ *
+ *  @return
+ *    @ref ECODE_EMDRV_EZRADIODRV_OK on success,
+ *    @ref ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_RING_EMPTY if there is no
+ *    packet in the ring.
+ *****************************************************************************/
+Ecode_t ezradioRxRingGet(EZRADIODRV_Handle_t radioHandle, EZRADIODRV_RxPacket_t **packet)
+{
+  if ( (radioHandle == NULL) || (packet == NULL) ) {
+    return ECODE_EMDRV_EZRADIODRV_ILLEGAL_HANDLE;
+  }
+
+  if ( rxRingWrite == rxRingRead ) {
+    return ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_RING_EMPTY;
+  }
+
+  *packet = &rxRing[rxRingRead % EZRADIO_PLUGIN_RECEIVE_RING_SLOTS];
+
+  return ECODE_EMDRV_EZRADIODRV_OK;
+}
+
+/**************************************************************************//**
+ * @brief Give the oldest packet borrowed with ezradioRxRingGet() back to
+ *        the receive ring.
+ *
+ *  @param radioHandle EzRadio driver instance handler.
+ *
+ *  @return
+ *    @ref ECODE_EMDRV_EZRADIODRV_OK on success,
+ *    @ref ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_RING_EMPTY if there is no
+ *    packet in the ring.
+ *****************************************************************************/
+Ecode_t ezradioRxRingRelease(EZRADIODRV_Handle_t radioHandle)
+{
+  if ( radioHandle == NULL ) {
+    return ECODE_EMDRV_EZRADIODRV_ILLEGAL_HANDLE;
+  }
+
+  if ( rxRingWrite == rxRingRead ) {
+    return ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_RING_EMPTY;
+  }
+
+  rxRingRead++;
+
+  return ECODE_EMDRV_EZRADIODRV_OK;
+}
+#endif //#if defined( EZRADIO_PLUGIN_RECEIVE_RING_SLOTS )
+
 /// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
 //  Note: These are internal routines used by ezradio plugin manager.
 
@@ -91,10 +184,48 @@ Ecode_t ezradioHandleReceivePlugin(EZRADIODRV_Handle_t radioHandle, EZRADIODRV_R
     return ECODE_EMDRV_EZRADIODRV_ILLEGAL_HANDLE;
   }
 
+#if defined(EZRADIO_PLUGIN_RECEIVE_RING_SLOTS)
+  /* Drain long packets into the ring slot before the RX FIFO overflows. */
+  if ( radioReplyHandle->GET_INT_STATUS.PH_PEND & EZRADIO_CMD_GET_INT_STATUS_REP_PH_PEND_RX_FIFO_ALMOST_FULL_PEND_BIT) {
+    ezradioRxRingDrain();
+  }
+
+  /* Forget the partial packet, the CRC error plugin resets the FIFO. */
+  if ( radioReplyHandle->GET_INT_STATUS.PH_PEND & EZRADIO_CMD_GET_INT_STATUS_REP_PH_PEND_CRC_ERROR_PEND_BIT) {
+    rxRingFill = 0u;
+    rxRingDrop = false;
+  }
+#endif
+
   /* Check if Pkt Rxd IT is received */
   if ( radioReplyHandle->GET_INT_STATUS.PH_PEND & EZRADIO_CMD_GET_INT_STATUS_REP_PH_PEND_PACKET_RX_PEND_BIT) {
     ezradio_cmd_reply_t radioReplyLocal;
+#if defined(EZRADIO_PLUGIN_RECEIVE_RING_SLOTS)
+    Ecode_t status = ECODE_EMDRV_EZRADIODRV_OK;
+
+    /* Read the rest of the packet into the ring slot. */
+    ezradioRxRingDrain();
+
+    if ( rxRingDrop ) {
+      status = ECODE_EMDRV_EZRADIODRV_RECEIVE_PLUGIN_RING_OVERFLOW;
+    } else {
+      EZRADIODRV_RxPacket_t *slot = &rxRing[rxRingWrite % EZRADIO_PLUGIN_RECEIVE_RING_SLOTS];
+
+      /* Get the RSSI latched during the packet, keep pending modem ITs. */
+      ezradio_get_modem_status(0xFFu, &radioReplyLocal);
+      slot->rssi = radioReplyLocal.GET_MODEM_STATUS.LATCH_RSSI;
+      slot->length = rxRingFill;
+
+      /* Publish the slot to the consumer. */
+      rxRingWrite++;
+    }
+    rxRingFill = 0u;
+    rxRingDrop = false;
 
+    if ( radioHandle->packetRx.userCallback != NULL ) {
+      radioHandle->packetRx.userCallback(radioHandle, status);
+    }
+#else
     /* Check how many bytes we received. */
     ezradio_fifo_info(0u, &radioReplyLocal);
 
@@ -104,6 +235,7 @@ Ecode_t ezradioHandleReceivePlugin(EZRADIODRV_Handle_t radioHandle, EZRADIODRV_R
     if ( radioHandle->packetRx.userCallback != NULL ) {
       radioHandle->packetRx.userCallback(radioHandle, ECODE_EMDRV_EZRADIODRV_OK);
     }
+#endif
 
     /* Note: Workaround for some FIFO issue. */
     ezradio_fifo_info(EZRADIO_CMD_FIFO_INFO_ARG_FIFO_RX_BIT, NULL);
@@ -121,12 +253,64 @@ Ecode_t ezradioHandleReceivePlugin(EZRADIODRV_Handle_t radioHandle, EZRADIODRV_R
     return ECODE_EMDRV_EZRADIODRV_OK;
   }
 
+#if defined(EZRADIO_PLUGIN_RECEIVE_RING_SLOTS)
+  /* Keep the FIFO while a long packet is being drained. */
+  if ( (rxRingFill != 0u) || rxRingDrop ) {
+    return ECODE_EMDRV_EZRADIODRV_OK;
+  }
+#endif
+
   /* Reset FIFO */
   ezradio_fifo_info(EZRADIO_CMD_FIFO_INFO_ARG_FIFO_RX_BIT, NULL);
 
   return ECODE_EMDRV_EZRADIODRV_OK;
 }
 
+#if defined(EZRADIO_PLUGIN_RECEIVE_RING_SLOTS)
+/**************************************************************************//**
+ * @brief Read the RX FIFO content directly into the ring slot of the packet
+ *        being received.
+ *
+ * @details
+ *  If the ring is full or the packet does not fit into a slot, the packet is
+ *  dropped: the FIFO is reset on every call until the packet ends.
+ *****************************************************************************/
+static void ezradioRxRingDrain(void)
+{
+  ezradio_cmd_reply_t radioReplyLocal;
+  EZRADIODRV_RxPacket_t *slot;
+  uint8_t count;
+
+  /* Check how many bytes we received. */
+  ezradio_fifo_info(0u, &radioReplyLocal);
+  count = radioReplyLocal.FIFO_INFO.RX_FIFO_COUNT;
+
+  if ( !rxRingDrop
+       && ( ((uint8_t)(rxRingWrite - rxRingRead) >= EZRADIO_PLUGIN_RECEIVE_RING_SLOTS)
+            || ((rxRingFill + count) > EZRADIO_PLUGIN_RECEIVE_RING_SLOT_SIZE) ) ) {
+    rxRingDrop = true;
+  }
+
+  if ( rxRingDrop ) {
+    ezradio_fifo_info(EZRADIO_CMD_FIFO_INFO_ARG_FIFO_RX_BIT, NULL);
+    return;
+  }
+
+  if ( count == 0u ) {
+    return;
+  }
+
+  slot = &rxRing[rxRingWrite % EZRADIO_PLUGIN_RECEIVE_RING_SLOTS];
+  if ( rxRingFill == 0u ) {
+    slot->timestamp = EZRADIO_PLUGIN_RECEIVE_RING_TIMESTAMP();
+  }
+
+  /* Read out the RX FIFO content. */
+  ezradio_read_rx_fifo(count, &slot->data[rxRingFill]);
+  rxRingFill += count;
+}
+#endif
+
 /// @endcond
 
 #endif //#if defined( EZRADIO_PLUGIN_RECEIVE )
@@ -0,0 +1,194 @@
+/***************************************************************************//**
+ * @file i2cdrv.h
+ * @brief I2CDRV API definition.
+ * @version 5.5.0
+ *******************************************************************************
+ * # License
+ * <b>(C) Copyright 2015 Silicon Labs, www.silabs.com</b>
+ *******************************************************************************
+ *
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ *
+ ******************************************************************************/
+#ifndef __SILICON_LABS_I2CDRV_H__
+#define __SILICON_LABS_I2CDRV_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "em_device.h"
+#include "em_i2c.h"
+#include "ecode.h"
+#include "i2cdrv_config.h"
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+#include "dmadrv.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************//**
+ * @addtogroup emdrv
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup I2CDRV
+ * @{
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @addtogroup I2CDRV_ERROR_CODES Error Codes
+ * @brief I2CDRV error codes.
+ * @{
+ ******************************************************************************/
+
+#define ECODE_EMDRV_I2CDRV_OK                (ECODE_OK)                               ///< A successful return value.
+#define ECODE_EMDRV_I2CDRV_ILLEGAL_HANDLE    (ECODE_EMDRV_I2CDRV_BASE | 0x00000001)   ///< An illegal I2C handle.
+#define ECODE_EMDRV_I2CDRV_PARAM_ERROR       (ECODE_EMDRV_I2CDRV_BASE | 0x00000002)   ///< An illegal input parameter.
+#define ECODE_EMDRV_I2CDRV_QUEUE_FULL        (ECODE_EMDRV_I2CDRV_BASE | 0x00000003)   ///< The transaction queue is full.
+#define ECODE_EMDRV_I2CDRV_NACK              (ECODE_EMDRV_I2CDRV_BASE | 0x00000004)   ///< The slave did not acknowledge the address or data.
+#define ECODE_EMDRV_I2CDRV_BUS_ERROR         (ECODE_EMDRV_I2CDRV_BASE | 0x00000005)   ///< A misplaced START or STOP condition on the bus.
+#define ECODE_EMDRV_I2CDRV_ARB_LOST          (ECODE_EMDRV_I2CDRV_BASE | 0x00000006)   ///< Arbitration lost.
+#define ECODE_EMDRV_I2CDRV_ABORTED           (ECODE_EMDRV_I2CDRV_BASE | 0x00000007)   ///< The transaction was aborted.
+#define ECODE_EMDRV_I2CDRV_DMA_ALLOC_ERROR   (ECODE_EMDRV_I2CDRV_BASE | 0x00000008)   ///< Unable to allocate a DMA channel.
+
+/** @} (end addtogroup I2CDRV_ERROR_CODES) */
+
+/// I2C transaction types.
+typedef enum I2CDRV_TransferType{
+  i2cdrvTransferWrite = 0,        ///< Write the transmit buffer.
+  i2cdrvTransferRead,             ///< Read into the receive buffer.
+  i2cdrvTransferWriteRead         ///< Write the transmit buffer, repeated START, read into the receive buffer.
+} I2CDRV_TransferType_t;
+
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+struct I2CDRV_HandleData;
+/// @endcond
+
+/***************************************************************************//**
+ * @brief
+ *  I2CDRV transaction completion callback function.
+ *
+ * @details
+ *  Called from the I2C or DMA interrupt handler when a transaction queued
+ *  with @ref I2CDRV_QueueTransfer() is complete, failed or was aborted.
+ *  The callback may queue new transactions.
+ *
+ * @param[in] handle
+ *   The I2CDRV device handle the transaction was queued on.
+ *
+ * @param[in] transferStatus
+ *   @ref ECODE_EMDRV_I2CDRV_OK on success, or the cause of the failure.
+ *
+ * @param[in] userParam
+ *   The @ref I2CDRV_Transfer_t.userParam of the transaction.
+ ******************************************************************************/
+typedef void (*I2CDRV_Callback_t)(struct I2CDRV_HandleData *handle,
+                                  Ecode_t transferStatus,
+                                  void *userParam);
+
+/// An I2C master transaction descriptor for @ref I2CDRV_QueueTransfer().
+/// The descriptor is copied into the driver instance when queued, the
+/// buffers must stay valid until the transaction is complete.
+typedef struct I2CDRV_Transfer{
+  uint16_t              addr;         ///< 7 bit slave address, format AAAA AAAX as in @ref I2C_TransferSeq_TypeDef.
+  I2CDRV_TransferType_t type;         ///< Transaction type.
+  const uint8_t         *txBuffer;    ///< Transmit data buffer.
+  uint16_t              txCount;      ///< Number of bytes to transmit, 0 sends the address only.
+  uint16_t              txSegment;    ///< Transmit bytes per repeated START segment, 0 for one segment.
+  uint8_t               *rxBuffer;    ///< Receive data buffer.
+  uint16_t              rxCount;      ///< Number of bytes to receive, at least 1 when reading.
+  I2CDRV_Callback_t     callback;     ///< Completion callback, may be NULL.
+  void                  *userParam;   ///< User parameter passed to the callback.
+} I2CDRV_Transfer_t;
+
+/// An I2C driver instance initialization structure.
+/// Contains a number of I2CDRV configuration options.
+/// This structure is passed to @ref I2CDRV_Init() when initializing a I2CDRV
+/// instance.
+typedef struct I2CDRV_Init{
+  I2C_TypeDef           *port;            ///< The I2C peripheral.
+#if defined(_I2C_ROUTELOC0_MASK)
+  uint8_t               portLocationScl;  ///< A location number for the SCL pin.
+  uint8_t               portLocationSda;  ///< A location number for the SDA pin.
+#else
+  uint8_t               portLocation;     ///< A location number for the I2C pins.
+#endif
+  uint32_t              bitRate;          ///< SCL frequency, for example @ref I2C_FREQ_FAST_MAX.
+  I2C_ClockHLR_TypeDef  clhr;             ///< SCL low/high ratio.
+} I2CDRV_Init_t;
+
+/// An I2C driver instance handle data structure.
+/// The handle is allocated by the application using the I2CDRV.
+/// Several concurrent driver instances can exist in an application. The application is
+/// neither supposed to write or read the contents of the handle.
+typedef struct I2CDRV_HandleData{
+  /// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+  I2CDRV_Init_t         initData;
+  I2CDRV_Transfer_t     queue[EMDRV_I2CDRV_QUEUE_SIZE];
+  volatile uint8_t      queueHead;        // Transactions queued, free running.
+  volatile uint8_t      queueTail;        // Transactions completed, free running.
+  volatile uint8_t      state;
+  uint16_t              offset;           // Current buffer position.
+  uint16_t              segmentEnd;       // End of the current transmit segment.
+  bool                  reading;          // Address sent for a read.
+  Ecode_t               status;
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+  unsigned int          dmaCh;
+  DMADRV_PeripheralSignal_t txDmaSignal;
+#endif
+  /// @endcond
+} I2CDRV_HandleData_t;
+
+/// An I2C driver instance handle.
+typedef I2CDRV_HandleData_t * I2CDRV_Handle_t;
+
+#if defined(_I2C_ROUTELOC0_MASK)
+/// Configuration data for an I2C master using I2C0, standard mode.
+#define I2CDRV_MASTER_I2C0                                       \
+  {                                                              \
+    I2C0,                   /* I2C port                       */ \
+    _I2C_ROUTELOC0_SCLLOC_LOC0, /* SCL pin location           */ \
+    _I2C_ROUTELOC0_SDALOC_LOC0, /* SDA pin location           */ \
+    I2C_FREQ_STANDARD_MAX,  /* SCL frequency                  */ \
+    i2cClockHLRStandard     /* SCL low/high ratio 4:4         */ \
+  }
+#else
+/// Configuration data for an I2C master using I2C0, standard mode.
+#define I2CDRV_MASTER_I2C0                                       \
+  {                                                              \
+    I2C0,                   /* I2C port                       */ \
+    _I2C_ROUTE_LOCATION_LOC0, /* Pin location                 */ \
+    I2C_FREQ_STANDARD_MAX,  /* SCL frequency                  */ \
+    i2cClockHLRStandard     /* SCL low/high ratio 4:4         */ \
+  }
+#endif
+
+// --------------------------------
+// I2CDRV API
+
+Ecode_t   I2CDRV_Init(I2CDRV_Handle_t handle, const I2CDRV_Init_t *initData);
+
+Ecode_t   I2CDRV_DeInit(I2CDRV_Handle_t handle);
+
+Ecode_t   I2CDRV_QueueTransfer(I2CDRV_Handle_t handle,
+                               const I2CDRV_Transfer_t *transfer);
+
+Ecode_t   I2CDRV_TransferB(I2CDRV_Handle_t handle,
+                           const I2CDRV_Transfer_t *transfer);
+
+Ecode_t   I2CDRV_AbortTransfers(I2CDRV_Handle_t handle);
+
+Ecode_t   I2CDRV_GetQueueCount(I2CDRV_Handle_t handle, int *count);
+
+/** @} (end addtogroup I2CDRV) */
+/** @} (end addtogroup emdrv) */
+
+#ifdef __cplusplus
+}
+#endif
+#endif // __SILICON_LABS_I2CDRV_H__
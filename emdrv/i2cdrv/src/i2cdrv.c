@@ -0,0 +1,1052 @@
+/***************************************************************************//**
+ * @file i2cdrv.c
+ * @brief I2CDRV API implementation.
+ * @version 5.5.0
+ *******************************************************************************
+ * # License
+ * <b>(C) Copyright 2015 Silicon Labs, www.silabs.com</b>
+ *******************************************************************************
+ *
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_core.h"
+#include "em_emu.h"
+#include "em_gpio.h"
+#include "em_i2c.h"
+
+#include "i2cdrv.h"
+#include "emdrv_section.h"
+#if defined(EMDRV_I2CDRV_SLEEPDRV_INTEGRATION)
+#include "sleep.h"
+#endif
+
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+
+#if (EMDRV_I2CDRV_QUEUE_SIZE < 1) || (EMDRV_I2CDRV_QUEUE_SIZE > 128) \
+  || (EMDRV_I2CDRV_QUEUE_SIZE & (EMDRV_I2CDRV_QUEUE_SIZE - 1))
+#error "EMDRV_I2CDRV_QUEUE_SIZE must be a power of 2 in the range 1..128"
+#endif
+
+#define I2C_IF_ERRORS    (I2C_IF_BUSERR | I2C_IF_ARBLOST)
+
+// STATE polls after an abort, which is also done from the I2C interrupt.
+// The master goes idle at once, but BUSY stays set while another master
+// holds the bus. A START queued meanwhile waits for the bus in hardware.
+#define I2C_ABORT_POLLS  64
+
+#if defined(EMDRV_NVIC_SECTIONS)
+// Interrupts touching the driver state: the I2C ports, the DMA completion
+// callback and the application interrupts calling the driver.
+#if defined(I2C1)
+#define I2CDRV_PORT_IRQS(X, w)  X(I2C0_IRQn, w) X(I2C1_IRQn, w)
+#else
+#define I2CDRV_PORT_IRQS(X, w)  X(I2C0_IRQn, w)
+#endif
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0) && defined(EMDRV_DMADRV_UDMA)
+#define I2CDRV_DMA_IRQS(X, w)   X(DMA_IRQn, w)
+#elif (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+#define I2CDRV_DMA_IRQS(X, w)   X(LDMA_IRQn, w)
+#else
+#define I2CDRV_DMA_IRQS(X, w)
+#endif
+#if !defined(EMDRV_I2CDRV_SECTION_EXTRA_IRQS)
+#define EMDRV_I2CDRV_SECTION_EXTRA_IRQS(X, w)
+#endif
+#define I2CDRV_SECTION_IRQS(X, w) \
+  I2CDRV_PORT_IRQS(X, w)          \
+  I2CDRV_DMA_IRQS(X, w)           \
+  EMDRV_I2CDRV_SECTION_EXTRA_IRQS(X, w)
+
+static const CORE_nvicMask_t sectionMask =
+  EMDRV_SECTION_MASK(I2CDRV_SECTION_IRQS);
+#endif
+
+// Transaction state machine states, run from the I2C interrupt handler.
+typedef enum {
+  i2cdrvStateIdle = 0,          // No transaction active.
+  i2cdrvStateAddrWFAckNack,     // Wait for ACK/NACK on (repeated) START+address.
+  i2cdrvStateDataWFAckNack,     // Wait for ACK/NACK on a transmitted byte.
+  i2cdrvStateDmaSend,           // DMA feeds the transmit buffer.
+  i2cdrvStateDmaWFTxc,          // Wait for the last DMA byte to be shifted out.
+  i2cdrvStateWFData,            // Wait for received data.
+  i2cdrvStateWFStopSent         // Wait for STOP to be sent.
+} I2CDRV_State_t;
+
+// Completion of a blocking transaction.
+typedef struct {
+  volatile bool done;
+  Ecode_t       status;
+} BlockingStatus_t;
+
+static I2CDRV_Handle_t i2cdrvHandle[I2C_COUNT];
+
+static void     AbortBus(I2C_TypeDef *i2c);
+
+static void     BlockingComplete(I2CDRV_Handle_t handle,
+                                 Ecode_t transferStatus,
+                                 void *userParam);
+
+static void     Complete(I2CDRV_Handle_t handle);
+
+static Ecode_t  ConfigGPIO(I2CDRV_Handle_t handle, bool enable);
+
+static void     DataSend(I2CDRV_Handle_t handle);
+
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+static bool     DmaComplete(unsigned int channel,
+                            unsigned int sequenceNo,
+                            void *userParam);
+#endif
+
+static int      HandleIndex(I2C_TypeDef *port);
+
+static void     I2cIrqHandler(I2CDRV_Handle_t handle);
+
+static void     SendAddress(I2CDRV_Handle_t handle, bool read, bool repeated);
+
+static void     StartNext(I2CDRV_Handle_t handle);
+
+static void     Stop(I2CDRV_Handle_t handle, Ecode_t status);
+
+/// @endcond
+
+/***************************************************************************//**
+ * @brief
+ *    Initialize an I2C driver instance.
+ *
+ * @details
+ *    The I2C peripheral is set up as a single bus master, the pins are
+ *    configured as open drain and the I2C interrupt is enabled.
+ *
+ * @param[out] handle  Pointer to an I2C driver handle, see @ref I2CDRV_Handle_t.
+ *
+ * @param[in] initData Pointer to an initialization data structure,
+ *                     see @ref I2CDRV_Init_t.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_I2CDRV_OK on success. On failure, an appropriate
+ *    I2CDRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t I2CDRV_Init(I2CDRV_Handle_t handle, const I2CDRV_Init_t *initData)
+{
+  I2C_Init_TypeDef i2cInit = I2C_INIT_DEFAULT;
+  CMU_Clock_TypeDef i2cClock;
+  int index;
+
+  if ( handle == NULL ) {
+    return ECODE_EMDRV_I2CDRV_ILLEGAL_HANDLE;
+  }
+
+  if ( initData == NULL ) {
+    return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+  }
+
+  index = HandleIndex(initData->port);
+  if ( index < 0 ) {
+    return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+  }
+
+  memset(handle, 0, sizeof(I2CDRV_HandleData_t));
+  handle->initData = *initData;
+
+  if ( 0 ) {
+#if defined(I2C0)
+  } else if ( initData->port == I2C0 ) {
+    i2cClock = cmuClock_I2C0;
+#endif
+#if defined(I2C1)
+  } else if ( initData->port == I2C1 ) {
+    i2cClock = cmuClock_I2C1;
+#endif
+  } else {
+    return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+  }
+
+#if defined(_CMU_HFPERCLKEN0_MASK)
+  CMU_ClockEnable(cmuClock_HFPER, true);
+#endif
+  CMU_ClockEnable(cmuClock_GPIO, true);
+  CMU_ClockEnable(i2cClock, true);
+
+  ConfigGPIO(handle, true);
+
+  i2cInit.enable = false;
+  i2cInit.freq   = initData->bitRate;
+  i2cInit.clhr   = initData->clhr;
+  I2C_Init(initData->port, &i2cInit);
+
+  initData->port->IEN = 0;
+  initData->port->IFC = _I2C_IFC_MASK;
+  I2C_Enable(initData->port, true);
+
+  // The bus is assumed idle after reset, single master only.
+  if ( initData->port->STATE & I2C_STATE_BUSY ) {
+    AbortBus(initData->port);
+  }
+
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+  DMADRV_Init();
+
+  if ( DMADRV_AllocateChannel(&handle->dmaCh, NULL) != ECODE_EMDRV_DMADRV_OK ) {
+    return ECODE_EMDRV_I2CDRV_DMA_ALLOC_ERROR;
+  }
+
+  if ( 0 ) {
+#if defined(I2C0)
+  } else if ( initData->port == I2C0 ) {
+    handle->txDmaSignal = dmadrvPeripheralSignal_I2C0_TXBL;
+#endif
+#if defined(I2C1)
+  } else if ( initData->port == I2C1 ) {
+    handle->txDmaSignal = dmadrvPeripheralSignal_I2C1_TXBL;
+#endif
+  }
+#endif
+
+  i2cdrvHandle[index] = handle;
+
+  if ( 0 ) {
+#if defined(I2C0)
+  } else if ( initData->port == I2C0 ) {
+    NVIC_ClearPendingIRQ(I2C0_IRQn);
+    NVIC_EnableIRQ(I2C0_IRQn);
+#endif
+#if defined(I2C1)
+  } else if ( initData->port == I2C1 ) {
+    NVIC_ClearPendingIRQ(I2C1_IRQn);
+    NVIC_EnableIRQ(I2C1_IRQn);
+#endif
+  }
+
+  return ECODE_EMDRV_I2CDRV_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Deinitialize an I2C driver instance.
+ *
+ * @details
+ *    Queued transactions are aborted, their callbacks are called with
+ *    @ref ECODE_EMDRV_I2CDRV_ABORTED.
+ *
+ * @param[in] handle Pointer to an I2C driver handle.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_I2CDRV_OK on success. On failure, an appropriate
+ *    I2CDRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t I2CDRV_DeInit(I2CDRV_Handle_t handle)
+{
+  int index;
+
+  if ( handle == NULL ) {
+    return ECODE_EMDRV_I2CDRV_ILLEGAL_HANDLE;
+  }
+
+  I2CDRV_AbortTransfers(handle);
+  I2C_Reset(handle->initData.port);
+
+  if ( 0 ) {
+#if defined(I2C0)
+  } else if ( handle->initData.port == I2C0 ) {
+    NVIC_DisableIRQ(I2C0_IRQn);
+    CMU_ClockEnable(cmuClock_I2C0, false);
+#endif
+#if defined(I2C1)
+  } else if ( handle->initData.port == I2C1 ) {
+    NVIC_DisableIRQ(I2C1_IRQn);
+    CMU_ClockEnable(cmuClock_I2C1, false);
+#endif
+  }
+
+  ConfigGPIO(handle, false);
+
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+  DMADRV_FreeChannel(handle->dmaCh);
+#endif
+
+  index = HandleIndex(handle->initData.port);
+  if ( index >= 0 ) {
+    i2cdrvHandle[index] = NULL;
+  }
+
+  return ECODE_EMDRV_I2CDRV_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Queue an I2C master transaction.
+ *
+ * @details
+ *    Transactions are run in queued order from the I2C interrupt handler,
+ *    each one from START to STOP, and the transaction callback is called on
+ *    completion. A transaction is started at once if the bus is idle.
+ *
+ *    A write with @ref I2CDRV_Transfer_t.txSegment set is split into segments
+ *    of txSegment bytes, each segment sent after a repeated START and the
+ *    slave address. A run of register writes, for example (register, value)
+ *    pairs with txSegment 2, is sent as one transaction without releasing
+ *    the bus between the writes.
+ *
+ *    With @ref EMDRV_I2CDRV_DMA_THRESHOLD set, segments of at least that many
+ *    bytes are written by DMA.
+ *
+ * @note
+ *    Only 7 bit slave addresses are supported.
+ *
+ * @param[in] handle Pointer to an I2C driver handle.
+ *
+ * @param[in] transfer The transaction descriptor, copied into the queue.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_I2CDRV_OK on success, @ref ECODE_EMDRV_I2CDRV_QUEUE_FULL
+ *    if all queue slots are in use. On other failures, an appropriate
+ *    I2CDRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t I2CDRV_QueueTransfer(I2CDRV_Handle_t handle,
+                             const I2CDRV_Transfer_t *transfer)
+{
+  EMDRV_DECLARE_SECTION_STATE;
+
+  if ( handle == NULL ) {
+    return ECODE_EMDRV_I2CDRV_ILLEGAL_HANDLE;
+  }
+
+  if ( transfer == NULL ) {
+    return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+  }
+
+  if ( transfer->type == i2cdrvTransferRead ) {
+    if ( (transfer->rxBuffer == NULL) || (transfer->rxCount == 0) ) {
+      return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+    }
+  } else {
+    if ( (transfer->txBuffer == NULL) && (transfer->txCount > 0) ) {
+      return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+    }
+    // A read can not be 0 bytes, the slave always sends the first byte.
+    if ( (transfer->type == i2cdrvTransferWriteRead)
+         && ((transfer->rxBuffer == NULL) || (transfer->rxCount == 0)) ) {
+      return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+    }
+  }
+
+  EMDRV_ENTER_SECTION(&sectionMask);
+  if ( (uint8_t)(handle->queueHead - handle->queueTail)
+       >= EMDRV_I2CDRV_QUEUE_SIZE ) {
+    EMDRV_EXIT_SECTION();
+    return ECODE_EMDRV_I2CDRV_QUEUE_FULL;
+  }
+
+  handle->queue[handle->queueHead % EMDRV_I2CDRV_QUEUE_SIZE] = *transfer;
+  handle->queueHead++;
+
+  if ( handle->state == i2cdrvStateIdle ) {
+#if defined(EMDRV_I2CDRV_SLEEPDRV_INTEGRATION)
+    // The I2C peripheral runs on the high frequency clock.
+    SLEEP_SleepBlockBeginTagged(sleepEM2, (uint32_t)(uintptr_t)handle);
+#endif
+    StartNext(handle);
+  }
+  EMDRV_EXIT_SECTION();
+
+  return ECODE_EMDRV_I2CDRV_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Queue an I2C master transaction and wait for it to complete.
+ *
+ * @details
+ *    The callback and userParam of the descriptor are not used. The MCU
+ *    waits in EM1 and is woken by the I2C interrupt.
+ *
+ * @note
+ *    Waits for the transactions queued before this one as well. Do not call
+ *    from an interrupt handler or a transaction callback.
+ *
+ * @param[in] handle Pointer to an I2C driver handle.
+ *
+ * @param[in] transfer The transaction descriptor.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_I2CDRV_OK on success. On failure, an appropriate
+ *    I2CDRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t I2CDRV_TransferB(I2CDRV_Handle_t handle,
+                         const I2CDRV_Transfer_t *transfer)
+{
+  I2CDRV_Transfer_t blocking;
+  BlockingStatus_t status;
+  Ecode_t retVal;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ( transfer == NULL ) {
+    return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+  }
+
+  blocking           = *transfer;
+  blocking.callback  = BlockingComplete;
+  blocking.userParam = &status;
+  status.done        = false;
+
+  retVal = I2CDRV_QueueTransfer(handle, &blocking);
+  if ( retVal != ECODE_EMDRV_I2CDRV_OK ) {
+    return retVal;
+  }
+
+  // The transaction blocks EM2 while active, the core waits in EM1 for the
+  // I2C interrupt. The flag is checked with interrupts masked so the wakeup
+  // cannot be lost between the check and the sleep.
+  CORE_ENTER_ATOMIC();
+  while ( !status.done ) {
+#if defined(EMDRV_I2CDRV_SLEEPDRV_INTEGRATION)
+    SLEEP_Sleep();
+#else
+    EMU_EnterEM1();
+#endif
+    CORE_EXIT_ATOMIC();
+    CORE_ENTER_ATOMIC();
+  }
+  CORE_EXIT_ATOMIC();
+
+  return status.status;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Abort the active and all queued transactions.
+ *
+ * @details
+ *    The callbacks of the aborted transactions are called with
+ *    @ref ECODE_EMDRV_I2CDRV_ABORTED.
+ *
+ * @param[in] handle Pointer to an I2C driver handle.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_I2CDRV_OK on success. On failure, an appropriate
+ *    I2CDRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t I2CDRV_AbortTransfers(I2CDRV_Handle_t handle)
+{
+  I2CDRV_Transfer_t *transfer;
+  I2CDRV_Callback_t callback[EMDRV_I2CDRV_QUEUE_SIZE];
+  void *userParam[EMDRV_I2CDRV_QUEUE_SIZE];
+  int count = 0;
+  int i;
+  EMDRV_DECLARE_SECTION_STATE;
+
+  if ( handle == NULL ) {
+    return ECODE_EMDRV_I2CDRV_ILLEGAL_HANDLE;
+  }
+
+  EMDRV_ENTER_SECTION(&sectionMask);
+  if ( handle->state != i2cdrvStateIdle ) {
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+    DMADRV_StopTransfer(handle->dmaCh);
+#endif
+    handle->initData.port->IEN = 0;
+    AbortBus(handle->initData.port);
+    handle->state = i2cdrvStateIdle;
+#if defined(EMDRV_I2CDRV_SLEEPDRV_INTEGRATION)
+    SLEEP_SleepBlockEndTagged(sleepEM2, (uint32_t)(uintptr_t)handle);
+#endif
+  }
+
+  // Empty the queue before calling back, a callback may queue a new one.
+  while ( handle->queueTail != handle->queueHead ) {
+    transfer          = &handle->queue[handle->queueTail % EMDRV_I2CDRV_QUEUE_SIZE];
+    callback[count]   = transfer->callback;
+    userParam[count]  = transfer->userParam;
+    count++;
+    handle->queueTail++;
+  }
+  EMDRV_EXIT_SECTION();
+
+  for ( i = 0; i < count; i++ ) {
+    if ( callback[i] != NULL ) {
+      callback[i](handle, ECODE_EMDRV_I2CDRV_ABORTED, userParam[i]);
+    }
+  }
+
+  return ECODE_EMDRV_I2CDRV_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of transactions queued, including the active one.
+ *
+ * @param[in] handle Pointer to an I2C driver handle.
+ *
+ * @param[out] count Number of transactions not yet complete.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_I2CDRV_OK on success. On failure, an appropriate
+ *    I2CDRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t I2CDRV_GetQueueCount(I2CDRV_Handle_t handle, int *count)
+{
+  if ( handle == NULL ) {
+    return ECODE_EMDRV_I2CDRV_ILLEGAL_HANDLE;
+  }
+
+  if ( count == NULL ) {
+    return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+  }
+
+  *count = (uint8_t)(handle->queueHead - handle->queueTail);
+
+  return ECODE_EMDRV_I2CDRV_OK;
+}
+
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+
+/***************************************************************************//**
+ * @brief
+ *    Abort the bus activity and wait a bounded time for the I2C state
+ *    machine and the bus to go idle. The next transaction may then start,
+ *    after lost arbitration its START waits for the other master.
+ ******************************************************************************/
+static void AbortBus(I2C_TypeDef *i2c)
+{
+  int polls = I2C_ABORT_POLLS;
+
+  i2c->CMD = I2C_CMD_ABORT;
+  while ( (i2c->STATE & (I2C_STATE_BUSY | _I2C_STATE_STATE_MASK))
+          && (--polls > 0) ) ;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Completion callback for blocking transactions.
+ ******************************************************************************/
+static void BlockingComplete(I2CDRV_Handle_t handle,
+                             Ecode_t transferStatus,
+                             void *userParam)
+{
+  BlockingStatus_t *status = (BlockingStatus_t *)userParam;
+
+  (void)handle;
+  status->status = transferStatus;
+  status->done   = true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Finish the active transaction, start the next and call the callback.
+ *    Called from the interrupt handlers.
+ ******************************************************************************/
+static void Complete(I2CDRV_Handle_t handle)
+{
+  I2CDRV_Transfer_t *transfer;
+  I2CDRV_Callback_t callback;
+  void *userParam;
+  Ecode_t status;
+  EMDRV_DECLARE_SECTION_STATE;
+
+  EMDRV_ENTER_SECTION(&sectionMask);
+  handle->initData.port->IEN = 0;
+  transfer  = &handle->queue[handle->queueTail % EMDRV_I2CDRV_QUEUE_SIZE];
+  callback  = transfer->callback;
+  userParam = transfer->userParam;
+  status    = handle->status;
+  handle->queueTail++;
+  StartNext(handle);
+  EMDRV_EXIT_SECTION();
+
+  if ( callback != NULL ) {
+    callback(handle, status, userParam);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Configure or deconfigure the I2C pins.
+ ******************************************************************************/
+static Ecode_t ConfigGPIO(I2CDRV_Handle_t handle, bool enable)
+{
+  I2CDRV_Init_t *initData = &handle->initData;
+  int sclPort, sdaPort, sclPin, sdaPin;
+
+  if ( 0 ) {
+#if defined(I2C0)
+  } else if ( initData->port == I2C0 ) {
+#if defined(_I2C_ROUTELOC0_MASK)
+    sclPort = AF_I2C0_SCL_PORT(initData->portLocationScl);
+    sdaPort = AF_I2C0_SDA_PORT(initData->portLocationSda);
+    sclPin  = AF_I2C0_SCL_PIN(initData->portLocationScl);
+    sdaPin  = AF_I2C0_SDA_PIN(initData->portLocationSda);
+#else
+    sclPort = AF_I2C0_SCL_PORT(initData->portLocation);
+    sdaPort = AF_I2C0_SDA_PORT(initData->portLocation);
+    sclPin  = AF_I2C0_SCL_PIN(initData->portLocation);
+    sdaPin  = AF_I2C0_SDA_PIN(initData->portLocation);
+#endif
+#endif
+#if defined(I2C1)
+  } else if ( initData->port == I2C1 ) {
+#if defined(_I2C_ROUTELOC0_MASK)
+    sclPort = AF_I2C1_SCL_PORT(initData->portLocationScl);
+    sdaPort = AF_I2C1_SDA_PORT(initData->portLocationSda);
+    sclPin  = AF_I2C1_SCL_PIN(initData->portLocationScl);
+    sdaPin  = AF_I2C1_SDA_PIN(initData->portLocationSda);
+#else
+    sclPort = AF_I2C1_SCL_PORT(initData->portLocation);
+    sdaPort = AF_I2C1_SDA_PORT(initData->portLocation);
+    sclPin  = AF_I2C1_SCL_PIN(initData->portLocation);
+    sdaPin  = AF_I2C1_SDA_PIN(initData->portLocation);
+#endif
+#endif
+  } else {
+    return ECODE_EMDRV_I2CDRV_PARAM_ERROR;
+  }
+
+  if ( enable ) {
+    // Idle high, open drain with filter as required by the I2C spec.
+    GPIO_PinModeSet( (GPIO_Port_TypeDef)sclPort, sclPin,
+                     gpioModeWiredAndPullUpFilter, 1);
+    GPIO_PinModeSet( (GPIO_Port_TypeDef)sdaPort, sdaPin,
+                     gpioModeWiredAndPullUpFilter, 1);
+
+#if defined(_I2C_ROUTELOC0_MASK)
+    initData->port->ROUTEPEN  = I2C_ROUTEPEN_SDAPEN | I2C_ROUTEPEN_SCLPEN;
+    initData->port->ROUTELOC0 = (initData->portLocationSda
+                                 << _I2C_ROUTELOC0_SDALOC_SHIFT)
+                                | (initData->portLocationScl
+                                   << _I2C_ROUTELOC0_SCLLOC_SHIFT);
+#else
+    initData->port->ROUTE = I2C_ROUTE_SDAPEN
+                            | I2C_ROUTE_SCLPEN
+                            | (initData->portLocation
+                               << _I2C_ROUTE_LOCATION_SHIFT);
+#endif
+  } else {
+#if defined(_I2C_ROUTELOC0_MASK)
+    initData->port->ROUTEPEN = _I2C_ROUTEPEN_RESETVALUE;
+#else
+    initData->port->ROUTE = _I2C_ROUTE_RESETVALUE;
+#endif
+    GPIO_PinModeSet( (GPIO_Port_TypeDef)sclPort, sclPin, gpioModeDisabled, 0);
+    GPIO_PinModeSet( (GPIO_Port_TypeDef)sdaPort, sdaPin, gpioModeDisabled, 0);
+  }
+
+  return ECODE_EMDRV_I2CDRV_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Transmit the next byte of the active segment, or continue with the
+ *    next segment, the read part or STOP.
+ ******************************************************************************/
+static void DataSend(I2CDRV_Handle_t handle)
+{
+  I2C_TypeDef *i2c = handle->initData.port;
+  I2CDRV_Transfer_t *transfer;
+  uint16_t segment;
+
+  transfer = &handle->queue[handle->queueTail % EMDRV_I2CDRV_QUEUE_SIZE];
+
+  if ( handle->offset < handle->segmentEnd ) {
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+    if ( (handle->segmentEnd - handle->offset) >= EMDRV_I2CDRV_DMA_THRESHOLD ) {
+      // The I2C sends each byte written by the DMA as soon as the one before
+      // is acknowledged, only a NACK needs attention until the DMA is done.
+      handle->state = i2cdrvStateDmaSend;
+      i2c->IEN     &= ~I2C_IEN_ACK;
+      DMADRV_MemoryPeripheral(handle->dmaCh,
+                              handle->txDmaSignal,
+                              (void *)&i2c->TXDATA,
+                              (void *)&transfer->txBuffer[handle->offset],
+                              true,
+                              handle->segmentEnd - handle->offset,
+                              dmadrvDataSize1,
+                              DmaComplete,
+                              handle);
+      handle->offset = handle->segmentEnd;
+      return;
+    }
+#endif
+    handle->state = i2cdrvStateDataWFAckNack;
+    i2c->TXDATA   = transfer->txBuffer[handle->offset++];
+    return;
+  }
+
+  // Segment done.
+  if ( handle->offset < transfer->txCount ) {
+    segment = transfer->txSegment;
+    if ( (segment == 0) || (segment > (transfer->txCount - handle->offset)) ) {
+      segment = transfer->txCount - handle->offset;
+    }
+    handle->segmentEnd = handle->offset + segment;
+    SendAddress(handle, false, true);
+  } else if ( transfer->type == i2cdrvTransferWriteRead ) {
+    handle->offset = 0;
+    SendAddress(handle, true, true);
+  } else {
+    Stop(handle, ECODE_EMDRV_I2CDRV_OK);
+  }
+}
+
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+/***************************************************************************//**
+ * @brief
+ *    DMA completion callback, the last byte is in the transmit buffer.
+ ******************************************************************************/
+static bool DmaComplete(unsigned int channel,
+                        unsigned int sequenceNo,
+                        void *userParam)
+{
+  I2CDRV_Handle_t handle = (I2CDRV_Handle_t)userParam;
+  I2C_TypeDef *i2c = handle->initData.port;
+  EMDRV_DECLARE_SECTION_STATE;
+
+  (void)channel;
+  (void)sequenceNo;
+
+  EMDRV_ENTER_SECTION(&sectionMask);
+  if ( handle->state == i2cdrvStateDmaSend ) {
+    // Continue from the I2C interrupt when the last byte is acknowledged,
+    // which may already have happened.
+    handle->state = i2cdrvStateDmaWFTxc;
+    i2c->IFC      = I2C_IFC_TXC;
+    i2c->IEN     |= I2C_IEN_TXC;
+    if ( i2c->STATUS & I2C_STATUS_TXC ) {
+      i2c->IFS = I2C_IFS_TXC;
+    }
+  }
+  EMDRV_EXIT_SECTION();
+
+  return true;
+}
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Get the index of the I2C peripheral, or -1.
+ ******************************************************************************/
+static int HandleIndex(I2C_TypeDef *port)
+{
+  if ( 0 ) {
+#if defined(I2C0)
+  } else if ( port == I2C0 ) {
+    return 0;
+#endif
+#if defined(I2C1)
+  } else if ( port == I2C1 ) {
+    return 1;
+#endif
+  }
+  return -1;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    The transaction state machine, one step per I2C interrupt.
+ ******************************************************************************/
+static void I2cIrqHandler(I2CDRV_Handle_t handle)
+{
+  I2C_TypeDef *i2c = handle->initData.port;
+  I2CDRV_Transfer_t *transfer;
+  uint32_t pending;
+
+  pending  = i2c->IF;
+  transfer = &handle->queue[handle->queueTail % EMDRV_I2CDRV_QUEUE_SIZE];
+
+  if ( pending & I2C_IF_ERRORS ) {
+    // No STOP is sent after a bus error or lost arbitration, the bus
+    // is released by the abort.
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+    DMADRV_StopTransfer(handle->dmaCh);
+#endif
+    i2c->IFC       = I2C_IF_ERRORS;
+    AbortBus(i2c);
+    handle->status = (pending & I2C_IF_ARBLOST) ? ECODE_EMDRV_I2CDRV_ARB_LOST
+                     : ECODE_EMDRV_I2CDRV_BUS_ERROR;
+    Complete(handle);
+    return;
+  }
+
+  switch ( handle->state ) {
+    case i2cdrvStateAddrWFAckNack:
+      if ( pending & I2C_IF_NACK ) {
+        i2c->IFC = I2C_IFC_NACK;
+        Stop(handle, ECODE_EMDRV_I2CDRV_NACK);
+      } else if ( pending & I2C_IF_ACK ) {
+        i2c->IFC = I2C_IFC_ACK;
+        if ( handle->reading ) {
+          handle->state = i2cdrvStateWFData;
+          if ( transfer->rxCount == 1 ) {
+            i2c->CMD = I2C_CMD_NACK;
+          }
+        } else {
+          DataSend(handle);
+        }
+      }
+      break;
+
+    case i2cdrvStateDataWFAckNack:
+      if ( pending & I2C_IF_NACK ) {
+        i2c->IFC = I2C_IFC_NACK;
+        Stop(handle, ECODE_EMDRV_I2CDRV_NACK);
+      } else if ( pending & I2C_IF_ACK ) {
+        i2c->IFC = I2C_IFC_ACK;
+        DataSend(handle);
+      }
+      break;
+
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+    case i2cdrvStateDmaSend:
+    case i2cdrvStateDmaWFTxc:
+      if ( pending & I2C_IF_NACK ) {
+        DMADRV_StopTransfer(handle->dmaCh);
+        i2c->IFC  = I2C_IFC_NACK | I2C_IFC_TXC;
+        i2c->IEN &= ~I2C_IEN_TXC;
+        i2c->CMD  = I2C_CMD_CLEARTX;
+        Stop(handle, ECODE_EMDRV_I2CDRV_NACK);
+      } else if ( (handle->state == i2cdrvStateDmaWFTxc)
+                  && (pending & I2C_IF_TXC) ) {
+        i2c->IFC  = I2C_IFC_TXC | I2C_IFC_ACK;
+        i2c->IEN  = (i2c->IEN & ~I2C_IEN_TXC) | I2C_IEN_ACK;
+        DataSend(handle);
+      }
+      break;
+#endif
+
+    case i2cdrvStateWFData:
+      if ( pending & I2C_IF_RXDATAV ) {
+        transfer->rxBuffer[handle->offset++] = (uint8_t)i2c->RXDATA;
+
+        if ( handle->offset >= transfer->rxCount ) {
+          Stop(handle, ECODE_EMDRV_I2CDRV_OK);
+        } else {
+          i2c->CMD = I2C_CMD_ACK;
+          // NACK the last byte, the command is queued before it arrives.
+          if ( handle->offset == (transfer->rxCount - 1) ) {
+            i2c->CMD = I2C_CMD_NACK;
+          }
+        }
+      }
+      break;
+
+    case i2cdrvStateWFStopSent:
+      if ( pending & I2C_IF_MSTOP ) {
+        i2c->IFC = I2C_IFC_MSTOP;
+        Complete(handle);
+      }
+      break;
+
+    default:
+      // Not expected, drop the interrupt sources.
+      i2c->IEN = 0;
+      break;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Send a (repeated) START and the slave address.
+ ******************************************************************************/
+static void SendAddress(I2CDRV_Handle_t handle, bool read, bool repeated)
+{
+  I2C_TypeDef *i2c = handle->initData.port;
+  I2CDRV_Transfer_t *transfer;
+  uint32_t addr;
+
+  transfer = &handle->queue[handle->queueTail % EMDRV_I2CDRV_QUEUE_SIZE];
+  addr     = (transfer->addr & 0xFEU) | (read ? 1U : 0U);
+
+  handle->state   = i2cdrvStateAddrWFAckNack;
+  handle->reading = read;
+  if ( repeated ) {
+    // START first, otherwise the address is sent as data.
+    i2c->CMD    = I2C_CMD_START;
+    i2c->TXDATA = addr;
+  } else {
+    i2c->TXDATA = addr;
+    i2c->CMD    = I2C_CMD_START;
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Start the next queued transaction, or go idle.
+ *    Called with interrupts disabled.
+ ******************************************************************************/
+static void StartNext(I2CDRV_Handle_t handle)
+{
+  I2C_TypeDef *i2c = handle->initData.port;
+  I2CDRV_Transfer_t *transfer;
+  uint16_t segment;
+
+  if ( handle->queueTail == handle->queueHead ) {
+    if ( handle->state != i2cdrvStateIdle ) {
+      handle->state = i2cdrvStateIdle;
+#if defined(EMDRV_I2CDRV_SLEEPDRV_INTEGRATION)
+      SLEEP_SleepBlockEndTagged(sleepEM2, (uint32_t)(uintptr_t)handle);
+#endif
+    }
+    return;
+  }
+
+  transfer       = &handle->queue[handle->queueTail % EMDRV_I2CDRV_QUEUE_SIZE];
+  handle->status = ECODE_EMDRV_I2CDRV_OK;
+  handle->offset = 0;
+
+  segment = transfer->txSegment;
+  if ( (transfer->type == i2cdrvTransferRead)
+       || (segment == 0) || (segment > transfer->txCount) ) {
+    segment = transfer->txCount;
+  }
+  handle->segmentEnd = (transfer->type == i2cdrvTransferRead) ? 0 : segment;
+
+  i2c->CMD = I2C_CMD_CLEARPC | I2C_CMD_CLEARTX;
+  if ( i2c->IF & I2C_IF_RXDATAV ) {
+    (void)i2c->RXDATA;
+  }
+  i2c->IFC = _I2C_IFC_MASK;
+  i2c->IEN = I2C_IEN_NACK | I2C_IEN_ACK | I2C_IEN_MSTOP
+             | I2C_IEN_RXDATAV | I2C_IF_ERRORS;
+
+  SendAddress(handle, transfer->type == i2cdrvTransferRead, false);
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Send STOP, the transaction completes when it is on the bus.
+ ******************************************************************************/
+static void Stop(I2CDRV_Handle_t handle, Ecode_t status)
+{
+  handle->status = status;
+  handle->state  = i2cdrvStateWFStopSent;
+  handle->initData.port->CMD = I2C_CMD_STOP;
+}
+
+#if defined(I2C0)
+void I2C0_IRQHandler(void)
+{
+  if ( i2cdrvHandle[0] != NULL ) {
+    I2cIrqHandler(i2cdrvHandle[0]);
+  }
+}
+#endif
+
+#if defined(I2C1)
+void I2C1_IRQHandler(void)
+{
+  if ( i2cdrvHandle[1] != NULL ) {
+    I2cIrqHandler(i2cdrvHandle[1]);
+  }
+}
+#endif
+
+/// @endcond
+
+/* *INDENT-OFF* */
+/******** THE REST OF THE FILE IS DOCUMENTATION ONLY !**********************//**
+ * @addtogroup emdrv
+ * @{
+ * @addtogroup I2CDRV
+ * @brief I2CDRV I2C Master Driver
+ * @{
+
+   @details
+   The source files for the I2C driver library, i2cdrv.c and i2cdrv.h, are in
+   the emdrv/i2cdrv folder.
+
+   @li @ref i2cdrv_intro
+   @li @ref i2cdrv_conf
+   @li @ref i2cdrv_api
+   @li @ref i2cdrv_example
+
+   @n @section i2cdrv_intro Introduction
+   The I2C driver runs single master I2C transactions on an I2C peripheral.
+   Transactions are queued per bus and run one after the other from the I2C
+   interrupt handler, the CPU is free or sleeping in EM1 while the bus is
+   busy. A callback is called when a transaction completes.
+
+   A transaction is a write, a read, or a write followed by a repeated START
+   and a read. A write can be split into segments that are each sent after a
+   repeated START and the slave address, so a run of register writes to a
+   device holds the bus from the first START to the last STOP.
+
+   @n @section i2cdrv_conf Configuration Options
+
+   Some properties of the I2CDRV driver are compile-time configurable. These
+   properties are stored in a file named @ref i2cdrv_config.h. A template for
+   this file, containing default values, is in the emdrv/i2cdrv/config folder.
+   Currently the configuration options are as follows:
+   @li The number of queued transactions per driver instance.
+   @li The segment length from which writes use DMA, or 0 for no DMA.
+   @li Blocking EM2 with the SLEEP driver while transactions are queued.
+
+   The properties of each I2C driver instance are set at run-time via the
+   @ref I2CDRV_Init_t data structure input parameter to the @ref I2CDRV_Init()
+   function.
+
+   @n @section i2cdrv_api The API
+
+   This section contains brief descriptions of the functions in the API. For
+   more information on input and output parameters and return values,
+   click on the hyperlinked function names. Most functions return an error
+   code, @ref ECODE_EMDRV_I2CDRV_OK is returned on success,
+   see @ref ecode.h and @ref i2cdrv.h for other error codes.
+
+   Your application code must include one header file: @em i2cdrv.h.
+
+   @ref I2CDRV_Init(), @ref I2CDRV_DeInit() @n
+    These functions initialize or deinitialize the I2CDRV driver. Typically,
+    @htmlonly I2CDRV_Init() @endhtmlonly is called once in your startup code.
+
+   @ref I2CDRV_QueueTransfer() @n
+    Queue a transaction, the callback is called when it is complete.
+
+   @ref I2CDRV_TransferB() @n
+    Queue a transaction and wait for it to complete.
+
+   @ref I2CDRV_AbortTransfers(), @ref I2CDRV_GetQueueCount() @n
+    Abort all transactions, or get the number of transactions not complete.
+
+   @n @section i2cdrv_example Example
+   @verbatim
+#include "i2cdrv.h"
+
+I2CDRV_HandleData_t handleData;
+I2CDRV_Handle_t handle = &handleData;
+
+// Three register writes to the slave at address 0x70, each register
+// address followed by its value, sent with repeated STARTs in between.
+static const uint8_t regs[] = { 0x00, 0x01, 0x01, 0x0F, 0x02, 0x80 };
+
+void callback(I2CDRV_Handle_t handle, Ecode_t transferStatus, void *userParam)
+{
+  if ( transferStatus == ECODE_EMDRV_I2CDRV_OK ) {
+    // Success !
+  }
+}
+
+int main(void)
+{
+  I2CDRV_Init_t initData = I2CDRV_MASTER_I2C0;
+  I2CDRV_Transfer_t transfer = {
+    0x70 << 1, i2cdrvTransferWrite, regs, sizeof(regs), 2,
+    NULL, 0, callback, NULL
+  };
+
+  // Initialize an I2C driver instance.
+  I2CDRV_Init(handle, &initData);
+
+  // Queue the register writes.
+  I2CDRV_QueueTransfer(handle, &transfer);
+}
+   @endverbatim
+
+ * @} end group I2CDRV ********************************************************
+ * @} end group emdrv ****************************************************/
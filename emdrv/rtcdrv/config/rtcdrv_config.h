@@ -37,6 +37,15 @@
 /// @brief Define to configure RTCDRV for LFRCO. The default is LFXO.
 //#define EMDRV_RTCDRV_USE_LFRCO
 
+/// @brief With EMDRV_NVIC_SECTIONS defined, the driver sections disable only
+/// the RTC interrupt. List here the other interrupts whose handlers call the
+/// RTCDRV API, e.g. X(GPIO_EVEN_IRQn, w), see @ref EMDRV_SECTION.
+/// SPIDRV slave transfers (EMDRV_SPIDRV_INCLUDE_SLAVE) stop their timer
+/// from the DMA completion callback and need X(DMA_IRQn, w).
+#ifndef EMDRV_RTCDRV_SECTION_EXTRA_IRQS
+#define EMDRV_RTCDRV_SECTION_EXTRA_IRQS(X, w)
+#endif
+
 /** @} (end addtogroup RTCDRV) */
 /** @} (end addtogroup emdrv) */
 
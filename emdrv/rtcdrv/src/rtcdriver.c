@@ -33,8 +33,13 @@
 #endif
 
 #include "rtcdriver.h"
+#include "emdrv_section.h"
+#include "emdrv_trace.h"
 #if defined(EMDRV_RTCDRV_SLEEPDRV_INTEGRATION)
 #include "sleep.h"
+
+// Requester of the RTCDRV sleep blocks in the SLEEP statistics.
+#define RTCDRV_SLEEP_TAG  SLEEP_TAG('R', 'T', 'C', 'D')
 #endif
 
 /// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
@@ -68,6 +73,7 @@
 #define RTC_INTDISABLE(x)           RTCC_IntDisable(x)
 #define RTC_INTENABLE(x)            RTCC_IntEnable(x)
 #define RTC_INTCLEAR(x)             RTCC_IntClear(x)
+#define RTC_INTSET(x)               RTCC_IntSet(x)
 #define RTC_INTGET()                RTCC_IntGetEnabled()
 #define RTC_COUNTERRESET()          RTCC->CNT = _RTCC_CNT_RESETVALUE
 #define RTC_COMPARESET(x)           RTCC_ChannelCCVSet(1, x)
@@ -75,6 +81,7 @@
 #define NVIC_CLEARPENDINGIRQ()      NVIC_ClearPendingIRQ(RTCC_IRQn)
 #define NVIC_DISABLEIRQ()           NVIC_DisableIRQ(RTCC_IRQn)
 #define NVIC_ENABLEIRQ()            NVIC_EnableIRQ(RTCC_IRQn)
+#define RTCDRV_IRQS(X, w)           X(RTCC_IRQn, w)
 #define RTC_ONESHOT_TICK_ADJUST     0
 
 #else
@@ -91,6 +98,7 @@
 #define RTC_INTDISABLE(x)           RTC_IntDisable(x)
 #define RTC_INTENABLE(x)            RTC_IntEnable(x)
 #define RTC_INTCLEAR(x)             RTC_IntClear(x)
+#define RTC_INTSET(x)               RTC_IntSet(x)
 #define RTC_INTGET()                RTC_IntGetEnabled()
 #define RTC_COUNTERRESET()          RTC_CounterReset()
 #define RTC_COMPARESET(x)           RTC_CompareSet(0, (x) & _RTC_COMP0_MASK)
@@ -98,10 +106,25 @@
 #define NVIC_CLEARPENDINGIRQ()      NVIC_ClearPendingIRQ(RTC_IRQn)
 #define NVIC_DISABLEIRQ()           NVIC_DisableIRQ(RTC_IRQn)
 #define NVIC_ENABLEIRQ()            NVIC_EnableIRQ(RTC_IRQn)
+#define RTCDRV_IRQS(X, w)           X(RTC_IRQn, w)
 #define RTC_ONESHOT_TICK_ADJUST     1
 
 #endif
 
+#if defined(EMDRV_NVIC_SECTIONS)
+// Interrupts touching the driver state: the RTC and the application
+// interrupts calling the driver.
+#if !defined(EMDRV_RTCDRV_SECTION_EXTRA_IRQS)
+#define EMDRV_RTCDRV_SECTION_EXTRA_IRQS(X, w)
+#endif
+#define RTCDRV_SECTION_IRQS(X, w) \
+  RTCDRV_IRQS(X, w)               \
+  EMDRV_RTCDRV_SECTION_EXTRA_IRQS(X, w)
+
+static const CORE_nvicMask_t sectionMask =
+  EMDRV_SECTION_MASK(RTCDRV_SECTION_IRQS);
+#endif
+
 // Maximum number of ticks per overflow period (not the maximum tick value)
 #define MAX_RTC_TICK_CNT              (RTC_MAX_VALUE + 1UL)
 #define RTC_CLOSE_TO_MAX_VALUE        (RTC_MAX_VALUE - 100UL)
@@ -229,11 +252,11 @@ static void rescheduleRtc(uint32_t rtcCnt);
  ******************************************************************************/
 Ecode_t RTCDRV_AllocateTimer(RTCDRV_TimerID_t *id)
 {
-  CORE_DECLARE_IRQ_STATE;
+  EMDRV_DECLARE_SECTION_STATE;
   int i      = 0;
   Ecode_t retVal = 0;
 
-  CORE_ENTER_ATOMIC();
+  EMDRV_ENTER_SECTION(&sectionMask);
   // Iterate through the table of the timers until the first available.
   while ( (i < EMDRV_RTCDRV_NUM_TIMERS) && (timer[i].allocated) ) {
     i++;
@@ -252,7 +275,7 @@ Ecode_t RTCDRV_AllocateTimer(RTCDRV_TimerID_t *id)
       retVal = ECODE_EMDRV_RTCDRV_PARAM_ERROR;
     }
   }
-  CORE_EXIT_ATOMIC();
+  EMDRV_EXIT_SECTION();
 
   return retVal;
 }
@@ -296,15 +319,17 @@ Ecode_t RTCDRV_Delay(uint32_t ms)
  ******************************************************************************/
 Ecode_t RTCDRV_FreeTimer(RTCDRV_TimerID_t id)
 {
+  EMDRV_DECLARE_SECTION_STATE;
+
   // Check if valid timer ID.
   if ( id >= EMDRV_RTCDRV_NUM_TIMERS ) {
     return ECODE_EMDRV_RTCDRV_ILLEGAL_TIMER_ID;
   }
 
-  CORE_ATOMIC_SECTION(
-    timer[id].running   = false;
-    timer[id].allocated = false;
-    )
+  EMDRV_ENTER_SECTION(&sectionMask);
+  timer[id].running   = false;
+  timer[id].allocated = false;
+  EMDRV_EXIT_SECTION();
 
   return ECODE_EMDRV_RTCDRV_OK;
 }
@@ -392,7 +417,7 @@ Ecode_t RTCDRV_Init(void)
 
 #if defined(EMODE_NEVER_ALLOW_EM3EM4)
   // Always block EM3 and EM4 if wallclock is running.
-  SLEEP_SleepBlockBegin(sleepEM3);
+  SLEEP_SleepBlockBeginTagged(sleepEM3, RTCDRV_SLEEP_TAG);
 #endif
 
 #endif
@@ -432,13 +457,13 @@ Ecode_t RTCDRV_DeInit(void)
 
 #if defined(EMODE_NEVER_ALLOW_EM3EM4)
   // End EM3 and EM4 blocking.
-  SLEEP_SleepBlockEnd(sleepEM3);
+  SLEEP_SleepBlockEndTagged(sleepEM3, RTCDRV_SLEEP_TAG);
 #endif
 
 #if defined(EMODE_DYNAMIC)
   // End EM3 and EM4 blocking if a block start has been set.
   if ( sleepBlocked ) {
-    SLEEP_SleepBlockEnd(sleepEM3);
+    SLEEP_SleepBlockEndTagged(sleepEM3, RTCDRV_SLEEP_TAG);
   }
 #endif
 
@@ -466,7 +491,7 @@ Ecode_t RTCDRV_DeInit(void)
  ******************************************************************************/
 Ecode_t RTCDRV_IsRunning(RTCDRV_TimerID_t id, bool *isRunning)
 {
-  CORE_DECLARE_IRQ_STATE;
+  EMDRV_DECLARE_SECTION_STATE;
 
   // Check if valid timer ID.
   if ( id >= EMDRV_RTCDRV_NUM_TIMERS ) {
@@ -478,14 +503,14 @@ Ecode_t RTCDRV_IsRunning(RTCDRV_TimerID_t id, bool *isRunning)
     return ECODE_EMDRV_RTCDRV_PARAM_ERROR;
   }
 
-  CORE_ENTER_ATOMIC();
+  EMDRV_ENTER_SECTION(&sectionMask);
   // Check if the timer is reserved.
   if ( !timer[id].allocated ) {
-    CORE_EXIT_ATOMIC();
+    EMDRV_EXIT_SECTION();
     return ECODE_EMDRV_RTCDRV_TIMER_NOT_ALLOCATED;
   }
   *isRunning = timer[id].running;
-  CORE_EXIT_ATOMIC();
+  EMDRV_EXIT_SECTION();
 
   return ECODE_EMDRV_RTCDRV_OK;
 }
@@ -517,7 +542,7 @@ Ecode_t RTCDRV_StartTimer(RTCDRV_TimerID_t id,
                           RTCDRV_Callback_t callback,
                           void *user)
 {
-  CORE_DECLARE_IRQ_STATE;
+  EMDRV_DECLARE_SECTION_STATE;
 
   uint32_t timeElapsed, cnt, compVal, loopCnt = 0;
   uint32_t timeToNextTimerCompletion;
@@ -527,9 +552,9 @@ Ecode_t RTCDRV_StartTimer(RTCDRV_TimerID_t id,
     return ECODE_EMDRV_RTCDRV_ILLEGAL_TIMER_ID;
   }
 
-  CORE_ENTER_ATOMIC();
+  EMDRV_ENTER_SECTION(&sectionMask);
   if ( !timer[id].allocated ) {
-    CORE_EXIT_ATOMIC();
+    EMDRV_EXIT_SECTION();
     return ECODE_EMDRV_RTCDRV_TIMER_NOT_ALLOCATED;
   }
 
@@ -537,7 +562,7 @@ Ecode_t RTCDRV_StartTimer(RTCDRV_TimerID_t id,
     if ( callback != NULL ) {
       callback(id, user);
     }
-    CORE_EXIT_ATOMIC();
+    EMDRV_EXIT_SECTION();
     return ECODE_EMDRV_RTCDRV_OK;
   }
 
@@ -563,7 +588,7 @@ Ecode_t RTCDRV_StartTimer(RTCDRV_TimerID_t id,
 
   if ( inTimerIRQ == true ) {
     // Exit now, remaining processing will be done in IRQ handler.
-    CORE_EXIT_ATOMIC();
+    EMDRV_EXIT_SECTION();
     return ECODE_EMDRV_RTCDRV_OK;
   }
 
@@ -591,7 +616,7 @@ Ecode_t RTCDRV_StartTimer(RTCDRV_TimerID_t id,
     // When RTC is running, EM3 or EM4 is not allowed.
     if ( sleepBlocked == false ) {
       sleepBlocked = true;
-      SLEEP_SleepBlockBegin(sleepEM3);
+      SLEEP_SleepBlockBeginTagged(sleepEM3, RTCDRV_SLEEP_TAG);
     }
 #endif
 
@@ -646,7 +671,7 @@ Ecode_t RTCDRV_StartTimer(RTCDRV_TimerID_t id,
     startTimerNestingLevel--;
   }
 
-  CORE_EXIT_ATOMIC();
+  EMDRV_EXIT_SECTION();
   return ECODE_EMDRV_RTCDRV_OK;
 }
 
@@ -663,21 +688,21 @@ Ecode_t RTCDRV_StartTimer(RTCDRV_TimerID_t id,
  ******************************************************************************/
 Ecode_t RTCDRV_StopTimer(RTCDRV_TimerID_t id)
 {
-  CORE_DECLARE_IRQ_STATE;
+  EMDRV_DECLARE_SECTION_STATE;
 
   // Check if valid timer ID.
   if ( id >= EMDRV_RTCDRV_NUM_TIMERS ) {
     return ECODE_EMDRV_RTCDRV_ILLEGAL_TIMER_ID;
   }
 
-  CORE_ENTER_ATOMIC();
+  EMDRV_ENTER_SECTION(&sectionMask);
   if ( !timer[id].allocated ) {
-    CORE_EXIT_ATOMIC();
+    EMDRV_EXIT_SECTION();
     return ECODE_EMDRV_RTCDRV_TIMER_NOT_ALLOCATED;
   }
 
   timer[id].running = false;
-  CORE_EXIT_ATOMIC();
+  EMDRV_EXIT_SECTION();
 
   return ECODE_EMDRV_RTCDRV_OK;
 }
@@ -700,7 +725,7 @@ Ecode_t RTCDRV_StopTimer(RTCDRV_TimerID_t id)
  ******************************************************************************/
 Ecode_t RTCDRV_TimeRemaining(RTCDRV_TimerID_t id, uint32_t *timeRemaining)
 {
-  CORE_DECLARE_IRQ_STATE;
+  EMDRV_DECLARE_SECTION_STATE;
   uint64_t ticksLeft;
   uint32_t currentCnt, lastRtcStart;
 
@@ -714,23 +739,23 @@ Ecode_t RTCDRV_TimeRemaining(RTCDRV_TimerID_t id, uint32_t *timeRemaining)
     return ECODE_EMDRV_RTCDRV_PARAM_ERROR;
   }
 
-  CORE_ENTER_ATOMIC();
+  EMDRV_ENTER_SECTION(&sectionMask);
   // Check if timer is reserved.
   if ( !timer[id].allocated ) {
-    CORE_EXIT_ATOMIC();
+    EMDRV_EXIT_SECTION();
     return ECODE_EMDRV_RTCDRV_TIMER_NOT_ALLOCATED;
   }
 
   // Check if timer is running.
   if ( !timer[id].running ) {
-    CORE_EXIT_ATOMIC();
+    EMDRV_EXIT_SECTION();
     return ECODE_EMDRV_RTCDRV_TIMER_NOT_RUNNING;
   }
 
   ticksLeft    = timer[id].remaining;
   currentCnt   = RTC_COUNTERGET();
   lastRtcStart = lastStart;
-  CORE_EXIT_ATOMIC();
+  EMDRV_EXIT_SECTION();
 
   // Get number of RTC clock ticks elapsed since last RTC reschedule.
   currentCnt = TIMEDIFF(currentCnt, lastRtcStart);
@@ -913,10 +938,11 @@ void RTC_IRQHandler(void)
 void RTCC_IRQHandler(void)
 #endif
 {
-  CORE_DECLARE_IRQ_STATE;
+  EMDRV_DECLARE_SECTION_STATE;
   uint32_t flags, timeElapsed, cnt, timeToNextTimerCompletion;
 
-  CORE_ENTER_ATOMIC();
+  EMDRV_TRACE_IRQ_ENTER();
+  EMDRV_ENTER_SECTION(&sectionMask);
 
   // CNT will normally be COMP0+1 at this point,
   // unless IRQ latency exceeded one tick period.
@@ -969,7 +995,8 @@ void RTCC_IRQHandler(void)
   }
 #endif
 
-  CORE_EXIT_ATOMIC();
+  EMDRV_EXIT_SECTION();
+  EMDRV_TRACE_IRQ_EXIT();
 }
 
 static void checkAllTimers(uint32_t timeElapsed)
@@ -1034,7 +1061,7 @@ static void checkAllTimers(uint32_t timeElapsed)
   // If no timers are running, remove block on EM3 and EM4 sleep modes.
   if ( (numOfTimersRunning == 0) && (sleepBlocked == true) ) {
     sleepBlocked = false;
-    SLEEP_SleepBlockEnd(sleepEM3);
+    SLEEP_SleepBlockEndTagged(sleepEM3, RTCDRV_SLEEP_TAG);
   }
 #endif
 }
@@ -1095,7 +1122,7 @@ static void rescheduleRtc(uint32_t rtcCnt)
     // When RTC is running, EM3 or EM4 are not allowed.
     if ( sleepBlocked == false ) {
       sleepBlocked = true;
-      SLEEP_SleepBlockBegin(sleepEM3);
+      SLEEP_SleepBlockBeginTagged(sleepEM3, RTCDRV_SLEEP_TAG);
     }
 #endif
 
@@ -1103,6 +1130,16 @@ static void rescheduleRtc(uint32_t rtcCnt)
 
     // Reenable compare IRQ.
     RTC_INTENABLE(RTC_COMP_INT);
+
+#if defined(EMDRV_NVIC_SECTIONS)
+    // Interrupts outside the section mask may have delayed this past the
+    // compare value, the compare would then only match after a wrap. The
+    // interrupt handler checks for this itself.
+    if ( (inTimerIRQ == false)
+         && (TIMEDIFF(RTC_COUNTERGET(), rtcCnt) >= min) ) {
+      RTC_INTSET(RTC_COMP_INT);
+    }
+#endif
   }
 }
 /// @endcond
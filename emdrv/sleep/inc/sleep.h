@@ -125,6 +125,46 @@ extern "C" {
  *   }
  *   @endcode
  *
+ *   @n @section sleepdrv_stats Energy Mode Statistics
+ *
+ *   With @ref SLEEP_STATS_ENABLED set to true, the module records how long
+ *   the MCU stays in each energy mode, which interrupts wake it up and which
+ *   code holds the sleep blocks. The statistics use a tick counter provided
+ *   by the application in @ref SLEEP_StatsInit(). The counter must keep
+ *   running in the energy modes used, e.g. the RTC in EM0 to EM2. A current
+ *   model given in the same call turns the residency into an estimated
+ *   average current, see @ref SLEEP_StatsAverageCurrentGet().
+ *
+ *   A sleep block is charged to the requester tag given to
+ *   @ref SLEEP_SleepBlockBeginTagged() until the
+ *   @ref SLEEP_SleepBlockEndTagged() with the same tag, so blocks of
+ *   different requesters can begin and end in any order. The blocks of
+ *   @ref SLEEP_SleepBlockBegin() share tag 0.
+ *
+ *   @code
+ *   static uint32_t ticks(void)
+ *   {
+ *     return RTC_CounterGet();
+ *   }
+ *
+ *   void main(void)
+ *   {
+ *     SLEEP_StatsInit_t statsConfig = {
+ *       .tickGet = ticks,
+ *       .tickMask = _RTC_CNT_MASK,
+ *       .currentUa = { 1500, 600, 2, 1, 0 }
+ *     };
+ *     SLEEP_Init(NULL, NULL);
+ *     SLEEP_StatsInit(&statsConfig);
+ *     while (true) {
+ *       SLEEP_Sleep();
+ *       if (SLEEP_StatsGet()->residencyTicks[sleepEM0] > LIMIT) {
+ *         printf("%lu uA\n", SLEEP_StatsAverageCurrentGet());
+ *       }
+ *     }
+ *   }
+ *   @endcode
+ *
  * @{
  ******************************************************************************/
 
@@ -143,6 +183,11 @@ extern "C" {
  * the sleep driver should go right back to sleep again. */
 #define SLEEP_FLAG_NO_CLOCK_RESTORE  0x1u
 
+/** Sleep block tag from four characters, readable in a memory view, see
+ *  @ref SLEEP_SleepBlockBeginTagged(). */
+#define SLEEP_TAG(a, b, c, d)  ((uint32_t)(a) | ((uint32_t)(b) << 8) \
+                                | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
 /*******************************************************************************
  ****************************   CONFIGURATION   ********************************
  ******************************************************************************/
@@ -168,6 +213,23 @@ extern "C" {
 #define SLEEP_LOWEST_ENERGY_MODE_DEFAULT    sleepEM3
 #endif
 
+/** Enable/disable energy mode residency, wakeup source and sleep block
+ *  requester statistics. */
+#ifndef SLEEP_STATS_ENABLED
+#define SLEEP_STATS_ENABLED                 false
+#endif
+
+/** Number of sleep block requesters (tag and energy mode) tracked by
+ *  the statistics. */
+#ifndef SLEEP_STATS_REQUESTERS
+#define SLEEP_STATS_REQUESTERS              8
+#endif
+
+/** Number of interrupt lines tracked as wakeup sources. */
+#ifndef SLEEP_STATS_WAKE_SOURCES
+#define SLEEP_STATS_WAKE_SOURCES            32
+#endif
+
 /*******************************************************************************
  ******************************   TYPEDEFS   ***********************************
  ******************************************************************************/
@@ -236,6 +298,63 @@ typedef struct {
   uint32_t (*restoreCallback)(SLEEP_EnergyMode_t emode);
 } SLEEP_Init_t;
 
+#if (SLEEP_STATS_ENABLED == true)
+/** Configuration of the energy mode statistics. */
+typedef struct {
+  /** Function returning a free running tick counter. If NULL, only the
+   *  number of entries and wakeups are counted. */
+  uint32_t (*tickGet)(void);
+
+  /** Mask of the valid counter bits, e.g. _RTC_CNT_MASK for a 24 bit RTC. */
+  uint32_t tickMask;
+
+  /** Current model, average current consumption in EM0 to EM4 [uA]. */
+  uint32_t currentUa[5];
+} SLEEP_StatsInit_t;
+
+/** Sleep block requester, the tag of @ref SLEEP_SleepBlockBeginTagged(). */
+typedef struct {
+  /** Requester tag, 0 for the blocks of @ref SLEEP_SleepBlockBegin(). */
+  uint32_t tag;
+
+  /** Energy mode blocked. */
+  SLEEP_EnergyMode_t eMode;
+
+  /** Number of blocks begun. */
+  uint32_t begins;
+
+  /** Number of blocks currently held. */
+  uint32_t held;
+
+  /** Time the requester held at least one block [ticks]. */
+  uint64_t heldTicks;
+
+  /** Tick counter when the requester started holding a block. */
+  uint32_t heldSince;
+} SLEEP_StatsRequester_t;
+
+/** Energy mode statistics. */
+typedef struct {
+  /** Time spent in EM0 to EM4 [ticks]. */
+  uint64_t residencyTicks[5];
+
+  /** Number of times EM1 to EM4 were entered, EM0 counts the wakeups. */
+  uint32_t entries[5];
+
+  /** Number of wakeups with the interrupt line pending. */
+  uint32_t wakeSource[SLEEP_STATS_WAKE_SOURCES];
+
+  /** Number of wakeups without a pending enabled interrupt. */
+  uint32_t wakeSourceUnknown;
+
+  /** Sleep block requesters, in order of first use. */
+  SLEEP_StatsRequester_t requester[SLEEP_STATS_REQUESTERS];
+
+  /** Number of blocks begun by requesters not fitting into the table. */
+  uint32_t requesterOverflow;
+} SLEEP_Stats_t;
+#endif
+
 /*******************************************************************************
  ******************************   PROTOTYPES   *********************************
  ******************************************************************************/
@@ -254,6 +373,20 @@ void SLEEP_SleepBlockBegin(SLEEP_EnergyMode_t eMode);
 
 void SLEEP_SleepBlockEnd(SLEEP_EnergyMode_t eMode);
 
+void SLEEP_SleepBlockBeginTagged(SLEEP_EnergyMode_t eMode, uint32_t tag);
+
+void SLEEP_SleepBlockEndTagged(SLEEP_EnergyMode_t eMode, uint32_t tag);
+
+#if (SLEEP_STATS_ENABLED == true)
+void SLEEP_StatsInit(const SLEEP_StatsInit_t * init);
+
+void SLEEP_StatsClear(void);
+
+const SLEEP_Stats_t * SLEEP_StatsGet(void);
+
+uint32_t SLEEP_StatsAverageCurrentGet(void);
+#endif
+
 /** @} (end addtogroup SLEEP) */
 /** @} (end addtogroup emdrv) */
 
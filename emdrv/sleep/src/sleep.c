@@ -16,6 +16,8 @@
  * SLEEP_Sleep()
  * SLEEP_SleepBlockBegin()
  * SLEEP_SleepBlockEnd()
+ * SLEEP_SleepBlockBeginTagged()
+ * SLEEP_SleepBlockEndTagged()
  * SLEEP_ForceSleepInEM4()
  *
  *******************************************************************************
@@ -38,6 +40,7 @@
 
 /* Module header file(s). */
 #include "sleep.h"
+#include "emdrv_trace.h"
 
 /* stdlib is needed for NULL definition */
 #include <stdlib.h>
@@ -93,6 +96,15 @@ static SLEEP_CbFuncPtr_t sleepCallback  = NULL;
  * - Max. number of sleep block nesting is 255. */
 static uint8_t sleepBlockCnt[SLEEP_NUMOF_LOW_ENERGY_MODES];
 
+#if (SLEEP_STATS_ENABLED == true)
+/* Statistics configuration and counters. */
+static SLEEP_StatsInit_t sleepStatsConfig = { 0 };
+static SLEEP_Stats_t sleepStats;
+
+/* Tick counter value at the last energy mode change. */
+static uint32_t sleepStatsLastTick = 0U;
+#endif
+
 /**
  * @brief
  *   This function is only used to keep the interface backwards compatible.
@@ -115,6 +127,15 @@ static bool sleepCallbackWrapper(SLEEP_EnergyMode_t emode)
 
 static SLEEP_EnergyMode_t enterEMx(SLEEP_EnergyMode_t eMode);
 
+#if (SLEEP_STATS_ENABLED == true)
+static uint32_t statsTickGet(void);
+static uint32_t statsElapsed(uint32_t now, uint32_t since);
+static void statsModeChange(SLEEP_EnergyMode_t from, SLEEP_EnergyMode_t to);
+static void statsWakeSource(void);
+static void statsBlockBegin(SLEEP_EnergyMode_t eMode, uint32_t tag);
+static bool statsBlockEnd(SLEEP_EnergyMode_t eMode, uint32_t tag);
+#endif
+
 /** @endcond */
 
 /*******************************************************************************
@@ -295,6 +316,31 @@ void SLEEP_ForceSleepInEM4(void)
  ******************************************************************************/
 void SLEEP_SleepBlockBegin(SLEEP_EnergyMode_t eMode)
 {
+  SLEEP_SleepBlockBeginTagged(eMode, 0U);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Begin sleep block in the requested energy mode for a tagged requester.
+ *
+ * @details
+ *   Same as @ref SLEEP_SleepBlockBegin(). The statistics charge the block to
+ *   the requester identified by tag until @ref SLEEP_SleepBlockEndTagged()
+ *   with the same tag ends it.
+ *
+ * @param[in] eMode
+ *   Energy mode to begin to block, sleepEM2 or sleepEM3.
+ *
+ * @param[in] tag
+ *   Requester of the block, e.g. the address of a driver handle or a
+ *   @ref SLEEP_TAG() code. Tag 0 collects the untagged blocks.
+ ******************************************************************************/
+void SLEEP_SleepBlockBeginTagged(SLEEP_EnergyMode_t eMode, uint32_t tag)
+{
+#if (SLEEP_STATS_ENABLED == false)
+  (void)tag;
+#endif
+
   EFM_ASSERT((eMode >= sleepEM2) && (eMode < sleepEM4));
   EFM_ASSERT((sleepBlockCnt[eMode - 2U]) < 255U);
 
@@ -302,6 +348,10 @@ void SLEEP_SleepBlockBegin(SLEEP_EnergyMode_t eMode)
     /* Increase the sleep block counter of the selected energy mode. */
     sleepBlockCnt[eMode - 2U]++;
 
+#if (SLEEP_STATS_ENABLED == true)
+    statsBlockBegin(eMode, tag);
+#endif
+
 #if (SLEEP_HW_LOW_ENERGY_BLOCK_ENABLED == true)
     /* Block EM2/EM3 sleep if the EM2 block begins. */
     if (eMode == sleepEM2) {
@@ -339,11 +389,45 @@ void SLEEP_SleepBlockBegin(SLEEP_EnergyMode_t eMode)
  ******************************************************************************/
 void SLEEP_SleepBlockEnd(SLEEP_EnergyMode_t eMode)
 {
+  SLEEP_SleepBlockEndTagged(eMode, 0U);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   End sleep block in the requested energy mode for a tagged requester.
+ *
+ * @details
+ *   Same as @ref SLEEP_SleepBlockEnd(), ending a block begun with
+ *   @ref SLEEP_SleepBlockBeginTagged() and the same tag. With
+ *   @ref SLEEP_STATS_ENABLED an end for a tag that holds no block asserts
+ *   and is ignored.
+ *
+ * @param[in] eMode
+ *   Energy mode to end to block, sleepEM2 or sleepEM3.
+ *
+ * @param[in] tag
+ *   Requester of the block, as given when it began.
+ ******************************************************************************/
+void SLEEP_SleepBlockEndTagged(SLEEP_EnergyMode_t eMode, uint32_t tag)
+{
+#if (SLEEP_STATS_ENABLED == false)
+  (void)tag;
+#endif
+
   EFM_ASSERT((eMode >= sleepEM2) && (eMode < sleepEM4));
 
   if ((eMode == sleepEM2) || (eMode == sleepEM3)) {
+    /* An end without a block held, by anyone or with statistics by this
+     * tag, is ignored. It would release the block of another requester. */
+    bool held = (sleepBlockCnt[eMode - 2U] > 0U);
+
+#if (SLEEP_STATS_ENABLED == true)
+    held = held && statsBlockEnd(eMode, tag);
+#endif
+    EFM_ASSERT(held);
+
     /* Decrease the sleep block counter of the selected energy mode. */
-    if (sleepBlockCnt[eMode - 2U] > 0U) {
+    if (held) {
       sleepBlockCnt[eMode - 2U]--;
     }
 
@@ -390,6 +474,114 @@ SLEEP_EnergyMode_t SLEEP_LowestEnergyModeGet(void)
   return tmpLowestEM;
 }
 
+#if (SLEEP_STATS_ENABLED == true)
+/***************************************************************************//**
+ * @brief
+ *   Initialize and start the energy mode statistics.
+ *
+ * @details
+ *   All counters are cleared. Time in EM0 is counted from this call on.
+ *
+ * @param[in] init
+ *   Pointer to the statistics configuration, containing the tick counter
+ *   and the current model.
+ ******************************************************************************/
+void SLEEP_StatsInit(const SLEEP_StatsInit_t * init)
+{
+  sleepStatsConfig = *init;
+  SLEEP_StatsClear();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Clear all energy mode statistics counters.
+ ******************************************************************************/
+void SLEEP_StatsClear(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  uint32_t i;
+
+  CORE_ENTER_CRITICAL();
+  sleepStatsLastTick = statsTickGet();
+  for (i = 0U; i < 5U; i++) {
+    sleepStats.residencyTicks[i] = 0U;
+    sleepStats.entries[i] = 0U;
+  }
+  for (i = 0U; i < SLEEP_STATS_WAKE_SOURCES; i++) {
+    sleepStats.wakeSource[i] = 0U;
+  }
+  sleepStats.wakeSourceUnknown = 0U;
+
+  /* Keep the requesters holding blocks, restart their hold time. */
+  for (i = 0U; i < SLEEP_STATS_REQUESTERS; i++) {
+    sleepStats.requester[i].begins = 0U;
+    sleepStats.requester[i].heldTicks = 0U;
+    sleepStats.requester[i].heldSince = sleepStatsLastTick;
+  }
+  sleepStats.requesterOverflow = 0U;
+  CORE_EXIT_CRITICAL();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get the energy mode statistics.
+ *
+ * @details
+ *   The EM0 residency and the hold time of held sleep blocks are brought up
+ *   to date before returning. The counters keep being updated in place.
+ *
+ * @return
+ *   Pointer to the statistics counters.
+ ******************************************************************************/
+const SLEEP_Stats_t * SLEEP_StatsGet(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  uint32_t now;
+  uint32_t i;
+
+  CORE_ENTER_CRITICAL();
+  now = statsTickGet();
+  for (i = 0U; i < SLEEP_STATS_REQUESTERS; i++) {
+    if (sleepStats.requester[i].held > 0U) {
+      sleepStats.requester[i].heldTicks +=
+        statsElapsed(now, sleepStats.requester[i].heldSince);
+      sleepStats.requester[i].heldSince = now;
+    }
+  }
+  statsModeChange(sleepEM0, sleepEM0);
+  CORE_EXIT_CRITICAL();
+
+  return &sleepStats;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Estimate the average current consumption.
+ *
+ * @details
+ *   The time spent in each energy mode is weighted with the current model
+ *   given in @ref SLEEP_StatsInit().
+ *
+ * @return
+ *   Estimated average current since the statistics were cleared [uA], 0 if
+ *   no time has been recorded.
+ ******************************************************************************/
+uint32_t SLEEP_StatsAverageCurrentGet(void)
+{
+  const SLEEP_Stats_t *stats = SLEEP_StatsGet();
+  uint64_t charge = 0U;
+  uint64_t time = 0U;
+  uint32_t i;
+
+  for (i = 0U; i < 5U; i++) {
+    charge += stats->residencyTicks[i] * sleepStatsConfig.currentUa[i];
+    time += stats->residencyTicks[i];
+  }
+
+  return (time > 0U) ? (uint32_t)(charge / time) : 0U;
+}
+#endif
+
 /** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
 
 /***************************************************************************//**
@@ -423,6 +615,12 @@ static SLEEP_EnergyMode_t enterEMx(SLEEP_EnergyMode_t eMode)
     return sleepEM0;
   }
 
+  EMDRV_TRACE_SLEEP(eMode);
+
+#if (SLEEP_STATS_ENABLED == true)
+  statsModeChange(sleepEM0, eMode);
+#endif
+
   /* Enter the requested energy mode. */
   switch (eMode) {
     case sleepEM1:
@@ -446,6 +644,13 @@ static SLEEP_EnergyMode_t enterEMx(SLEEP_EnergyMode_t eMode)
       break;
   }
 
+  EMDRV_TRACE_WAKE(eMode);
+
+#if (SLEEP_STATS_ENABLED == true)
+  statsModeChange(eMode, sleepEM0);
+  statsWakeSource();
+#endif
+
   /* Call the callback after waking up from sleep. */
   if (NULL != sleepContext.wakeupCallback) {
     sleepContext.wakeupCallback(eMode);
@@ -453,6 +658,122 @@ static SLEEP_EnergyMode_t enterEMx(SLEEP_EnergyMode_t eMode)
 
   return eMode;
 }
+
+#if (SLEEP_STATS_ENABLED == true)
+/* Read the statistics tick counter, 0 if there is none. */
+static uint32_t statsTickGet(void)
+{
+  if (NULL == sleepStatsConfig.tickGet) {
+    return 0U;
+  }
+  return sleepStatsConfig.tickGet() & sleepStatsConfig.tickMask;
+}
+
+/* Ticks between two counter values, handling counter wrap. */
+static uint32_t statsElapsed(uint32_t now, uint32_t since)
+{
+  return (now - since) & sleepStatsConfig.tickMask;
+}
+
+/* Add the time since the last change to the energy mode left and count
+ * the entry of the new one. Called with interrupts disabled. */
+static void statsModeChange(SLEEP_EnergyMode_t from, SLEEP_EnergyMode_t to)
+{
+  uint32_t now = statsTickGet();
+
+  sleepStats.residencyTicks[from] += statsElapsed(now, sleepStatsLastTick);
+  sleepStatsLastTick = now;
+  if (from != to) {
+    sleepStats.entries[to]++;
+  }
+}
+
+/* Count the interrupts pending at wakeup. Interrupts are still disabled, so
+ * these are the interrupts that woke up the core. */
+static void statsWakeSource(void)
+{
+  uint32_t pending = NVIC->ISPR[0] & NVIC->ISER[0];
+  uint32_t i;
+
+  if (0U == pending) {
+    sleepStats.wakeSourceUnknown++;
+    return;
+  }
+  for (i = 0U; i < SLEEP_STATS_WAKE_SOURCES; i++) {
+    if (pending & (1UL << i)) {
+      sleepStats.wakeSource[i]++;
+    }
+  }
+}
+
+/* Find the requester entry of tag and eMode, taking a free entry if add is
+ * set. NULL if there is none. Called with interrupts disabled. */
+static SLEEP_StatsRequester_t *statsRequester(SLEEP_EnergyMode_t eMode,
+                                              uint32_t tag, bool add)
+{
+  SLEEP_StatsRequester_t *req;
+  uint32_t i;
+
+  for (i = 0U; i < SLEEP_STATS_REQUESTERS; i++) {
+    req = &sleepStats.requester[i];
+    if ((req->tag == tag) && (req->eMode == eMode)) {
+      return req;
+    }
+    /* Free entries are at the end of the table. */
+    if (req->eMode == sleepEM0) {
+      if (!add) {
+        return NULL;
+      }
+      req->tag = tag;
+      req->eMode = eMode;
+      return req;
+    }
+  }
+  return NULL;
+}
+
+/* Count a sleep block for its requester and start its hold time. */
+static void statsBlockBegin(SLEEP_EnergyMode_t eMode, uint32_t tag)
+{
+  CORE_DECLARE_IRQ_STATE;
+  SLEEP_StatsRequester_t *req;
+
+  CORE_ENTER_CRITICAL();
+  req = statsRequester(eMode, tag, true);
+  if (NULL == req) {
+    sleepStats.requesterOverflow++;
+  } else {
+    req->begins++;
+    if (0U == req->held++) {
+      req->heldSince = statsTickGet();
+    }
+  }
+  CORE_EXIT_CRITICAL();
+}
+
+/* End a sleep block of the requester that began it. Returns false if the
+ * tag holds no block. A requester that did not fit into the table is not
+ * known, its end is accepted while any requester overflowed. */
+static bool statsBlockEnd(SLEEP_EnergyMode_t eMode, uint32_t tag)
+{
+  CORE_DECLARE_IRQ_STATE;
+  SLEEP_StatsRequester_t *req;
+  bool held;
+
+  CORE_ENTER_CRITICAL();
+  req = statsRequester(eMode, tag, false);
+  if (NULL == req) {
+    held = (sleepStats.requesterOverflow > 0U);
+  } else {
+    held = (req->held > 0U);
+    if (held && (0U == --req->held)) {
+      req->heldTicks += statsElapsed(statsTickGet(), req->heldSince);
+    }
+  }
+  CORE_EXIT_CRITICAL();
+  return held;
+}
+#endif
 /** @endcond */
 
 /** @} (end addtogroup SLEEP */
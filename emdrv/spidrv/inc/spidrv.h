@@ -50,6 +50,11 @@ extern "C" {
 #define ECODE_EMDRV_SPIDRV_ABORTED           (ECODE_EMDRV_SPIDRV_BASE | 0x00000007)   ///< An SPI transfer has been aborted.
 #define ECODE_EMDRV_SPIDRV_MODE_ERROR        (ECODE_EMDRV_SPIDRV_BASE | 0x00000008)   ///< SPI master used slave API or vica versa.
 #define ECODE_EMDRV_SPIDRV_DMA_ALLOC_ERROR   (ECODE_EMDRV_SPIDRV_BASE | 0x00000009)   ///< Unable to allocate DMA channels.
+#define ECODE_EMDRV_SPIDRV_QUEUE_FULL        (ECODE_EMDRV_SPIDRV_BASE | 0x0000000A)   ///< The SPI transaction queue is full.
+
+#if !defined(EMDRV_SPIDRV_QUEUE_SIZE)
+#define EMDRV_SPIDRV_QUEUE_SIZE 0
+#endif
 
 /// SPI driver instance type.
 typedef enum SPIDRV_Type{
@@ -135,6 +140,66 @@ typedef struct SPIDRV_Init{
   SPIDRV_SlaveStart_t slaveStartMode;   ///< A slave mode transfer start scheme.
 } SPIDRV_Init_t;
 
+/// A segment of a chained SPI master transfer.
+/// An array of segments is passed to @ref SPIDRV_MTransferChainB(), which
+/// transfers all segments back to back while keeping CS asserted.
+typedef struct SPIDRV_Segment{
+  const void          *txBuffer;        ///< Transmit data buffer, NULL to transmit @ref SPIDRV_Init_t.dummyTxValue.
+  void                *rxBuffer;        ///< Receive data buffer, NULL to discard received data.
+  int                 count;            ///< Number of items (frames) in the segment.
+} SPIDRV_Segment_t;
+
+#if (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+/***************************************************************************//**
+ * @brief
+ *  SPIDRV queued transaction completion callback function.
+ *
+ * @details
+ *  Called from the DMA interrupt handler when a transaction queued with
+ *  @ref SPIDRV_MQueueTransfer() is complete or has been aborted.
+ *
+ * @param[in] handle
+ *   The SPIDRV device handle the transaction was queued on.
+ *
+ * @param[in] transferStatus
+ *   @ref ECODE_EMDRV_SPIDRV_OK on success, @ref ECODE_EMDRV_SPIDRV_ABORTED
+ *   if the transaction was aborted.
+ *
+ * @param[in] itemsTransferred
+ *   A number of items (frames) transferred.
+ *
+ * @param[in] userParam
+ *   The @ref SPIDRV_Transaction_t.userParam of the transaction.
+ ******************************************************************************/
+typedef void (*SPIDRV_TransactionCallback_t)(struct SPIDRV_HandleData *handle,
+                                             Ecode_t transferStatus,
+                                             int itemsTransferred,
+                                             void *userParam);
+
+/// An SPI master transaction descriptor for @ref SPIDRV_MQueueTransfer().
+/// The descriptor is copied into the driver instance when queued.
+typedef struct SPIDRV_Transaction{
+  const void          *txBuffer;        ///< Transmit data buffer, NULL to transmit @ref SPIDRV_Init_t.dummyTxValue.
+  void                *rxBuffer;        ///< Receive data buffer, NULL to discard received data.
+  int                 count;            ///< Number of items (frames) in the transaction.
+  int                 csPort;           ///< CS pin port, used when CS is controlled by the application.
+  int                 csPin;            ///< CS pin number, used when CS is controlled by the application.
+  uint32_t            bitRate;          ///< Bitrate for this transaction, 0 uses the instance bitrate.
+  uint32_t            frameLength;      ///< Framelength for this transaction, 0 uses the instance framelength.
+  uint8_t             priority;         ///< Transaction priority, 0 is highest.
+  SPIDRV_TransactionCallback_t callback; ///< Completion callback, may be NULL.
+  void                *userParam;       ///< User parameter passed to the callback.
+} SPIDRV_Transaction_t;
+
+/// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
+typedef struct SPIDRV_QueueSlot{
+  SPIDRV_Transaction_t transaction;
+  uint16_t            sequence;
+  volatile enum { spidrvSlotFree = 0, spidrvSlotPending = 1, spidrvSlotActive = 2 } state;
+} SPIDRV_QueueSlot_t;
+/// @endcond
+#endif
+
 /// An SPI driver instance handle data structure.
 /// The handle is allocated by the application using the SPIDRV.
 /// Several concurrent driver instances can exist in an application. The application is
@@ -156,6 +221,15 @@ typedef struct SPIDRV_HandleData{
   volatile enum { spidrvStateIdle = 0, spidrvStateTransferring = 1 } state;
   CMU_Clock_TypeDef   usartClock;
   volatile bool       blockingCompleted;
+  const SPIDRV_Segment_t *chainSegment;
+  int                 chainRemaining;
+#if (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+  SPIDRV_QueueSlot_t  queue[EMDRV_SPIDRV_QUEUE_SIZE];
+  SPIDRV_QueueSlot_t  *queueActive;
+  uint16_t            queueSequence;
+  uint32_t            queueClkDiv;
+  uint32_t            queueFrame;
+#endif
 
   #if defined(EMDRV_SPIDRV_INCLUDE_SLAVE)
   RTCDRV_TimerID_t timer;
@@ -705,6 +779,13 @@ Ecode_t   SPIDRV_GetTransferStatus(SPIDRV_Handle_t handle,
 Ecode_t   SPIDRV_Init(SPIDRV_Handle_t handle,
                       SPIDRV_Init_t *initData);
 
+#if (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+Ecode_t   SPIDRV_MQueueTransfer(SPIDRV_Handle_t handle,
+                                const SPIDRV_Transaction_t *transaction);
+
+Ecode_t   SPIDRV_QueueResume(SPIDRV_Handle_t handle);
+#endif
+
 Ecode_t   SPIDRV_MReceive(SPIDRV_Handle_t handle,
                           void *buffer,
                           int count,
@@ -729,6 +810,10 @@ Ecode_t   SPIDRV_MTransferSingleItemB(SPIDRV_Handle_t handle,
                                       uint32_t txValue,
                                       void *rxValue);
 
+Ecode_t   SPIDRV_MTransferChainB(SPIDRV_Handle_t handle,
+                                 const SPIDRV_Segment_t *segments,
+                                 int segmentCount);
+
 Ecode_t   SPIDRV_MTransmit(SPIDRV_Handle_t handle,
                            const void *buffer,
                            int count,
@@ -22,6 +22,9 @@
 
 #include "dmadrv.h"
 #include "spidrv.h"
+#if defined(EMDRV_SPIDRV_BLOCKING_SLEEP)
+#include "sleep.h"
+#endif
 
 /// @cond DO_NOT_INCLUDE_WITH_DOXYGEN
 
@@ -41,8 +44,24 @@ static void     BlockingComplete(SPIDRV_Handle_t handle,
                                  Ecode_t transferStatus,
                                  int itemsTransferred);
 
+static void     ChainComplete(SPIDRV_Handle_t handle,
+                              Ecode_t transferStatus,
+                              int itemsTransferred);
+
+static void     ChainCsControl(SPIDRV_Handle_t handle, bool assert);
+
 static Ecode_t  ConfigGPIO(SPIDRV_Handle_t handle, bool enable);
 
+#if (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+static void     QueueComplete(SPIDRV_Handle_t handle,
+                              Ecode_t transferStatus,
+                              int itemsTransferred);
+
+static void     QueueResume(SPIDRV_Handle_t handle);
+
+static void     QueueStartNext(SPIDRV_Handle_t handle);
+#endif
+
 static bool     RxDMAComplete(unsigned int channel,
                               unsigned int sequenceNo,
                               void *userParam);
@@ -52,6 +71,12 @@ static void     SlaveTimeout(RTCDRV_TimerID_t id,
                              void *user);
 #endif
 
+static void     StartSegmentDMA(SPIDRV_Handle_t handle,
+                                const void *txBuffer,
+                                void *rxBuffer,
+                                int count,
+                                SPIDRV_Callback_t callback);
+
 static void     StartReceiveDMA(SPIDRV_Handle_t handle,
                                 void *buffer,
                                 int count,
@@ -339,6 +364,7 @@ Ecode_t SPIDRV_DeInit(SPIDRV_Handle_t handle)
  ******************************************************************************/
 Ecode_t SPIDRV_AbortTransfer(SPIDRV_Handle_t handle)
 {
+  SPIDRV_Callback_t callback;
   CORE_DECLARE_IRQ_STATE;
 
   if ( handle == NULL ) {
@@ -366,11 +392,22 @@ Ecode_t SPIDRV_AbortTransfer(SPIDRV_Handle_t handle)
   handle->transferStatus    = ECODE_EMDRV_SPIDRV_ABORTED;
   handle->blockingCompleted = true;
 
-  if ( handle->userCallback != NULL ) {
-    handle->userCallback(handle,
-                         ECODE_EMDRV_SPIDRV_ABORTED,
-                         handle->transferCount - handle->remaining);
+  callback = handle->userCallback;
+  if ( callback != NULL ) {
+    callback(handle,
+             ECODE_EMDRV_SPIDRV_ABORTED,
+             handle->transferCount - handle->remaining);
+  }
+
+#if (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+  // Queued transactions start the next one themselves, blocking transfers
+  // when the caller is done with CS.
+  if ( (callback != QueueComplete)
+       && (callback != BlockingComplete)
+       && (callback != ChainComplete) ) {
+    QueueResume(handle);
   }
+#endif
   CORE_EXIT_ATOMIC();
 
   return ECODE_EMDRV_SPIDRV_OK;
@@ -476,6 +513,131 @@ Ecode_t SPIDRV_GetTransferStatus(SPIDRV_Handle_t handle,
   return ECODE_EMDRV_SPIDRV_OK;
 }
 
+#if (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+/***************************************************************************//**
+ * @brief
+ *    Queue an SPI master transaction.
+ *
+ * @details
+ *    The transaction descriptor is copied into one of the
+ *    @ref EMDRV_SPIDRV_QUEUE_SIZE preallocated slots of the driver instance.
+ *    If the bus is idle the transaction is started immediately, otherwise it
+ *    is started from the DMA interrupt handler when the bus becomes idle.
+ *    Pending transactions are started in priority order and in queue order
+ *    within the same priority. A running transaction is never preempted.
+ *
+ * @note
+ *    When the driver instance uses @ref spidrvCsControlApplication, the
+ *    driver drives the transaction's CS pin low for the duration of the
+ *    transaction. The CS pins must be configured as push-pull outputs, set
+ *    high, by the application. With @ref spidrvCsControlAuto the CS fields
+ *    are ignored.
+ *    @n A non-queued transfer function called while a queued transaction is
+ *    running returns @ref ECODE_EMDRV_SPIDRV_BUSY as before.
+ *    @n Pending transactions are not started while a non-queued transfer is
+ *    running. With @ref spidrvCsControlApplication they are not started when
+ *    it ends either, call @ref SPIDRV_QueueResume() after releasing CS.
+ *    @n @ref SPIDRV_AbortTransfer() aborts the running transaction only;
+ *    pending transactions are started afterwards.
+ *
+ * @param[in] handle Pointer to an SPI driver handle.
+ *
+ * @param[in] transaction Transaction descriptor.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_SPIDRV_OK on success, @ref ECODE_EMDRV_SPIDRV_QUEUE_FULL
+ *    if all slots are in use. On failure, an appropriate SPIDRV @ref Ecode_t
+ *    is returned.
+ ******************************************************************************/
+Ecode_t SPIDRV_MQueueTransfer(SPIDRV_Handle_t handle,
+                              const SPIDRV_Transaction_t *transaction)
+{
+  int i;
+  SPIDRV_QueueSlot_t *slot = NULL;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ( handle == NULL ) {
+    return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+  }
+
+  if ( handle->initData.type == spidrvSlave ) {
+    return ECODE_EMDRV_SPIDRV_MODE_ERROR;
+  }
+
+  if ( (transaction == NULL)
+       || ((transaction->txBuffer == NULL) && (transaction->rxBuffer == NULL))
+       || (transaction->count <= 0)
+       || (transaction->count > DMADRV_MAX_XFER_COUNT) ) {
+    return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+  }
+
+  if ( (transaction->frameLength != 0)
+       && ((transaction->frameLength < 4) || (transaction->frameLength > 16)) ) {
+    return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+  }
+
+  CORE_ENTER_ATOMIC();
+  for ( i = 0; i < EMDRV_SPIDRV_QUEUE_SIZE; i++ ) {
+    if ( handle->queue[i].state == spidrvSlotFree ) {
+      slot = &handle->queue[i];
+      break;
+    }
+  }
+
+  if ( slot == NULL ) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_SPIDRV_QUEUE_FULL;
+  }
+
+  slot->transaction = *transaction;
+  slot->sequence    = handle->queueSequence++;
+  slot->state       = spidrvSlotPending;
+
+  if ( handle->state == spidrvStateIdle ) {
+    QueueStartNext(handle);
+  }
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_SPIDRV_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Start pending queued transactions after non-queued transfers.
+ *
+ * @details
+ *    With @ref spidrvCsControlApplication, call this function when CS of a
+ *    non-queued transfer has been released. Pending transactions are not
+ *    started before, so that two devices are never selected at once.
+ *    With @ref spidrvCsControlAuto the driver does this itself.
+ *
+ * @param[in] handle Pointer to an SPI driver handle.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_SPIDRV_OK on success, @ref ECODE_EMDRV_SPIDRV_BUSY if a
+ *    transfer is running. On failure, an appropriate SPIDRV @ref Ecode_t is
+ *    returned.
+ ******************************************************************************/
+Ecode_t SPIDRV_QueueResume(SPIDRV_Handle_t handle)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if ( handle == NULL ) {
+    return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if ( handle->state != spidrvStateIdle ) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_SPIDRV_BUSY;
+  }
+  QueueStartNext(handle);
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_SPIDRV_OK;
+}
+#endif
+
 /***************************************************************************//**
  * @brief
  *    Start an SPI master receive transfer.
@@ -650,6 +812,84 @@ Ecode_t SPIDRV_MTransferB(SPIDRV_Handle_t handle,
   return handle->transferStatus;
 }
 
+/***************************************************************************//**
+ * @brief
+ *    Start an SPI master blocking chained transfer.
+ *
+ * @details
+ *    All segments are transferred back to back as one bus transaction. The
+ *    next segment is started from the DMA completion interrupt of the
+ *    previous one, and CS is kept asserted until the last segment is done.
+ *    A typical use is a command header followed by a payload in a separate
+ *    buffer, without copying both into one buffer first.
+ *
+ * @note
+ *    This function is blocking and returns when all segments are transferred
+ *    or when @ref SPIDRV_AbortTransfer() is called.
+ *    @n If CS is controlled by the driver, the CS pin is driven as a GPIO for
+ *    the duration of the chain. If CS is controlled by the application, the
+ *    application must assert CS before calling this function.
+ *
+ * @param[in] handle Pointer to an SPI driver handle.
+ *
+ * @param[in] segments Array of transfer segments. The array must remain
+ *                     valid until the function returns.
+ *
+ * @param[in] segmentCount Number of segments in the array.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_SPIDRV_OK on success or @ref ECODE_EMDRV_SPIDRV_ABORTED
+ *    if @ref SPIDRV_AbortTransfer() has been called. On failure, an appropriate
+ *    SPIDRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t SPIDRV_MTransferChainB(SPIDRV_Handle_t handle,
+                               const SPIDRV_Segment_t *segments,
+                               int segmentCount)
+{
+  int i;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ( handle == NULL ) {
+    return ECODE_EMDRV_SPIDRV_ILLEGAL_HANDLE;
+  }
+
+  if ( handle->initData.type == spidrvSlave ) {
+    return ECODE_EMDRV_SPIDRV_MODE_ERROR;
+  }
+
+  if ( (segments == NULL) || (segmentCount <= 0) ) {
+    return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+  }
+
+  for ( i = 0; i < segmentCount; i++ ) {
+    if ( ((segments[i].txBuffer == NULL) && (segments[i].rxBuffer == NULL))
+         || (segments[i].count <= 0)
+         || (segments[i].count > DMADRV_MAX_XFER_COUNT) ) {
+      return ECODE_EMDRV_SPIDRV_PARAM_ERROR;
+    }
+  }
+
+  CORE_ENTER_ATOMIC();
+  if ( handle->state != spidrvStateIdle ) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_SPIDRV_BUSY;
+  }
+  handle->state = spidrvStateTransferring;
+  CORE_EXIT_ATOMIC();
+
+  handle->chainSegment   = segments;
+  handle->chainRemaining = segmentCount - 1;
+
+  ChainCsControl(handle, true);
+
+  StartSegmentDMA(handle, segments->txBuffer, segments->rxBuffer,
+                  segments->count, ChainComplete);
+
+  WaitForTransferCompletion(handle);
+
+  return handle->transferStatus;
+}
+
 /***************************************************************************//**
  * @brief
  *    Start an SPI master blocking single item (frame) transfer.
@@ -1241,6 +1481,195 @@ static void BlockingComplete(SPIDRV_Handle_t handle,
   handle->blockingCompleted = true;
 }
 
+/***************************************************************************//**
+ * @brief
+ *    Transfer complete callback function used by @ref SPIDRV_MTransferChainB().
+ *    Starts the next segment of the chain, or releases CS and completes the
+ *    blocking transfer when the chain is done or has failed.
+ ******************************************************************************/
+static void ChainComplete(SPIDRV_Handle_t handle,
+                          Ecode_t transferStatus,
+                          int itemsTransferred)
+{
+  if ( (transferStatus == ECODE_EMDRV_SPIDRV_OK)
+       && (handle->chainRemaining > 0) ) {
+    handle->chainRemaining--;
+    handle->chainSegment++;
+    handle->state = spidrvStateTransferring;
+    StartSegmentDMA(handle,
+                    handle->chainSegment->txBuffer,
+                    handle->chainSegment->rxBuffer,
+                    handle->chainSegment->count,
+                    ChainComplete);
+  } else {
+    handle->chainRemaining = 0;
+    ChainCsControl(handle, false);
+    BlockingComplete(handle, transferStatus, itemsTransferred);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Take over (assert) or give back (deassert) a driver controlled CS pin
+ *    for the duration of a chained transfer. With AUTOCS the USART would
+ *    deassert CS between segments.
+ ******************************************************************************/
+static void ChainCsControl(SPIDRV_Handle_t handle, bool assert)
+{
+  USART_TypeDef *port = handle->initData.port;
+
+  if ( handle->initData.csControl != spidrvCsControlAuto ) {
+    return;
+  }
+
+  if ( assert ) {
+    GPIO_PinOutClear((GPIO_Port_TypeDef)handle->csPort, handle->csPin);
+    port->CTRL &= ~USART_CTRL_AUTOCS;
+#if defined(USART_ROUTEPEN_CSPEN)
+    port->ROUTEPEN &= ~USART_ROUTEPEN_CSPEN;
+#else
+    port->ROUTE &= ~USART_ROUTE_CSPEN;
+#endif
+  } else {
+    GPIO_PinOutSet((GPIO_Port_TypeDef)handle->csPort, handle->csPin);
+    port->CTRL |= USART_CTRL_AUTOCS;
+#if defined(USART_ROUTEPEN_CSPEN)
+    port->ROUTEPEN |= USART_ROUTEPEN_CSPEN;
+#else
+    port->ROUTE |= USART_ROUTE_CSPEN;
+#endif
+  }
+}
+
+#if (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+/***************************************************************************//**
+ * @brief
+ *    Transfer complete callback function used by queued transactions.
+ *    Releases CS and the queue slot, restores the instance bitrate and
+ *    framelength and calls the transaction callback. Then starts the next
+ *    pending transaction, unless the callback started a transfer of its own.
+ *    Called by the DMA interrupt handler or @ref SPIDRV_AbortTransfer() with
+ *    interrupts disabled.
+ ******************************************************************************/
+static void QueueComplete(SPIDRV_Handle_t handle,
+                          Ecode_t transferStatus,
+                          int itemsTransferred)
+{
+  SPIDRV_QueueSlot_t *slot = handle->queueActive;
+  SPIDRV_TransactionCallback_t callback;
+  USART_TypeDef *port = handle->initData.port;
+  void *userParam;
+
+  if ( slot == NULL ) {
+    return;
+  }
+
+  if ( handle->initData.csControl == spidrvCsControlApplication ) {
+    GPIO_PinOutSet((GPIO_Port_TypeDef)slot->transaction.csPort,
+                   slot->transaction.csPin);
+  }
+
+  // Free the slot before the callback so that it can queue a new transaction.
+  callback            = slot->transaction.callback;
+  userParam           = slot->transaction.userParam;
+  handle->queueActive = NULL;
+  slot->state         = spidrvSlotFree;
+
+  // Later non-queued transfers run with the instance settings.
+  if ( port->CLKDIV != handle->queueClkDiv ) {
+    port->CLKDIV = handle->queueClkDiv;
+  }
+  if ( port->FRAME != handle->queueFrame ) {
+    port->FRAME = handle->queueFrame;
+  }
+
+  if ( callback != NULL ) {
+    callback(handle, transferStatus, itemsTransferred, userParam);
+  }
+
+  if ( handle->state == spidrvStateIdle ) {
+    QueueStartNext(handle);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Start the next pending transaction after a non-queued transfer. With
+ *    @ref spidrvCsControlApplication the driver does not know when the
+ *    application has released CS, so @ref SPIDRV_QueueResume() does it.
+ *    Must be called with interrupts disabled.
+ ******************************************************************************/
+static void QueueResume(SPIDRV_Handle_t handle)
+{
+  if ( (handle->initData.csControl == spidrvCsControlAuto)
+       && (handle->state == spidrvStateIdle) ) {
+    QueueStartNext(handle);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Start the highest priority pending transaction, if any. Must be called
+ *    with interrupts disabled and the driver instance idle.
+ ******************************************************************************/
+static void QueueStartNext(SPIDRV_Handle_t handle)
+{
+  int i;
+  SPIDRV_QueueSlot_t *slot = NULL;
+  SPIDRV_Transaction_t *transaction;
+  USART_TypeDef *port = handle->initData.port;
+
+  for ( i = 0; i < EMDRV_SPIDRV_QUEUE_SIZE; i++ ) {
+    if ( handle->queue[i].state != spidrvSlotPending ) {
+      continue;
+    }
+    if ( (slot == NULL)
+         || (handle->queue[i].transaction.priority < slot->transaction.priority)
+         || ((handle->queue[i].transaction.priority == slot->transaction.priority)
+             && ((int16_t)(handle->queue[i].sequence - slot->sequence) < 0)) ) {
+      slot = &handle->queue[i];
+    }
+  }
+
+  if ( slot == NULL ) {
+    return;
+  }
+
+  transaction         = &slot->transaction;
+  slot->state         = spidrvSlotActive;
+  handle->queueActive = slot;
+  handle->state       = spidrvStateTransferring;
+
+  // The instance settings are restored by QueueComplete(). Only reprogram
+  // the USART when the transaction needs other settings,
+  // USART_BaudrateSyncSet() does a clock tree lookup.
+  handle->queueClkDiv = port->CLKDIV;
+  handle->queueFrame  = port->FRAME;
+  if ( (transaction->bitRate != 0)
+       && (transaction->bitRate != handle->initData.bitRate) ) {
+    USART_BaudrateSyncSet(port, 0, transaction->bitRate);
+  }
+
+  if ( (transaction->frameLength != 0)
+       && (transaction->frameLength != handle->initData.frameLength) ) {
+    port->FRAME = (port->FRAME & ~_USART_FRAME_DATABITS_MASK)
+                  | ((transaction->frameLength - 3)
+                     << _USART_FRAME_DATABITS_SHIFT);
+  }
+
+  if ( handle->initData.csControl == spidrvCsControlApplication ) {
+    GPIO_PinOutClear((GPIO_Port_TypeDef)transaction->csPort,
+                     transaction->csPin);
+  }
+
+  StartSegmentDMA(handle,
+                  transaction->txBuffer,
+                  transaction->rxBuffer,
+                  transaction->count,
+                  QueueComplete);
+}
+#endif
+
 /***************************************************************************//**
  * @brief Configure/deconfigure SPI GPIO pins.
  ******************************************************************************/
@@ -1483,6 +1912,7 @@ static bool RxDMAComplete(unsigned int channel,
 {
   CORE_DECLARE_IRQ_STATE;
   SPIDRV_Handle_t handle;
+  SPIDRV_Callback_t callback;
   (void)channel;
   (void)sequenceNo;
 
@@ -1500,10 +1930,21 @@ static bool RxDMAComplete(unsigned int channel,
   }
 #endif
 
-  if ( handle->userCallback != NULL ) {
-    handle->userCallback(handle, ECODE_EMDRV_SPIDRV_OK, handle->transferCount);
+  callback = handle->userCallback;
+  if ( callback != NULL ) {
+    callback(handle, ECODE_EMDRV_SPIDRV_OK, handle->transferCount);
   }
 
+#if (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+  // Queued transactions start the next one themselves, blocking transfers
+  // when the caller is done with CS.
+  if ( (callback != QueueComplete)
+       && (callback != BlockingComplete)
+       && (callback != ChainComplete) ) {
+    QueueResume(handle);
+  }
+#endif
+
   CORE_EXIT_ATOMIC();
   return true;
 }
@@ -1548,6 +1989,26 @@ static void SlaveTimeout(RTCDRV_TimerID_t id, void *user)
 }
 #endif
 
+/***************************************************************************//**
+ * @brief
+ *    Start a receive, transmit or transfer DMA depending on which buffers
+ *    are given. Used by chained and queued transfers.
+ ******************************************************************************/
+static void StartSegmentDMA(SPIDRV_Handle_t handle,
+                            const void *txBuffer,
+                            void *rxBuffer,
+                            int count,
+                            SPIDRV_Callback_t callback)
+{
+  if ( txBuffer == NULL ) {
+    StartReceiveDMA(handle, rxBuffer, count, callback);
+  } else if ( rxBuffer == NULL ) {
+    StartTransmitDMA(handle, txBuffer, count, callback);
+  } else {
+    StartTransferDMA(handle, txBuffer, rxBuffer, count, callback);
+  }
+}
+
 /***************************************************************************//**
  * @brief Start an SPI receive DMA.
  ******************************************************************************/
@@ -1767,9 +2228,20 @@ static Ecode_t TransferApiPrologue(SPIDRV_Handle_t handle,
 
 /***************************************************************************//**
  * @brief Wait for transfer completion.
+ *
+ * @details
+ *    With @ref EMDRV_SPIDRV_BLOCKING_SLEEP defined, the MCU waits in EM1 and
+ *    is woken by the DMA completion interrupt. EM2 is blocked while waiting
+ *    since the USART and DMA need the HF clocks. The completion flag is
+ *    checked with interrupts masked so the wakeup cannot be lost between the
+ *    check and the sleep; a pending interrupt still wakes the core from WFI.
  ******************************************************************************/
 static void WaitForTransferCompletion(SPIDRV_Handle_t handle)
 {
+#if defined(EMDRV_SPIDRV_BLOCKING_SLEEP) || (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+  CORE_DECLARE_IRQ_STATE;
+#endif
+
   if (CORE_IrqIsBlocked(SPI_DMA_IRQ)) {
     // Poll for completion by calling IRQ handler.
     while ( handle->blockingCompleted == false ) {
@@ -1782,8 +2254,28 @@ static void WaitForTransferCompletion(SPIDRV_Handle_t handle)
 #endif
     }
   } else {
+#if defined(EMDRV_SPIDRV_BLOCKING_SLEEP)
+    SLEEP_SleepBlockBeginTagged(sleepEM2, (uint32_t)(uintptr_t)handle);
+    CORE_ENTER_ATOMIC();
+    while ( handle->blockingCompleted == false ) {
+      SLEEP_Sleep();
+      // Let the pending DMA interrupt run.
+      CORE_EXIT_ATOMIC();
+      CORE_ENTER_ATOMIC();
+    }
+    CORE_EXIT_ATOMIC();
+    SLEEP_SleepBlockEndTagged(sleepEM2, (uint32_t)(uintptr_t)handle);
+#else
     while ( handle->blockingCompleted == false ) ;
+#endif
   }
+
+#if (EMDRV_SPIDRV_QUEUE_SIZE > 0)
+  // CS is released, a chain releases it on its last segment.
+  CORE_ENTER_ATOMIC();
+  QueueResume(handle);
+  CORE_EXIT_ATOMIC();
+#endif
 }
 
 #if defined(EMDRV_SPIDRV_INCLUDE_SLAVE)
@@ -1842,6 +2334,8 @@ static Ecode_t WaitForIdleLine(SPIDRV_Handle_t handle)
    this file, containing default values, is in the emdrv/config folder.
    Currently the configuration options are as follows:
    @li Inclusion of slave API transfer functions.
+   @li Waiting in EM1 instead of busy-waiting in blocking transfer functions.
+   @li The number of transaction slots for the queued transfer API.
 
    To configure SPIDRV, provide a custom configuration file. This is a
    sample @ref spidrv_config.h file:
@@ -1853,6 +2347,10 @@ static Ecode_t WaitForIdleLine(SPIDRV_Handle_t handle)
 // slave part of the SPIDRV API.
 #define EMDRV_SPIDRV_INCLUDE_SLAVE
 
+// SPIDRV configuration option. Use this define to make blocking
+// transfer functions wait for completion in EM1.
+#define EMDRV_SPIDRV_BLOCKING_SLEEP
+
 #endif
    @endverbatim
 
@@ -1889,6 +2387,8 @@ static Ecode_t WaitForIdleLine(SPIDRV_Handle_t handle)
 
    SPIDRV_MReceive(), SPIDRV_MReceiveB() @n
    SPIDRV_MTransfer(), SPIDRV_MTransferB(), SPIDRV_MTransferSingleItemB() @n
+   SPIDRV_MTransferChainB() @n
+   SPIDRV_MQueueTransfer(), SPIDRV_QueueResume() @n
    SPIDRV_MTransmit(), SPIDRV_MTransmitB() @n
    SPIDRV_SReceive(), SPIDRV_SReceiveB() @n
    SPIDRV_STransfer(), SPIDRV_STransferB() @n
@@ -1908,6 +2408,23 @@ static Ecode_t WaitForIdleLine(SPIDRV_Handle_t handle)
     All slave transfer functions have a millisecond timeout parameter. Use 0
     for no (infinite) timeout.
 
+    @htmlonly SPIDRV_MTransferChainB() @endhtmlonly transfers a list of
+    @ref SPIDRV_Segment_t buffers as one bus transaction with CS held asserted.
+    Each segment may transmit, receive or both.
+
+    @htmlonly SPIDRV_MQueueTransfer() @endhtmlonly queues a
+    @ref SPIDRV_Transaction_t instead of returning @ref ECODE_EMDRV_SPIDRV_BUSY
+    when the bus is in use. Each transaction carries its own CS pin, bitrate
+    and framelength, so several devices can share one driver instance.
+    Queued transactions are started back to back from the DMA interrupt
+    handler, highest priority first. Each transaction runs with its own
+    settings, the instance bitrate and framelength are restored after it.
+    Pending transactions wait for a running non-queued transfer. With
+    @ref spidrvCsControlApplication they are only started again by
+    @htmlonly SPIDRV_QueueResume() @endhtmlonly or the next
+    @htmlonly SPIDRV_MQueueTransfer() @endhtmlonly, as the driver does not
+    know when the application has released CS.
+
    @n @section spidrv_example Example
    @verbatim
 #include "spidrv.h"
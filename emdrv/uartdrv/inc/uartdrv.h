@@ -53,6 +53,7 @@ extern "C" {
 #define ECODE_EMDRV_UARTDRV_FRAME_ERROR       (ECODE_EMDRV_UARTDRV_BASE | 0x0000000D) ///< A UART frame error. Data is ignored.
 #define ECODE_EMDRV_UARTDRV_DMA_ALLOC_ERROR   (ECODE_EMDRV_UARTDRV_BASE | 0x0000000E) ///< Unable to allocate DMA channels.
 #define ECODE_EMDRV_UARTDRV_CLOCK_ERROR       (ECODE_EMDRV_UARTDRV_BASE | 0x0000000F) ///< Unable to set a desired baudrate.
+#define ECODE_EMDRV_UARTDRV_OVERRUN           (ECODE_EMDRV_UARTDRV_BASE | 0x00000010) ///< Receive stream data was overwritten before it was consumed.
 
 // UARTDRV status codes
 #define UARTDRV_STATUS_RXEN     (1 << 0)  ///< The receiver is enabled.
@@ -134,6 +135,37 @@ typedef struct {
   Ecode_t transferStatus;                  ///< Completion status of the transfer operation
 } UARTDRV_Buffer_t;
 
+/***************************************************************************//**
+ * @brief
+ *  UARTDRV receive stream callback function.
+ *
+ * @details
+ *  Called when new data is available in a receive stream started with
+ *  @ref UARTDRV_ReceiveStreamStart(). The data is read with
+ *  @ref UARTDRV_ReceiveStreamPeek() and released with
+ *  @ref UARTDRV_ReceiveStreamConsume().
+ *
+ * @param[in] handle
+ *   The UARTDRV device handle used to start the stream.
+ *
+ * @param[in] status
+ *   @ref ECODE_EMDRV_UARTDRV_OK, @ref ECODE_EMDRV_UARTDRV_OVERRUN if
+ *   unconsumed data was dropped, or @ref ECODE_EMDRV_UARTDRV_ABORTED when
+ *   the stream is stopped by @ref UARTDRV_Abort().
+ *
+ * @param[in] bytesAvailable
+ *   A number of received bytes not yet consumed.
+ ******************************************************************************/
+typedef void (*UARTDRV_StreamCallback_t)(struct UARTDRV_HandleData *handle,
+                                         Ecode_t status,
+                                         UARTDRV_Count_t bytesAvailable);
+
+/// A contiguous view into the receive stream buffer.
+typedef struct {
+  uint8_t         *data;                   ///< Start of received data
+  UARTDRV_Count_t length;                  ///< A number of bytes at data
+} UARTDRV_Span_t;
+
 /// Transfer operation FIFO queue typedef
 typedef struct {
   volatile uint16_t head;                  ///< An index of the next byte to send.
@@ -260,6 +292,13 @@ typedef struct UARTDRV_HandleData{
   bool                       hasTransmitted;    // Indicates whether the handle has transmitted data
   UARTDRV_FlowControlType_t  fcType;            // A flow control mode
   UARTDRV_UartType_t         type;              // A type of UART
+  uint8_t                    *rxStreamBuf;      // A receive stream ring buffer
+  UARTDRV_Count_t            rxStreamSize;      // A receive stream ring buffer size
+  UARTDRV_Count_t            rxStreamTail;      // An offset of the oldest unconsumed byte
+  volatile UARTDRV_Count_t   rxStreamUsed;      // A number of unconsumed bytes
+  UARTDRV_Count_t            rxStreamFill;      // Bytes counted in the half being filled
+  UARTDRV_StreamCallback_t   rxStreamCallback;  // A receive stream data callback
+  volatile bool              rxStreamActive;    // A receive stream is running
   /// @endcond
 } UARTDRV_HandleData_t;
 
@@ -308,6 +347,21 @@ Ecode_t UARTDRV_ReceiveB(UARTDRV_Handle_t handle,
                          uint8_t *data,
                          UARTDRV_Count_t count);
 
+Ecode_t UARTDRV_ReceiveStreamStart(UARTDRV_Handle_t handle,
+                                   uint8_t *buffer,
+                                   UARTDRV_Count_t size,
+                                   UARTDRV_StreamCallback_t callback);
+
+Ecode_t UARTDRV_ReceiveStreamStop(UARTDRV_Handle_t handle);
+
+UARTDRV_Count_t UARTDRV_ReceiveStreamPeek(UARTDRV_Handle_t handle,
+                                          UARTDRV_Span_t spans[2]);
+
+Ecode_t UARTDRV_ReceiveStreamConsume(UARTDRV_Handle_t handle,
+                                     UARTDRV_Count_t count);
+
+Ecode_t UARTDRV_ReceiveStreamPoll(UARTDRV_Handle_t handle);
+
 Ecode_t UARTDRV_ForceTransmit(UARTDRV_Handle_t handle,
                               uint8_t *data,
                               UARTDRV_Count_t count);
@@ -51,6 +51,9 @@ static bool ReceiveDmaComplete(unsigned int channel,
 static bool TransmitDmaComplete(unsigned int channel,
                                 unsigned int sequenceNo,
                                 void *userParam);
+static bool ReceiveStreamDmaComplete(unsigned int channel,
+                                     unsigned int sequenceNo,
+                                     void *userParam);
 
 /***************************************************************************//**
  * @brief Get UARTDRV_Handle_t from GPIO pin number (HW FC CTS pin interrupt).
@@ -535,6 +538,87 @@ static bool TransmitDmaComplete(unsigned int channel,
   return true;
 }
 
+/***************************************************************************//**
+ * @brief
+ *  Account for bytes written by DMA into the half of the receive stream
+ *  buffer currently being filled. Must be called with interrupts disabled.
+ *
+ * @return
+ *  True if new bytes were made available.
+ ******************************************************************************/
+static bool ReceiveStreamUpdate(UARTDRV_Handle_t handle)
+{
+  int remaining;
+  UARTDRV_Count_t half = handle->rxStreamSize / 2;
+  UARTDRV_Count_t fill;
+
+  if ((DMADRV_TransferRemainingCount(handle->rxDmaCh, &remaining)
+       != ECODE_EMDRV_DMADRV_OK)
+      || (remaining < 0)
+      || ((UARTDRV_Count_t)remaining > half)) {
+    return false;
+  }
+
+  // If the half complete interrupt is pending, the count read belongs to the
+  // next half. The half being accounted is complete then, so the bytes are
+  // valid, and ReceiveStreamDmaComplete() adds the rest.
+  fill = half - (UARTDRV_Count_t)remaining;
+  if (fill <= handle->rxStreamFill) {
+    return false;
+  }
+  handle->rxStreamUsed += fill - handle->rxStreamFill;
+  handle->rxStreamFill = fill;
+  return true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *  Receive stream DMA callback. Called by the DMA interrupt handler each time
+ *  one half of the stream buffer is full. DMA continues into the other half
+ *  without being restarted, so no bytes are lost between the halves.
+ ******************************************************************************/
+static bool ReceiveStreamDmaComplete(unsigned int channel,
+                                     unsigned int sequenceNo,
+                                     void *userParam)
+{
+  CORE_DECLARE_IRQ_STATE;
+  UARTDRV_Handle_t handle;
+  UARTDRV_Count_t half;
+  UARTDRV_Count_t head;
+  Ecode_t status = ECODE_EMDRV_UARTDRV_OK;
+  (void)channel;
+  (void)sequenceNo;
+
+  handle = (UARTDRV_Handle_t)userParam;
+
+  // Stop the ping-pong cycle if the stream was stopped while the interrupt
+  // was pending.
+  if (!handle->rxStreamActive) {
+    return false;
+  }
+
+  half = handle->rxStreamSize / 2;
+
+  CORE_ENTER_ATOMIC();
+  handle->rxStreamUsed += half - handle->rxStreamFill;
+  handle->rxStreamFill = 0;
+
+  // DMA now fills the half after the one just completed. Unconsumed data in
+  // that half is being overwritten, drop it.
+  if (handle->rxStreamUsed > half) {
+    head = (handle->rxStreamTail + handle->rxStreamUsed) % handle->rxStreamSize;
+    handle->rxStreamTail = (head + half) % handle->rxStreamSize;
+    handle->rxStreamUsed = half;
+    status = ECODE_EMDRV_UARTDRV_OVERRUN;
+  }
+
+  if (handle->rxStreamCallback != NULL) {
+    handle->rxStreamCallback(handle, status, handle->rxStreamUsed);
+  }
+  CORE_EXIT_ATOMIC();
+  return true;
+}
+
 /***************************************************************************//**
  * @brief Parameter checking function for blocking transfer API functions.
  ******************************************************************************/
@@ -836,6 +920,8 @@ static void InitializeQueues(UARTDRV_Handle_t handle,
   handle->rxQueue->tail = 0;
   handle->rxQueue->used = 0;
   handle->rxDmaActive = false;
+  handle->rxStreamActive = false;
+  handle->rxStreamBuf = NULL;
 
   handle->txQueue = txQueue;
   handle->txQueue->head = 0;
@@ -1345,12 +1431,15 @@ Ecode_t UARTDRV_Abort(UARTDRV_Handle_t handle, UARTDRV_AbortType_t type)
   if ((type == uartdrvAbortTransmit) && (handle->txQueue->used == 0)) {
     CORE_EXIT_ATOMIC();
     return ECODE_EMDRV_UARTDRV_IDLE;
-  } else if ((type == uartdrvAbortReceive) && (handle->rxQueue->used == 0)) {
+  } else if ((type == uartdrvAbortReceive)
+             && (handle->rxQueue->used == 0)
+             && !handle->rxStreamActive) {
     CORE_EXIT_ATOMIC();
     return ECODE_EMDRV_UARTDRV_IDLE;
   } else if ((type == uartdrvAbortAll)
              && (handle->txQueue->used == 0)
-             && (handle->rxQueue->used == 0)) {
+             && (handle->rxQueue->used == 0)
+             && !handle->rxStreamActive) {
     CORE_EXIT_ATOMIC();
     return ECODE_EMDRV_UARTDRV_IDLE;
   }
@@ -1389,6 +1478,9 @@ Ecode_t UARTDRV_Abort(UARTDRV_Handle_t handle, UARTDRV_AbortType_t type)
   }
   if ((type == uartdrvAbortReceive) || (type == uartdrvAbortAll)) {
     // Stop the current transfer
+    if (handle->rxStreamActive) {
+      ReceiveStreamUpdate(handle);
+    }
     DMADRV_StopTransfer(handle->rxDmaCh);
     handle->rxDmaActive = false;
 
@@ -1413,6 +1505,15 @@ Ecode_t UARTDRV_Abort(UARTDRV_Handle_t handle, UARTDRV_AbortType_t type)
       }
     }
 
+    if (handle->rxStreamActive) {
+      handle->rxStreamActive = false;
+      if (handle->rxStreamCallback != NULL) {
+        handle->rxStreamCallback(handle,
+                                 ECODE_EMDRV_UARTDRV_ABORTED,
+                                 handle->rxStreamUsed);
+      }
+    }
+
     // Disable the receiver
     if (handle->fcType != uartdrvFlowControlHwUart) {
       DisableReceiver(handle);
@@ -1716,7 +1817,7 @@ UARTDRV_Count_t UARTDRV_ForceReceive(UARTDRV_Handle_t handle,
   UARTDRV_Count_t i = 0;
 
   retVal = CheckParams(handle, data, maxCount);
-  if (retVal != ECODE_EMDRV_UARTDRV_OK) {
+  if ((retVal != ECODE_EMDRV_UARTDRV_OK) || handle->rxStreamActive) {
     return 0;
   }
 
@@ -1888,6 +1989,9 @@ Ecode_t UARTDRV_Receive(UARTDRV_Handle_t handle,
   if (retVal != ECODE_EMDRV_UARTDRV_OK) {
     return retVal;
   }
+  if (handle->rxStreamActive) {
+    return ECODE_EMDRV_UARTDRV_BUSY;
+  }
   outputBuffer.data = data;
   outputBuffer.transferCount = count;
   outputBuffer.itemsRemaining = count;
@@ -1937,6 +2041,9 @@ Ecode_t UARTDRV_ReceiveB(UARTDRV_Handle_t handle,
   if (retVal != ECODE_EMDRV_UARTDRV_OK) {
     return retVal;
   }
+  if (handle->rxStreamActive) {
+    return ECODE_EMDRV_UARTDRV_BUSY;
+  }
   inputBuffer.data = data;
   inputBuffer.transferCount = count;
   inputBuffer.itemsRemaining = count;
@@ -1964,6 +2071,277 @@ Ecode_t UARTDRV_ReceiveB(UARTDRV_Handle_t handle,
   return queueBuffer->transferStatus;
 }
 
+/***************************************************************************//**
+ * @brief
+ *    Consume data from a receive stream.
+ *
+ * @details
+ *    Releases the oldest @p count bytes returned by
+ *    @ref UARTDRV_ReceiveStreamPeek() so that the space can be reused by DMA.
+ *
+ * @param[in] handle Pointer to a UART driver handle.
+ *
+ * @param[in] count A number of bytes to release.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_UARTDRV_OK on success. On failure, an appropriate
+ *    UARTDRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t UARTDRV_ReceiveStreamConsume(UARTDRV_Handle_t handle,
+                                     UARTDRV_Count_t count)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if (handle == NULL) {
+    return ECODE_EMDRV_UARTDRV_ILLEGAL_HANDLE;
+  }
+  if (handle->rxStreamBuf == NULL) {
+    return ECODE_EMDRV_UARTDRV_ILLEGAL_OPERATION;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if (count > handle->rxStreamUsed) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_UARTDRV_PARAM_ERROR;
+  }
+  handle->rxStreamTail = (handle->rxStreamTail + count) % handle->rxStreamSize;
+  handle->rxStreamUsed -= count;
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_UARTDRV_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Get a zero-copy view of received stream data.
+ *
+ * @details
+ *    Bytes received so far, including those in a partially filled half of
+ *    the stream buffer, are returned as up to two spans pointing into the
+ *    stream buffer. The second span is used when the data wraps around the
+ *    end of the buffer, it has zero length otherwise. Data stays valid until
+ *    it is released with @ref UARTDRV_ReceiveStreamConsume().
+ *
+ * @param[in] handle Pointer to a UART driver handle.
+ *
+ * @param[out] spans Two spans describing the unconsumed data, in order.
+ *
+ * @return
+ *    Total number of unconsumed bytes.
+ ******************************************************************************/
+UARTDRV_Count_t UARTDRV_ReceiveStreamPeek(UARTDRV_Handle_t handle,
+                                          UARTDRV_Span_t spans[2])
+{
+  UARTDRV_Count_t used;
+  UARTDRV_Count_t tail;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ((handle == NULL) || (spans == NULL) || (handle->rxStreamBuf == NULL)) {
+    return 0;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if (handle->rxStreamActive) {
+    ReceiveStreamUpdate(handle);
+  }
+  used = handle->rxStreamUsed;
+  tail = handle->rxStreamTail;
+  CORE_EXIT_ATOMIC();
+
+  spans[0].data = &handle->rxStreamBuf[tail];
+  spans[0].length = SL_MIN(used, handle->rxStreamSize - tail);
+  spans[1].data = handle->rxStreamBuf;
+  spans[1].length = used - spans[0].length;
+
+  return used;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Flush received bytes of a partially filled stream buffer half.
+ *
+ * @details
+ *    The stream callback is otherwise only called when a half of the stream
+ *    buffer is full. Call this function periodically, e.g. from an RTCDRV
+ *    timer with a period of a few character times, to get the callback for
+ *    a message that ends before the half is full (idle line).
+ *
+ * @param[in] handle Pointer to a UART driver handle.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_UARTDRV_OK if new data was reported,
+ *    @ref ECODE_EMDRV_UARTDRV_IDLE if no new data was received. On failure,
+ *    an appropriate UARTDRV @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t UARTDRV_ReceiveStreamPoll(UARTDRV_Handle_t handle)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if (handle == NULL) {
+    return ECODE_EMDRV_UARTDRV_ILLEGAL_HANDLE;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if (!handle->rxStreamActive) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_UARTDRV_ILLEGAL_OPERATION;
+  }
+  if (!ReceiveStreamUpdate(handle)) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_UARTDRV_IDLE;
+  }
+  if (handle->rxStreamCallback != NULL) {
+    handle->rxStreamCallback(handle,
+                             ECODE_EMDRV_UARTDRV_OK,
+                             handle->rxStreamUsed);
+  }
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_UARTDRV_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Start a continuous receive stream.
+ *
+ * @details
+ *    The receiver is kept enabled and DMA runs in ping-pong mode over the two
+ *    halves of @p buffer for as long as the stream is running. Unlike
+ *    @ref UARTDRV_Receive(), there is no gap between buffers where incoming
+ *    bytes can be lost. The callback is called each time a half is full.
+ *    If the application does not consume a half before DMA wraps around to
+ *    it, the oldest data is dropped and the callback reports
+ *    @ref ECODE_EMDRV_UARTDRV_OVERRUN.
+ *
+ * @param[in] handle Pointer to a UART driver handle.
+ *
+ * @param[in] buffer A stream ring buffer.
+ *
+ * @param[in] size Size of the ring buffer. Must be even, and half of it may
+ *                 not exceed @ref DMADRV_MAX_XFER_COUNT.
+ *
+ * @param[in] callback A data available callback, can be NULL.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_UARTDRV_OK on success, @ref ECODE_EMDRV_UARTDRV_BUSY if
+ *    a receive operation is active. On failure, an appropriate UARTDRV
+ *    @ref Ecode_t is returned.
+ ******************************************************************************/
+Ecode_t UARTDRV_ReceiveStreamStart(UARTDRV_Handle_t handle,
+                                   uint8_t *buffer,
+                                   UARTDRV_Count_t size,
+                                   UARTDRV_StreamCallback_t callback)
+{
+  void *rxPort = NULL;
+  Ecode_t retVal;
+  CORE_DECLARE_IRQ_STATE;
+
+  if (handle == NULL) {
+    return ECODE_EMDRV_UARTDRV_ILLEGAL_HANDLE;
+  }
+  if ((buffer == NULL)
+      || (size < 2)
+      || ((size & 1) != 0)
+      || ((size / 2) > DMADRV_MAX_XFER_COUNT)) {
+    return ECODE_EMDRV_UARTDRV_PARAM_ERROR;
+  }
+
+  if (handle->type == uartdrvUartTypeUart) {
+    rxPort = (void *)&(handle->peripheral.uart->RXDATA);
+  } else if (handle->type == uartdrvUartTypeLeuart) {
+    rxPort = (void *)&(handle->peripheral.leuart->RXDATA);
+  } else {
+    return ECODE_EMDRV_UARTDRV_ILLEGAL_OPERATION;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if (handle->rxDmaActive
+      || (handle->rxQueue->used > 0)
+      || handle->rxStreamActive) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_UARTDRV_BUSY;
+  }
+  handle->rxStreamBuf = buffer;
+  handle->rxStreamSize = size;
+  handle->rxStreamTail = 0;
+  handle->rxStreamUsed = 0;
+  handle->rxStreamFill = 0;
+  handle->rxStreamCallback = callback;
+  handle->rxStreamActive = true;
+  CORE_EXIT_ATOMIC();
+
+  EnableReceiver(handle);
+  retVal = DMADRV_PeripheralMemoryPingPong(handle->rxDmaCh,
+                                           handle->rxDmaSignal,
+                                           buffer,
+                                           buffer + (size / 2),
+                                           rxPort,
+                                           true,
+                                           size / 2,
+                                           dmadrvDataSize1,
+                                           ReceiveStreamDmaComplete,
+                                           handle);
+  if (retVal != ECODE_EMDRV_DMADRV_OK) {
+    handle->rxStreamActive = false;
+    if (handle->fcType != uartdrvFlowControlHwUart) {
+      DisableReceiver(handle);
+    }
+    return ECODE_EMDRV_UARTDRV_ILLEGAL_OPERATION;
+  }
+#if (EMDRV_UARTDRV_FLOW_CONTROL_ENABLE)
+  if (handle->fcType != uartdrvFlowControlHwUart) {
+    handle->fcSelfState = uartdrvFlowControlOn;
+    FcApplyState(handle);
+  }
+#endif
+
+  return ECODE_EMDRV_UARTDRV_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Stop a receive stream.
+ *
+ * @details
+ *    Bytes received up to this point stay available through
+ *    @ref UARTDRV_ReceiveStreamPeek() until the stream is started again.
+ *
+ * @param[in] handle Pointer to a UART driver handle.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_UARTDRV_OK on success, @ref ECODE_EMDRV_UARTDRV_IDLE if
+ *    no stream is running.
+ ******************************************************************************/
+Ecode_t UARTDRV_ReceiveStreamStop(UARTDRV_Handle_t handle)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if (handle == NULL) {
+    return ECODE_EMDRV_UARTDRV_ILLEGAL_HANDLE;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if (!handle->rxStreamActive) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_UARTDRV_IDLE;
+  }
+  ReceiveStreamUpdate(handle);
+  DMADRV_StopTransfer(handle->rxDmaCh);
+  handle->rxStreamActive = false;
+#if (EMDRV_UARTDRV_FLOW_CONTROL_ENABLE)
+  if (handle->fcType != uartdrvFlowControlHwUart) {
+    handle->fcSelfState = uartdrvFlowControlOff;
+    FcApplyState(handle);
+  }
+#endif
+  if (handle->fcType != uartdrvFlowControlHwUart) {
+    DisableReceiver(handle);
+  }
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_UARTDRV_OK;
+}
+
 /***************************************************************************//**
  * @brief
  *  Resume a paused transmit operation.
@@ -2197,9 +2575,20 @@ Ecode_t UARTDRV_TransmitB(UARTDRV_Handle_t handle,
     @ref UARTDRV_ForceTransmit() does not respect flow control.
     @ref UARTDRV_ForceReceive() forces RTS low.
 
+  @ref UARTDRV_ReceiveStreamStart(), @ref UARTDRV_ReceiveStreamStop() @n
+  @ref UARTDRV_ReceiveStreamPeek(), @ref UARTDRV_ReceiveStreamConsume() and
+  @ref UARTDRV_ReceiveStreamPoll() @n
+    Continuous reception into an application ring buffer. DMA runs in
+    ping-pong mode over the two halves of the buffer, so the receiver is
+    never without a DMA destination. Received data is read in place as one or
+    two spans and released when processed. Call
+    @htmlonly UARTDRV_ReceiveStreamPoll() @endhtmlonly periodically to be
+    notified of data that does not fill a whole buffer half. Queued receive
+    operations can't be used while a stream is running.
+
   @ref UARTDRV_Abort() @n
     Abort current transmit or receive operations and remove all queued
-    operations.
+    operations. Aborting receive also stops a receive stream.
 
   @ref UARTDRV_FlowControlSet(), @ref UARTDRV_FlowControlGetSelfStatus(), @ref UARTDRV_FlowControlSetPeerStatus() and @ref UARTDRV_FlowControlGetPeerStatus() @n
     Set and get flow control status of self or peer device. Note that the return
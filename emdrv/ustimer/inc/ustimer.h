@@ -16,6 +16,7 @@
 #define __SILICON_LABS_USTIMER_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "ecode.h"
 #include "ustimer_config.h"
 
@@ -33,13 +34,60 @@ extern "C" {
  * @{
  ******************************************************************************/
 
-#define ECODE_EMDRV_USTIMER_OK ( ECODE_OK ) ///< Success return value.
+#define ECODE_EMDRV_USTIMER_OK                  ( ECODE_OK )                                ///< Success return value.
+#define ECODE_EMDRV_USTIMER_ALL_TIMERS_USED     ( ECODE_EMDRV_USTIMER_BASE | 0x00000001 )   ///< No callback timers available.
+#define ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID    ( ECODE_EMDRV_USTIMER_BASE | 0x00000002 )   ///< An illegal timer ID.
+#define ECODE_EMDRV_USTIMER_TIMER_NOT_ALLOCATED ( ECODE_EMDRV_USTIMER_BASE | 0x00000003 )   ///< A timer is not allocated.
+#define ECODE_EMDRV_USTIMER_PARAM_ERROR         ( ECODE_EMDRV_USTIMER_BASE | 0x00000004 )   ///< An illegal input parameter.
+
+#ifndef USTIMER_NUM_TIMERS
+#define USTIMER_NUM_TIMERS 0    ///< Number of callback timers, 0 disables them.
+#endif
+
+#if (USTIMER_NUM_TIMERS > 0)
+
+/// Timer ID.
+typedef uint32_t USTIMER_TimerID_t;
+
+/***************************************************************************//**
+ * @brief
+ *  Typedef for the user supplied callback function which is called when
+ *  a timer expires. The callback runs in the TIMER interrupt handler.
+ *
+ * @param[in] id
+ *   The timer id.
+ *
+ * @param[in] user
+ *   Extra parameter for user application.
+ ******************************************************************************/
+typedef void (*USTIMER_Callback_t)(USTIMER_TimerID_t id, void *user);
+
+/// Timer type enumerator.
+typedef enum {
+  ustimerTimerTypeOneshot = 0,    ///< Oneshot timer.
+  ustimerTimerTypePeriodic = 1    ///< Periodic timer.
+} USTIMER_TimerType_t;
+
+#endif
 
 Ecode_t USTIMER_Init(void);
 Ecode_t USTIMER_DeInit(void);
 Ecode_t USTIMER_Delay(uint32_t usec);
 Ecode_t USTIMER_DelayIntSafe(uint32_t usec);
 
+#if (USTIMER_NUM_TIMERS > 0)
+Ecode_t USTIMER_AllocateTimer(USTIMER_TimerID_t *id);
+Ecode_t USTIMER_FreeTimer(USTIMER_TimerID_t id);
+Ecode_t USTIMER_StartTimer(USTIMER_TimerID_t id,
+                           USTIMER_TimerType_t type,
+                           uint32_t usec,
+                           USTIMER_Callback_t callback,
+                           void *user);
+Ecode_t USTIMER_StopTimer(USTIMER_TimerID_t id);
+Ecode_t USTIMER_IsRunning(USTIMER_TimerID_t id, bool *isRunning);
+Ecode_t USTIMER_WaitTimer(USTIMER_TimerID_t id);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,6 +14,7 @@
  ******************************************************************************/
 
 #include <stdbool.h>
+#include <stddef.h>
 #include "em_device.h"
 #include "em_common.h"
 #include "em_cmu.h"
@@ -118,10 +119,39 @@
 static uint32_t freq;
 static uint32_t minTicks;
 static volatile bool timeElapsed = false;
+static CMU_ClockChangeSubscriber_TypeDef clockChange;
+static uint32_t hfperClockFreq;   // Clock frequencies used by ClockScale().
+static uint32_t coreClockFreq;
 
+static TIMER_Prescale_TypeDef ClockScale(void);
+static void ClockChanged(void *user);
 static void DelayTicksEM1(uint16_t ticks);
 static void DelayTicksPolled(uint16_t ticks);
 
+#if (USTIMER_NUM_TIMERS > 0)
+// Callback timers share the counter with the delay functions and are
+// multiplexed on compare channel 1, the delay functions use channel 0.
+typedef struct {
+  int64_t             remaining;  // Ticks to expiry, relative to lastUpdate.
+  uint64_t            period;     // Ticks between expiries.
+  uint32_t            usec;       // Timeout, the period after clock changes.
+  USTIMER_Callback_t  callback;
+  void                *user;
+  USTIMER_TimerType_t type;
+  bool                allocated;
+  volatile bool       running;
+} Timer_t;
+
+static Timer_t timer[USTIMER_NUM_TIMERS];
+static uint16_t lastUpdate;
+
+static void TimersStopAll(void);
+static void TimersRescale(uint32_t oldFreq);
+static void TimersUpdate(void);
+static void TimersReschedule(void);
+static void TimersProcess(void);
+#endif
+
 /** @endcond */
 
 /***************************************************************************//**
@@ -130,44 +160,42 @@ static void DelayTicksPolled(uint16_t ticks);
  *   delay functions.
  *
  * @note
- *   Call this function whenever the HFPERCLK and/or HFCORECLK frequency is
- *   changed.
+ *   The timer prescaler is set up again on every change of the HFPERCLK
+ *   and/or HFCORECLK frequency made with the CMU functions, see
+ *   @ref CMU_ClockChangeSubscribe(). The counter keeps running, the
+ *   remaining time of running callback timers is converted to the new tick
+ *   length. A delay in progress is not restarted, its remaining ticks are
+ *   counted at the new rate.
  *
  * @return
  *    @ref ECODE_EMDRV_USTIMER_OK.
  ******************************************************************************/
 Ecode_t USTIMER_Init(void)
 {
-  TIMER_Init_TypeDef timerInit     = TIMER_INIT_DEFAULT;
+  TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
   TIMER_InitCC_TypeDef timerCCInit = TIMER_INITCC_DEFAULT;
-  uint32_t coreClockScale;
 
   timerCCInit.mode = timerCCModeCompare;
   CMU_ClockEnable(TIMER_CLK, true);
   TIMER_TopSet(TIMER, TIMER_MAX);
   TIMER_InitCC(TIMER, 0, &timerCCInit);
+#if (USTIMER_NUM_TIMERS > 0)
+  TIMER_InitCC(TIMER, 1, &timerCCInit);
+#endif
 
-  /* Run timer at slowest frequency that still gives less than 1 us per tick */
-  timerInit.prescale = (TIMER_Prescale_TypeDef)_TIMER_CTRL_PRESC_DIV1;
-  do {
-    TIMER_Init(TIMER, &timerInit);
-
-    freq = CMU_ClockFreqGet(cmuClock_HFPER);
-    freq /= 1 << timerInit.prescale;
-    timerInit.prescale++;
-  } while ( (timerInit.prescale <= _TIMER_CTRL_PRESC_DIV1024)
-            && (freq > 2000000) );
-
-  /* Figure out the minimum delay we can have when using timer interrupt
-   * to avoid that actual delay become a full timer counter lap.
-   * We are assuming that this number scales with mcu core clock.
-   * The number is found by trial and err on a GG running at 14MHz.
-   */
-  coreClockScale = (4 * 48000000) / CMU_ClockFreqGet(cmuClock_CORE);
-  minTicks = ( ( (uint64_t)freq * coreClockScale) + 500000) / 1000000;
+  timerInit.prescale = ClockScale();
+  TIMER_Init(TIMER, &timerInit);
   timeElapsed = false;
+#if (USTIMER_NUM_TIMERS > 0)
+  TimersStopAll();
+  lastUpdate = (uint16_t)TIMER_CounterGet(TIMER);
+#endif
+  CMU_ClockChangeSubscribe(&clockChange, ClockChanged, NULL);
 
   TIMER_IntDisable(TIMER, TIMER_IEN_CC0);
+#if (USTIMER_NUM_TIMERS > 0)
+  TIMER_IntDisable(TIMER, TIMER_IEN_CC1);
+#endif
   NVIC_ClearPendingIRQ(TIMER_IRQ);
   NVIC_EnableIRQ(TIMER_IRQ);
 
@@ -180,17 +208,23 @@ Ecode_t USTIMER_Init(void)
  *
  * @details
  *    Will disable interrupts and turn off the clock to the underlying hardware
- *    timer.
+ *    timer. Running callback timers are stopped.
  *
  * @return
  *    @ref ECODE_EMDRV_USTIMER_OK.
  ******************************************************************************/
 Ecode_t USTIMER_DeInit(void)
 {
+  CMU_ClockChangeUnsubscribe(&clockChange);
   NVIC_DisableIRQ(TIMER_IRQ);
   TIMER_IntDisable(TIMER, TIMER_IEN_CC0);
 
   TIMER_IntClear(TIMER, TIMER_IFC_CC0);
+#if (USTIMER_NUM_TIMERS > 0)
+  TimersStopAll();
+  TIMER_IntDisable(TIMER, TIMER_IEN_CC1);
+  TIMER_IntClear(TIMER, TIMER_IFC_CC1);
+#endif
   NVIC_ClearPendingIRQ(TIMER_IRQ);
 
   TIMER_Enable(TIMER, false);
@@ -267,18 +301,357 @@ Ecode_t USTIMER_DelayIntSafe(uint32_t usec)
   return ECODE_EMDRV_USTIMER_OK;
 }
 
+#if (USTIMER_NUM_TIMERS > 0)
+/***************************************************************************//**
+ * @brief
+ *    Allocate a callback timer.
+ *
+ * @details
+ *    Reserve a timer instance.
+ *
+ * @param[out] id
+ *    The ID of the reserved timer.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_USTIMER_OK on success.@n
+ *    @ref ECODE_EMDRV_USTIMER_ALL_TIMERS_USED when no timers are available.@n
+ *    @ref ECODE_EMDRV_USTIMER_PARAM_ERROR if an invalid id pointer was supplied.
+ ******************************************************************************/
+Ecode_t USTIMER_AllocateTimer(USTIMER_TimerID_t *id)
+{
+  int i;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ( id == NULL ) {
+    return ECODE_EMDRV_USTIMER_PARAM_ERROR;
+  }
+
+  CORE_ENTER_ATOMIC();
+  for ( i = 0; i < USTIMER_NUM_TIMERS; i++ ) {
+    if ( !timer[i].allocated ) {
+      timer[i].allocated = true;
+      timer[i].running = false;
+      *id = (USTIMER_TimerID_t)i;
+      CORE_EXIT_ATOMIC();
+      return ECODE_EMDRV_USTIMER_OK;
+    }
+  }
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_USTIMER_ALL_TIMERS_USED;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Free a callback timer.
+ *
+ * @param[in] id
+ *    The ID of the timer to free.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_USTIMER_OK on success.@n
+ *    @ref ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID if the ID has an illegal value.
+ ******************************************************************************/
+Ecode_t USTIMER_FreeTimer(USTIMER_TimerID_t id)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if ( id >= USTIMER_NUM_TIMERS ) {
+    return ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID;
+  }
+
+  CORE_ENTER_ATOMIC();
+  timer[id].allocated = false;
+  timer[id].running = false;
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_USTIMER_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Start a callback timer.
+ *
+ * @details
+ *    All callback timers share compare channel 1 of the TIMER resource, which
+ *    is programmed for the timer closest to expiry. Expiries further away than
+ *    the 16 bit counter range are reached in several compare laps.
+ *
+ * @note
+ *    The callback function is called in the TIMER interrupt handler, and may
+ *    start and stop timers. A timer running when @ref USTIMER_StartTimer() is
+ *    called is restarted.
+ *
+ * @param[in] id
+ *    The ID of the timer to start.
+ *
+ * @param[in] type
+ *    Timer type, oneshot or periodic.
+ *
+ * @param[in] usec
+ *    Timeout expressed in microseconds. The timeout is rounded to whole timer
+ *    ticks, and a tick is at most 1 microsecond.
+ *
+ * @param[in] callback
+ *    Function to call on timer expiry, may be NULL. See @ref USTIMER_Callback_t.
+ *
+ * @param[in] user
+ *    Extra callback function parameter for user application.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_USTIMER_OK on success.@n
+ *    @ref ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID if the ID has an illegal value.@n
+ *    @ref ECODE_EMDRV_USTIMER_TIMER_NOT_ALLOCATED if the timer is not reserved.@n
+ *    @ref ECODE_EMDRV_USTIMER_PARAM_ERROR if a periodic timer is shorter than
+ *    one tick.
+ ******************************************************************************/
+Ecode_t USTIMER_StartTimer(USTIMER_TimerID_t id,
+                           USTIMER_TimerType_t type,
+                           uint32_t usec,
+                           USTIMER_Callback_t callback,
+                           void *user)
+{
+  uint64_t ticks;
+  CORE_DECLARE_IRQ_STATE;
+
+  if ( id >= USTIMER_NUM_TIMERS ) {
+    return ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID;
+  }
+
+  ticks = ( ( (uint64_t)freq * usec) + 500000) / 1000000;
+  if ( (type == ustimerTimerTypePeriodic) && (ticks == 0) ) {
+    return ECODE_EMDRV_USTIMER_PARAM_ERROR;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if ( !timer[id].allocated ) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_USTIMER_TIMER_NOT_ALLOCATED;
+  }
+
+  // Bring running timers up to date, the new timer counts from now.
+  TimersUpdate();
+  timer[id].remaining = (int64_t)ticks;
+  timer[id].period = ticks;
+  timer[id].usec = usec;
+  timer[id].type = type;
+  timer[id].callback = callback;
+  timer[id].user = user;
+  timer[id].running = true;
+  TimersReschedule();
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_USTIMER_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Stop a callback timer.
+ *
+ * @param[in] id
+ *    The ID of the timer to stop.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_USTIMER_OK on success.@n
+ *    @ref ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID if the ID has an illegal value.@n
+ *    @ref ECODE_EMDRV_USTIMER_TIMER_NOT_ALLOCATED if the timer is not reserved.
+ ******************************************************************************/
+Ecode_t USTIMER_StopTimer(USTIMER_TimerID_t id)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if ( id >= USTIMER_NUM_TIMERS ) {
+    return ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if ( !timer[id].allocated ) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_USTIMER_TIMER_NOT_ALLOCATED;
+  }
+
+  if ( timer[id].running ) {
+    TimersUpdate();
+    timer[id].running = false;
+    TimersReschedule();
+  }
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_USTIMER_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Check if a callback timer is running.
+ *
+ * @param[in] id
+ *    The ID of the timer to query.
+ *
+ * @param[out] isRunning
+ *    True if timer is running.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_USTIMER_OK on success.@n
+ *    @ref ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID if the ID has an illegal value.@n
+ *    @ref ECODE_EMDRV_USTIMER_TIMER_NOT_ALLOCATED if the timer is not reserved.@n
+ *    @ref ECODE_EMDRV_USTIMER_PARAM_ERROR if an invalid isRunning pointer was
+ *    supplied.
+ ******************************************************************************/
+Ecode_t USTIMER_IsRunning(USTIMER_TimerID_t id, bool *isRunning)
+{
+  if ( id >= USTIMER_NUM_TIMERS ) {
+    return ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID;
+  }
+
+  if ( isRunning == NULL ) {
+    return ECODE_EMDRV_USTIMER_PARAM_ERROR;
+  }
+
+  if ( !timer[id].allocated ) {
+    return ECODE_EMDRV_USTIMER_TIMER_NOT_ALLOCATED;
+  }
+
+  *isRunning = timer[id].running;
+
+  return ECODE_EMDRV_USTIMER_OK;
+}
+
+/***************************************************************************//**
+ * @brief
+ *    Wait in EM1 until a oneshot callback timer has expired.
+ *
+ * @details
+ *    The MCU enters EM1 until the timer is no longer running, either because
+ *    it expired and its callback returned, or because it was stopped from an
+ *    interrupt handler. Returns immediately if the timer is not running.
+ *
+ * @note
+ *    This function assumes that the timer interrupt needed to wake the mcu
+ *    up from EM1 is not blocked.
+ *
+ * @param[in] id
+ *    The ID of the timer to wait for.
+ *
+ * @return
+ *    @ref ECODE_EMDRV_USTIMER_OK on success.@n
+ *    @ref ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID if the ID has an illegal value.@n
+ *    @ref ECODE_EMDRV_USTIMER_TIMER_NOT_ALLOCATED if the timer is not reserved.@n
+ *    @ref ECODE_EMDRV_USTIMER_PARAM_ERROR if the timer is periodic.
+ ******************************************************************************/
+Ecode_t USTIMER_WaitTimer(USTIMER_TimerID_t id)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  if ( id >= USTIMER_NUM_TIMERS ) {
+    return ECODE_EMDRV_USTIMER_ILLEGAL_TIMER_ID;
+  }
+
+  CORE_ENTER_ATOMIC();
+  if ( !timer[id].allocated ) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_USTIMER_TIMER_NOT_ALLOCATED;
+  }
+
+  if ( timer[id].running && (timer[id].type == ustimerTimerTypePeriodic) ) {
+    CORE_EXIT_ATOMIC();
+    return ECODE_EMDRV_USTIMER_PARAM_ERROR;
+  }
+
+  // Interrupts are masked while testing the flag, a pending interrupt
+  // still wakes the core and is serviced when the mask is lifted.
+  while ( timer[id].running ) {
+    EMU_EnterEM1();
+    CORE_EXIT_ATOMIC();
+    CORE_ENTER_ATOMIC();
+  }
+  CORE_EXIT_ATOMIC();
+
+  return ECODE_EMDRV_USTIMER_OK;
+}
+#endif
+
 /** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
 
+// Select the slowest timer frequency that still gives less than 1 us per
+// tick for the current clocks, returns the prescaler.
+static TIMER_Prescale_TypeDef ClockScale(void)
+{
+  uint32_t prescale = _TIMER_CTRL_PRESC_DIV1;
+  uint32_t coreClockScale;
+
+  hfperClockFreq = CMU_ClockFreqGet(cmuClock_HFPER);
+  coreClockFreq = CMU_ClockFreqGet(cmuClock_CORE);
+
+  freq = hfperClockFreq;
+  while ( (prescale < _TIMER_CTRL_PRESC_DIV1024) && (freq > 2000000) ) {
+    prescale++;
+    freq = hfperClockFreq >> prescale;
+  }
+
+  /* Figure out the minimum delay we can have when using timer interrupt
+   * to avoid that actual delay become a full timer counter lap.
+   * We are assuming that this number scales with mcu core clock.
+   * The number is found by trial and err on a GG running at 14MHz.
+   */
+  coreClockScale = (4 * 48000000) / coreClockFreq;
+  minTicks = ( ( (uint64_t)freq * coreClockScale) + 500000) / 1000000;
+
+  return (TIMER_Prescale_TypeDef)prescale;
+}
+
+static void ClockChanged(void *user)
+{
+  TIMER_Prescale_TypeDef prescale;
+  uint32_t oldFreq = freq;
+  CORE_DECLARE_IRQ_STATE;
+
+  (void)user;
+
+  // Changes of other clocks do not disturb running timers.
+  if ((CMU_ClockFreqGet(cmuClock_HFPER) == hfperClockFreq)
+      && (CMU_ClockFreqGet(cmuClock_CORE) == coreClockFreq)) {
+    return;
+  }
+
+  CORE_ENTER_ATOMIC();
+#if (USTIMER_NUM_TIMERS > 0)
+  // Count the ticks elapsed so far at the old tick length.
+  TimersUpdate();
+#endif
+  // Only the prescaler changes, TIMER_Init() would clear the counter under
+  // a delay in progress and the callback timer bookkeeping.
+  prescale = ClockScale();
+  TIMER->CMD  = TIMER_CMD_STOP;
+  TIMER->CTRL = (TIMER->CTRL & ~_TIMER_CTRL_PRESC_MASK)
+                | ((uint32_t)prescale << _TIMER_CTRL_PRESC_SHIFT);
+  TIMER->CMD  = TIMER_CMD_START;
+#if (USTIMER_NUM_TIMERS > 0)
+  TimersRescale(oldFreq);
+  TimersReschedule();
+#else
+  (void)oldFreq;
+#endif
+  CORE_EXIT_ATOMIC();
+}
+
 void TIMER_IRQHandler(void)
 {
   uint32_t flags;
 
-  flags = TIMER_IntGet(TIMER);
+  // Compare flags are set on every counter lap, only act on enabled ones.
+  flags = TIMER_IntGetEnabled(TIMER);
 
   if ( flags & TIMER_IF_CC0 ) {
     TIMER_IntClear(TIMER, TIMER_IFC_CC0);
     timeElapsed = true;
   }
+
+#if (USTIMER_NUM_TIMERS > 0)
+  if ( flags & TIMER_IF_CC1 ) {
+    TIMER_IntClear(TIMER, TIMER_IFC_CC1);
+    TimersProcess();
+  }
+#endif
 }
 
 static void DelayTicksPolled(uint16_t ticks)
@@ -318,6 +691,136 @@ static void DelayTicksEM1(uint16_t ticks)
   }
 }
 
+#if (USTIMER_NUM_TIMERS > 0)
+static void TimersStopAll(void)
+{
+  int i;
+
+  for ( i = 0; i < USTIMER_NUM_TIMERS; i++ ) {
+    timer[i].running = false;
+  }
+}
+
+// Convert the remaining ticks of running timers to the new tick frequency,
+// periods are computed again from their timeout.
+// Called with interrupts disabled, right after TimersUpdate().
+static void TimersRescale(uint32_t oldFreq)
+{
+  uint64_t ticks;
+  int i;
+
+  for ( i = 0; i < USTIMER_NUM_TIMERS; i++ ) {
+    if ( !timer[i].running ) {
+      continue;
+    }
+    if ( timer[i].remaining > 0 ) {
+      // Split to stay within 64 bits for long timeouts.
+      ticks = (uint64_t)timer[i].remaining;
+      timer[i].remaining = (int64_t)( (ticks / oldFreq) * freq
+                                      + ( (ticks % oldFreq) * freq
+                                          + (oldFreq / 2) ) / oldFreq);
+    }
+    timer[i].period = ( ( (uint64_t)freq * timer[i].usec) + 500000) / 1000000;
+    if ( timer[i].period == 0 ) {
+      timer[i].period = 1;
+    }
+  }
+}
+
+// Subtract the ticks elapsed since the last update from the running timers.
+// Called with interrupts disabled, at least once per 16 bit counter lap.
+static void TimersUpdate(void)
+{
+  uint16_t now;
+  uint16_t elapsed;
+  int i;
+
+  now = (uint16_t)TIMER_CounterGet(TIMER);
+  elapsed = (uint16_t)(now - lastUpdate);
+  lastUpdate = now;
+
+  for ( i = 0; i < USTIMER_NUM_TIMERS; i++ ) {
+    if ( timer[i].running ) {
+      timer[i].remaining -= elapsed;
+    }
+  }
+}
+
+// Program compare channel 1 for the timer closest to expiry, at most 65000
+// ticks ahead so that TimersUpdate() never misses a counter lap.
+// Called with interrupts disabled, right after TimersUpdate().
+static void TimersReschedule(void)
+{
+  int64_t next = 65000;
+  bool running = false;
+  int i;
+
+  for ( i = 0; i < USTIMER_NUM_TIMERS; i++ ) {
+    if ( timer[i].running ) {
+      running = true;
+      if ( timer[i].remaining < next ) {
+        next = timer[i].remaining;
+      }
+    }
+  }
+
+  if ( !running ) {
+    TIMER_IntDisable(TIMER, TIMER_IEN_CC1);
+    return;
+  }
+
+  if ( next < (int64_t)minTicks ) {
+    next = minTicks;
+  }
+  TIMER_CompareSet(TIMER, 1, (lastUpdate + (uint32_t)next) & TIMER_MAX);
+  TIMER_IntClear(TIMER, TIMER_IFC_CC1);
+  TIMER_IntEnable(TIMER, TIMER_IEN_CC1);
+}
+
+// Run the callbacks of expired timers and reload periodic ones.
+static void TimersProcess(void)
+{
+  USTIMER_Callback_t callback;
+  void *user;
+  int i;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  TimersUpdate();
+  CORE_EXIT_ATOMIC();
+
+  for ( i = 0; i < USTIMER_NUM_TIMERS; i++ ) {
+    callback = NULL;
+    user = NULL;
+
+    CORE_ENTER_ATOMIC();
+    if ( timer[i].running && (timer[i].remaining <= 0) ) {
+      callback = timer[i].callback;
+      user = timer[i].user;
+      if ( timer[i].type == ustimerTimerTypePeriodic ) {
+        // Keep the period phase, skip periods missed while the interrupt
+        // was blocked.
+        do {
+          timer[i].remaining += (int64_t)timer[i].period;
+        } while ( timer[i].remaining <= 0 );
+      } else {
+        timer[i].running = false;
+      }
+    }
+    CORE_EXIT_ATOMIC();
+
+    if ( callback != NULL ) {
+      callback( (USTIMER_TimerID_t)i, user);
+    }
+  }
+
+  CORE_ENTER_ATOMIC();
+  TimersUpdate();
+  TimersReschedule();
+  CORE_EXIT_ATOMIC();
+}
+#endif
+
 /** @endcond */
 
 /* *INDENT-OFF* */
@@ -329,11 +832,12 @@ static void DelayTicksEM1(uint16_t ticks)
  * @{
 
 @details
-   Implements microsecond delays.
+   Implements microsecond delays and microsecond callback timers.
 
    The delay is implemented using a hardware timer. @ref USTIMER_Init() must
-   be called prior to using the delay functions. @ref USTIMER_Init() must
-   also be called if HFCORECLK and/or HFPERCLK is changed.
+   be called prior to using the delay functions. Changes of HFCORECLK and/or
+   HFPERCLK made with the CMU functions are followed by the driver, running
+   callback timers keep their remaining time.
 
   The source files for the USTIMER driver library resides in the
   emdrv/ustimer folder, and are named ustimer.c and ustimer.h.
@@ -350,6 +854,12 @@ static void DelayTicksEM1(uint16_t ticks)
   one which uses energy mode EM1 to preserve energy while waiting, and one which
   performs busy wait.
 
+  With @ref USTIMER_NUM_TIMERS defined, the driver also provides oneshot and
+  periodic callback timers with microsecond resolution. All callback timers
+  are multiplexed on one compare channel of the same TIMER resource, and
+  their callbacks are called from the TIMER interrupt handler. The delay
+  functions can be used while callback timers are running.
+
 @n @section ustimer_conf Configuration Options
 
   By default the module use TIMER0. Timer resource selection is stored in a
@@ -365,6 +875,9 @@ static void DelayTicksEM1(uint16_t ticks)
 /// USTIMER configuration option. Use this define to select a TIMER resource.
 #define USTIMER_TIMER USTIMER_TIMER3
 
+/// USTIMER configuration option. Number of callback timers.
+#define USTIMER_NUM_TIMERS 2
+
 #endif
   @endverbatim
 
@@ -389,6 +902,21 @@ static void DelayTicksEM1(uint16_t ticks)
     Delay a given number of microseconds. The MCU stays in EM0 during the delay.
     This function can be called in any context and is also thread safe.
 
+  @ref USTIMER_AllocateTimer(), @ref USTIMER_FreeTimer() @n
+    Reserve and release a callback timer, available when
+    @ref USTIMER_NUM_TIMERS is defined.
+
+  @ref USTIMER_StartTimer(), @ref USTIMER_StopTimer() @n
+    Start and stop a oneshot or periodic callback timer. The timeout is given
+    in microseconds.
+
+  @ref USTIMER_IsRunning() @n
+    Check if a callback timer is running.
+
+  @ref USTIMER_WaitTimer() @n
+    Wait for a oneshot callback timer to expire. The MCU enters EM1 while
+    waiting.
+
 @n @section ustimer_example Example
   @verbatim
 #include "ustimer.h"
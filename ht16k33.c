@@ -0,0 +1,173 @@
+#include <stddef.h>
+#include <stdint.h>
+#include "em_core.h"
+#include "bsp.h"
+#include "i2cdrv.h"
+#include "display.h"
+
+/* HT16K33 commands, one byte each */
+#define HT16K33_RAM        0x00U /* display RAM address, auto increment */
+#define HT16K33_OSC_ON     0x21U /* system setup, oscillator on */
+#define HT16K33_DISPLAY_ON 0x81U /* display setup, display on, blink in bits 2:1 */
+#define HT16K33_DIMMING    0xE0U /* dimming set, duty in bits 3:0 */
+
+#define HT16K33_RAM_SIZE   16U   /* 8 commons, 2 bytes each */
+
+static I2CDRV_HandleData_t l_i2c;
+
+/* RAM address followed by the whole RAM, sent in one burst */
+static uint8_t l_ram[1U + HT16K33_RAM_SIZE];
+static volatile bool l_ramBusy;
+
+/* single byte commands, stay valid while queued. a command queued again
+* before it is sent only sends the newer value */
+static uint8_t const l_oscOn = HT16K33_OSC_ON;
+static uint8_t l_dimming;
+static uint8_t l_displaySetup;
+
+/* commands the queue refused or the bus lost. they are queued again when
+* another transfer completed or with the next frame */
+#define DIRTY_OSC     0x01U
+#define DIRTY_DISPLAY 0x02U
+#define DIRTY_DIMMING 0x04U
+static volatile uint8_t l_dirty;
+
+static void ht16k33Init(void);
+static bool ht16k33Flush(uint8_t const *fb, uint8_t first, uint8_t last);
+static void ht16k33Brightness(uint8_t level);
+static void ht16k33Blink(uint8_t rate);
+
+DISPLAY_Backend const DISPLAY_ht16k33 = {
+  ht16k33Init,
+  ht16k33Flush,
+  ht16k33Brightness,
+  ht16k33Blink
+};
+
+static void dirtyMark(uint8_t dirty) {
+  CORE_ATOMIC_SECTION(l_dirty |= dirty; )
+}
+
+static void commandDone(I2CDRV_Handle_t handle, Ecode_t status, void *user);
+
+/* dirty gives the commands of the transfer, marked again if it fails */
+static void commandSend(uint8_t const *cmd, uint16_t len, uint8_t dirty) {
+  I2CDRV_Transfer_t t = {
+    HT16K33_ADDR, i2cdrvTransferWrite, NULL, 0U, 1U, NULL, 0U, commandDone,
+    NULL
+  };
+
+  /* every command byte in its own segment, repeated START between them */
+  t.txBuffer = cmd;
+  t.txCount = len;
+  t.userParam = (void *)(uintptr_t)dirty;
+  if (I2CDRV_QueueTransfer(&l_i2c, &t) != ECODE_EMDRV_I2CDRV_OK) {
+    dirtyMark(dirty);
+  }
+}
+
+/* queue the dirty commands again, in the order of the setup */
+static void commandResend(void) {
+  uint8_t dirty;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  dirty = l_dirty;
+  l_dirty = 0U;
+  CORE_EXIT_ATOMIC();
+  if ((dirty & DIRTY_OSC) != 0U) {
+    commandSend(&l_oscOn, 1U, DIRTY_OSC);
+  }
+  if ((dirty & DIRTY_DISPLAY) != 0U) {
+    commandSend(&l_displaySetup, 1U, DIRTY_DISPLAY);
+  }
+  if ((dirty & DIRTY_DIMMING) != 0U) {
+    commandSend(&l_dimming, 1U, DIRTY_DIMMING);
+  }
+}
+
+/* a failed transfer is not sent again from its own callback, a slave that
+* is gone would keep the bus busy */
+static void transferDone(Ecode_t status) {
+  if (status == ECODE_EMDRV_I2CDRV_OK && l_dirty != 0U) {
+    commandResend();
+  }
+}
+
+static void commandDone(I2CDRV_Handle_t handle, Ecode_t status, void *user) {
+  (void)handle;
+  if (status != ECODE_EMDRV_I2CDRV_OK) {
+    dirtyMark((uint8_t)(uintptr_t)user);
+  }
+  transferDone(status);
+}
+
+static void ramDone(I2CDRV_Handle_t handle, Ecode_t status, void *user) {
+  (void)handle;
+  (void)user;
+  if (status != ECODE_EMDRV_I2CDRV_OK) {
+    DISPLAY_invalidate(); /* NACK, bus error or abort: send the frame again */
+  }
+  l_ramBusy = false;
+  transferDone(status);
+}
+
+static void ht16k33Init(void) {
+  static uint8_t const setup[] = {
+    HT16K33_OSC_ON,
+    HT16K33_DISPLAY_ON,
+    HT16K33_DIMMING | DISPLAY_BRIGHT_MAX
+  };
+  I2CDRV_Init_t init = I2CDRV_MASTER_I2C0;
+
+  init.port = DISPLAY_I2C;
+  init.portLocation = DISPLAY_I2C_LOCATION;
+  init.bitRate = I2C_FREQ_FAST_MAX;
+  init.clhr = i2cClockHLRAsymetric;
+  I2CDRV_Init(&l_i2c, &init);
+  l_ramBusy = false;
+  l_displaySetup = HT16K33_DISPLAY_ON;
+  l_dimming = HT16K33_DIMMING | DISPLAY_BRIGHT_MAX;
+  l_dirty = 0U;
+  commandSend(setup, sizeof(setup), DIRTY_OSC | DIRTY_DISPLAY | DIRTY_DIMMING);
+}
+
+static bool ht16k33Flush(uint8_t const *fb, uint8_t first, uint8_t last) {
+  I2CDRV_Transfer_t t = {
+    HT16K33_ADDR, i2cdrvTransferWrite, l_ram, sizeof(l_ram), 0U,
+    NULL, 0U, ramDone, NULL
+  };
+  uint8_t row;
+
+  /* the whole RAM is shorter on the bus than addressing the dirty rows
+  * one by one, so first and last are not used */
+  (void)first;
+  (void)last;
+  if (l_dirty != 0U) {
+    commandResend();
+  }
+  if (l_ramBusy) {
+    return false;
+  }
+  l_ram[0] = HT16K33_RAM;
+  for (row = 0U; row < DISPLAY_ROWS; row++) {
+    l_ram[1U + 2U * row] = fb[row];
+    l_ram[2U + 2U * row] = 0U; /* ROW8..15 not connected */
+  }
+  l_ramBusy = true;
+  if (I2CDRV_QueueTransfer(&l_i2c, &t) != ECODE_EMDRV_I2CDRV_OK) {
+    l_ramBusy = false;
+    return false;
+  }
+  return true;
+}
+
+static void ht16k33Brightness(uint8_t level) {
+  l_dimming = HT16K33_DIMMING | level;
+  commandSend(&l_dimming, 1U, DIRTY_DIMMING);
+}
+
+static void ht16k33Blink(uint8_t rate) {
+  l_displaySetup = HT16K33_DISPLAY_ON | (uint8_t)(rate << 1);
+  commandSend(&l_displaySetup, 1U, DIRTY_DISPLAY);
+}
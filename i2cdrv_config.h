@@ -0,0 +1,25 @@
+#ifndef __I2CDRV_CONFIG_H__
+#define __I2CDRV_CONFIG_H__
+
+/* I2CDRV configuration of the application, found before the template in
+* emdrv/i2cdrv/config through the include path order */
+
+/* HT16K33 frame and up to three commands */
+#define EMDRV_I2CDRV_QUEUE_SIZE     4
+
+/* no DMADRV: it would share the controller BSP_init() enabled, but it
+* allocates from channel 0 up, where bsp.h puts the DMA_CH_ channels */
+#ifndef EMDRV_I2CDRV_DMA_THRESHOLD
+#define EMDRV_I2CDRV_DMA_THRESHOLD  0
+#endif
+
+/* I2C0 stops in EM2, SCHED_run() idles in EM1 while transfers are queued */
+#define EMDRV_I2CDRV_SLEEPDRV_INTEGRATION
+
+/* transfers are queued from the display task and the I2C callbacks only,
+* no other interrupt needs masking in EMDRV_NVIC_SECTIONS builds */
+#ifndef EMDRV_I2CDRV_SECTION_EXTRA_IRQS
+#define EMDRV_I2CDRV_SECTION_EXTRA_IRQS(X, w)
+#endif
+
+#endif // __I2CDRV_CONFIG_H__
@@ -80,6 +80,12 @@ extern "C" {
  *     buffers must be exactly overlapping. If partly overlapping, the
  *     behavior is undefined.
  *
+ *   The functions above block until all data is processed. For ECB, CBC, and
+ *   CTR modes with 128 bit keys, a stream API is also available. A stream
+ *   request, see AES_StreamProcess(), is processed block by block from the
+ *   AES interrupt, and several stream sessions can share the AES peripheral.
+ *   The application must call AES_StreamIRQHandler() from AES_IRQHandler().
+ *
  *   Use a cipher mode according to its requirements to avoid
  *   breaking security. See a specific cipher mode
  *   theory for details.
@@ -115,6 +121,54 @@ extern "C" {
  */
 typedef void (*AES_CtrFuncPtr_TypeDef)(uint8_t *ctr);
 
+/** Cipher mode of a stream session. */
+typedef enum {
+  aesStreamModeECB, /**< Electronic Code Book mode. */
+  aesStreamModeCBC, /**< Cipher Block Chaining mode. */
+  aesStreamModeCTR  /**< Counter mode, 32 bit counter increment. */
+} AES_StreamMode_TypeDef;
+
+struct AES_Stream;
+
+/**
+ * @brief
+ *   An AES stream completion callback function pointer.
+ * @details
+ *   Called from AES_StreamIRQHandler() when all blocks of a request passed
+ *   to AES_StreamProcess() have been processed.
+ *   Parameters:
+ *   @li stream - The stream session the request belonged to.
+ *   @li user - The user pointer given to AES_StreamProcess().
+ */
+typedef void (*AES_StreamCallback_TypeDef)(struct AES_Stream *stream,
+                                           void *user);
+
+/**
+ * @brief
+ *   AES stream session.
+ * @details
+ *   Holds the key and the chaining state (IV or counter) of one cipher
+ *   stream, so that several sessions may share the AES peripheral. Set up
+ *   with AES_StreamInit(). The application must not modify the contents
+ *   while a request is pending.
+ */
+typedef struct AES_Stream {
+  /** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
+  uint32_t                   key[4];     /* Encryption or decryption key. */
+  uint32_t                   chain[4];   /* IV, previous block, or counter. */
+  uint32_t                   block[4];   /* Input of the block in progress. */
+  AES_StreamMode_TypeDef     mode;
+  bool                       encrypt;
+  volatile bool              busy;
+  const uint32_t             *in;
+  uint32_t                   *out;
+  unsigned int               blocks;     /* Blocks left, including current. */
+  AES_StreamCallback_TypeDef callback;
+  void                       *user;
+  struct AES_Stream          *next;      /* Next session waiting for AES. */
+  /** @endcond */
+} AES_Stream_TypeDef;
+
 /*******************************************************************************
  *****************************   PROTOTYPES   **********************************
  ******************************************************************************/
@@ -298,6 +352,36 @@ void AES_OFB256(uint8_t *out,
                 const uint8_t *iv);
 #endif
 
+/***************************************************************************//**
+ * @brief
+ *   Check if a stream session has a request in progress.
+ *
+ * @param[in] stream
+ *   A stream session.
+ *
+ * @return
+ *   True if a request passed to AES_StreamProcess() has not completed yet.
+ ******************************************************************************/
+__STATIC_INLINE bool AES_StreamBusy(const AES_Stream_TypeDef *stream)
+{
+  return stream->busy;
+}
+
+void AES_StreamIRQHandler(void);
+
+void AES_StreamInit(AES_Stream_TypeDef *stream,
+                    AES_StreamMode_TypeDef mode,
+                    const uint8_t *key,
+                    const uint8_t *iv,
+                    bool encrypt);
+
+bool AES_StreamProcess(AES_Stream_TypeDef *stream,
+                       uint8_t *out,
+                       const uint8_t *in,
+                       unsigned int len,
+                       AES_StreamCallback_TypeDef callback,
+                       void *user);
+
 /** @} (end addtogroup AES) */
 /** @} (end addtogroup emlib) */
 
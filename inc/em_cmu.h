@@ -1613,6 +1613,22 @@ typedef struct {
   }
 #endif // CMU_OSCENCMD_DPLLEN
 
+/**
+ * Clock change callback, see @ref CMU_ClockChangeSubscribe().
+ * Called after a clock frequency changed, in the context of the function
+ * that changed it.
+ */
+typedef void (*CMU_ClockChangeCallback_TypeDef)(void *user);
+
+/** Clock change subscriber, allocated by the subscriber. */
+typedef struct CMU_ClockChangeSubscriber {
+  CMU_ClockChangeCallback_TypeDef callback;   /**< Called after a change.  */
+  void                            *user;      /**< Callback parameter.     */
+  /** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
+  struct CMU_ClockChangeSubscriber *next;
+  /** @endcond */
+} CMU_ClockChangeSubscriber_TypeDef;
+
 /*******************************************************************************
  *****************************   PROTOTYPES   **********************************
  ******************************************************************************/
@@ -1638,6 +1654,11 @@ void                  CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable);
 CMU_ClkDiv_TypeDef    CMU_ClockDivGet(CMU_Clock_TypeDef clock);
 void                  CMU_ClockDivSet(CMU_Clock_TypeDef clock, CMU_ClkDiv_TypeDef div);
 uint32_t              CMU_ClockFreqGet(CMU_Clock_TypeDef clock);
+void                  CMU_ClockFreqInvalidate(void);
+void                  CMU_ClockChangeSubscribe(CMU_ClockChangeSubscriber_TypeDef *subscriber,
+                                               CMU_ClockChangeCallback_TypeDef callback,
+                                               void *user);
+void                  CMU_ClockChangeUnsubscribe(CMU_ClockChangeSubscriber_TypeDef *subscriber);
 
 #if defined(_SILICON_LABS_32B_SERIES_1)
 void                  CMU_ClockPrescSet(CMU_Clock_TypeDef clock, CMU_ClkPresc_TypeDef presc);
@@ -68,6 +68,11 @@
 #error "em_core: Unexpected NVIC external interrupt count."
 #endif
 
+#if defined(CORE_PROFILE) && !defined(CORE_PROFILE_SITES)
+/** Number of call sites kept by the critical section profiler. */
+#define CORE_PROFILE_SITES    16
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -101,6 +106,16 @@ extern "C" {
     CORE_EXIT_CRITICAL();               \
   }
 
+#if defined(CORE_PROFILE)
+/** Enter CRITICAL section. Assumes that a @ref CORE_DECLARE_IRQ_STATE exist in
+ *  scope. The section is timed by the profiler. */
+#define CORE_ENTER_CRITICAL() \
+  irqState = CORE_ProfileEnter(CORE_EnterCritical(), __FILE__, __LINE__)
+
+/** Exit CRITICAL section. Assumes that a @ref CORE_DECLARE_IRQ_STATE exist in
+ *  scope. The section is timed by the profiler. */
+#define CORE_EXIT_CRITICAL()    CORE_ExitCritical(CORE_ProfileExit(irqState))
+#else
 /** Enter CRITICAL section. Assumes that a @ref CORE_DECLARE_IRQ_STATE exist in
  *  scope. */
 #define CORE_ENTER_CRITICAL()   irqState = CORE_EnterCritical()
@@ -108,6 +123,7 @@ extern "C" {
 /** Exit CRITICAL section. Assumes that a @ref CORE_DECLARE_IRQ_STATE exist in
  *  scope. */
 #define CORE_EXIT_CRITICAL()    CORE_ExitCritical(irqState)
+#endif
 
 /** CRITICAL style yield. */
 #define CORE_YIELD_CRITICAL()   CORE_YieldCritical()
@@ -133,6 +149,16 @@ extern "C" {
     CORE_EXIT_ATOMIC();               \
   }
 
+#if defined(CORE_PROFILE)
+/** Enter ATOMIC section. Assumes that a @ref CORE_DECLARE_IRQ_STATE exist in
+ *  scope. The section is timed by the profiler. */
+#define CORE_ENTER_ATOMIC() \
+  irqState = CORE_ProfileEnter(CORE_EnterAtomic(), __FILE__, __LINE__)
+
+/** Exit ATOMIC section. Assumes that a @ref CORE_DECLARE_IRQ_STATE exist in
+ *  scope. The section is timed by the profiler. */
+#define CORE_EXIT_ATOMIC()    CORE_ExitAtomic(CORE_ProfileExit(irqState))
+#else
 /** Enter ATOMIC section. Assumes that a @ref CORE_DECLARE_IRQ_STATE exist in
  *  scope. */
 #define CORE_ENTER_ATOMIC()   irqState = CORE_EnterAtomic()
@@ -140,6 +166,7 @@ extern "C" {
 /** Exit ATOMIC section. Assumes that a @ref CORE_DECLARE_IRQ_STATE exist in
  *  scope. */
 #define CORE_EXIT_ATOMIC()    CORE_ExitAtomic(irqState)
+#endif
 
 /** ATOMIC style yield. */
 #define CORE_YIELD_ATOMIC()   CORE_YieldAtomic()
@@ -224,6 +251,18 @@ typedef struct {
   uint32_t a[CORE_NVIC_REG_WORDS];    /*!< Array of NVIC mask words. */
 } CORE_nvicMask_t;
 
+#if defined(CORE_PROFILE)
+/** Critical section profiler record of one call site. */
+typedef struct {
+  const char *file;   /*!< __FILE__ of the section entry. */
+  uint32_t line;      /*!< __LINE__ of the section entry. */
+  uint32_t count;     /*!< Outermost sections entered at this site. */
+  uint32_t wrapped;   /*!< Sections longer than the timestamp range. */
+  uint32_t max;       /*!< Longest masked time in timestamp ticks. */
+  uint32_t total;     /*!< Sum of the masked times in timestamp ticks. */
+} CORE_ProfileSite_t;
+#endif
+
 /*******************************************************************************
  *****************************   PROTOTYPES   **********************************
  ******************************************************************************/
@@ -256,6 +295,18 @@ void  CORE_NvicMaskSetIRQ(IRQn_Type irqN, CORE_nvicMask_t *mask);
 void  CORE_NvicMaskClearIRQ(IRQn_Type irqN, CORE_nvicMask_t *mask);
 bool  CORE_NvicIRQDisabled(IRQn_Type irqN);
 
+#if defined(CORE_PROFILE)
+CORE_irqState_t CORE_ProfileEnter(CORE_irqState_t irqState,
+                                  const char *file,
+                                  uint32_t line);
+CORE_irqState_t CORE_ProfileExit(CORE_irqState_t irqState);
+void  CORE_ProfileSuspend(void);
+void  CORE_ProfileResume(void);
+uint32_t CORE_ProfileGet(CORE_ProfileSite_t *sites, uint32_t maxSites);
+uint32_t CORE_ProfileDropped(void);
+void  CORE_ProfileReset(void);
+#endif
+
 void *CORE_GetNvicRamTableHandler(IRQn_Type irqN);
 void  CORE_SetNvicRamTableHandler(IRQn_Type irqN, void *handler);
 void  CORE_InitNvicVectorTable(uint32_t *sourceTable,
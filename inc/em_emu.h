@@ -38,6 +38,9 @@
 
 #include <stdbool.h>
 #include "em_bus.h"
+#if defined(CORE_PROFILE)
+#include "em_core.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -765,7 +768,13 @@ __STATIC_INLINE void EMU_EnterEM1(void)
 {
   /* Enter sleep mode. */
   SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+#if defined(CORE_PROFILE)
+  CORE_ProfileSuspend();
+  __WFI();
+  CORE_ProfileResume();
+#else
   __WFI();
+#endif
 }
 
 #if defined(_EMU_STATUS_VSCALE_MASK)
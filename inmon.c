@@ -0,0 +1,143 @@
+#include <stddef.h>
+#include "em_core.h"
+#include "em_rtc.h"
+#include "bsp.h"
+#include "inmon.h"
+
+#if (INMON_MAX_EVENTS & (INMON_MAX_EVENTS - 1)) || (INMON_MAX_EVENTS > 128)
+#error INMON_MAX_EVENTS must be a power of 2 up to 128
+#endif
+
+static INMON_Config const *l_config;
+static uint32_t l_pins;   /* interrupt flags of the monitored inputs */
+static uint8_t l_state;   /* decoder state */
+static uint32_t l_start;  /* time of the last INMON_START edge */
+
+static INMON_Event l_event[INMON_MAX_EVENTS];
+static volatile uint8_t l_head; /* events recorded, free running */
+static volatile uint8_t l_tail; /* events read, free running */
+static volatile uint32_t l_lost;
+static bool l_postDue;          /* the batch post failed, retried per edge */
+
+bool INMON_start(INMON_Config const *config) {
+  INMON_Input const *in;
+  uint32_t pins = 0U;
+  uint8_t i;
+
+  if (config->batch == 0U || config->batch > INMON_MAX_EVENTS) {
+    return false;
+  }
+  for (i = 0U; i < config->numInputs; i++) {
+    in = &config->inputs[i];
+    if ((pins & (1UL << in->pin)) != 0U) {
+      return false; /* one external interrupt per pin number */
+    }
+    pins |= 1UL << in->pin;
+  }
+
+  NVIC_DisableIRQ(GPIO_EVEN_IRQn);
+  NVIC_DisableIRQ(GPIO_ODD_IRQn);
+  l_config = config;
+  l_pins = pins;
+  l_state = 0U;
+  l_head = 0U;
+  l_tail = 0U;
+  l_lost = 0U;
+  l_postDue = false;
+  for (i = 0U; i < config->numInputs; i++) {
+    in = &config->inputs[i];
+    GPIO_ExtIntConfig(in->port, in->pin, in->pin,
+                      (in->edges & INMON_EDGE_RISING) != 0U,
+                      (in->edges & INMON_EDGE_FALLING) != 0U,
+                      true);
+  }
+  GPIO_IntClear(pins);
+  NVIC_ClearPendingIRQ(GPIO_EVEN_IRQn);
+  NVIC_ClearPendingIRQ(GPIO_ODD_IRQn);
+  NVIC_EnableIRQ(GPIO_EVEN_IRQn);
+  NVIC_EnableIRQ(GPIO_ODD_IRQn);
+  return true;
+}
+
+bool INMON_read(INMON_Event *event) {
+  CORE_DECLARE_IRQ_STATE;
+  bool read = false;
+
+  CORE_ENTER_ATOMIC();
+  if (l_tail != l_head) {
+    *event = l_event[l_tail % INMON_MAX_EVENTS];
+    l_tail++;
+    read = true;
+  }
+  CORE_EXIT_ATOMIC();
+  return read;
+}
+
+uint32_t INMON_lost(void) {
+  return l_lost;
+}
+
+BSP_FAST static void record(uint8_t event, uint32_t now) {
+  INMON_Event *e;
+  uint8_t count = (uint8_t)(l_head - l_tail);
+
+  if (count == INMON_MAX_EVENTS) {
+    l_lost++;
+  } else {
+    e = &l_event[l_head % INMON_MAX_EVENTS];
+    e->time = now;
+    e->duration = (now - l_start) & _RTC_CNT_MASK;
+    e->event = event;
+    l_head++;
+    /* one post per batch, the task reads all buffered events */
+    if (count + 1U == l_config->batch) {
+      l_postDue = true;
+    }
+  }
+  /* a post the full task queue refused is tried again with the next event */
+  if (l_postDue) {
+    l_postDue = !SCHED_post(l_config->prio, l_config->sig);
+  }
+}
+
+BSP_FAST static void decode(uint8_t input, uint8_t edge, uint32_t now) {
+  INMON_Transition const *t = l_config->transitions;
+  INMON_Transition const *end = t + l_config->numTransitions;
+
+  for (; t < end; t++) {
+    if (t->state == l_state && t->input == input && (t->edge & edge) != 0U) {
+      if (t->event != INMON_NO_EVENT) {
+        record(t->event, now);
+      }
+      if ((t->flags & INMON_START) != 0U) {
+        l_start = now;
+      }
+      l_state = t->next;
+      return;
+    }
+  }
+}
+
+BSP_FAST void INMON_irq(uint32_t flags) {
+  INMON_Input const *in;
+  uint32_t now = RTC_CounterGet();
+  uint8_t i;
+
+  flags &= l_pins;
+  GPIO_IntClear(flags);
+  for (i = 0U; i < l_config->numInputs && flags != 0U; i++) {
+    in = &l_config->inputs[i];
+    if ((flags & (1UL << in->pin)) != 0U) {
+      flags &= ~(1UL << in->pin);
+      if (in->edges != INMON_EDGE_ANY) {
+        decode(i, in->edges, now);
+      } else {
+        /* the level now tells the edge, pulses shorter than the interrupt
+        * latency read as the wrong edge */
+        decode(i, GPIO_PinInGet(in->port, in->pin) != 0U ? INMON_EDGE_RISING
+                                                          : INMON_EDGE_FALLING,
+               now);
+      }
+    }
+  }
+}
@@ -0,0 +1,75 @@
+#ifndef __INMON_H__
+#define __INMON_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_gpio.h"
+
+/* input monitor
+* edges of GPIO inputs drive a decoder state machine described by a
+* transition table, in the manner of the LESENSE decoder (the Zero Gecko
+* has no LESENSE). the edge interrupts wake the core from EM2 only for the
+* decoder step; the application task is posted when a transition marked
+* with an event has filled the event buffer to the configured batch.
+* times are RTC counts, 24 bits, at the RTCDRV tick rate: see SCHED_init() */
+
+#define INMON_MAX_EVENTS 8 /* event buffer, power of 2 */
+
+#define INMON_EDGE_RISING  1U
+#define INMON_EDGE_FALLING 2U
+#define INMON_EDGE_ANY     (INMON_EDGE_RISING | INMON_EDGE_FALLING)
+
+#define INMON_NO_EVENT 0U
+
+/* transition flags */
+#define INMON_START 1U /* the edge starts the duration of the next event */
+
+/* monitored input, the pin numbers of the inputs must differ. with both
+* edges interrupting the level read in the interrupt tells the edge */
+typedef struct {
+    GPIO_Port_TypeDef port;
+    uint8_t pin;
+    uint8_t edges; /* INMON_EDGE_xxx interrupting */
+} INMON_Input;
+
+/* in state, an edge of inputs[input] moves the decoder to next. the first
+* matching transition is taken, edges without one are ignored */
+typedef struct {
+    uint8_t state;
+    uint8_t input;
+    uint8_t edge;  /* INMON_EDGE_xxx matching */
+    uint8_t next;
+    uint8_t flags; /* INMON_START */
+    uint8_t event; /* recorded with the edge, or INMON_NO_EVENT */
+} INMON_Transition;
+
+typedef struct {
+    INMON_Input const *inputs;
+    uint8_t numInputs;
+    INMON_Transition const *transitions;
+    uint8_t numTransitions;
+    uint8_t batch; /* buffered events posting the task, 1..INMON_MAX_EVENTS */
+    uint8_t prio;  /* task and signal posted */
+    uint8_t sig;
+} INMON_Config;
+
+typedef struct {
+    uint32_t time;     /* RTC count of the edge */
+    uint32_t duration; /* RTC ticks since the last INMON_START edge */
+    uint8_t event;
+} INMON_Event;
+
+/* configure the input interrupts, the decoder starts in state 0 */
+bool INMON_start(INMON_Config const *config);
+
+/* take the oldest buffered event, returns false if there is none */
+bool INMON_read(INMON_Event *event);
+
+/* events lost because the buffer was full */
+uint32_t INMON_lost(void);
+
+/* decoder step for the pending GPIO interrupt flags, called from the GPIO
+* interrupt handlers. clears the flags of the monitored inputs */
+void INMON_irq(uint32_t flags);
+
+#endif // __INMON_H__
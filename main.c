@@ -1,5 +1,13 @@
 
+#include "em_core.h"
 #include "bsp.h"
+#include "inmon.h"
+#ifdef BSP_ADC
+#include "adcscan.h"
+#endif
+#ifdef BSP_LOG
+#include "dlog.h"
+#endif
 //#include "startup_efm32.c"
 //#define 	CMU_HFPERCLKEN0_GPIO   (0x1U << 7)
 //#define 	GPIO_BASE   (0x40006000U)
@@ -21,27 +29,178 @@ int number;
 
 float j;
 
+#ifdef BSP_BENCH
+/* bench results as JSON, read out with the debugger */
+char benchJson[448];
+#endif
+
+#ifdef BSP_ADC
+/* latest decimated ADC frame, read out with the debugger */
+uint16_t adcFrame[ADC_SCAN_CHANNELS];
+
+#define ADC_RATE 1000 /* scans per second */
+#endif
+
+/* pause between display frames [ms], was BSP_delay(1000) */
+#define FRAME_PAUSE_MS 30
+#define TELEMETRY_MS   5000
+
+#ifdef BSP_DISPLAY_HT16K33
+#define DISPLAY_BACKEND (&DISPLAY_ht16k33)
+#else
+#define DISPLAY_BACKEND (&DISPLAY_max7219)
+#endif
+
+/* capture: PE13 falling starts, PE11 rising stops. a repeated start
+* restarts the measurement */
+enum { CAPTURE_IDLE, CAPTURE_STARTED };
+enum { CAPTURE_PAIR = 1 };
+
+static INMON_Input const captureInputs[] = {
+  { gpioPortE, 13, INMON_EDGE_FALLING },
+  { gpioPortE, 11, INMON_EDGE_RISING },
+};
+
+static INMON_Transition const captureTransitions[] = {
+  { CAPTURE_IDLE,    0, INMON_EDGE_FALLING, CAPTURE_STARTED, INMON_START, INMON_NO_EVENT },
+  { CAPTURE_STARTED, 0, INMON_EDGE_FALLING, CAPTURE_STARTED, INMON_START, INMON_NO_EVENT },
+  { CAPTURE_STARTED, 1, INMON_EDGE_RISING,  CAPTURE_IDLE,    0,           CAPTURE_PAIR },
+};
+
+static INMON_Config const captureConfig = {
+  captureInputs, sizeof(captureInputs) / sizeof(captureInputs[0]),
+  captureTransitions, sizeof(captureTransitions) / sizeof(captureTransitions[0]),
+  1, TASK_CAPTURE, SIG_CAPTURE
+};
+
+static SCHED_Timer frameTimer;
+#if defined(BSP_BENCH) || defined(EMDRV_TRACE) || defined(BSP_LOG)
+static SCHED_Timer telemetryTimer;
+#endif
+
+static void displayTask(uint8_t sig) {
+  (void)sig;
+  drawMatrix(matrix);
+  SCHED_timerArm(&frameTimer, FRAME_PAUSE_MS, false);
+}
+
+static void captureTask(uint8_t sig) {
+  INMON_Event ev;
+
+  (void)sig;
+  /* only the latest pair is shown */
+  while (INMON_read(&ev)) {
+    number = (int)ev.duration;
+#ifdef BSP_LOG
+    DLOG1(DLOG_CAPTURE, ev.duration);
+#endif
+  }
+  updateMatrix(((float)RTCDRV_TicksToMsec((uint32_t)number))/1000,matrix);
+}
+
+#ifdef BSP_ADC
+static void adcOutput(uint16_t const *frame) {
+  int i;
+
+  for (i = 0; i < ADC_SCAN_CHANNELS; i++) {
+    adcFrame[i] = frame[i];
+  }
+}
+#endif
+
+#if defined(CORE_PROFILE) && defined(BSP_LOG)
+#define CORE_PROFILE_WORST 3 /* sites logged per telemetry period */
+
+static CORE_ProfileSite_t coreSites[CORE_PROFILE_SITES];
+
+/* log the sites with the longest masked time, worst first */
+static void coreProfileLog(void) {
+  uint32_t n = CORE_ProfileGet(coreSites, CORE_PROFILE_SITES);
+  uint32_t worst;
+  uint32_t i;
+  int k;
+
+  for (k = 0; k < CORE_PROFILE_WORST; k++) {
+    worst = n;
+    for (i = 0U; i < n; i++) {
+      if (coreSites[i].count != 0U
+          && (worst == n || coreSites[i].max > coreSites[worst].max)) {
+        worst = i;
+      }
+    }
+    if (worst == n) {
+      break;
+    }
+    DLOG3(DLOG_CORE_SITE, (uintptr_t)coreSites[worst].file,
+          coreSites[worst].line, coreSites[worst].max);
+    coreSites[worst].count = 0U; /* logged */
+  }
+}
+#endif
+
+#if defined(BSP_BENCH) || defined(EMDRV_TRACE) || defined(BSP_LOG)
+static void telemetryTask(uint8_t sig) {
+  (void)sig;
+#ifdef BSP_BENCH
+  BSP_benchJson(benchJson, sizeof(benchJson));
+#endif
+#ifdef EMDRV_TRACE
+  BSP_traceDump();
+#endif
+#ifdef BSP_LOG
+  DLOG1(DLOG_CAPTURE_LOST, INMON_lost());
+#ifdef BSP_ADC
+  DLOG1(DLOG_ADC_OVERRUNS, ADCSCAN_overruns());
+#endif
+#ifdef CORE_PROFILE
+  coreProfileLog();
+#endif
+#endif
+}
+#endif
+
 int main()
 {
   CHIP_Init();
   BSP_init();
   BSP_setLED();
   initSpi3Wire();
+  BSP_cycleInit();
+#ifdef CORE_PROFILE
+  CORE_ProfileReset(); /* timed with the cycle counter from here */
+#endif
+  SCHED_init(); /* before the display blocks energy modes */
+#ifdef BSP_LOG
+  DLOG_init();
+  DLOG1(DLOG_BOOT, SystemCoreClock);
+#endif
+  BSP_delay(305); /* display power up */
+  DISPLAY_init(DISPLAY_BACKEND);
+#ifdef BSP_BENCH
+  BSP_benchRun();
+#endif
   updateMatrix(0.1,matrix);
+  SCHED_taskStart(TASK_DISPLAY, displayTask);
+  SCHED_taskStart(TASK_CAPTURE, captureTask);
+  SCHED_timerInit(&frameTimer, TASK_DISPLAY, SIG_TICK);
+  INMON_start(&captureConfig);
+#ifdef BSP_ADC
+  SCHED_taskStart(TASK_ADC, ADCSCAN_task);
+  ADCSCAN_start(ADC_RATE, adcOutput);
+#endif
+#if defined(BSP_BENCH) || defined(EMDRV_TRACE) || defined(BSP_LOG)
+  SCHED_taskStart(TASK_TELEMETRY, telemetryTask);
+  SCHED_timerInit(&telemetryTimer, TASK_TELEMETRY, SIG_TICK);
+  SCHED_timerArm(&telemetryTimer, TELEMETRY_MS, true);
+#endif
   __enable_irq();
-  BSP_delay(10000);
-  USART1->TXDOUBLE = 0xC01;
-  BSP_delay(1000);
-  USART1->TXDOUBLE |= 0xB07;
-  BSP_delay(1000);
-  while (1) {
-      
-      drawMatrix(matrix);
-      BSP_delay(1000);
+
+  /* first frame now, displayTask() schedules the next ones */
+  SCHED_post(TASK_DISPLAY, SIG_TICK);
+  SCHED_run();
     //BSP_delay(32768);
     //USART1->TXDOUBLE |= 0xF0;
     //writeSpiByte(0xF0,1);
-  }
   
   
     /*TIMER0->CMD |= 1;
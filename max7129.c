@@ -1,11 +1,62 @@
 //driver for max7219 efm32zg
+#include <math.h>
 #include "bsp.h"
+#include "em_core.h"
+#include "em_emu.h"
+#include "sleep.h"
+#include "display.h"
 char matrix[8];
 float value;
 int second;
 int third;
 int fourth;
 int first;
+
+#define SLEEP_TAG_MAX7219 SLEEP_TAG('M', '7', '2', '1')
+
+MAX7219_SCRIPT(MAX7219_scriptInit,
+    MAX7219_CMD(MAX7219_DISPLAY_TEST, 0),
+    MAX7219_CMD(MAX7219_DECODE_MODE, 0),
+    MAX7219_CMD(MAX7219_SCAN_LIMIT, 7),
+    MAX7219_CMD(MAX7219_SHUTDOWN, 1));
+
+MAX7219_SCRIPT(MAX7219_scriptTest,
+    MAX7219_CMD(MAX7219_DISPLAY_TEST, 1));
+
+MAX7219_SCRIPT(MAX7219_scriptShutdown,
+    MAX7219_CMD(MAX7219_DISPLAY_TEST, 0),
+    MAX7219_CMD(MAX7219_SHUTDOWN, 0));
+
+static volatile bool l_scriptBusy;
+
+/* DMA callback, runs in the DMA interrupt */
+static void scriptDone(unsigned int channel, bool primary, void *user) {
+  (void)channel;
+  (void)primary;
+  (void)user;
+  l_scriptBusy = false;
+  SLEEP_SleepBlockEndTagged(sleepEM2, SLEEP_TAG_MAX7219);
+}
+
+static DMA_CB_TypeDef l_scriptCb = { scriptDone, NULL, 0 };
+
+/* display backend, scripts built at run time */
+static MAX7219_Cmd l_frameCmd[DISPLAY_ROWS];
+static MAX7219_Script l_frame = { l_frameCmd, 0U };
+static MAX7219_Cmd l_intensityCmd;
+static MAX7219_Script const l_intensity = { &l_intensityCmd, 1U };
+
+static void max7219Init(void);
+static bool max7219Flush(uint8_t const *fb, uint8_t first, uint8_t last);
+static void max7219Brightness(uint8_t level);
+
+DISPLAY_Backend const DISPLAY_max7219 = {
+  max7219Init,
+  max7219Flush,
+  max7219Brightness,
+  NULL /* no blink in the MAX7219 */
+};
+
 void initSpi3Wire()
     {
       USART_InitSync_TypeDef usartConfig = USART_INITSYNC_DEFAULT;
@@ -16,6 +67,7 @@ void initSpi3Wire()
       
       usartConfig.clockMode = usartClockMode3;
       usartConfig.msbf      = true; 
+      usartConfig.databits  = usartDatabits16; /* one MAX7219 command per frame */
 
       /* Configure USART as SPI master */
       USART_InitSync(SPI_USART,&usartConfig);
@@ -35,11 +87,60 @@ void initSpi3Wire()
       GPIO_PinModeSet(CS_PORT,   CS_PIN,   gpioModePushPull,1);/* CS */
       
       USART_Enable(SPI_USART, usartEnable);
-      USART1->FRAME |= 13;
-      USART1->TXDOUBLE |= 0xC01;
-      USART1->TXDOUBLE |= 0xB07;
  }
 
+void MAX7219_scriptRun(MAX7219_Script const *script)
+{
+  DMA_CfgChannel_TypeDef chnlCfg;
+  DMA_CfgDescr_TypeDef descrCfg;
+
+  MAX7219_scriptWait();
+
+  /* one command per request on TXEMPTY: the frame before is fully shifted
+  * out and AUTOCS has raised CS, which latches it in the MAX7219. TXBL
+  * would send back to back with CS held low, only the last would latch */
+  chnlCfg.highPri   = false;
+  chnlCfg.enableInt = true;
+  chnlCfg.select    = DMAREQ_USART1_TXEMPTY;
+  chnlCfg.cb        = &l_scriptCb;
+  DMA_CfgChannel(DMA_CH_DISPLAY, &chnlCfg);
+
+  descrCfg.dstInc  = dmaDataIncNone;
+  descrCfg.srcInc  = dmaDataInc2;
+  descrCfg.size    = dmaDataSize2;
+  descrCfg.arbRate = dmaArbitrate1;
+  descrCfg.hprot   = 0;
+  DMA_CfgDescr(DMA_CH_DISPLAY, true, &descrCfg);
+
+  /* USART1 and the DMA stop in EM2 */
+  SLEEP_SleepBlockBeginTagged(sleepEM2, SLEEP_TAG_MAX7219);
+  l_scriptBusy = true;
+  DMA_ActivateBasic(DMA_CH_DISPLAY, true, false,
+                    (void *)&SPI_USART->TXDOUBLE,
+                    (void const *)script->cmd,
+                    script->len - 1U);
+}
+
+bool MAX7219_scriptBusy(void)
+{
+  return l_scriptBusy;
+}
+
+void MAX7219_scriptWait(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  /* flag tested with interrupts masked, the DMA interrupt still wakes
+  * the core and runs when the mask is lifted */
+  CORE_ENTER_ATOMIC();
+  while (l_scriptBusy) {
+    EMU_EnterEM1();
+    CORE_EXIT_ATOMIC();
+    CORE_ENTER_ATOMIC();
+  }
+  CORE_EXIT_ATOMIC();
+}
+
 void writeSpiByte(uint8_t addr,uint8_t data)
 {
   /* Write addr to TXDATA0 to be transmitted first, before TXDATA1 with data
@@ -52,13 +153,34 @@ void writeSpiByte(uint8_t addr,uint8_t data)
 }
 
 
-void drawMatrix(char * matrix) {
-  for(int i=1;i<9;i++) {
-    if(USART1->STATUS && (1<<5)){
-      USART1->TXDOUBLE = (i)<<8 | matrix[i-1];
-      BSP_delay(500);
-    }
+static void max7219Init(void) {
+  MAX7219_scriptRun(&MAX7219_scriptInit);
+  max7219Brightness(DISPLAY_BRIGHT_MAX);
+}
+
+static bool max7219Flush(uint8_t const *fb, uint8_t first, uint8_t last) {
+  uint8_t row;
+
+  if (MAX7219_scriptBusy()) {
+    return false;
   }
+  for (row = first; row <= last; row++) {
+    l_frameCmd[row - first] = MAX7219_cmd((MAX7219_Reg)(MAX7219_DIGIT0 + row),
+                                          fb[row]);
+  }
+  l_frame.len = (uint16_t)(last - first + 1U);
+  MAX7219_scriptRun(&l_frame);
+  return true;
+}
+
+static void max7219Brightness(uint8_t level) {
+  MAX7219_scriptWait(); /* l_intensityCmd may still be sent */
+  l_intensityCmd = MAX7219_cmd(MAX7219_INTENSITY, level);
+  MAX7219_scriptRun(&l_intensity);
+}
+
+void drawMatrix(char * matrix) {
+  DISPLAY_flush((uint8_t const *)matrix);
 }
 
 void updateMatrix(float number, char * matrix) {
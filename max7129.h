@@ -1,7 +1,74 @@
 #ifndef __MAX7219_H__
 #define __MAX7219_H__
+#include <stdint.h>
+#include <stdbool.h>
+
+/* MAX7219 registers, the high byte of a command frame */
+typedef enum {
+    MAX7219_NOOP         = 0x0,
+    MAX7219_DIGIT0       = 0x1, /* DIGIT0..DIGIT7 are 0x1..0x8 */
+    MAX7219_DIGIT7       = 0x8,
+    MAX7219_DECODE_MODE  = 0x9, /* bit per digit, 1 = code B font */
+    MAX7219_INTENSITY    = 0xA, /* 0..15, 1/32 .. 31/32 duty */
+    MAX7219_SCAN_LIMIT   = 0xB, /* 0..7, digits scanned - 1 */
+    MAX7219_SHUTDOWN     = 0xC, /* 0 shutdown, 1 normal operation */
+    MAX7219_DISPLAY_TEST = 0xF  /* 0 normal operation, 1 all segments on */
+} MAX7219_Reg;
+
+/* one command, a 16 bit frame with the register in the high byte and the
+* data in the low byte, written to SPI_USART->TXDOUBLE as it is */
+typedef uint16_t MAX7219_Cmd;
+
+/* data value allowed in the register */
+#define MAX7219_VALID(reg_, data_) \
+    ((unsigned)(data_) <= 0xFFU && \
+     ((unsigned)(reg_) <= MAX7219_DECODE_MODE || \
+      ((reg_) == MAX7219_INTENSITY && (unsigned)(data_) <= 15U) || \
+      ((reg_) == MAX7219_SCAN_LIMIT && (unsigned)(data_) <= 7U) || \
+      (((reg_) == MAX7219_SHUTDOWN || (reg_) == MAX7219_DISPLAY_TEST) && \
+       (unsigned)(data_) <= 1U)))
+
+/* command, constant expression that does not compile for an unknown
+* register or a data value out of the register range */
+#define MAX7219_CMD(reg_, data_) \
+    ((MAX7219_Cmd)(((unsigned)(reg_) << 8) | (unsigned)(data_)) \
+     + (MAX7219_Cmd)(0U * sizeof(char[MAX7219_VALID(reg_, data_) ? 1 : -1])))
+
+/* command from run time values, not checked */
+static inline MAX7219_Cmd MAX7219_cmd(MAX7219_Reg reg, uint8_t data) {
+    return (MAX7219_Cmd)(((unsigned)reg << 8) | data);
+}
+
+/* command script, streamed to the display by one DMA transfer */
+typedef struct {
+    MAX7219_Cmd const *cmd;
+    uint16_t len;
+} MAX7219_Script;
+
+/* longest script one basic DMA cycle can send */
+#define MAX7219_SCRIPT_MAX 1024U
+
+/* define a const script from MAX7219_CMD() commands */
+#define MAX7219_SCRIPT(name_, ...) \
+    static MAX7219_Cmd const name_##Cmd[] = { __VA_ARGS__ }; \
+    typedef char name_##Len[(sizeof(name_##Cmd) / sizeof(MAX7219_Cmd) \
+                             <= MAX7219_SCRIPT_MAX) ? 1 : -1]; \
+    MAX7219_Script const name_ = { \
+        name_##Cmd, (uint16_t)(sizeof(name_##Cmd) / sizeof(MAX7219_Cmd)) }
+
+extern MAX7219_Script const MAX7219_scriptInit;     /* no test, no decode, 8 digits, on */
+extern MAX7219_Script const MAX7219_scriptTest;     /* all segments on */
+extern MAX7219_Script const MAX7219_scriptShutdown; /* display off, registers kept */
+
+/* start streaming a script on DMA_CH_DISPLAY, waits for a running one.
+* EM2 is blocked while the script is sent, call after SCHED_init() */
+void MAX7219_scriptRun(MAX7219_Script const *script);
+bool MAX7219_scriptBusy(void);
+/* wait in EM1 until the script is sent */
+void MAX7219_scriptWait(void);
+
 extern char matrix[8];
 void drawMatrix(char * matrix);
 extern float value;
 void updateMatrix(float number, char * matrix);
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,28 @@
+#ifndef __RTCDRV_CONFIG_H__
+#define __RTCDRV_CONFIG_H__
+
+/* RTCDRV configuration of the application, found before the template in
+* emdrv/rtcdrv/config through the include path order */
+
+/* scheduler timers: display frame, telemetry */
+#define EMDRV_RTCDRV_NUM_TIMERS     (4)
+
+/* the tick conversions RTCDRV_MsecsToTicks() and RTCDRV_TicksToMsec()
+* come with the wall clock. its RTC overflow interrupt is once per 2^24
+* ticks, 68 minutes */
+#define EMDRV_RTCDRV_WALLCLOCK_CONFIG
+
+/* with the wall clock RTCDRV blocks EM3 from RTCDRV_Init() on, the RTC
+* keeps counting and the scheduler idles in EM2 */
+#define EMDRV_RTCDRV_SLEEPDRV_INTEGRATION
+
+/* the board runs the RTC from LFRCO, see BSP_init() */
+#define EMDRV_RTCDRV_USE_LFRCO
+
+/* the scheduler arms timers from tasks and RTCDRV callbacks only, no other
+* interrupt needs masking in EMDRV_NVIC_SECTIONS builds */
+#ifndef EMDRV_RTCDRV_SECTION_EXTRA_IRQS
+#define EMDRV_RTCDRV_SECTION_EXTRA_IRQS(X, w)
+#endif
+
+#endif // __RTCDRV_CONFIG_H__
@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "em_assert.h"
+#include "em_core.h"
+#include "sleep.h"
+#include "sched.h"
+
+#if (SCHED_QUEUE_LEN & (SCHED_QUEUE_LEN - 1)) || (SCHED_QUEUE_LEN > 128)
+#error SCHED_QUEUE_LEN must be a power of 2 up to 128
+#endif
+
+typedef struct {
+    SCHED_Handler handler;
+    uint8_t queue[SCHED_QUEUE_LEN];
+    uint8_t head; /* events posted, free running */
+    uint8_t tail; /* events dispatched, free running */
+} SCHED_Task;
+
+static SCHED_Task l_task[SCHED_MAX_TASKS];
+static volatile uint8_t l_ready; /* one bit per task with pending events */
+
+void SCHED_init(void) {
+  SLEEP_Init(NULL, NULL);
+  RTCDRV_Init();
+}
+
+void SCHED_taskStart(uint8_t prio, SCHED_Handler handler) {
+  EFM_ASSERT(prio < SCHED_MAX_TASKS);
+  l_task[prio].handler = handler;
+}
+
+bool SCHED_post(uint8_t prio, uint8_t sig) {
+  CORE_DECLARE_IRQ_STATE;
+  SCHED_Task *t = &l_task[prio];
+  bool posted = false;
+
+  EFM_ASSERT(prio < SCHED_MAX_TASKS);
+  CORE_ENTER_CRITICAL();
+  if ((uint8_t)(t->head - t->tail) < SCHED_QUEUE_LEN) {
+    t->queue[t->head % SCHED_QUEUE_LEN] = sig;
+    t->head++;
+    l_ready |= (uint8_t)(1U << prio);
+    posted = true;
+  }
+  CORE_EXIT_CRITICAL();
+  return posted;
+}
+
+/* RTCDRV callback, runs in the RTC interrupt */
+static void timerExpired(RTCDRV_TimerID_t id, void *user) {
+  SCHED_Timer *timer = user;
+
+  (void)id;
+  SCHED_post(timer->prio, timer->sig);
+}
+
+bool SCHED_timerInit(SCHED_Timer *timer, uint8_t prio, uint8_t sig) {
+  EFM_ASSERT(prio < SCHED_MAX_TASKS);
+  timer->prio = prio;
+  timer->sig = sig;
+  return RTCDRV_AllocateTimer(&timer->id) == ECODE_EMDRV_RTCDRV_OK;
+}
+
+bool SCHED_timerArm(SCHED_Timer *timer, uint32_t ms, bool periodic) {
+  return RTCDRV_StartTimer(timer->id,
+                           periodic ? rtcdrvTimerTypePeriodic
+                                    : rtcdrvTimerTypeOneshot,
+                           ms, timerExpired, timer) == ECODE_EMDRV_RTCDRV_OK;
+}
+
+void SCHED_timerDisarm(SCHED_Timer *timer) {
+  RTCDRV_StopTimer(timer->id);
+}
+
+void SCHED_run(void) {
+  CORE_DECLARE_IRQ_STATE;
+  SCHED_Task *t;
+  uint8_t prio;
+  uint8_t sig;
+
+  for (;;) {
+    CORE_ENTER_CRITICAL();
+    if (l_ready != 0U) {
+      prio = SCHED_MAX_TASKS - 1U;
+      while ((l_ready & (1U << prio)) == 0U) {
+        prio--;
+      }
+      t = &l_task[prio];
+      sig = t->queue[t->tail % SCHED_QUEUE_LEN];
+      t->tail++;
+      if (t->tail == t->head) {
+        l_ready &= (uint8_t)~(1U << prio);
+      }
+      CORE_EXIT_CRITICAL();
+
+      if (t->handler != NULL) {
+        t->handler(sig);
+      }
+    } else {
+      /* interrupts stay masked: an event posted after the check above
+      * still wakes the core, its handler runs when the mask is lifted */
+      SLEEP_Sleep();
+      CORE_EXIT_CRITICAL();
+    }
+  }
+}
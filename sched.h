@@ -0,0 +1,45 @@
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rtcdriver.h"
+
+/* cooperative run-to-completion scheduler
+* tasks are event handlers with a fixed priority, the highest priority
+* task with a pending event runs its handler to completion, then the next.
+* when no event is pending the CPU sleeps in the lowest energy mode the
+* SLEEP driver allows. timers are RTCDRV timers that post an event */
+
+#define SCHED_MAX_TASKS 4   /* priorities 0..SCHED_MAX_TASKS-1, higher runs first */
+#define SCHED_QUEUE_LEN 8   /* pending events per task, power of 2 */
+
+typedef void (*SCHED_Handler)(uint8_t sig);
+
+/* timer posting sig to the task prio when it expires */
+typedef struct {
+    RTCDRV_TimerID_t id;
+    uint8_t prio;
+    uint8_t sig;
+} SCHED_Timer;
+
+/* initialize SLEEP and RTCDRV, call before enabling interrupts. RTCDRV
+* prescales the RTC, raw RTC counts (BSP_tickCtr(), INMON and DLOG times)
+* are converted with RTCDRV_TicksToMsec() from here on */
+void SCHED_init(void);
+
+void SCHED_taskStart(uint8_t prio, SCHED_Handler handler);
+
+/* queue an event for a task, can be called from interrupts.
+* returns false if the task queue is full and the event is lost */
+bool SCHED_post(uint8_t prio, uint8_t sig);
+
+/* allocate an RTCDRV timer, returns false if none is left */
+bool SCHED_timerInit(SCHED_Timer *timer, uint8_t prio, uint8_t sig);
+bool SCHED_timerArm(SCHED_Timer *timer, uint32_t ms, bool periodic);
+void SCHED_timerDisarm(SCHED_Timer *timer);
+
+/* dispatch events and sleep when idle, never returns */
+void SCHED_run(void);
+
+#endif // __SCHED_H__
@@ -33,7 +33,9 @@
 #include "em_aes.h"
 #if defined(AES_COUNT) && (AES_COUNT > 0)
 
+#include <stddef.h>
 #include "em_assert.h"
+#include "em_core.h"
 /***************************************************************************//**
  * @addtogroup emlib
  * @{
@@ -57,6 +59,174 @@
 
 /** @endcond */
 
+/*******************************************************************************
+ **************************   LOCAL VARIABLES   ********************************
+ ******************************************************************************/
+
+/** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
+
+/* Stream sessions with pending requests, the first one owns the AES. */
+static AES_Stream_TypeDef *streamHead = NULL;
+static AES_Stream_TypeDef *streamTail = NULL;
+
+/** @endcond */
+
+/*******************************************************************************
+ **************************   LOCAL FUNCTIONS   ********************************
+ ******************************************************************************/
+
+/** @cond DO_NOT_INCLUDE_WITH_DOXYGEN */
+
+/***************************************************************************//**
+ * @brief
+ *   Load the key and the next input block of a stream session and start the
+ *   AES.
+ ******************************************************************************/
+static void streamStartBlock(AES_Stream_TypeDef *stream)
+{
+  int      i;
+  uint32_t data;
+
+  #if !defined(AES_CTRL_KEYBUFEN)
+  /* The key register is modified by each block, reload it. */
+  for (i = 3; i >= 0; i--) {
+    AES->KEYLA = __REV(stream->key[i]);
+  }
+  #endif
+
+  /* Keep a copy of the input since out may be equal to in. */
+  for (i = 0; i < 4; i++) {
+    stream->block[i] = stream->in[i];
+  }
+
+  /* The last data write starts the AES. */
+  for (i = 3; i >= 0; i--) {
+    if (stream->mode == aesStreamModeCTR) {
+      data = stream->chain[i];
+    } else if ((stream->mode == aesStreamModeCBC) && stream->encrypt) {
+      data = stream->block[i] ^ stream->chain[i];
+    } else {
+      data = stream->block[i];
+    }
+    AES->DATA = __REV(data);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Read the result of the current block of a stream session and update the
+ *   chaining state.
+ ******************************************************************************/
+static void streamFinishBlock(AES_Stream_TypeDef *stream)
+{
+  int      i;
+  uint32_t data;
+
+  for (i = 3; i >= 0; i--) {
+    data = __REV(AES->DATA);
+    if (stream->mode == aesStreamModeCTR) {
+      stream->out[i] = data ^ stream->block[i];
+    } else if (stream->mode == aesStreamModeCBC) {
+      if (stream->encrypt) {
+        stream->out[i]   = data;
+        stream->chain[i] = data;
+      } else {
+        stream->out[i]   = data ^ stream->chain[i];
+        stream->chain[i] = stream->block[i];
+      }
+    } else {
+      stream->out[i] = data;
+    }
+  }
+
+  if (stream->mode == aesStreamModeCTR) {
+    AES_CTRUpdate32Bit((uint8_t *)stream->chain);
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Configure the AES for a stream session and start its first block.
+ ******************************************************************************/
+static void streamStart(AES_Stream_TypeDef *stream)
+{
+  uint32_t ctrl = AES_CTRL_DATASTART;
+
+  #if defined(AES_CTRL_KEYBUFEN)
+  int i;
+
+  /* Another session may have used the key buffer, load it for each request. */
+  for (i = 3; i >= 0; i--) {
+    AES->KEYHA = __REV(stream->key[i]);
+  }
+  ctrl |= AES_CTRL_KEYBUFEN;
+  #endif
+
+  if (!stream->encrypt && (stream->mode != aesStreamModeCTR)) {
+    ctrl |= AES_CTRL_DECRYPT;
+  }
+  AES->CTRL = ctrl;
+
+  streamStartBlock(stream);
+}
+
+/** @endcond */
+
+/*******************************************************************************
+ ************************   INTERRUPT FUNCTIONS   ******************************
+ ******************************************************************************/
+
+/***************************************************************************//**
+ * @brief
+ *   AES stream interrupt handler.
+ *
+ * @details
+ *   Completes the current block of the active stream session and starts the
+ *   next one. When a request is complete, the next pending session is started
+ *   and the completion callback is called.
+ *
+ *   This function must be called from AES_IRQHandler() when the stream API is
+ *   used. The AES DONE interrupt is enabled by AES_StreamProcess().
+ ******************************************************************************/
+void AES_StreamIRQHandler(void)
+{
+  AES_Stream_TypeDef *stream;
+  CORE_DECLARE_IRQ_STATE;
+
+  AES_IntClear(AES_IF_DONE);
+
+  CORE_ENTER_CRITICAL();
+  stream = streamHead;
+  if (stream == NULL) {
+    CORE_EXIT_CRITICAL();
+    return;
+  }
+
+  streamFinishBlock(stream);
+  stream->in  += 4;
+  stream->out += 4;
+  if (--stream->blocks > 0) {
+    streamStartBlock(stream);
+    CORE_EXIT_CRITICAL();
+    return;
+  }
+
+  /* Request complete, hand the AES over to the next session. */
+  streamHead = stream->next;
+  if (streamHead == NULL) {
+    streamTail = NULL;
+  } else {
+    streamStart(streamHead);
+  }
+  stream->next = NULL;
+  stream->busy = false;
+  CORE_EXIT_CRITICAL();
+
+  if (stream->callback) {
+    stream->callback(stream, stream->user);
+  }
+}
+
 /*******************************************************************************
  **************************   GLOBAL FUNCTIONS   *******************************
  ******************************************************************************/
@@ -1260,6 +1430,144 @@ void AES_OFB256(uint8_t *out,
 }
 #endif
 
+/***************************************************************************//**
+ * @brief
+ *   Initialize an AES stream session, 128 bit key.
+ *
+ * @details
+ *   A stream session processes data in the background, driven by the AES
+ *   DONE interrupt, see AES_StreamProcess(). The key and the chaining state
+ *   are kept in the session and loaded into the AES for every request, so
+ *   any number of sessions can be used concurrently.
+ *
+ *   See general comments on layout and byte ordering of parameters.
+ *
+ * @param[out] stream
+ *   A stream session to initialize.
+ *
+ * @param[in] mode
+ *   A cipher mode.
+ *
+ * @param[in] key
+ *   When encrypting, or in CTR mode, this is the 128 bit encryption key.
+ *   When decrypting in ECB or CBC mode, this is the 128 bit decryption key,
+ *   see AES_DecryptKey128().
+ *
+ * @param[in] iv
+ *   128 bit initialization vector (CBC) or initial counter value (CTR). The
+ *   value is copied. Not used in ECB mode, can be NULL.
+ *
+ * @param[in] encrypt
+ *   Set to true to encrypt, false to decrypt. Not used in CTR mode.
+ ******************************************************************************/
+void AES_StreamInit(AES_Stream_TypeDef *stream,
+                    AES_StreamMode_TypeDef mode,
+                    const uint8_t *key,
+                    const uint8_t *iv,
+                    bool encrypt)
+{
+  int            i;
+  const uint32_t *_key = (const uint32_t *)key;
+  const uint32_t *_iv  = (const uint32_t *)iv;
+
+  EFM_ASSERT(stream);
+  EFM_ASSERT(key);
+  EFM_ASSERT(iv || (mode == aesStreamModeECB));
+
+  for (i = 0; i < 4; i++) {
+    stream->key[i]   = _key[i];
+    stream->chain[i] = iv ? _iv[i] : 0;
+  }
+  stream->mode     = mode;
+  stream->encrypt  = encrypt;
+  stream->busy     = false;
+  stream->blocks   = 0;
+  stream->callback = NULL;
+  stream->next     = NULL;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Encrypt or decrypt data in the background.
+ *
+ * @details
+ *   The request is processed one block at a time from the AES DONE
+ *   interrupt; the CPU does not wait for the AES. If another session is
+ *   using the AES, the request is started when the earlier ones are
+ *   complete. The chaining state of the session is updated, so a message
+ *   can be processed in several requests.
+ *
+ *   The blocking functions in this module must not be used while a stream
+ *   request is in progress.
+ *
+ * @param[in,out] stream
+ *   A stream session, see AES_StreamInit().
+ *
+ * @param[out] out
+ *   A buffer to place encrypted/decrypted data. Must be at least @p len long. It
+ *   may be set equal to @p in, in which case the input buffer is overwritten.
+ *   Must remain valid until the request is complete.
+ *
+ * @param[in] in
+ *   A buffer holding data to encrypt/decrypt. Must be at least @p len long.
+ *   Must remain valid until the request is complete.
+ *
+ * @param[in] len
+ *   A number of bytes to encrypt/decrypt. Must be a non-zero multiple of 16.
+ *
+ * @param[in] callback
+ *   A function called from AES_StreamIRQHandler() when the request is
+ *   complete. Can be NULL, use AES_StreamBusy() to poll for completion.
+ *
+ * @param[in] user
+ *   A user pointer passed to @p callback.
+ *
+ * @return
+ *   False if the session already has a request in progress.
+ ******************************************************************************/
+bool AES_StreamProcess(AES_Stream_TypeDef *stream,
+                       uint8_t *out,
+                       const uint8_t *in,
+                       unsigned int len,
+                       AES_StreamCallback_TypeDef callback,
+                       void *user)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  EFM_ASSERT(stream);
+  EFM_ASSERT(len && !(len % AES_BLOCKSIZE));
+
+  CORE_ENTER_CRITICAL();
+  if (stream->busy) {
+    CORE_EXIT_CRITICAL();
+    return false;
+  }
+
+  stream->in       = (const uint32_t *)in;
+  stream->out      = (uint32_t *)out;
+  stream->blocks   = len / AES_BLOCKSIZE;
+  stream->callback = callback;
+  stream->user     = user;
+  stream->next     = NULL;
+  stream->busy     = true;
+
+  if (streamTail != NULL) {
+    streamTail->next = stream;
+    streamTail       = stream;
+  } else {
+    streamHead = stream;
+    streamTail = stream;
+    AES_IntClear(AES_IF_DONE);
+    AES_IntEnable(AES_IF_DONE);
+    NVIC_ClearPendingIRQ(AES_IRQn);
+    NVIC_EnableIRQ(AES_IRQn);
+    streamStart(stream);
+  }
+  CORE_EXIT_CRITICAL();
+
+  return true;
+}
+
 /** @} (end addtogroup AES) */
 /** @} (end addtogroup emlib) */
 #endif /* defined(AES_COUNT) && (AES_COUNT > 0) */
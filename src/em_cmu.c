@@ -37,6 +37,7 @@
 #include <limits.h>
 #include "em_assert.h"
 #include "em_bus.h"
+#include "em_core.h"
 #include "em_emu.h"
 #include "em_cmu.h"
 #include "em_system.h"
@@ -261,6 +262,18 @@ static const struct flashWsTableElement{
 static uint32_t ushfrcoFreq = EFM32_USHFRCO_STARTUP_FREQ;
 #endif
 
+/** Frequencies returned by CMU_ClockFreqGet(), one entry per clock branch. */
+static uint32_t freqCache[CMU_CLK_BRANCH_MASK + 1U];
+/** One bit per clock branch with a valid entry in freqCache. */
+static uint32_t freqCacheValid;
+/** Incremented by every clock change, see clockChangeBegin(). */
+static uint32_t freqCacheGeneration;
+/** Nesting depth of clock changes in progress, the cache is not used while
+ *  a change is in progress. */
+static uint8_t clockChangeNesting;
+/** Subscribers notified by clockChangeEnd(). */
+static CMU_ClockChangeSubscriber_TypeDef *clockChangeSubscribers;
+
 /*******************************************************************************
  **************************   LOCAL PROTOTYPES   *******************************
  ******************************************************************************/
@@ -274,6 +287,8 @@ static uint32_t CMU_USHFRCODevinfoGet(CMU_USHFRCOFreq_TypeDef freq);
 
 static void hfperClkSafePrescaler(void);
 static void hfperClkOptimizedPrescaler(void);
+static void clockChangeBegin(void);
+static void clockChangeEnd(void);
 
 /** @endcond */
 
@@ -1290,6 +1305,55 @@ static void hfperClkOptimizedPrescaler(void)
 #endif
 }
 
+/***************************************************************************//**
+ * @brief
+ *   Start changing the clock configuration.
+ *
+ * @details
+ *   The frequency cache is emptied and not used until the matching
+ *   clockChangeEnd(). Changes can nest, e.g. CMU_HFRCOBandSet() calls
+ *   CMU_ClockPrescSet().
+ ******************************************************************************/
+static void clockChangeBegin(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  freqCacheValid = 0U;
+  freqCacheGeneration++;
+  clockChangeNesting++;
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   End changing the clock configuration.
+ *
+ * @details
+ *   The subscribers are notified when the outermost change ends.
+ ******************************************************************************/
+static void clockChangeEnd(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CMU_ClockChangeSubscriber_TypeDef *subscriber;
+  bool done;
+
+  CORE_ENTER_ATOMIC();
+  freqCacheValid = 0U;
+  freqCacheGeneration++;
+  clockChangeNesting--;
+  done = (clockChangeNesting == 0U);
+  CORE_EXIT_ATOMIC();
+
+  if (done) {
+    for (subscriber = clockChangeSubscribers;
+         subscriber != NULL;
+         subscriber = subscriber->next) {
+      subscriber->callback(subscriber->user);
+    }
+  }
+}
+
 /** @endcond */
 
 /*******************************************************************************
@@ -1315,13 +1379,9 @@ CMU_AUXHFRCOBand_TypeDef CMU_AUXHFRCOBandGet(void)
 #if defined(_CMU_AUXHFRCOCTRL_BAND_MASK)
 /***************************************************************************//**
  * @brief
- *   Set the AUXHFRCO band and the tuning value based on the value in the
- *   calibration table made during production.
- *
- * @param[in] band
- *   AUXHFRCO band to activate.
+ *   CMU_AUXHFRCOBandSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_AUXHFRCOBandSet(CMU_AUXHFRCOBand_TypeDef band)
+static void auxhfrcoBandSet(CMU_AUXHFRCOBand_TypeDef band)
 {
   uint32_t tuning;
 
@@ -1371,6 +1431,21 @@ void CMU_AUXHFRCOBandSet(CMU_AUXHFRCOBand_TypeDef band)
                       | (band << _CMU_AUXHFRCOCTRL_BAND_SHIFT)
                       | (tuning << _CMU_AUXHFRCOCTRL_TUNING_SHIFT);
 }
+
+/***************************************************************************//**
+ * @brief
+ *   Set the AUXHFRCO band and the tuning value based on the value in the
+ *   calibration table made during production.
+ *
+ * @param[in] band
+ *   AUXHFRCO band to activate.
+ ******************************************************************************/
+void CMU_AUXHFRCOBandSet(CMU_AUXHFRCOBand_TypeDef band)
+{
+  clockChangeBegin();
+  auxhfrcoBandSet(band);
+  clockChangeEnd();
+}
 #endif /* _CMU_AUXHFRCOCTRL_BAND_MASK */
 
 #if defined(_CMU_AUXHFRCOCTRL_FREQRANGE_MASK)
@@ -1446,12 +1521,9 @@ CMU_AUXHFRCOFreq_TypeDef CMU_AUXHFRCOBandGet(void)
 #if defined(_CMU_AUXHFRCOCTRL_FREQRANGE_MASK)
 /***************************************************************************//**
  * @brief
- *   Set AUXHFRCO calibration for the selected target frequency.
- *
- * @param[in] setFreq
- *   AUXHFRCO frequency to set
+ *   CMU_AUXHFRCOBandSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_AUXHFRCOBandSet(CMU_AUXHFRCOFreq_TypeDef setFreq)
+static void auxhfrcoBandSet(CMU_AUXHFRCOFreq_TypeDef setFreq)
 {
   uint32_t freqCal;
 
@@ -1488,6 +1560,20 @@ void CMU_AUXHFRCOBandSet(CMU_AUXHFRCOFreq_TypeDef setFreq)
   }
   CMU->AUXHFRCOCTRL = freqCal;
 }
+
+/***************************************************************************//**
+ * @brief
+ *   Set AUXHFRCO calibration for the selected target frequency.
+ *
+ * @param[in] setFreq
+ *   AUXHFRCO frequency to set
+ ******************************************************************************/
+void CMU_AUXHFRCOBandSet(CMU_AUXHFRCOFreq_TypeDef setFreq)
+{
+  clockChangeBegin();
+  auxhfrcoBandSet(setFreq);
+  clockChangeEnd();
+}
 #endif /* _CMU_AUXHFRCOCTRL_FREQRANGE_MASK */
 
 /***************************************************************************//**
@@ -1837,24 +1923,9 @@ CMU_ClkDiv_TypeDef CMU_ClockDivGet(CMU_Clock_TypeDef clock)
 
 /***************************************************************************//**
  * @brief
- *   Set the clock divisor/prescaler.
- *
- * @note
- *   If setting an LF clock prescaler, synchronization into the low-frequency
- *   domain is required. If the same register is modified before a previous
- *   update has completed, this function will stall until the previous
- *   synchronization has completed. See @ref CMU_FreezeEnable() for
- *   a suggestion on how to reduce the stalling time in some use cases.
- *
- * @param[in] clock
- *   Clock point to set divisor/prescaler for. Notice that not all clock points
- *   have a divisor/prescaler. See the CMU overview in the reference
- *   manual.
- *
- * @param[in] div
- *   The clock divisor to use (<= cmuClkDiv_512).
+ *   CMU_ClockDivSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_ClockDivSet(CMU_Clock_TypeDef clock, CMU_ClkDiv_TypeDef div)
+static void clockDivSet(CMU_Clock_TypeDef clock, CMU_ClkDiv_TypeDef div)
 {
 #if defined(_SILICON_LABS_32B_SERIES_1)
   CMU_ClockPrescSet(clock, (CMU_ClkPresc_TypeDef)(div - 1U));
@@ -2032,6 +2103,32 @@ void CMU_ClockDivSet(CMU_Clock_TypeDef clock, CMU_ClkDiv_TypeDef div)
 #endif
 }
 
+/***************************************************************************//**
+ * @brief
+ *   Set the clock divisor/prescaler.
+ *
+ * @note
+ *   If setting an LF clock prescaler, synchronization into the low-frequency
+ *   domain is required. If the same register is modified before a previous
+ *   update has completed, this function will stall until the previous
+ *   synchronization has completed. See @ref CMU_FreezeEnable() for
+ *   a suggestion on how to reduce the stalling time in some use cases.
+ *
+ * @param[in] clock
+ *   Clock point to set divisor/prescaler for. Notice that not all clock points
+ *   have a divisor/prescaler. See the CMU overview in the reference
+ *   manual.
+ *
+ * @param[in] div
+ *   The clock divisor to use (<= cmuClkDiv_512).
+ ******************************************************************************/
+void CMU_ClockDivSet(CMU_Clock_TypeDef clock, CMU_ClkDiv_TypeDef div)
+{
+  clockChangeBegin();
+  clockDivSet(clock, div);
+  clockChangeEnd();
+}
+
 /***************************************************************************//**
  * @brief
  *   Enable/disable a clock.
@@ -2170,15 +2267,9 @@ void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable)
 
 /***************************************************************************//**
  * @brief
- *   Get the clock frequency for a clock point.
- *
- * @param[in] clock
- *   A clock point to fetch the frequency for.
- *
- * @return
- *   The current frequency in Hz.
+ *   CMU_ClockFreqGet() without the frequency cache.
  ******************************************************************************/
-uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock)
+static uint32_t clockFreqGet(CMU_Clock_TypeDef clock)
 {
   uint32_t ret;
 
@@ -2428,6 +2519,138 @@ uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock)
   return ret;
 }
 
+/***************************************************************************//**
+ * @brief
+ *   Get the clock frequency for a clock point.
+ *
+ * @details
+ *   The frequency of each clock branch is computed from the clock
+ *   configuration once and then served from a cache. The cache is emptied
+ *   by the CMU functions changing the clock configuration.
+ *
+ * @note
+ *   Call @ref CMU_ClockFreqInvalidate() after changing the clock
+ *   configuration without the CMU functions, e.g. by writing CMU registers
+ *   directly or with SystemHFXOClockSet() or SystemLFXOClockSet().
+ *   EMU_EnterEM2() and EMU_EnterEM3() do so when waking up without restore,
+ *   the hardware has switched HFCLK to HFRCO.
+ *
+ * @param[in] clock
+ *   A clock point to fetch the frequency for.
+ *
+ * @return
+ *   The current frequency in Hz.
+ ******************************************************************************/
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock)
+{
+  CORE_DECLARE_IRQ_STATE;
+  uint32_t branch;
+  uint32_t generation;
+  uint32_t ret;
+  bool cached;
+
+  branch = ((unsigned)clock >> CMU_CLK_BRANCH_POS) & CMU_CLK_BRANCH_MASK;
+
+  CORE_ENTER_ATOMIC();
+  cached = (freqCacheValid & (1UL << branch)) != 0UL;
+  ret = freqCache[branch];
+  generation = freqCacheGeneration;
+  CORE_EXIT_ATOMIC();
+
+  if (!cached) {
+    ret = clockFreqGet(clock);
+
+    /* Keep the result only if the clocks did not change meanwhile. */
+    CORE_ENTER_ATOMIC();
+    if ((generation == freqCacheGeneration) && (clockChangeNesting == 0U)) {
+      freqCache[branch] = ret;
+      freqCacheValid |= 1UL << branch;
+    }
+    CORE_EXIT_ATOMIC();
+  }
+  return ret;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Empty the clock frequency cache and notify the clock change subscribers.
+ *
+ * @details
+ *   The CMU functions changing the clock configuration do this themselves.
+ *   Call this function after changing the clock configuration otherwise,
+ *   see @ref CMU_ClockFreqGet().
+ ******************************************************************************/
+void CMU_ClockFreqInvalidate(void)
+{
+  clockChangeBegin();
+  clockChangeEnd();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Subscribe to clock changes.
+ *
+ * @details
+ *   The callback is called after every change of the clock configuration,
+ *   in the context of the function making the change, which can be an
+ *   interrupt handler. Typically the subscriber recomputes its baud rate
+ *   or prescaler settings from @ref CMU_ClockFreqGet(). Subscribing again
+ *   replaces the callback.
+ *
+ * @note
+ *   The callback must not subscribe or change the clock configuration.
+ *
+ * @param[in] subscriber
+ *   Subscriber data, allocated by the caller and valid until unsubscribed.
+ *
+ * @param[in] callback
+ *   Function called after a clock change.
+ *
+ * @param[in] user
+ *   Parameter passed to the callback.
+ ******************************************************************************/
+void CMU_ClockChangeSubscribe(CMU_ClockChangeSubscriber_TypeDef *subscriber,
+                              CMU_ClockChangeCallback_TypeDef callback,
+                              void *user)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  EFM_ASSERT((subscriber != NULL) && (callback != NULL));
+
+  CMU_ClockChangeUnsubscribe(subscriber);
+  subscriber->callback = callback;
+  subscriber->user     = user;
+
+  CORE_ENTER_ATOMIC();
+  subscriber->next       = clockChangeSubscribers;
+  clockChangeSubscribers = subscriber;
+  CORE_EXIT_ATOMIC();
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Stop notifying a subscriber of clock changes.
+ *
+ * @param[in] subscriber
+ *   Subscriber data passed to @ref CMU_ClockChangeSubscribe(). Unsubscribing
+ *   a subscriber that is not subscribed does nothing.
+ ******************************************************************************/
+void CMU_ClockChangeUnsubscribe(CMU_ClockChangeSubscriber_TypeDef *subscriber)
+{
+  CORE_DECLARE_IRQ_STATE;
+  CMU_ClockChangeSubscriber_TypeDef **link;
+
+  CORE_ENTER_ATOMIC();
+  for (link = &clockChangeSubscribers; *link != NULL; link = &(*link)->next) {
+    if (*link == subscriber) {
+      /* subscriber->next is kept, a notification in progress continues. */
+      *link = subscriber->next;
+      break;
+    }
+  }
+  CORE_EXIT_ATOMIC();
+}
+
 #if defined(_SILICON_LABS_32B_SERIES_1)
 /***************************************************************************//**
  * @brief
@@ -2631,23 +2854,9 @@ uint32_t CMU_ClockPrescGet(CMU_Clock_TypeDef clock)
 #if defined(_SILICON_LABS_32B_SERIES_1)
 /***************************************************************************//**
  * @brief
- *   Set the clock prescaler.
- *
- * @note
- *   If setting an LF clock prescaler, synchronization into the low-frequency
- *   domain is required. If the same register is modified before a previous
- *   update has completed, this function will stall until the previous
- *   synchronization has completed. See @ref CMU_FreezeEnable() for
- *   a suggestion on how to reduce the stalling time in some use cases.
- *
- * @param[in] clock
- *   A clock point to set the prescaler for. Notice that not all clock points
- *   have a prescaler. See the CMU overview in the reference manual.
- *
- * @param[in] presc
- *   The clock prescaler.
+ *   CMU_ClockPrescSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_ClockPrescSet(CMU_Clock_TypeDef clock, CMU_ClkPresc_TypeDef presc)
+static void clockPrescSet(CMU_Clock_TypeDef clock, CMU_ClkPresc_TypeDef presc)
 {
   uint32_t freq;
   uint32_t prescReg;
@@ -2938,6 +3147,31 @@ void CMU_ClockPrescSet(CMU_Clock_TypeDef clock, CMU_ClkPresc_TypeDef presc)
       break;
   }
 }
+
+/***************************************************************************//**
+ * @brief
+ *   Set the clock prescaler.
+ *
+ * @note
+ *   If setting an LF clock prescaler, synchronization into the low-frequency
+ *   domain is required. If the same register is modified before a previous
+ *   update has completed, this function will stall until the previous
+ *   synchronization has completed. See @ref CMU_FreezeEnable() for
+ *   a suggestion on how to reduce the stalling time in some use cases.
+ *
+ * @param[in] clock
+ *   A clock point to set the prescaler for. Notice that not all clock points
+ *   have a prescaler. See the CMU overview in the reference manual.
+ *
+ * @param[in] presc
+ *   The clock prescaler.
+ ******************************************************************************/
+void CMU_ClockPrescSet(CMU_Clock_TypeDef clock, CMU_ClkPresc_TypeDef presc)
+{
+  clockChangeBegin();
+  clockPrescSet(clock, presc);
+  clockChangeEnd();
+}
 #endif
 
 /***************************************************************************//**
@@ -3411,58 +3645,9 @@ CMU_Select_TypeDef CMU_ClockSelectGet(CMU_Clock_TypeDef clock)
 
 /***************************************************************************//**
  * @brief
- *   Select the reference clock/oscillator used for a clock branch.
- *
- * @details
- *   Notice that if a selected reference is not enabled prior to selecting its
- *   use, it will be enabled and this function will wait for the selected
- *   oscillator to be stable. It will however NOT be disabled if another
- *   reference clock is selected later.
- *
- *   This feature is particularly important if selecting a new reference
- *   clock for the clock branch clocking the core. Otherwise, the system
- *   may halt.
- *
- * @param[in] clock
- *   A clock branch to select reference clock for. One of:
- *   @li #cmuClock_HF
- *   @li #cmuClock_LFA
- *   @li #cmuClock_LFB
- *   @if _CMU_LFCCLKEN0_MASK
- *   @li #cmuClock_LFC
- *   @endif
- *   @if _CMU_LFECLKEN0_MASK
- *   @li #cmuClock_LFE
- *   @endif
- *   @li #cmuClock_DBG
- *   @if _CMU_CMD_USBCLKSEL_MASK
- *   @li #cmuClock_USBC
- *   @endif
- *   @if _CMU_USBCTRL_MASK
- *   @li #cmuClock_USBR
- *   @endif
- *
- * @param[in] ref
- *   A reference selected for clocking. See the reference manual
- *   for details about references available for a specific clock branch.
- *   @li #cmuSelect_HFRCO
- *   @li #cmuSelect_LFRCO
- *   @li #cmuSelect_HFXO
- *   @if _CMU_HFXOCTRL_HFXOX2EN_MASK
- *   @li #cmuSelect_HFXOX2
- *   @endif
- *   @li #cmuSelect_LFXO
- *   @li #cmuSelect_HFCLKLE
- *   @li #cmuSelect_AUXHFRCO
- *   @if _CMU_USHFRCOCTRL_MASK
- *   @li #cmuSelect_USHFRCO
- *   @endif
- *   @li #cmuSelect_HFCLK
- *   @ifnot DOXYDOC_EFM32_GECKO_FAMILY
- *   @li #cmuSelect_ULFRCO
- *   @endif
+ *   CMU_ClockSelectSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
+static void clockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
 {
   uint32_t              select = (uint32_t)cmuOsc_HFRCO;
   CMU_Osc_TypeDef       osc    = cmuOsc_HFRCO;
@@ -4102,29 +4287,72 @@ void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
   }
 }
 
-#if defined(CMU_OSCENCMD_DPLLEN)
-/**************************************************************************//**
+/***************************************************************************//**
  * @brief
- *   Lock the DPLL to a given frequency.
+ *   Select the reference clock/oscillator used for a clock branch.
  *
- *   The frequency is given by: Fout = Fref * (N+1) / (M+1).
+ * @details
+ *   Notice that if a selected reference is not enabled prior to selecting its
+ *   use, it will be enabled and this function will wait for the selected
+ *   oscillator to be stable. It will however NOT be disabled if another
+ *   reference clock is selected later.
  *
- * @note
- *   This function does not check if the given N & M values will actually
- *   produce the desired target frequency. @n
- *   N & M limitations: @n
- *     300 < N <= 4095 @n
- *     0 <= M <= 4095 @n
- *   Any peripheral running off HFRCO should be switched to HFRCODIV2 prior to
- *   calling this function to avoid over-clocking.
+ *   This feature is particularly important if selecting a new reference
+ *   clock for the clock branch clocking the core. Otherwise, the system
+ *   may halt.
  *
- * @param[in] init
- *    DPLL setup parameters.
+ * @param[in] clock
+ *   A clock branch to select reference clock for. One of:
+ *   @li #cmuClock_HF
+ *   @li #cmuClock_LFA
+ *   @li #cmuClock_LFB
+ *   @if _CMU_LFCCLKEN0_MASK
+ *   @li #cmuClock_LFC
+ *   @endif
+ *   @if _CMU_LFECLKEN0_MASK
+ *   @li #cmuClock_LFE
+ *   @endif
+ *   @li #cmuClock_DBG
+ *   @if _CMU_CMD_USBCLKSEL_MASK
+ *   @li #cmuClock_USBC
+ *   @endif
+ *   @if _CMU_USBCTRL_MASK
+ *   @li #cmuClock_USBR
+ *   @endif
  *
- * @return
- *   Returns false on invalid target frequency or DPLL locking error.
- *****************************************************************************/
-bool CMU_DPLLLock(CMU_DPLLInit_TypeDef *init)
+ * @param[in] ref
+ *   A reference selected for clocking. See the reference manual
+ *   for details about references available for a specific clock branch.
+ *   @li #cmuSelect_HFRCO
+ *   @li #cmuSelect_LFRCO
+ *   @li #cmuSelect_HFXO
+ *   @if _CMU_HFXOCTRL_HFXOX2EN_MASK
+ *   @li #cmuSelect_HFXOX2
+ *   @endif
+ *   @li #cmuSelect_LFXO
+ *   @li #cmuSelect_HFCLKLE
+ *   @li #cmuSelect_AUXHFRCO
+ *   @if _CMU_USHFRCOCTRL_MASK
+ *   @li #cmuSelect_USHFRCO
+ *   @endif
+ *   @li #cmuSelect_HFCLK
+ *   @ifnot DOXYDOC_EFM32_GECKO_FAMILY
+ *   @li #cmuSelect_ULFRCO
+ *   @endif
+ ******************************************************************************/
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
+{
+  clockChangeBegin();
+  clockSelectSet(clock, ref);
+  clockChangeEnd();
+}
+
+#if defined(CMU_OSCENCMD_DPLLEN)
+/***************************************************************************//**
+ * @brief
+ *   CMU_DPLLLock() without the frequency cache handling.
+ ******************************************************************************/
+static bool dpllLock(CMU_DPLLInit_TypeDef *init)
 {
   int index = 0;
   unsigned int i;
@@ -4249,6 +4477,37 @@ bool CMU_DPLLLock(CMU_DPLLInit_TypeDef *init)
   }
   return false;
 }
+
+/**************************************************************************//**
+ * @brief
+ *   Lock the DPLL to a given frequency.
+ *
+ *   The frequency is given by: Fout = Fref * (N+1) / (M+1).
+ *
+ * @note
+ *   This function does not check if the given N & M values will actually
+ *   produce the desired target frequency. @n
+ *   N & M limitations: @n
+ *     300 < N <= 4095 @n
+ *     0 <= M <= 4095 @n
+ *   Any peripheral running off HFRCO should be switched to HFRCODIV2 prior to
+ *   calling this function to avoid over-clocking.
+ *
+ * @param[in] init
+ *    DPLL setup parameters.
+ *
+ * @return
+ *   Returns false on invalid target frequency or DPLL locking error.
+ *****************************************************************************/
+bool CMU_DPLLLock(CMU_DPLLInit_TypeDef *init)
+{
+  bool ret;
+
+  clockChangeBegin();
+  ret = dpllLock(init);
+  clockChangeEnd();
+  return ret;
+}
 #endif // CMU_OSCENCMD_DPLLEN
 
 /**************************************************************************//**
@@ -4317,13 +4576,9 @@ CMU_HFRCOBand_TypeDef CMU_HFRCOBandGet(void)
 #if defined(_CMU_HFRCOCTRL_BAND_MASK)
 /***************************************************************************//**
  * @brief
- *   Set HFRCO band and the tuning value based on the value in the calibration
- *   table made during production.
- *
- * @param[in] band
- *   HFRCO band to activate.
+ *   CMU_HFRCOBandSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_HFRCOBandSet(CMU_HFRCOBand_TypeDef band)
+static void hfrcoBandSet(CMU_HFRCOBand_TypeDef band)
 {
   uint32_t           tuning;
   uint32_t           freq;
@@ -4393,6 +4648,21 @@ void CMU_HFRCOBandSet(CMU_HFRCOBand_TypeDef band)
   setHfLeConfig(CMU_ClockFreqGet(cmuClock_HFLE));
 #endif
 }
+
+/***************************************************************************//**
+ * @brief
+ *   Set HFRCO band and the tuning value based on the value in the calibration
+ *   table made during production.
+ *
+ * @param[in] band
+ *   HFRCO band to activate.
+ ******************************************************************************/
+void CMU_HFRCOBandSet(CMU_HFRCOBand_TypeDef band)
+{
+  clockChangeBegin();
+  hfrcoBandSet(band);
+  clockChangeEnd();
+}
 #endif /* _CMU_HFRCOCTRL_BAND_MASK */
 
 #if defined(_CMU_HFRCOCTRL_FREQRANGE_MASK)
@@ -4475,12 +4745,9 @@ CMU_HFRCOFreq_TypeDef CMU_HFRCOBandGet(void)
 
 /***************************************************************************//**
  * @brief
- *   Set the HFRCO calibration for the selected target frequency.
- *
- * @param[in] setFreq
- *   HFRCO frequency to set.
+ *   CMU_HFRCOBandSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_HFRCOBandSet(CMU_HFRCOFreq_TypeDef setFreq)
+static void hfrcoBandSet(CMU_HFRCOFreq_TypeDef setFreq)
 {
   uint32_t freqCal;
   uint32_t sysFreq;
@@ -4569,6 +4836,20 @@ void CMU_HFRCOBandSet(CMU_HFRCOFreq_TypeDef setFreq)
     hfperClkOptimizedPrescaler();
   }
 }
+
+/***************************************************************************//**
+ * @brief
+ *   Set the HFRCO calibration for the selected target frequency.
+ *
+ * @param[in] setFreq
+ *   HFRCO frequency to set.
+ ******************************************************************************/
+void CMU_HFRCOBandSet(CMU_HFRCOFreq_TypeDef setFreq)
+{
+  clockChangeBegin();
+  hfrcoBandSet(setFreq);
+  clockChangeEnd();
+}
 #endif /* _CMU_HFRCOCTRL_FREQRANGE_MASK */
 
 #if defined(_CMU_HFRCOCTRL_SUDELAY_MASK)
@@ -4653,12 +4934,9 @@ CMU_USHFRCOFreq_TypeDef CMU_USHFRCOBandGet(void)
 
 /***************************************************************************//**
  * @brief
- *   Set the USHFRCO calibration for the selected target frequency.
- *
- * @param[in] setFreq
- *   USHFRCO frequency to set.
+ *   CMU_USHFRCOBandSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_USHFRCOBandSet(CMU_USHFRCOFreq_TypeDef setFreq)
+static void ushfrcoBandSet(CMU_USHFRCOFreq_TypeDef setFreq)
 {
   uint32_t freqCal;
 
@@ -4673,6 +4951,20 @@ void CMU_USHFRCOBandSet(CMU_USHFRCOFreq_TypeDef setFreq)
 
   CMU->USHFRCOCTRL = freqCal;
 }
+
+/***************************************************************************//**
+ * @brief
+ *   Set the USHFRCO calibration for the selected target frequency.
+ *
+ * @param[in] setFreq
+ *   USHFRCO frequency to set.
+ ******************************************************************************/
+void CMU_USHFRCOBandSet(CMU_USHFRCOFreq_TypeDef setFreq)
+{
+  clockChangeBegin();
+  ushfrcoBandSet(setFreq);
+  clockChangeEnd();
+}
 #endif /* _CMU_USHFRCOCTRL_FREQRANGE_MASK  */
 
 #if defined(_CMU_HFXOCTRL_AUTOSTARTEM0EM1_MASK)
@@ -4895,18 +5187,9 @@ uint32_t CMU_LCDClkFDIVGet(void)
 
 /***************************************************************************//**
  * @brief
- *   Set the LCD framerate divisor (FDIV) setting.
- *
- * @note
- *   The FDIV field (CMU LCDCTRL register) should only be modified while the
- *   LCD module is clock disabled (CMU LFACLKEN0.LCD bit is 0). This function
- *   will NOT modify FDIV if the LCD module clock is enabled. See
- *   @ref CMU_ClockEnable() for disabling/enabling LCD clock.
- *
- * @param[in] div
- *   The FDIV setting to use.
+ *   CMU_LCDClkFDIVSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_LCDClkFDIVSet(uint32_t div)
+static void lcdClkFDIVSet(uint32_t div)
 {
 #if defined(LCD_PRESENT) && defined(_CMU_LCDCTRL_MASK)
   EFM_ASSERT(div <= cmuClkDiv_128);
@@ -4924,6 +5207,26 @@ void CMU_LCDClkFDIVSet(uint32_t div)
 #endif /* defined(LCD_PRESENT) */
 }
 
+/***************************************************************************//**
+ * @brief
+ *   Set the LCD framerate divisor (FDIV) setting.
+ *
+ * @note
+ *   The FDIV field (CMU LCDCTRL register) should only be modified while the
+ *   LCD module is clock disabled (CMU LFACLKEN0.LCD bit is 0). This function
+ *   will NOT modify FDIV if the LCD module clock is enabled. See
+ *   @ref CMU_ClockEnable() for disabling/enabling LCD clock.
+ *
+ * @param[in] div
+ *   The FDIV setting to use.
+ ******************************************************************************/
+void CMU_LCDClkFDIVSet(uint32_t div)
+{
+  clockChangeBegin();
+  lcdClkFDIVSet(div);
+  clockChangeEnd();
+}
+
 /**************************************************************************//**
  * @brief
  *   Set LFXO control registers.
@@ -5525,12 +5828,9 @@ CMU_USHFRCOBand_TypeDef CMU_USHFRCOBandGet(void)
 #if defined(_CMU_USHFRCOCONF_BAND_MASK)
 /***************************************************************************//**
  * @brief
- *   Set the USHFRCO band to use.
- *
- * @param[in] band
- *   USHFRCO band to activate.
+ *   CMU_USHFRCOBandSet() without the frequency cache handling.
  ******************************************************************************/
-void CMU_USHFRCOBandSet(CMU_USHFRCOBand_TypeDef band)
+static void ushfrcoBandSet(CMU_USHFRCOBand_TypeDef band)
 {
   uint32_t           tuning;
   uint32_t           fineTuning;
@@ -5578,6 +5878,20 @@ void CMU_USHFRCOBandSet(CMU_USHFRCOBand_TypeDef band)
     BUS_RegBitWrite(&CMU->USHFRCOCONF, _CMU_USHFRCOCONF_USHFRCODIV2DIS_SHIFT, 1);
   }
 }
+
+/***************************************************************************//**
+ * @brief
+ *   Set the USHFRCO band to use.
+ *
+ * @param[in] band
+ *   USHFRCO band to activate.
+ ******************************************************************************/
+void CMU_USHFRCOBandSet(CMU_USHFRCOBand_TypeDef band)
+{
+  clockChangeBegin();
+  ushfrcoBandSet(band);
+  clockChangeEnd();
+}
 #endif
 
 /** @} (end addtogroup CMU) */
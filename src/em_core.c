@@ -51,6 +51,7 @@
   @li @ref core_macro_api
   @li @ref core_reimplementation
   @li @ref core_vector_tables
+  @li @ref core_profile
   @li @ref core_examples
   @li @ref core_porting
 
@@ -87,6 +88,9 @@
   #define CORE_ATOMIC_METHOD                 CORE_ATOMIC_METHOD_PRIMASK
   @endverbatim
 
+  The critical section profiler is enabled with -DCORE_PROFILE on the
+  compiler command line, see @ref core_profile.
+
   If the default values do not support your needs, they can be overridden
   by supplying -D compiler flags on the compiler command line or by collecting
   all macro redefinitions in a file named @em emlib_config.h and then supplying
@@ -201,6 +205,36 @@
   They both use the interrupt vector table defined by the current
   VTOR register value.
 
+@n @section core_profile Critical section profiler
+
+  When CORE_PROFILE is defined, @ref CORE_ENTER_ATOMIC(),
+  @ref CORE_ENTER_CRITICAL() and their exit macros time every outermost
+  section. The masked time and the call site (__FILE__ and __LINE__ of the
+  entry macro) are added to a table of @ref CORE_PROFILE_SITES entries.
+  Sites that do not fit in the table are counted by
+  @ref CORE_ProfileDropped(). The macros are expanded in the user's code, so
+  CORE_PROFILE must be defined for all of it, not only for em_core.c.
+  Direct calls to CORE_EnterAtomic() and similar functions are not profiled.
+
+  Timestamps are DWT cycles on Cortex-M3 and later, and the SysTick counter
+  on Cortex-M0+. SysTick must then run free with the maximum reload value,
+  so the longest measurable section is 2^24 cycles. A longer one is
+  recorded with the maximum time and counted as wrapped when SysTick
+  COUNTFLAG shows the counter passed zero and the end timestamp is not
+  below the start; one that ends below its start reads as the time modulo
+  2^24. Define CORE_PROFILE_TIMESTAMP(), CORE_PROFILE_TIMESTAMP_MASK and
+  CORE_PROFILE_WRAPPED() to use another counter.
+
+  The core clock and the timestamp counter stop in EM2 and EM3, and time
+  slept in EM1 is no masked time. The EMU energy mode entry functions call
+  @ref CORE_ProfileSuspend() before WFI and @ref CORE_ProfileResume() after
+  it, so a section that sleeps is timed up to WFI and again from the
+  wakeup. Sections entered while suspended are not recorded.
+
+  @ref CORE_ProfileGet() copies the table at run time, for example to rank
+  the sections with the longest masked time. @ref CORE_ProfileReset()
+  empties it.
+
 @n @section core_examples Examples
 
   Implement an NVIC critical section:
@@ -291,6 +325,31 @@
 #define CORE_INTERRUPT_EXIT()
 #endif
 
+#if defined(CORE_PROFILE) && !defined(CORE_PROFILE_TIMESTAMP)
+#if (__CORTEX_M >= 3)
+/** Profiler timestamp, cycles. */
+#define CORE_PROFILE_TIMESTAMP()      (DWT->CYCCNT)
+/** Profiler timestamp width. */
+#define CORE_PROFILE_TIMESTAMP_MASK   0xFFFFFFFFUL
+#else
+#define CORE_PROFILE_TIMESTAMP() \
+  (SysTick_LOAD_RELOAD_Msk - SysTick->VAL)
+#define CORE_PROFILE_TIMESTAMP_MASK   SysTick_LOAD_RELOAD_Msk
+#endif
+#endif
+
+#if defined(CORE_PROFILE) && !defined(CORE_PROFILE_WRAPPED)
+#if (__CORTEX_M >= 3)
+/** Profiler timestamp passed zero since the last call, not detected. */
+#define CORE_PROFILE_WRAPPED()        false
+#else
+/** Profiler timestamp passed zero since the last call, reading CTRL clears
+ *  COUNTFLAG. */
+#define CORE_PROFILE_WRAPPED() \
+  ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0U)
+#endif
+#endif
+
 // Compile time sanity check.
 #if (CORE_ATOMIC_METHOD != CORE_ATOMIC_METHOD_PRIMASK) \
   && (CORE_ATOMIC_METHOD != CORE_ATOMIC_METHOD_BASEPRI)
@@ -497,6 +556,230 @@ SL_WEAK void CORE_YieldAtomic(void)
 #endif // (CORE_ATOMIC_METHOD == CORE_ATOMIC_METHOD_BASEPRI)
 }
 
+#if defined(CORE_PROFILE)
+static CORE_ProfileSite_t profileSites[CORE_PROFILE_SITES];
+static uint32_t profileDropped;
+static uint32_t profileDepth;
+static uint32_t profileStart;
+static uint32_t profileElapsed;
+static bool profileWrapped;
+static bool profileSuspended;
+static bool profileTiming;
+static const char *profileFile;
+static uint32_t profileLine;
+
+/* Add the time from profileStart to now to profileElapsed. */
+static void profileSegmentEnd(void)
+{
+  uint32_t end = CORE_PROFILE_TIMESTAMP();
+  uint32_t elapsed = (end - profileStart) & CORE_PROFILE_TIMESTAMP_MASK;
+
+  // The counter passed zero and is not below the start again: a period or
+  // more has passed. At the mask it may just have reached zero.
+  if (CORE_PROFILE_WRAPPED() && end >= profileStart
+      && end != CORE_PROFILE_TIMESTAMP_MASK) {
+    profileWrapped = true;
+  }
+  if (elapsed > CORE_PROFILE_TIMESTAMP_MASK - profileElapsed) {
+    profileWrapped = true;
+  }
+  profileElapsed += elapsed;
+  profileTiming = false;
+}
+
+/* Clear the wrap indication and take the start timestamp. */
+static void profileSegmentStart(void)
+{
+  (void)CORE_PROFILE_WRAPPED();
+  profileStart = CORE_PROFILE_TIMESTAMP();
+  profileTiming = true;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Start timing a section, used by the ATOMIC and CRITICAL entry macros.
+ *
+ * @details
+ *   Only the outermost of nested sections is timed, it is attributed to
+ *   the call site of its entry macro.
+ *
+ * @param[in] irqState
+ *   The state returned by the section entry function.
+ *
+ * @param[in] file
+ *   __FILE__ of the entry macro.
+ *
+ * @param[in] line
+ *   __LINE__ of the entry macro.
+ *
+ * @return
+ *   irqState, unchanged.
+ ******************************************************************************/
+CORE_irqState_t CORE_ProfileEnter(CORE_irqState_t irqState,
+                                  const char *file,
+                                  uint32_t line)
+{
+  if (profileDepth++ == 0U) {
+    profileFile = file;
+    profileLine = line;
+    profileElapsed = 0U;
+    profileWrapped = false;
+    profileTiming = false;
+    // An interrupt handler runs awake, also between suspend and resume.
+    if (!profileSuspended || CORE_InIrqContext()) {
+      profileSegmentStart();
+    }
+  }
+  return irqState;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Stop timing a section, used by the ATOMIC and CRITICAL exit macros.
+ *
+ * @param[in] irqState
+ *   The state to be passed to the section exit function.
+ *
+ * @return
+ *   irqState, unchanged.
+ ******************************************************************************/
+CORE_irqState_t CORE_ProfileExit(CORE_irqState_t irqState)
+{
+  uint32_t elapsed;
+  uint32_t i;
+
+  if (profileDepth == 0U || --profileDepth != 0U) {
+    return irqState;
+  }
+  // Entered and left while suspended, e.g. inside an energy mode entry.
+  if (!profileTiming) {
+    return irqState;
+  }
+  profileSegmentEnd();
+  elapsed = profileWrapped ? CORE_PROFILE_TIMESTAMP_MASK : profileElapsed;
+  for (i = 0U; i < CORE_PROFILE_SITES; i++) {
+    CORE_ProfileSite_t *site = &profileSites[i];
+
+    if (site->count == 0U) {
+      site->file = profileFile;
+      site->line = profileLine;
+    } else if (site->line != profileLine || site->file != profileFile) {
+      continue;
+    }
+    site->count++;
+    if (profileWrapped) {
+      site->wrapped++;
+    }
+    site->total += elapsed;
+    if (elapsed > site->max) {
+      site->max = elapsed;
+    }
+    return irqState;
+  }
+  profileDropped++;
+  return irqState;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Stop the clock of the section being timed, before the core sleeps.
+ *
+ * @details
+ *   Called by the EMU energy mode entry functions before WFI. Time until
+ *   @ref CORE_ProfileResume() is not masked time. Sections entered and
+ *   left in between outside of interrupt handlers are not recorded.
+ ******************************************************************************/
+void CORE_ProfileSuspend(void)
+{
+  if (!profileSuspended) {
+    profileSuspended = true;
+    if (profileTiming) {
+      profileSegmentEnd();
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Restart the clock of the section being timed, after the core woke up.
+ ******************************************************************************/
+void CORE_ProfileResume(void)
+{
+  if (profileSuspended) {
+    profileSuspended = false;
+    if (profileDepth != 0U && !profileTiming) {
+      profileSegmentStart();
+    }
+  }
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Copy the profiler table.
+ *
+ * @param[out] sites
+ *   Destination of the site records, in order of first use.
+ *
+ * @param[in] maxSites
+ *   Number of records that fit in sites.
+ *
+ * @return
+ *   Number of records copied.
+ ******************************************************************************/
+uint32_t CORE_ProfileGet(CORE_ProfileSite_t *sites, uint32_t maxSites)
+{
+  CORE_irqState_t irqState;
+  uint32_t n = 0U;
+
+  // Not the macros, this section must not profile itself.
+  irqState = CORE_EnterCritical();
+  while (n < maxSites && n < CORE_PROFILE_SITES
+         && profileSites[n].count != 0U) {
+    sites[n] = profileSites[n];
+    n++;
+  }
+  CORE_ExitCritical(irqState);
+  return n;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get the number of timed sections that did not fit in the profiler table.
+ ******************************************************************************/
+uint32_t CORE_ProfileDropped(void)
+{
+  return profileDropped;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Empty the profiler table.
+ *
+ * @details
+ *   On Cortex-M3 and later this also starts the DWT cycle counter used for
+ *   the default timestamps.
+ ******************************************************************************/
+void CORE_ProfileReset(void)
+{
+  CORE_irqState_t irqState;
+  uint32_t i;
+
+#if (__CORTEX_M >= 3)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  irqState = CORE_EnterCritical();
+  for (i = 0U; i < CORE_PROFILE_SITES; i++) {
+    profileSites[i].count = 0U;
+    profileSites[i].wrapped = 0U;
+    profileSites[i].max = 0U;
+    profileSites[i].total = 0U;
+  }
+  profileDropped = 0U;
+  CORE_ExitCritical(irqState);
+}
+#endif // defined(CORE_PROFILE)
+
 /***************************************************************************//**
  * @brief
  *   Enter a NVIC mask section.
@@ -36,6 +36,9 @@
 #include "em_cmu.h"
 #include "em_assert.h"
 #include "em_bus.h"
+#if defined(EMDRV_TRACE)
+#include "emdrv_trace.h"
+#endif
 
 /***************************************************************************//**
  * @addtogroup emlib
@@ -262,6 +265,9 @@ static void DMA_Prepare(unsigned int channel,
  *   a DMA IRQ handler, define EXCLUDE_DEFAULT_DMA_IRQ_HANDLER
  *   with a \#define statement or with the compiler option -D.
  *
+ *   With EMDRV_TRACE defined, entry and exit of this handler are reported
+ *   through the EMDRV trace hooks in emdrv_trace.h.
+ *
  ******************************************************************************/
 void DMA_IRQHandler(void)
 {
@@ -273,6 +279,10 @@ void DMA_IRQHandler(void)
   uint32_t               primaryCpy;
   int                    i;
 
+#if defined(EMDRV_TRACE)
+  EMDRV_TRACE_IRQ_ENTER();
+#endif
+
   /* Get all pending and enabled interrupts. */
   pending  = DMA->IF;
   pending &= DMA->IEN;
@@ -319,6 +329,10 @@ void DMA_IRQHandler(void)
     /* On second iteration, process default priority channels. */
     pendingPrio = pending & ~prio;
   }
+
+#if defined(EMDRV_TRACE)
+  EMDRV_TRACE_IRQ_EXIT();
+#endif
 }
 
 #endif /* EXCLUDE_DEFAULT_DMA_IRQ_HANDLER */
@@ -582,11 +582,17 @@ void EMU_EnterEM2(bool restore)
   dcdcHsFixLnBlock();
 #endif
 
+#if defined(CORE_PROFILE)
+  CORE_ProfileSuspend();
+#endif
 #if defined(ERRATA_FIX_EMU_E110_ENABLE)
   CORE_CRITICAL_SECTION(ramWFI(); )
 #else
   __WFI();
 #endif
+#if defined(CORE_PROFILE)
+  CORE_ProfileResume();
+#endif
 
 #if defined(ERRATA_FIX_DCDC_FETCNT_SET_ENABLE)
   dcdcFetCntSet(false);
@@ -613,6 +619,8 @@ void EMU_EnterEM2(bool restore)
     /* update CMSIS core clock variable since HF clock has changed */
     /* to HFRCO. */
     SystemCoreClockUpdate();
+    /* The frequencies cached by the CMU are stale as well. */
+    CMU_ClockFreqInvalidate();
   }
 }
 
@@ -721,11 +729,17 @@ void EMU_EnterEM3(bool restore)
   dcdcHsFixLnBlock();
 #endif
 
+#if defined(CORE_PROFILE)
+  CORE_ProfileSuspend();
+#endif
 #if defined(ERRATA_FIX_EMU_E110_ENABLE)
   CORE_CRITICAL_SECTION(ramWFI(); )
 #else
   __WFI();
 #endif
+#if defined(CORE_PROFILE)
+  CORE_ProfileResume();
+#endif
 
 #if defined(ERRATA_FIX_DCDC_FETCNT_SET_ENABLE)
   dcdcFetCntSet(false);
@@ -752,6 +766,8 @@ void EMU_EnterEM3(bool restore)
     /* As a result, he CMSIS core clock variable must be updated. */
     /* to HFRCO. */
     SystemCoreClockUpdate();
+    /* The frequencies cached by the CMU are stale as well. */
+    CMU_ClockFreqInvalidate();
   }
 }
 
@@ -299,9 +299,11 @@ void I2C_BusFreqSet(I2C_TypeDef *i2c,
    * For more details, see the reference manual
    * I2C Clock Generation chapter.  */
 
-  /* n = Nlow + Nhigh */
+  /* n = Nlow + Nhigh. DIV is rounded up, the bus must not run faster
+   * than freqScl. */
   n = (uint32_t)(i2cNSum[i2cMode]);
-  div = ((freqRef - (I2C_CR_MAX * freqScl)) / (n * freqScl)) - 1;
+  div = ((freqRef - (I2C_CR_MAX * freqScl) + (n * freqScl) - 1)
+         / (n * freqScl)) - 1;
   EFM_ASSERT(div >= 0);
   EFM_ASSERT((uint32_t)div <= _I2C_CLKDIV_DIV_MASK);
 
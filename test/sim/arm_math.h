@@ -0,0 +1 @@
+/* the device header takes __CLZ from here, the virtual core has it */
@@ -0,0 +1,22 @@
+#ifndef __CMU_PROBE_H__
+#define __CMU_PROBE_H__
+
+#include "em_device.h"
+#include "efm32sim.h"
+
+/* forced into an instrumented build of em_cmu.c (-include): the HF clock
+* selected by a CMD write is read back by SystemCoreClockGet() right after,
+* without a sync point in between. the CMD written takes effect in
+* SIM_cmuSync() first. right after the read is a preemption point, where
+* SIM_probeHook can change the clocks as an interrupt handler would, in the
+* middle of a clock change or of a frequency computation */
+
+#define SystemCoreClockGet() ({ \
+    uint32_t freq_; \
+    SIM_cmuSync(); \
+    freq_ = SystemCoreClockGet(); \
+    SIM_probe(); \
+    freq_; \
+  })
+
+#endif // __CMU_PROBE_H__
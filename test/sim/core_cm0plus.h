@@ -0,0 +1,193 @@
+#ifndef __CORE_CM0PLUS_H__
+#define __CORE_CM0PLUS_H__
+
+#include <stdint.h>
+
+/* virtual Cortex-M0+ core of the host simulation
+* stands in for the CMSIS core header. the core peripherals are plain
+* structures, PRIMASK and the NVIC are modelled by efm32sim.c: unmasking
+* interrupts, enabling or pending one dispatches the pending handlers */
+
+#define __CORTEX_M 0U
+
+#define __I   volatile const
+#define __O   volatile
+#define __IO  volatile
+#define __IM  volatile const
+#define __OM  volatile
+#define __IOM volatile
+
+#define __ASM            __asm
+#define __INLINE         inline
+#define __STATIC_INLINE  static inline
+#define __WEAK           __attribute__((weak))
+#define __ALIGNED(x)     __attribute__((aligned(x)))
+#define __NO_RETURN      __attribute__((noreturn))
+
+typedef struct {
+    __IOM uint32_t ISER[1];
+    uint32_t RESERVED0[31];
+    __IOM uint32_t ICER[1];
+    uint32_t RESERVED1[31];
+    __IOM uint32_t ISPR[1];
+    uint32_t RESERVED2[31];
+    __IOM uint32_t ICPR[1];
+    uint32_t RESERVED3[31];
+    uint32_t RESERVED4[64];
+    __IOM uint32_t IP[8];
+} NVIC_Type;
+
+typedef struct {
+    __IM uint32_t CPUID;
+    __IOM uint32_t ICSR;
+    __IOM uint32_t VTOR;
+    __IOM uint32_t AIRCR;
+    __IOM uint32_t SCR;
+    __IOM uint32_t CCR;
+    uint32_t RESERVED0;
+    __IOM uint32_t SHP[2];
+    __IOM uint32_t SHCSR;
+} SCB_Type;
+
+typedef struct {
+    __IOM uint32_t CTRL;
+    __IOM uint32_t LOAD;
+    __IOM uint32_t VAL;
+    __IM uint32_t CALIB;
+} SysTick_Type;
+
+extern NVIC_Type SIM_nvic;
+extern SCB_Type SIM_scb;
+extern SysTick_Type SIM_sysTick;
+
+#define NVIC    (&SIM_nvic)
+#define SCB     (&SIM_scb)
+#define SysTick (&SIM_sysTick)
+
+#define SCB_ICSR_ISRPENDING_Msk     (1UL << 22)
+#define SCB_ICSR_VECTACTIVE_Pos     0U
+#define SCB_ICSR_VECTACTIVE_Msk     0x1FFUL
+#define SCB_VTOR_TBLOFF_Msk         0xFFFFFF80UL
+#define SCB_SCR_SEVONPEND_Msk       (1UL << 4)
+#define SCB_SCR_SLEEPDEEP_Msk       (1UL << 2)
+#define SCB_SCR_SLEEPONEXIT_Msk     (1UL << 1)
+#define SCB_AIRCR_VECTKEY_Pos       16U
+#define SCB_AIRCR_SYSRESETREQ_Msk   (1UL << 2)
+#define SysTick_CTRL_COUNTFLAG_Msk  (1UL << 16)
+#define SysTick_CTRL_CLKSOURCE_Msk  (1UL << 2)
+#define SysTick_CTRL_TICKINT_Msk    (1UL << 1)
+#define SysTick_CTRL_ENABLE_Msk     1UL
+#define SysTick_LOAD_RELOAD_Msk     0xFFFFFFUL
+#define SysTick_VAL_CURRENT_Msk     0xFFFFFFUL
+
+/* COUNTFLAG clears when CTRL is read, which plain memory cannot model. the
+* critical section profiler of em_core.c reads it through this */
+#define CORE_PROFILE_WRAPPED() SIM_sysTickWrapped()
+
+/* model entry points, see efm32sim.h */
+extern volatile uint32_t SIM_primask;
+void SIM_irqEnable(int irq, int enable);
+void SIM_irqPend(int irq, int pend);
+int SIM_irqPending(int irq);
+int SIM_sysTickWrapped(void);
+void SIM_sync(void);
+void SIM_wfi(void);
+
+__STATIC_INLINE void __enable_irq(void) {
+  SIM_primask = 0U;
+  SIM_sync();
+}
+
+__STATIC_INLINE void __disable_irq(void) {
+  SIM_primask = 1U;
+}
+
+__STATIC_INLINE uint32_t __get_PRIMASK(void) {
+  return SIM_primask;
+}
+
+__STATIC_INLINE void __set_PRIMASK(uint32_t priMask) {
+  SIM_primask = priMask & 1U;
+  if (SIM_primask == 0U) {
+    SIM_sync();
+  }
+}
+
+__STATIC_INLINE uint32_t __get_IPSR(void) {
+  return SIM_scb.ICSR & SCB_ICSR_VECTACTIVE_Msk;
+}
+
+__STATIC_INLINE void __WFI(void) {
+  SIM_wfi();
+}
+
+__STATIC_INLINE void __WFE(void) {
+  SIM_wfi();
+}
+
+__STATIC_INLINE void __SEV(void) {}
+__STATIC_INLINE void __NOP(void) {}
+__STATIC_INLINE void __DSB(void) {}
+__STATIC_INLINE void __DMB(void) {}
+__STATIC_INLINE void __ISB(void) {}
+
+__STATIC_INLINE uint32_t __REV(uint32_t value) {
+  return __builtin_bswap32(value);
+}
+
+__STATIC_INLINE uint32_t __CLZ(uint32_t value) {
+  return (value != 0U) ? (uint32_t)__builtin_clz(value) : 32U;
+}
+
+__STATIC_INLINE void NVIC_EnableIRQ(IRQn_Type IRQn) {
+  SIM_irqEnable((int)IRQn, 1);
+}
+
+__STATIC_INLINE void NVIC_DisableIRQ(IRQn_Type IRQn) {
+  SIM_irqEnable((int)IRQn, 0);
+}
+
+__STATIC_INLINE uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn) {
+  return (SIM_nvic.ISER[0] >> (uint32_t)IRQn) & 1U;
+}
+
+__STATIC_INLINE void NVIC_SetPendingIRQ(IRQn_Type IRQn) {
+  SIM_irqPend((int)IRQn, 1);
+}
+
+__STATIC_INLINE void NVIC_ClearPendingIRQ(IRQn_Type IRQn) {
+  SIM_irqPend((int)IRQn, 0);
+}
+
+__STATIC_INLINE uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn) {
+  return (uint32_t)SIM_irqPending((int)IRQn);
+}
+
+/* priorities are stored, dispatch is in IRQ number order */
+__STATIC_INLINE void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority) {
+  if ((int32_t)IRQn >= 0) {
+    uint32_t shift = 8U * ((uint32_t)IRQn & 3U);
+
+    SIM_nvic.IP[(uint32_t)IRQn >> 2] = (SIM_nvic.IP[(uint32_t)IRQn >> 2] & ~(0xFFUL << shift))
+                                       | ((priority & 0xFFUL) << shift);
+  }
+}
+
+__STATIC_INLINE uint32_t NVIC_GetPriority(IRQn_Type IRQn) {
+  if ((int32_t)IRQn < 0) {
+    return 0U;
+  }
+  return (SIM_nvic.IP[(uint32_t)IRQn >> 2] >> (8U * ((uint32_t)IRQn & 3U))) & 0xFFU;
+}
+
+__STATIC_INLINE uint32_t SysTick_Config(uint32_t ticks) {
+  SIM_sysTick.LOAD = (ticks - 1U) & SysTick_LOAD_RELOAD_Msk;
+  SIM_sysTick.VAL = 0U;
+  SIM_sysTick.CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk
+                     | SysTick_CTRL_ENABLE_Msk;
+  return 0U;
+}
+
+void NVIC_SystemReset(void);
+
+#endif // __CORE_CM0PLUS_H__
@@ -0,0 +1,1665 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "efm32sim.h"
+#include "em_cmu.h"
+
+/* bit 31 is no interrupt or DMA channel of the device. it marks the value
+* the model left in a write-one-to-clear register, any other value was
+* written by the software since the last sync point */
+#define SIM_MARK (1UL << 31)
+
+/* sleeping longer than this without a wakeup source is a test bug */
+#define SIM_SLEEP_LIMIT (3600ULL * SIM_LFCLK_HZ)
+
+NVIC_Type SIM_nvic;
+SCB_Type SIM_scb;
+SysTick_Type SIM_sysTick;
+volatile uint32_t SIM_primask;
+
+jmp_buf SIM_stop;
+uint8_t SIM_tx[SIM_TX_SIZE];
+uint32_t SIM_txLen;
+SIM_UsartFrame SIM_usartTx[SIM_USART_TX_SIZE];
+uint32_t SIM_usartTxLen;
+SIM_I2cEvent SIM_i2cLog[SIM_I2C_LOG_SIZE];
+uint32_t SIM_i2cLogLen;
+uint32_t SIM_irqCount[32];
+void (*SIM_probeHook)(void);
+uint16_t (*SIM_usartSlave)(uint16_t frame);
+
+typedef struct {
+    uintptr_t base;
+    size_t size;
+} SIM_Region;
+
+/* calibration and device information, peripherals, ROM table */
+static SIM_Region const l_regions[] = {
+  { 0x0FE08000UL, 0x1000UL },
+  { PER_MEM_BASE, 0x100000UL },
+  { 0xF00FF000UL, 0x1000UL },
+};
+
+static uint64_t l_now;
+static uint64_t l_cycles;
+static uint32_t l_hfTick;   /* HFCLK cycles of the current LFCLK tick */
+static uint32_t l_hfPos;    /* of them passed */
+static uint32_t l_hfFrac;   /* HFCLK remainder, in 1/SIM_LFCLK_HZ cycles */
+static uint64_t l_deadline;
+static bool l_running;
+static uint32_t l_runPrimask;
+static int l_active;       /* exception number, 0 in thread mode */
+static uint32_t l_taken;   /* exceptions taken */
+
+static uint32_t l_nvicEnabled;
+static uint32_t l_nvicPending;
+
+static uint32_t l_rtcPresc;
+static uint32_t l_rtcCtrl;
+
+static uint32_t l_dmaEnabled;
+static uint32_t l_dmaAlt;
+static uint32_t l_dmaReqMask;
+static uint32_t l_dmaBurst;
+static uint32_t l_dmaPrio;
+static uintptr_t l_dmaTable[DMA_CHAN_COUNT];  /* scatter-gather task tables */
+static uint32_t l_leuartCredit; /* 1/256 LFCLK ticks */
+
+/* USART1 transmitter, a two frame buffer and the shift register */
+#define SIM_USART_BUF 2U
+static bool l_usartTxEn;
+static bool l_usartTxc;
+static uint16_t l_usartBuf[SIM_USART_BUF];
+static uint32_t l_usartBufLen;
+static bool l_usartShifting;
+static uint16_t l_usartShift;
+static uint64_t l_usartStart;
+static uint64_t l_usartLeft;  /* HFCLK cycles of the frame being sent */
+/* USART1 receiver, the frames shifted in from SIM_usartSlave */
+static bool l_usartRxEn;
+static uint16_t l_usartRx[SIM_USART_BUF];
+static uint32_t l_usartRxLen;
+
+/* I2C0 master, the bus phase it drives and the software commands it has
+* not taken yet */
+typedef enum {
+  I2C_IDLE,    /* not the bus master */
+  I2C_START,   /* (repeated) START */
+  I2C_TX,      /* a byte out and the ACK bit in */
+  I2C_RX,      /* a byte in */
+  I2C_ACKBIT,  /* the ACK bit of the byte in */
+  I2C_HOLD,    /* SCL held low for the software */
+  I2C_STOP
+} SIM_I2cPhase;
+
+static SIM_I2cPhase l_i2cPhase;
+static uint32_t l_i2cCmd;        /* pending commands */
+static bool l_i2cAddr;           /* the next byte out is the address */
+static bool l_i2cRead;           /* addressed for a read */
+static bool l_i2cNacked;
+static bool l_i2cTxFull;
+static uint8_t l_i2cTx;          /* the transmit buffer */
+static uint8_t l_i2cShift;       /* the byte out */
+static bool l_i2cRxValid;
+static bool l_i2cTxc;
+static bool l_i2cSlaveOn;        /* the slave was addressed and ACKed */
+static bool l_i2cAfterAddr;      /* held after the address */
+static bool l_i2cRestart;        /* the START is a repeated START */
+static bool l_i2cAckDue;         /* the byte in waits for its ACK bit */
+static bool l_i2cArbLose;        /* the next byte out loses arbitration */
+static bool l_i2cOther;          /* another master holds the bus */
+static uint64_t l_i2cLeft;       /* HFCLK cycles of the phase */
+static SIM_I2cEvent *l_i2cEvent; /* the event of the phase */
+static SIM_I2cSlave const *l_i2cSlave;
+
+static uint32_t l_sysTickVal;   /* VAL as the model left it */
+static uint32_t l_sysTickPhase; /* HFCLK cycles into a HFCORECLK cycle */
+static bool l_sysTickPending;
+
+typedef struct {
+    TIMER_TypeDef *regs;
+    uint32_t cnt;     /* CNT as the model left it */
+    uint32_t phase;   /* HFCLK cycles into a counter tick */
+    bool running;
+} SIM_Timer;
+
+static SIM_Timer l_timers[] = { { TIMER0 }, { TIMER1 } };
+
+#define SIM_TIMERS   (sizeof(l_timers) / sizeof(l_timers[0]))
+#define SIM_TIMER_CH 3U /* compare/capture channels */
+
+typedef struct {
+    volatile uint32_t *ifReg;
+    volatile uint32_t *ien;
+    IRQn_Type irq;
+} SIM_IrqLine;
+
+#define SIM_LINE(p) { (volatile uint32_t *)&(p)->IF, &(p)->IEN, p##_IRQn }
+
+/* sources with one interrupt line, the GPIO lines are split by pin */
+static SIM_IrqLine const l_lines[] = {
+  { (volatile uint32_t *)&DMA->IF, &DMA->IEN, DMA_IRQn },
+  SIM_LINE(RTC),
+  SIM_LINE(TIMER0),
+  SIM_LINE(TIMER1),
+  SIM_LINE(LEUART0),
+  SIM_LINE(I2C0),
+  SIM_LINE(PCNT0),
+  { (volatile uint32_t *)&ADC0->IF, &ADC0->IEN, ADC0_IRQn },
+};
+
+/* default handlers, the code under test defines the ones it uses */
+static void unexpectedIrq(void) {
+  fprintf(stderr, "sim: unexpected exception %d\n", l_active);
+  abort();
+}
+
+void SysTick_Handler(void) __attribute__((weak, alias("unexpectedIrq")));
+void DMA_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void GPIO_EVEN_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void TIMER0_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void ACMP0_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void ADC0_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void I2C0_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void GPIO_ODD_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void TIMER1_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void USART1_RX_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void USART1_TX_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void LEUART0_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void PCNT0_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void RTC_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void CMU_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void VCMP_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void MSC_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+void AES_IRQHandler(void) __attribute__((weak, alias("unexpectedIrq")));
+
+/* the vector table of startup_efm32.c, VTOR is not modelled */
+static void (* const l_vectors[])(void) = {
+  DMA_IRQHandler,         /* 0 */
+  GPIO_EVEN_IRQHandler,   /* 1 */
+  TIMER0_IRQHandler,      /* 2 */
+  ACMP0_IRQHandler,       /* 3 */
+  ADC0_IRQHandler,        /* 4 */
+  I2C0_IRQHandler,        /* 5 */
+  GPIO_ODD_IRQHandler,    /* 6 */
+  TIMER1_IRQHandler,      /* 7 */
+  USART1_RX_IRQHandler,   /* 8 */
+  USART1_TX_IRQHandler,   /* 9 */
+  LEUART0_IRQHandler,     /* 10 */
+  PCNT0_IRQHandler,       /* 11 */
+  RTC_IRQHandler,         /* 12 */
+  CMU_IRQHandler,         /* 13 */
+  VCMP_IRQHandler,        /* 14 */
+  MSC_IRQHandler,         /* 15 */
+  AES_IRQHandler,         /* 16 */
+};
+
+#define SIM_IRQS (sizeof(l_vectors) / sizeof(l_vectors[0]))
+
+static void mapRegions(void) {
+  static bool mapped;
+  size_t i;
+  void *p;
+
+  if (mapped) {
+    return;
+  }
+  for (i = 0U; i < sizeof(l_regions) / sizeof(l_regions[0]); i++) {
+    p = mmap((void *)l_regions[i].base, l_regions[i].size,
+             PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p != (void *)l_regions[i].base) {
+      fprintf(stderr, "sim: cannot map 0x%08lx\n",
+              (unsigned long)l_regions[i].base);
+      abort();
+    }
+  }
+  mapped = true;
+}
+
+/* take the software writes to a set/clear register pair, both read back
+* the state. the model writes the state into the set register, where a
+* write of set bits changes nothing, and with SIM_MARK into the clear
+* register */
+static void setClearSync(uint32_t *state, volatile uint32_t *set,
+                         volatile uint32_t *clear) {
+  uint32_t old = *state;
+
+  if (*set != old) {
+    *state |= *set & ~SIM_MARK;
+  }
+  if (*clear != (old | SIM_MARK)) {
+    *state &= ~*clear;
+  }
+  *set = *state;
+  *clear = *state | SIM_MARK;
+}
+
+static void setClearWrite(uint32_t *state, volatile uint32_t *set,
+                          volatile uint32_t *clear, uint32_t value) {
+  setClearSync(state, set, clear);
+  *state = value;
+  *set = value;
+  *clear = value | SIM_MARK;
+}
+
+static void nvicSync(void) {
+  setClearSync(&l_nvicEnabled, NVIC->ISER, NVIC->ICER);
+  setClearSync(&l_nvicPending, NVIC->ISPR, NVIC->ICPR);
+}
+
+static void nvicWrite(void) {
+  NVIC->ISER[0] = l_nvicEnabled;
+  NVIC->ICER[0] = l_nvicEnabled | SIM_MARK;
+  NVIC->ISPR[0] = l_nvicPending;
+  NVIC->ICPR[0] = l_nvicPending | SIM_MARK;
+}
+
+static void flagSync(volatile uint32_t *ifReg, volatile uint32_t *ifs,
+                     volatile uint32_t *ifc) {
+  if (*ifs != 0U) {
+    *ifReg |= *ifs;
+    *ifs = 0U;
+  }
+  if (*ifc != 0U) {
+    *ifReg &= ~*ifc;
+    *ifc = 0U;
+  }
+}
+
+#define FLAG_SYNC(p) \
+  flagSync((volatile uint32_t *)&(p)->IF, &(p)->IFS, &(p)->IFC)
+
+static uint32_t usartBits(void) {
+  return (USART1->FRAME & _USART_FRAME_DATABITS_MASK) + 3U;
+}
+
+/* HFCLK cycles of a frame, a synchronous bit takes 2 + 2 * CLKDIV / 256
+* HFPERCLK cycles */
+static uint64_t usartFrameCycles(void) {
+  uint32_t clkdiv = USART1->CLKDIV & _USART_CLKDIV_DIV_MASK;
+
+  return ((uint64_t)usartBits() * (512U + 2U * clkdiv) / 256U)
+         << (CMU->HFPERCLKDIV & _CMU_HFPERCLKDIV_HFPERCLKDIV_MASK);
+}
+
+/* TXBL at the buffer level of TXBIL */
+static bool usartTxbl(void) {
+  return (USART1->CTRL & USART_CTRL_TXBIL) != 0U ? l_usartBufLen < SIM_USART_BUF
+                                                 : l_usartBufLen == 0U;
+}
+
+/* RXDATA and RXDOUBLE hold the oldest frame received */
+static void usartStatus(void) {
+  *(volatile uint32_t *)&USART1->STATUS =
+    (l_usartTxEn ? USART_STATUS_TXENS : 0U)
+    | (usartTxbl() ? USART_STATUS_TXBL : 0U)
+    | (l_usartTxc ? USART_STATUS_TXC : 0U)
+    | (l_usartRxEn ? USART_STATUS_RXENS : 0U)
+    | (l_usartRxLen != 0U ? USART_STATUS_RXDATAV : 0U)
+    | (l_usartRxLen == SIM_USART_BUF ? USART_STATUS_RXFULL : 0U);
+  *(volatile uint32_t *)&USART1->RXDATA = l_usartRx[0] & 0xFFU;
+  *(volatile uint32_t *)&USART1->RXDOUBLE = l_usartRx[0];
+}
+
+/* the next buffered frame into the shift register */
+static void usartStart(void) {
+  if (l_usartShifting || !l_usartTxEn || l_usartBufLen == 0U) {
+    return;
+  }
+  l_usartShift = l_usartBuf[0];
+  l_usartBuf[0] = l_usartBuf[1];
+  l_usartBufLen--;
+  l_usartShifting = true;
+  l_usartStart = l_cycles;
+  l_usartLeft = usartFrameCycles();
+}
+
+static void usartPush(uint32_t frame) {
+  if (l_usartBufLen == SIM_USART_BUF) {
+    *(volatile uint32_t *)&USART1->IF |= USART_IF_TXOF;
+    return;
+  }
+  l_usartBuf[l_usartBufLen++] = (uint16_t)frame;
+  l_usartTxc = false;
+  usartStart();
+}
+
+/* a write to TXDATA or TXDOUBLE, which holds two frames of up to 8 bits
+* or one larger frame. the model leaves SIM_MARK in both */
+static void usartWrite(volatile uint32_t *reg, uint32_t value) {
+  uint32_t bits = usartBits();
+
+  if (reg == &USART1->TXDATA) {
+    usartPush(value & 0xFFU);
+  } else if (bits <= 8U) {
+    usartPush(value & 0xFFU);
+    usartPush((value >> 8) & 0xFFU);
+  } else {
+    usartPush(value & ((1UL << bits) - 1U));
+  }
+  *reg = SIM_MARK;
+  usartStatus();
+}
+
+/* take the commands and the frames written by the software */
+static void usartSync(void) {
+  uint32_t cmd = USART1->CMD;
+
+  if (cmd != 0U) {
+    USART1->CMD = 0U;
+    if ((cmd & USART_CMD_CLEARTX) != 0U) {
+      l_usartBufLen = 0U;
+    }
+    if ((cmd & USART_CMD_TXEN) != 0U) {
+      l_usartTxEn = true;
+    }
+    if ((cmd & USART_CMD_TXDIS) != 0U) {
+      l_usartTxEn = false;
+    }
+    if ((cmd & USART_CMD_CLEARRX) != 0U) {
+      l_usartRxLen = 0U;
+    }
+    if ((cmd & USART_CMD_RXEN) != 0U) {
+      l_usartRxEn = true;
+    }
+    if ((cmd & USART_CMD_RXDIS) != 0U) {
+      l_usartRxEn = false;
+    }
+  }
+  if (USART1->TXDATA != SIM_MARK) {
+    usartWrite(&USART1->TXDATA, USART1->TXDATA);
+  }
+  if (USART1->TXDOUBLE != SIM_MARK) {
+    usartWrite(&USART1->TXDOUBLE, USART1->TXDOUBLE);
+  }
+  usartStart();
+  usartStatus();
+}
+
+/* HFCLK cycles of an SCL period, as I2C_BusFreqGet() on the series 0 */
+static uint64_t i2cPeriod(void) {
+  static uint8_t const nSum[] = { 4 + 4, 6 + 3, 11 + 6, 4 + 4 };
+  uint32_t n = nSum[(I2C0->CTRL & _I2C_CTRL_CLHR_MASK) >> _I2C_CTRL_CLHR_SHIFT];
+
+  return ((uint64_t)n * ((I2C0->CLKDIV & _I2C_CLKDIV_DIV_MASK) + 1U) + 4U)
+         << (CMU->HFPERCLKDIV & _CMU_HFPERCLKDIV_HFPERCLKDIV_MASK);
+}
+
+static void i2cStatus(void) {
+  volatile uint32_t *ifReg = (volatile uint32_t *)&I2C0->IF;
+  uint32_t state = 0U;
+  uint32_t status;
+
+  switch (l_i2cPhase) {
+    case I2C_IDLE:
+      break;
+    case I2C_START:
+      state = I2C_STATE_STATE_START;
+      break;
+    case I2C_TX:
+      state = l_i2cAddr ? I2C_STATE_STATE_ADDR : I2C_STATE_STATE_DATA;
+      break;
+    case I2C_HOLD:
+      state = (l_i2cAfterAddr ? I2C_STATE_STATE_ADDRACK : I2C_STATE_STATE_DATAACK)
+              | I2C_STATE_BUSHOLD;
+      break;
+    default:
+      state = I2C_STATE_STATE_DATA;
+      break;
+  }
+  if (l_i2cPhase != I2C_IDLE) {
+    state |= I2C_STATE_MASTER | I2C_STATE_BUSY;
+    if (!l_i2cRead) {
+      state |= I2C_STATE_TRANSMITTER;
+    }
+    if (l_i2cNacked) {
+      state |= I2C_STATE_NACKED;
+    }
+  }
+  if (l_i2cOther) {
+    state |= I2C_STATE_BUSY;
+  }
+  *(volatile uint32_t *)&I2C0->STATE = state;
+
+  status = l_i2cCmd & (I2C_STATUS_PSTART | I2C_STATUS_PSTOP | I2C_STATUS_PACK
+                       | I2C_STATUS_PNACK);
+  *ifReg &= ~(I2C_IF_TXBL | I2C_IF_RXDATAV);
+  if (!l_i2cTxFull) {
+    status |= I2C_STATUS_TXBL;
+    *ifReg |= I2C_IF_TXBL;
+  }
+  if (l_i2cTxc) {
+    status |= I2C_STATUS_TXC;
+  }
+  if (l_i2cRxValid) {
+    status |= I2C_STATUS_RXDATAV;
+    *ifReg |= I2C_IF_RXDATAV;
+  }
+  *(volatile uint32_t *)&I2C0->STATUS = status;
+}
+
+static void i2cPhase(SIM_I2cPhase phase, uint32_t periods) {
+  l_i2cPhase = phase;
+  l_i2cLeft = periods * i2cPeriod();
+}
+
+/* a bus event, NULL once the log is full */
+static SIM_I2cEvent *i2cLog(SIM_I2cKind kind, uint8_t byte) {
+  SIM_I2cEvent *e = NULL;
+
+  if (SIM_i2cLogLen < SIM_I2C_LOG_SIZE) {
+    e = &SIM_i2cLog[SIM_i2cLogLen++];
+    memset(e, 0, sizeof(*e));
+    e->kind = kind;
+    e->byte = byte;
+    e->start = l_cycles;
+  }
+  return e;
+}
+
+static void i2cStart(void) {
+  l_i2cCmd &= ~I2C_CMD_START;
+  l_i2cRestart = l_i2cPhase != I2C_IDLE;
+  l_i2cAddr = true;
+  l_i2cRead = false;
+  l_i2cNacked = false;
+  l_i2cAckDue = false;
+  i2cPhase(I2C_START, 1U);
+  l_i2cEvent = i2cLog(SIM_I2C_START, 0U);
+}
+
+/* a byte out, the address first after a START */
+static void i2cTx(void) {
+  l_i2cShift = l_i2cTx;
+  l_i2cTxFull = false;
+  l_i2cTxc = false;
+  i2cPhase(I2C_TX, 9U);
+  l_i2cEvent = i2cLog(SIM_I2C_TX, l_i2cShift);
+  if (l_i2cEvent != NULL) {
+    l_i2cEvent->addr = l_i2cAddr;
+  }
+}
+
+static void i2cRx(void) {
+  i2cPhase(I2C_RX, 8U);
+  l_i2cEvent = i2cLog(SIM_I2C_RX, l_i2cSlaveOn && l_i2cSlave->read != NULL
+                                  ? l_i2cSlave->read() : 0xFFU);
+}
+
+/* the ACK bit of the byte in, once the software commanded it. an ACK
+* queued before a NACK goes first */
+static void i2cAckBit(void) {
+  bool ack = (l_i2cCmd & I2C_CMD_ACK) != 0U;
+
+  if (!ack && (l_i2cCmd & I2C_CMD_NACK) == 0U) {
+    return;
+  }
+  l_i2cCmd &= ack ? ~I2C_CMD_ACK : ~I2C_CMD_NACK;
+  l_i2cAckDue = false;
+  l_i2cNacked = !ack;
+  if (l_i2cEvent != NULL) {
+    l_i2cEvent->ack = ack;
+  }
+  i2cPhase(I2C_ACKBIT, 1U);
+}
+
+/* start the next phase the pending commands and the buffers allow */
+static void i2cStep(void) {
+  if ((I2C0->CTRL & I2C_CTRL_EN) == 0U) {
+    return;
+  }
+  if (l_i2cPhase == I2C_IDLE) {
+    if ((l_i2cCmd & I2C_CMD_START) != 0U && !l_i2cOther) {
+      i2cStart();
+    }
+  } else if (l_i2cPhase == I2C_HOLD) {
+    if (l_i2cAckDue) {
+      i2cAckBit();
+    } else if ((l_i2cCmd & I2C_CMD_START) != 0U) {
+      i2cStart();
+    } else if ((l_i2cCmd & I2C_CMD_STOP) != 0U) {
+      l_i2cCmd &= ~I2C_CMD_STOP;
+      i2cPhase(I2C_STOP, 1U);
+      l_i2cEvent = i2cLog(SIM_I2C_STOP, 0U);
+    } else if (!l_i2cRead && !l_i2cNacked && l_i2cTxFull) {
+      i2cTx();
+    }
+  }
+}
+
+/* the end of a bus phase, SCL is held low for the next one */
+static void i2cPhaseEnd(void) {
+  volatile uint32_t *ifReg = (volatile uint32_t *)&I2C0->IF;
+  SIM_I2cEvent *e = l_i2cEvent;
+  bool ack;
+
+  if (e != NULL) {
+    e->end = l_cycles;
+  }
+  l_i2cEvent = NULL;
+  switch (l_i2cPhase) {
+    case I2C_START:
+      *ifReg |= l_i2cRestart ? I2C_IF_RSTART : I2C_IF_START;
+      l_i2cPhase = I2C_HOLD;
+      /* the address written before the START */
+      if (l_i2cTxFull) {
+        i2cTx();
+        return;
+      }
+      break;
+    case I2C_TX:
+      if (l_i2cArbLose) {
+        /* the other master goes on, the bus stays busy */
+        l_i2cArbLose = false;
+        l_i2cOther = true;
+        l_i2cPhase = I2C_IDLE;
+        l_i2cSlaveOn = false;
+        *ifReg |= I2C_IF_ARBLOST;
+        return;
+      }
+      l_i2cAfterAddr = l_i2cAddr;
+      if (l_i2cAddr) {
+        l_i2cAddr = false;
+        l_i2cRead = (l_i2cShift & 1U) != 0U;
+        l_i2cSlaveOn = l_i2cSlave != NULL
+                       && (l_i2cShift & 0xFEU) == (l_i2cSlave->addr & 0xFEU);
+        if (l_i2cSlaveOn && l_i2cSlave->start != NULL) {
+          l_i2cSlave->start(l_i2cRead);
+        }
+        ack = l_i2cSlaveOn;
+      } else {
+        ack = l_i2cSlaveOn
+              && (l_i2cSlave->write == NULL || l_i2cSlave->write(l_i2cShift));
+      }
+      if (e != NULL) {
+        e->ack = ack;
+      }
+      l_i2cNacked = !ack;
+      *ifReg |= ack ? I2C_IF_ACK : I2C_IF_NACK;
+      l_i2cPhase = I2C_HOLD;
+      if (ack && l_i2cRead) {
+        i2cRx();
+        return;
+      }
+      if (!l_i2cTxFull) {
+        l_i2cTxc = true;
+        *ifReg |= I2C_IF_TXC;
+      }
+      break;
+    case I2C_RX:
+      /* the byte is in, the ACK bit waits for the software */
+      l_i2cRxValid = true;
+      *(volatile uint32_t *)&I2C0->RXDATA = e != NULL ? e->byte : 0xFFU;
+      l_i2cAfterAddr = false;
+      l_i2cAckDue = true;
+      l_i2cPhase = I2C_HOLD;
+      l_i2cEvent = e;
+      break;
+    case I2C_ACKBIT:
+      l_i2cPhase = I2C_HOLD;
+      if (!l_i2cNacked) {
+        i2cRx();
+        return;
+      }
+      break;
+    case I2C_STOP:
+      if (l_i2cSlaveOn && l_i2cSlave->stop != NULL) {
+        l_i2cSlave->stop();
+      }
+      l_i2cSlaveOn = false;
+      l_i2cNacked = false;
+      l_i2cPhase = I2C_IDLE;
+      *ifReg |= I2C_IF_MSTOP;
+      break;
+    default:
+      break;
+  }
+  i2cStep();
+}
+
+/* a software command. the software reads RXDATA before it commands the bus
+* again, which clears RXDATAV */
+static void i2cCommand(uint32_t cmd) {
+  if ((cmd & (I2C_CMD_START | I2C_CMD_STOP | I2C_CMD_ACK | I2C_CMD_NACK
+              | I2C_CMD_ABORT)) != 0U) {
+    l_i2cRxValid = false;
+  }
+  if ((cmd & I2C_CMD_CLEARPC) != 0U) {
+    l_i2cCmd = 0U;
+  }
+  if ((cmd & I2C_CMD_CLEARTX) != 0U) {
+    l_i2cTxFull = false;
+  }
+  if ((cmd & I2C_CMD_ABORT) != 0U) {
+    /* the master lets go of the bus at once, a bus another master holds
+    * stays busy */
+    l_i2cCmd = 0U;
+    l_i2cPhase = I2C_IDLE;
+    l_i2cEvent = NULL;
+    l_i2cSlaveOn = false;
+    l_i2cNacked = false;
+    l_i2cAckDue = false;
+  }
+  l_i2cCmd |= cmd & (I2C_CMD_START | I2C_CMD_STOP | I2C_CMD_ACK | I2C_CMD_NACK);
+}
+
+static void i2cWrite(uint32_t value) {
+  if (l_i2cTxFull) {
+    *(volatile uint32_t *)&I2C0->IF |= I2C_IF_TXOF;
+  } else {
+    l_i2cTx = (uint8_t)value;
+    l_i2cTxFull = true;
+    l_i2cTxc = false;
+  }
+  I2C0->TXDATA = SIM_MARK;
+}
+
+/* take TXDATA and the commands written by the software */
+static void i2cSync(void) {
+  uint32_t cmd = I2C0->CMD;
+
+  if (I2C0->TXDATA != SIM_MARK) {
+    i2cWrite(I2C0->TXDATA);
+  }
+  if (cmd != 0U) {
+    I2C0->CMD = 0U;
+    i2cCommand(cmd);
+  }
+  i2cStep();
+  i2cStatus();
+}
+
+uint32_t SIM_i2cCmd(uint32_t cmd) {
+  i2cSync();
+  i2cCommand(cmd);
+  i2cStep();
+  i2cStatus();
+  return 0U;
+}
+
+void SIM_i2cAttach(SIM_I2cSlave const *slave) {
+  l_i2cSlave = slave;
+}
+
+void SIM_i2cArbLost(void) {
+  l_i2cArbLose = true;
+}
+
+void SIM_i2cRelease(void) {
+  l_i2cOther = false;
+  SIM_sync();
+}
+
+/* take the commands and a written CNT */
+/* a HFCLKSEL command switches HFCLK at once, the oscillators are ready */
+static void cmuSync(void) {
+  uint32_t sel;
+
+  switch (CMU->CMD & _CMU_CMD_HFCLKSEL_MASK) {
+    case CMU_CMD_HFCLKSEL_HFRCO:
+      sel = CMU_STATUS_HFRCOSEL;
+      break;
+    case CMU_CMD_HFCLKSEL_HFXO:
+      sel = CMU_STATUS_HFXOSEL;
+      break;
+    case CMU_CMD_HFCLKSEL_LFRCO:
+      sel = CMU_STATUS_LFRCOSEL;
+      break;
+    case CMU_CMD_HFCLKSEL_LFXO:
+      sel = CMU_STATUS_LFXOSEL;
+      break;
+    default:
+      sel = 0U;
+      break;
+  }
+  if (sel != 0U) {
+    *(volatile uint32_t *)&CMU->STATUS =
+      (CMU->STATUS & ~(CMU_STATUS_HFRCOSEL | CMU_STATUS_HFXOSEL
+                       | CMU_STATUS_LFRCOSEL | CMU_STATUS_LFXOSEL)) | sel;
+  }
+  CMU->CMD = 0U;
+}
+
+void SIM_cmuSync(void) {
+  cmuSync();
+}
+
+static void timerSync(SIM_Timer *t) {
+  TIMER_TypeDef *timer = t->regs;
+  uint32_t cmd = timer->CMD;
+
+  if (timer->CNT != t->cnt) {
+    t->cnt = timer->CNT & _TIMER_CNT_MASK;
+  }
+  if (cmd != 0U) {
+    timer->CMD = 0U;
+    if ((cmd & TIMER_CMD_START) != 0U) {
+      t->running = true;
+    }
+    if ((cmd & TIMER_CMD_STOP) != 0U) {
+      t->running = false;
+    }
+  }
+  *(volatile uint32_t *)&timer->STATUS = t->running ? TIMER_STATUS_RUNNING : 0U;
+  timer->CNT = t->cnt;
+}
+
+/* the LEUART0 commands of the receiver and the transmitter enables. a
+* byte received waits in RXDATA with RXDATAV until the DMA takes it, a byte
+* written by the software leaves SIM_MARK in TXDATA */
+static void leuartCommand(uint32_t cmd) {
+  volatile uint32_t *status = (volatile uint32_t *)&LEUART0->STATUS;
+
+  if ((cmd & LEUART_CMD_RXEN) != 0U) {
+    *status |= LEUART_STATUS_RXENS;
+  }
+  if ((cmd & LEUART_CMD_RXDIS) != 0U) {
+    *status &= ~LEUART_STATUS_RXENS;
+  }
+  if ((cmd & LEUART_CMD_TXEN) != 0U) {
+    *status |= LEUART_STATUS_TXENS;
+  }
+  if ((cmd & LEUART_CMD_TXDIS) != 0U) {
+    *status &= ~LEUART_STATUS_TXENS;
+  }
+  if ((cmd & LEUART_CMD_CLEARRX) != 0U) {
+    *status &= ~LEUART_STATUS_RXDATAV;
+  }
+}
+
+static void leuartSync(void) {
+  uint32_t cmd = LEUART0->CMD;
+
+  if (cmd != 0U) {
+    LEUART0->CMD = 0U;
+    leuartCommand(cmd);
+  }
+  if (LEUART0->TXDATA != SIM_MARK) {
+    if (SIM_txLen < SIM_TX_SIZE) {
+      SIM_tx[SIM_txLen++] = (uint8_t)LEUART0->TXDATA;
+    }
+    LEUART0->TXDATA = SIM_MARK;
+  }
+}
+
+uint32_t SIM_leuartCmd(uint32_t cmd) {
+  leuartSync();
+  leuartCommand(cmd);
+  return 0U;
+}
+
+static DMA_DESCRIPTOR_TypeDef *dmaDescriptor(unsigned int ch, bool alt) {
+  uintptr_t base = alt ? DMA->ALTCTRLBASE : DMA->CTRLBASE;
+
+  return (DMA_DESCRIPTOR_TypeDef *)base + ch;
+}
+
+static bool dmaScatterGather(uint32_t ctrl) {
+  ctrl &= _DMA_CTRL_CYCLE_CTRL_MASK;
+  return ctrl == _DMA_CTRL_CYCLE_CTRL_MEM_SCATTER_GATHER
+         || ctrl == _DMA_CTRL_CYCLE_CTRL_PER_SCATTER_GATHER;
+}
+
+/* the task table of a scatter-gather cycle, where the primary descriptor
+* of a channel just enabled starts */
+static void dmaActivate(uint32_t chs) {
+  DMA_DESCRIPTOR_TypeDef *d;
+  uint32_t n;
+  unsigned int ch;
+
+  for (ch = 0U; ch < DMA_CHAN_COUNT; ch++) {
+    d = dmaDescriptor(ch, false);
+    if ((chs & (1UL << ch)) != 0U && dmaScatterGather(d->CTRL)) {
+      n = (d->CTRL & _DMA_CTRL_N_MINUS_1_MASK) >> _DMA_CTRL_N_MINUS_1_SHIFT;
+      l_dmaTable[ch] = (uintptr_t)d->SRCEND - (n << 2);
+    }
+  }
+}
+
+static void registerSync(void) {
+  GPIO_P_TypeDef *port;
+  uint32_t enabled;
+  unsigned int i;
+
+  FLAG_SYNC(DMA);
+  FLAG_SYNC(RTC);
+  FLAG_SYNC(TIMER0);
+  FLAG_SYNC(TIMER1);
+  FLAG_SYNC(LEUART0);
+  FLAG_SYNC(USART1);
+  FLAG_SYNC(I2C0);
+  FLAG_SYNC(PCNT0);
+  FLAG_SYNC(ADC0);
+  FLAG_SYNC(GPIO);
+
+  for (i = 0U; i < 6U; i++) {
+    port = &GPIO->P[i];
+    port->DOUT |= port->DOUTSET;
+    port->DOUT &= ~port->DOUTCLR;
+    port->DOUT ^= port->DOUTTGL;
+    port->DOUTSET = 0U;
+    port->DOUTCLR = 0U;
+    port->DOUTTGL = 0U;
+  }
+
+  /* a write to VAL clears it and COUNTFLAG */
+  if (SysTick->VAL != l_sysTickVal) {
+    SysTick->VAL = 0U;
+    SysTick->CTRL &= ~SysTick_CTRL_COUNTFLAG_Msk;
+    l_sysTickVal = 0U;
+  }
+
+  for (i = 0U; i < SIM_TIMERS; i++) {
+    timerSync(&l_timers[i]);
+  }
+  usartSync();
+  i2cSync();
+  cmuSync();
+  leuartSync();
+
+  /* a disabled counter is reset */
+  if ((RTC->CTRL & RTC_CTRL_EN) == 0U && (l_rtcCtrl & RTC_CTRL_EN) != 0U) {
+    *(volatile uint32_t *)&RTC->CNT = 0U;
+    l_rtcPresc = 0U;
+  }
+  l_rtcCtrl = RTC->CTRL;
+
+  enabled = l_dmaEnabled;
+  setClearSync(&l_dmaEnabled, &DMA->CHENS, &DMA->CHENC);
+  setClearSync(&l_dmaAlt, &DMA->CHALTS, &DMA->CHALTC);
+  setClearSync(&l_dmaReqMask, &DMA->CHREQMASKS, &DMA->CHREQMASKC);
+  setClearSync(&l_dmaBurst, &DMA->CHUSEBURSTS, &DMA->CHUSEBURSTC);
+  setClearSync(&l_dmaPrio, &DMA->CHPRIS, &DMA->CHPRIC);
+  *(volatile uint32_t *)&DMA->ALTCTRLBASE =
+    DMA->CTRLBASE + DMA_CHAN_COUNT * sizeof(DMA_DESCRIPTOR_TypeDef);
+  dmaActivate(l_dmaEnabled & ~enabled);
+}
+
+/* scatter-gather: the primary descriptor copies the next task of the table
+* into the alternate descriptor, its 4 words at once, and hands over to it.
+* the last task copied, the primary is done. a descriptor of the device is
+* 4 words, the word offset the primary is at is a task of the host's
+* larger descriptors */
+static void dmaGather(unsigned int ch) {
+  DMA_DESCRIPTOR_TypeDef *d = dmaDescriptor(ch, false);
+  uint32_t ctrl = d->CTRL;
+  uint32_t n = (ctrl & _DMA_CTRL_N_MINUS_1_MASK) >> _DMA_CTRL_N_MINUS_1_SHIFT;
+  uintptr_t task = ((uintptr_t)d->SRCEND - (n << 2) - l_dmaTable[ch]) / 16U;
+
+  memcpy(dmaDescriptor(ch, true),
+         (DMA_DESCRIPTOR_TypeDef *)l_dmaTable[ch] + task,
+         sizeof(DMA_DESCRIPTOR_TypeDef));
+  if (n < 4U) {
+    d->CTRL = ctrl & ~_DMA_CTRL_CYCLE_CTRL_MASK;
+  } else {
+    d->CTRL = (ctrl & ~_DMA_CTRL_N_MINUS_1_MASK)
+              | ((n - 4U) << _DMA_CTRL_N_MINUS_1_SHIFT);
+  }
+  setClearWrite(&l_dmaAlt, &DMA->CHALTS, &DMA->CHALTC, l_dmaAlt | (1UL << ch));
+}
+
+/* one element of the active descriptor of ch, returns true at the end of
+* the cycle */
+static bool dmaElement(unsigned int ch) {
+  bool alt = (l_dmaAlt & (1UL << ch)) != 0U;
+  DMA_DESCRIPTOR_TypeDef *d;
+  uint32_t ctrl;
+  uint32_t cycle;
+  uint32_t n;
+  uint32_t size;
+  uint32_t srcInc;
+  uint32_t dstInc;
+  uint8_t *src;
+  uint8_t *dst;
+  uint32_t value = 0U;
+
+  if (!alt && dmaScatterGather(dmaDescriptor(ch, false)->CTRL)) {
+    dmaGather(ch);
+    alt = true;
+  }
+  d = dmaDescriptor(ch, alt);
+  ctrl = d->CTRL;
+  cycle = ctrl & _DMA_CTRL_CYCLE_CTRL_MASK;
+  n = (ctrl & _DMA_CTRL_N_MINUS_1_MASK) >> _DMA_CTRL_N_MINUS_1_SHIFT;
+  size = 1UL << ((ctrl & _DMA_CTRL_SRC_SIZE_MASK) >> _DMA_CTRL_SRC_SIZE_SHIFT);
+  srcInc = (ctrl & _DMA_CTRL_SRC_INC_MASK) >> _DMA_CTRL_SRC_INC_SHIFT;
+  dstInc = (ctrl & _DMA_CTRL_DST_INC_MASK) >> _DMA_CTRL_DST_INC_SHIFT;
+  src = (uint8_t *)d->SRCEND - (srcInc == 3U ? 0U : n << srcInc);
+  dst = (uint8_t *)d->DSTEND - (dstInc == 3U ? 0U : n << dstInc);
+
+  memcpy(&value, src, size);
+  memcpy(dst, &value, size);
+  if (dst == (uint8_t *)&LEUART0->TXDATA) {
+    if (SIM_txLen < SIM_TX_SIZE) {
+      SIM_tx[SIM_txLen++] = (uint8_t)value;
+    }
+    LEUART0->TXDATA = SIM_MARK;
+  }
+  if (dst == (uint8_t *)&USART1->TXDATA || dst == (uint8_t *)&USART1->TXDOUBLE) {
+    usartWrite((volatile uint32_t *)dst, value);
+  }
+  if (dst == (uint8_t *)&I2C0->TXDATA) {
+    i2cWrite(value);
+  }
+
+  if (n != 0U) {
+    d->CTRL = (ctrl & ~_DMA_CTRL_N_MINUS_1_MASK)
+              | ((n - 1U) << _DMA_CTRL_N_MINUS_1_SHIFT);
+    return false;
+  }
+
+  /* cycle done: a scatter-gather task goes back to the primary for the
+  * next one, ping-pong continues on the other descriptor if it is valid, a
+  * basic cycle disables the channel */
+  d->CTRL = ctrl & ~_DMA_CTRL_CYCLE_CTRL_MASK;
+  if (cycle == _DMA_CTRL_CYCLE_CTRL_MEM_SCATTER_GATHER_ALT
+      || cycle == _DMA_CTRL_CYCLE_CTRL_PER_SCATTER_GATHER_ALT) {
+    setClearWrite(&l_dmaAlt, &DMA->CHALTS, &DMA->CHALTC,
+                  l_dmaAlt & ~(1UL << ch));
+    return false;
+  }
+  *(volatile uint32_t *)&DMA->IF |= 1UL << ch;
+  if (cycle == _DMA_CTRL_CYCLE_CTRL_PINGPONG
+      && (dmaDescriptor(ch, !alt)->CTRL & _DMA_CTRL_CYCLE_CTRL_MASK)
+         != _DMA_CTRL_CYCLE_CTRL_INVALID) {
+    setClearWrite(&l_dmaAlt, &DMA->CHALTS, &DMA->CHALTC,
+                  l_dmaAlt ^ (1UL << ch));
+  } else {
+    setClearWrite(&l_dmaEnabled, &DMA->CHENS, &DMA->CHENC,
+                  l_dmaEnabled & ~(1UL << ch));
+  }
+  return true;
+}
+
+static bool dmaReady(unsigned int ch) {
+  return (DMA->CONFIG & DMA_CONFIG_EN) != 0U
+         && (l_dmaEnabled & (1UL << ch)) != 0U;
+}
+
+/* serve one peripheral request, returns false if no channel takes it */
+static bool dmaRequest(uint32_t select) {
+  unsigned int ch;
+
+  for (ch = 0U; ch < DMA_CHAN_COUNT; ch++) {
+    if (dmaReady(ch) && (l_dmaReqMask & (1UL << ch)) == 0U
+        && (DMA->CH[ch].CTRL & (_DMA_CH_CTRL_SOURCESEL_MASK | _DMA_CH_CTRL_SIGSEL_MASK))
+           == select) {
+      (void)dmaElement(ch);
+      return true;
+    }
+  }
+  return false;
+}
+
+/* software requests run the whole cycle */
+static void dmaSoftware(void) {
+  uint32_t req = DMA->CHSWREQ;
+  unsigned int ch;
+
+  if (req == 0U) {
+    return;
+  }
+  DMA->CHSWREQ = 0U;
+  for (ch = 0U; ch < DMA_CHAN_COUNT; ch++) {
+    if ((req & (1UL << ch)) != 0U) {
+      while (dmaReady(ch) && !dmaElement(ch)) {
+      }
+    }
+  }
+}
+
+static void rtcTick(void) {
+  uint32_t div = 1UL << ((CMU->LFAPRESC0 & _CMU_LFAPRESC0_RTC_MASK)
+                         >> _CMU_LFAPRESC0_RTC_SHIFT);
+  uint32_t top;
+  uint32_t cnt;
+
+  if ((RTC->CTRL & RTC_CTRL_EN) == 0U) {
+    return;
+  }
+  if (++l_rtcPresc < div) {
+    return;
+  }
+  l_rtcPresc = 0U;
+
+  top = (RTC->CTRL & RTC_CTRL_COMP0TOP) != 0U ? RTC->COMP0 : _RTC_CNT_MASK;
+  cnt = RTC->CNT;
+  if (cnt == top) {
+    cnt = 0U;
+    if ((RTC->CTRL & RTC_CTRL_COMP0TOP) == 0U) {
+      *(volatile uint32_t *)&RTC->IF |= RTC_IF_OF;
+    }
+  } else {
+    cnt++;
+  }
+  *(volatile uint32_t *)&RTC->CNT = cnt;
+  if (cnt == RTC->COMP0) {
+    *(volatile uint32_t *)&RTC->IF |= RTC_IF_COMP0;
+  }
+  if (cnt == RTC->COMP1) {
+    *(volatile uint32_t *)&RTC->IF |= RTC_IF_COMP1;
+  }
+}
+
+/* one frame 8N1 takes 10 bit times, CLKDIV is 256 * (LFBCLK / baud - 1) */
+static void leuartTick(void) {
+  uint32_t frame = 10U * (256U + (LEUART0->CLKDIV & _LEUART_CLKDIV_DIV_MASK));
+
+  l_leuartCredit += 256U;
+  while (l_leuartCredit >= frame) {
+    if (!dmaRequest(DMA_CH_CTRL_SOURCESEL_LEUART0 | DMA_CH_CTRL_SIGSEL_LEUART0TXBL)) {
+      l_leuartCredit = frame; /* idle, the next byte starts at once */
+      break;
+    }
+    l_leuartCredit -= frame;
+  }
+}
+
+/* DMA requests of USART1: RXDATAV, TXBL, and TXEMPTY with the buffer and
+* the shift register empty */
+static void usartKick(void) {
+  bool empty;
+
+  while (l_usartRxLen != 0U
+         && dmaRequest(DMA_CH_CTRL_SOURCESEL_USART1 | DMA_CH_CTRL_SIGSEL_USART1RXDATAV)) {
+    l_usartRx[0] = l_usartRx[1];
+    l_usartRxLen--;
+    usartStatus();
+  }
+  do {
+    empty = !l_usartShifting && l_usartBufLen == 0U;
+  } while ((usartTxbl()
+            && dmaRequest(DMA_CH_CTRL_SOURCESEL_USART1 | DMA_CH_CTRL_SIGSEL_USART1TXBL))
+           || (empty
+               && dmaRequest(DMA_CH_CTRL_SOURCESEL_USART1 | DMA_CH_CTRL_SIGSEL_USART1TXEMPTY)));
+}
+
+/* the frame of the slave shifted in with the last bit sent, RXOF if the
+* receive buffer is full */
+static void usartReceive(uint16_t sent) {
+  uint16_t frame = SIM_usartSlave != NULL ? SIM_usartSlave(sent) : 0xFFFFU;
+
+  if (!l_usartRxEn) {
+    return;
+  }
+  if (l_usartRxLen == SIM_USART_BUF) {
+    *(volatile uint32_t *)&USART1->IF |= USART_IF_RXOF;
+    return;
+  }
+  l_usartRx[l_usartRxLen++] = frame & (uint16_t)((1UL << usartBits()) - 1U);
+  *(volatile uint32_t *)&USART1->IF |= USART_IF_RXDATAV;
+}
+
+/* shift out, the frame is captured into SIM_usartTx when its last bit is
+* sent. AUTOCS raises CS after it if no frame follows */
+static void usartRun(uint32_t cycles) {
+  SIM_UsartFrame *f;
+
+  if (!l_usartShifting) {
+    return;
+  }
+  l_usartLeft -= cycles;
+  if (l_usartLeft != 0U) {
+    return;
+  }
+  l_usartShifting = false;
+  if (SIM_usartTxLen < SIM_USART_TX_SIZE) {
+    f = &SIM_usartTx[SIM_usartTxLen++];
+    f->frame = l_usartShift;
+    f->csEnd = l_usartBufLen == 0U || !l_usartTxEn;
+    f->start = l_usartStart;
+    f->end = l_cycles;
+  }
+  usartReceive(l_usartShift);
+  /* TXC with nothing left to send */
+  if (l_usartBufLen == 0U) {
+    l_usartTxc = true;
+    *(volatile uint32_t *)&USART1->IF |= USART_IF_TXC;
+  }
+  usartStart();
+  usartStatus();
+}
+
+/* DMA requests of I2C0 on TXBL, a byte written starts as soon as the bus
+* is held for it */
+static void i2cKick(void) {
+  while (!l_i2cTxFull
+         && dmaRequest(DMA_CH_CTRL_SOURCESEL_I2C0 | DMA_CH_CTRL_SIGSEL_I2C0TXBL)) {
+    i2cStep();
+    i2cStatus();
+  }
+}
+
+static void i2cRun(uint32_t cycles) {
+  if (l_i2cPhase == I2C_IDLE || l_i2cPhase == I2C_HOLD) {
+    return;
+  }
+  l_i2cLeft -= cycles;
+  if (l_i2cLeft == 0U) {
+    i2cPhaseEnd();
+    i2cStatus();
+  }
+}
+
+static uint32_t sysTickDiv(void) {
+  return 1UL << (CMU->HFCORECLKDIV & _CMU_HFCORECLKDIV_HFCORECLKDIV_MASK);
+}
+
+/* HFCLK cycles to the next count to zero. a clock edge at zero reloads,
+* the edge to zero sets COUNTFLAG */
+static uint64_t sysTickNext(void) {
+  uint32_t load = SysTick->LOAD & SysTick_LOAD_RELOAD_Msk;
+  uint64_t edges = l_sysTickVal != 0U ? l_sysTickVal : load + 1ULL;
+
+  if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0U
+      || (l_sysTickVal == 0U && load == 0U)) {
+    return UINT64_MAX;
+  }
+  return edges * sysTickDiv() - l_sysTickPhase;
+}
+
+/* SysTick counts HFCORECLK, the CLKSOURCE bit is ignored */
+static void sysTickRun(uint32_t cycles) {
+  uint32_t load = SysTick->LOAD & SysTick_LOAD_RELOAD_Msk;
+  uint32_t div = sysTickDiv();
+  uint32_t edges;
+  uint32_t n;
+
+  if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0U) {
+    return;
+  }
+  edges = (uint32_t)(((uint64_t)l_sysTickPhase + cycles) / div);
+  l_sysTickPhase = (uint32_t)(((uint64_t)l_sysTickPhase + cycles) % div);
+  while (edges != 0U) {
+    if (l_sysTickVal == 0U) {
+      if (load == 0U) {
+        break;
+      }
+      l_sysTickVal = load;
+      edges--;
+      continue;
+    }
+    n = edges < l_sysTickVal ? edges : l_sysTickVal;
+    l_sysTickVal -= n;
+    edges -= n;
+    if (l_sysTickVal == 0U) {
+      SysTick->CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+      if ((SysTick->CTRL & SysTick_CTRL_TICKINT_Msk) != 0U) {
+        l_sysTickPending = true;
+      }
+    }
+  }
+  SysTick->VAL = l_sysTickVal;
+}
+
+/* HFCLK cycles of a counter tick: HFPERCLK and the prescaler */
+static uint32_t timerDiv(SIM_Timer const *t) {
+  return (1UL << (CMU->HFPERCLKDIV & _CMU_HFPERCLKDIV_HFPERCLKDIV_MASK))
+         << ((t->regs->CTRL & _TIMER_CTRL_PRESC_MASK) >> _TIMER_CTRL_PRESC_SHIFT);
+}
+
+static bool timerCompares(TIMER_TypeDef const *timer, unsigned int ch) {
+  uint32_t mode = timer->CC[ch].CTRL & _TIMER_CC_CTRL_MODE_MASK;
+
+  return mode == TIMER_CC_CTRL_MODE_OUTPUTCOMPARE
+         || mode == TIMER_CC_CTRL_MODE_PWM;
+}
+
+/* HFCLK cycles to the next overflow or compare match. the counter counts
+* up to TOP and wraps to 0 */
+static uint64_t timerNext(SIM_Timer const *t) {
+  TIMER_TypeDef *timer = t->regs;
+  uint32_t top = timer->TOP & _TIMER_TOP_MASK;
+  uint32_t next = top - t->cnt + 1U;
+  uint32_t ccv;
+  uint32_t d;
+  unsigned int ch;
+
+  if (!t->running) {
+    return UINT64_MAX;
+  }
+  for (ch = 0U; ch < SIM_TIMER_CH; ch++) {
+    ccv = timer->CC[ch].CCV & _TIMER_CC_CCV_MASK;
+    if (!timerCompares(timer, ch) || ccv > top) {
+      continue;
+    }
+    d = ccv > t->cnt ? ccv - t->cnt : top - t->cnt + 1U + ccv;
+    if (d < next) {
+      next = d;
+    }
+  }
+  return (uint64_t)next * timerDiv(t) - t->phase;
+}
+
+/* count, the compare flags of the values passed and the overflow flag */
+static void timerRun(SIM_Timer *t, uint32_t cycles) {
+  TIMER_TypeDef *timer = t->regs;
+  uint32_t top = timer->TOP & _TIMER_TOP_MASK;
+  uint32_t div = timerDiv(t);
+  uint64_t ticks;
+  uint32_t wrap;
+  uint32_t n;
+  uint32_t ccv;
+  unsigned int ch;
+
+  if (!t->running) {
+    return;
+  }
+  ticks = ((uint64_t)t->phase + cycles) / div;
+  t->phase = (uint32_t)(((uint64_t)t->phase + cycles) % div);
+  while (ticks != 0U) {
+    wrap = top - t->cnt + 1U;
+    n = ticks < wrap ? (uint32_t)ticks : wrap;
+    for (ch = 0U; ch < SIM_TIMER_CH; ch++) {
+      ccv = timer->CC[ch].CCV & _TIMER_CC_CCV_MASK;
+      if (timerCompares(timer, ch) && ccv <= top
+          && ((ccv > t->cnt && ccv <= t->cnt + n) || (n == wrap && ccv == 0U))) {
+        *(volatile uint32_t *)&timer->IF |= TIMER_IF_CC0 << ch;
+      }
+    }
+    if (n == wrap) {
+      t->cnt = 0U;
+      *(volatile uint32_t *)&timer->IF |= TIMER_IF_OF;
+    } else {
+      t->cnt += n;
+    }
+    ticks -= n;
+  }
+  timer->CNT = t->cnt;
+}
+
+/* pend the interrupts of the asserted lines */
+static void lineSync(void) {
+  uint32_t gpio = GPIO->IF & GPIO->IEN;
+  uint32_t asserted = 0U;
+  size_t i;
+
+  for (i = 0U; i < sizeof(l_lines) / sizeof(l_lines[0]); i++) {
+    if ((*l_lines[i].ifReg & *l_lines[i].ien) != 0U) {
+      asserted |= 1UL << l_lines[i].irq;
+    }
+  }
+  if ((gpio & 0x5555U) != 0U) {
+    asserted |= 1UL << GPIO_EVEN_IRQn;
+  }
+  if ((gpio & 0xAAAAU) != 0U) {
+    asserted |= 1UL << GPIO_ODD_IRQn;
+  }
+  /* the line of the running handler pends again only if it is still
+  * asserted at the return */
+  if (l_active >= 16) {
+    asserted &= ~(1UL << (l_active - 16));
+  }
+  l_nvicPending |= asserted;
+}
+
+static int nextIrq(void) {
+  uint32_t ready = l_nvicPending & l_nvicEnabled;
+
+  return ready != 0U ? __builtin_ctz(ready) : -1;
+}
+
+/* the exception to take: SysTick before the interrupts, 0 for none */
+static int nextException(void) {
+  int irq;
+
+  if (l_sysTickPending) {
+    return SysTick_IRQn + 16;
+  }
+  irq = nextIrq();
+  return irq >= 0 ? irq + 16 : 0;
+}
+
+void SIM_sync(void) {
+  int exc;
+
+  nvicSync();
+  registerSync();
+  dmaSoftware();
+  usartKick();
+  i2cKick();
+  lineSync();
+  /* handlers run to completion, there is no preemption */
+  while (l_active == 0 && SIM_primask == 0U && (exc = nextException()) != 0) {
+    l_active = exc;
+    l_taken++;
+    SCB->ICSR = (uint32_t)exc;
+    if (exc == SysTick_IRQn + 16) {
+      l_sysTickPending = false;
+      SysTick_Handler();
+    } else {
+      l_nvicPending &= ~(1UL << (exc - 16));
+      nvicWrite();
+      SIM_irqCount[exc - 16]++;
+      if ((size_t)(exc - 16) < SIM_IRQS) {
+        l_vectors[exc - 16]();
+      } else {
+        unexpectedIrq();
+      }
+    }
+    SCB->ICSR = 0U;
+    l_active = 0;
+    nvicSync();
+    registerSync();
+    dmaSoftware();
+    usartKick();
+    i2cKick();
+    lineSync();
+  }
+  nvicWrite();
+}
+
+void SIM_irqEnable(int irq, int enable) {
+  nvicSync();
+  if (enable) {
+    l_nvicEnabled |= 1UL << irq;
+  } else {
+    l_nvicEnabled &= ~(1UL << irq);
+  }
+  nvicWrite();
+  SIM_sync();
+}
+
+void SIM_irqPend(int irq, int pend) {
+  nvicSync();
+  if (pend) {
+    l_nvicPending |= 1UL << irq;
+  } else {
+    l_nvicPending &= ~(1UL << irq);
+  }
+  nvicWrite();
+  SIM_sync();
+}
+
+int SIM_sysTickWrapped(void) {
+  int wrapped = (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0U;
+
+  SysTick->CTRL &= ~SysTick_CTRL_COUNTFLAG_Msk;
+  return wrapped;
+}
+
+int SIM_irqPending(int irq) {
+  nvicSync();
+  return (l_nvicPending >> irq) & 1U;
+}
+
+/* the length of the coming LFCLK tick in HFCLK cycles */
+static void hfTickStart(void) {
+  uint32_t hf = SystemHFClockGet();
+
+  l_hfFrac += hf % SIM_LFCLK_HZ;
+  l_hfTick = hf / SIM_LFCLK_HZ + l_hfFrac / SIM_LFCLK_HZ;
+  l_hfFrac %= SIM_LFCLK_HZ;
+  l_hfPos = 0U;
+}
+
+static void lfTick(void) {
+  l_now++;
+  rtcTick();
+  leuartTick();
+  hfTickStart();
+}
+
+/* let at most cycles of HFCLK pass, up to the next state change of a model
+* clocked by it or the next LFCLK tick. returns the cycles passed */
+static uint32_t hfRun(uint32_t cycles) {
+  uint64_t next;
+  uint64_t t;
+  size_t i;
+  uint32_t d = l_hfTick - l_hfPos;
+
+  SIM_sync();
+  next = sysTickNext();
+  for (i = 0U; i < SIM_TIMERS; i++) {
+    t = timerNext(&l_timers[i]);
+    if (t < next) {
+      next = t;
+    }
+  }
+  if (l_usartShifting && l_usartLeft < next) {
+    next = l_usartLeft;
+  }
+  if (l_i2cPhase != I2C_IDLE && l_i2cPhase != I2C_HOLD && l_i2cLeft < next) {
+    next = l_i2cLeft;
+  }
+  if (cycles < d) {
+    d = cycles;
+  }
+  if (next < d) {
+    d = (uint32_t)next;
+  }
+  l_hfPos += d;
+  l_cycles += d;
+  sysTickRun(d);
+  for (i = 0U; i < SIM_TIMERS; i++) {
+    timerRun(&l_timers[i], d);
+  }
+  usartRun(d);
+  i2cRun(d);
+  if (l_hfPos == l_hfTick) {
+    lfTick();
+  }
+  SIM_sync();
+  return d;
+}
+
+/* a pending interrupt wakes the core also when PRIMASK masks it, an
+* unmasked one is taken and WFI returns after it. the HF clocks stop in EM2
+* and EM3 (SLEEPDEEP), the core sleeps to the next LFCLK tick at once and
+* wakes up on HFRCO */
+void SIM_wfi(void) {
+  uint64_t start = l_now;
+  uint32_t taken;
+
+  SIM_sync();
+  taken = l_taken;
+  for (;;) {
+    SIM_sync();
+    if (nextException() != 0 || l_taken != taken) {
+      return;
+    }
+    if (l_running && l_now >= l_deadline) {
+      longjmp(SIM_stop, 1);
+    }
+    if (l_now - start > SIM_SLEEP_LIMIT) {
+      fprintf(stderr, "sim: sleeping without a wakeup source\n");
+      abort();
+    }
+    if ((SCB->SCR & SCB_SCR_SLEEPDEEP_Msk) != 0U) {
+      CMU->CMD = CMU_CMD_HFCLKSEL_HFRCO;
+      cmuSync();
+      lfTick();
+      SIM_sync();
+    } else {
+      (void)hfRun(UINT32_MAX);
+    }
+  }
+}
+
+void SIM_advance(uint32_t ticks) {
+  uint64_t end = l_now + ticks;
+
+  while (l_now < end) {
+    (void)hfRun(UINT32_MAX);
+  }
+}
+
+void SIM_cycles(uint32_t cycles) {
+  while (cycles != 0U) {
+    cycles -= hfRun(cycles);
+  }
+}
+
+uint64_t SIM_cycleNow(void) {
+  return l_cycles;
+}
+
+uint64_t SIM_now(void) {
+  return l_now;
+}
+
+void SIM_runStart(uint32_t ticks) {
+  l_deadline = l_now + ticks;
+  l_running = true;
+  l_runPrimask = SIM_primask;
+}
+
+void SIM_runEnd(void) {
+  l_running = false;
+  l_active = 0;
+  SCB->ICSR = 0U;
+  SIM_primask = l_runPrimask;
+}
+
+void SIM_gpioSet(GPIO_Port_TypeDef port, unsigned int pin, bool level) {
+  uint32_t bit = 1UL << pin;
+  uint32_t din = GPIO->P[port].DIN;
+  uint32_t sel = pin < 8U ? GPIO->EXTIPSELL >> (4U * pin)
+                          : GPIO->EXTIPSELH >> (4U * (pin - 8U));
+  bool old = (din & bit) != 0U;
+
+  *(volatile uint32_t *)&GPIO->P[port].DIN = level ? din | bit : din & ~bit;
+  if (old != level && (sel & 0xFU) == (uint32_t)port) {
+    if ((level && (GPIO->EXTIRISE & bit) != 0U)
+        || (!level && (GPIO->EXTIFALL & bit) != 0U)) {
+      *(volatile uint32_t *)&GPIO->IF |= bit;
+    }
+  }
+  SIM_sync();
+}
+
+void SIM_adcScan(uint16_t const *results, unsigned int count) {
+  unsigned int i;
+
+  SIM_sync();
+  for (i = 0U; i < count; i++) {
+    *(volatile uint32_t *)&ADC0->SCANDATA = results[i];
+    *(volatile uint32_t *)&ADC0->STATUS |= ADC_STATUS_SCANDV;
+    if (dmaRequest(DMA_CH_CTRL_SOURCESEL_ADC0 | DMA_CH_CTRL_SIGSEL_ADC0SCAN)) {
+      *(volatile uint32_t *)&ADC0->STATUS &= ~ADC_STATUS_SCANDV;
+    }
+  }
+  *(volatile uint32_t *)&ADC0->IF |= ADC_IF_SCAN;
+  SIM_sync();
+}
+
+void SIM_leuartRx(uint8_t const *data, unsigned int count) {
+  volatile uint32_t *status = (volatile uint32_t *)&LEUART0->STATUS;
+  unsigned int i;
+
+  for (i = 0U; i < count; i++) {
+    SIM_sync();
+    if ((*status & LEUART_STATUS_RXENS) == 0U) {
+      continue;
+    }
+    if ((*status & LEUART_STATUS_RXDATAV) != 0U) {
+      *(volatile uint32_t *)&LEUART0->IF |= LEUART_IF_RXOF;
+      continue;
+    }
+    *(volatile uint32_t *)&LEUART0->RXDATA = data[i];
+    *status |= LEUART_STATUS_RXDATAV;
+    if (dmaRequest(DMA_CH_CTRL_SOURCESEL_LEUART0 | DMA_CH_CTRL_SIGSEL_LEUART0RXDATAV)) {
+      *status &= ~LEUART_STATUS_RXDATAV;
+    }
+  }
+  SIM_sync();
+}
+
+void SIM_probe(void) {
+  static bool busy;
+
+  if (SIM_probeHook != NULL && !busy) {
+    busy = true;
+    SIM_probeHook();
+    busy = false;
+  }
+}
+
+void NVIC_SystemReset(void) {
+  fprintf(stderr, "sim: system reset\n");
+  abort();
+}
+
+void SIM_init(void) {
+  size_t i;
+
+  mapRegions();
+  for (i = 0U; i < sizeof(l_regions) / sizeof(l_regions[0]); i++) {
+    memset((void *)l_regions[i].base, 0, l_regions[i].size);
+  }
+  LEUART0->TXDATA = SIM_MARK;
+  memset(&SIM_nvic, 0, sizeof(SIM_nvic));
+  memset(&SIM_scb, 0, sizeof(SIM_scb));
+  memset(&SIM_sysTick, 0, sizeof(SIM_sysTick));
+  memset(SIM_irqCount, 0, sizeof(SIM_irqCount));
+  SIM_primask = 0U;
+  SIM_txLen = 0U;
+  SIM_usartTxLen = 0U;
+  SIM_i2cLogLen = 0U;
+  SIM_probeHook = NULL;
+  l_now = 0U;
+  l_cycles = 0U;
+  l_hfFrac = 0U;
+  l_running = false;
+  l_active = 0;
+  l_nvicEnabled = 0U;
+  l_nvicPending = 0U;
+  l_rtcPresc = 0U;
+  l_rtcCtrl = 0U;
+  l_leuartCredit = 0U;
+  l_usartTxEn = false;
+  l_usartRxEn = false;
+  l_usartRxLen = 0U;
+  SIM_usartSlave = NULL;
+  l_usartTxc = false;
+  l_usartBufLen = 0U;
+  l_usartShifting = false;
+  l_i2cPhase = I2C_IDLE;
+  l_i2cCmd = 0U;
+  l_i2cNacked = false;
+  l_i2cTxFull = false;
+  l_i2cRxValid = false;
+  l_i2cTxc = false;
+  l_i2cSlaveOn = false;
+  l_i2cAckDue = false;
+  l_i2cArbLose = false;
+  l_i2cOther = false;
+  l_i2cEvent = NULL;
+  l_i2cSlave = NULL;
+  l_sysTickVal = 0U;
+  l_sysTickPhase = 0U;
+  l_sysTickPending = false;
+  for (i = 0U; i < SIM_TIMERS; i++) {
+    l_timers[i].cnt = 0U;
+    l_timers[i].phase = 0U;
+    l_timers[i].running = false;
+    l_timers[i].regs->TOP = _TIMER_TOP_RESETVALUE;
+  }
+  l_dmaEnabled = 0U;
+  l_dmaAlt = 0U;
+  l_dmaReqMask = 0U;
+  l_dmaBurst = 0U;
+  l_dmaPrio = 0U;
+  memset(l_dmaTable, 0, sizeof(l_dmaTable));
+  nvicWrite();
+
+  /* every oscillator is running and ready, the core runs from HFRCO */
+  CMU->CTRL = _CMU_CTRL_RESETVALUE;
+  CMU->HFRCOCTRL = _CMU_HFRCOCTRL_RESETVALUE;
+  *(volatile uint32_t *)&CMU->STATUS =
+    CMU_STATUS_HFRCOENS | CMU_STATUS_HFRCORDY | CMU_STATUS_HFXOENS
+    | CMU_STATUS_HFXORDY | CMU_STATUS_AUXHFRCOENS | CMU_STATUS_AUXHFRCORDY
+    | CMU_STATUS_LFRCOENS | CMU_STATUS_LFRCORDY | CMU_STATUS_LFXOENS
+    | CMU_STATUS_LFXORDY | CMU_STATUS_HFRCOSEL;
+  /* behind the CMU functions, whose frequencies are cached */
+  CMU_ClockFreqInvalidate();
+  *(volatile uint32_t *)&LEUART0->STATUS = LEUART_STATUS_TXBL | LEUART_STATUS_TXC;
+  USART1->FRAME = _USART_FRAME_RESETVALUE;
+  USART1->TXDATA = SIM_MARK;
+  USART1->TXDOUBLE = SIM_MARK;
+  I2C0->TXDATA = SIM_MARK;
+  hfTickStart();
+  SIM_sync();
+}
@@ -0,0 +1,167 @@
+#ifndef __EFM32SIM_H__
+#define __EFM32SIM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <setjmp.h>
+#include "em_gpio.h"
+
+/* host simulation of the EFM32ZG222F32
+* the peripheral address ranges of the device header are mapped into the
+* process, so emlib, emdrv and the application compile unmodified and
+* access their registers at the usual addresses. behavioural models
+* driven by simulated time give the registers their function:
+*   core   PRIMASK, NVIC enable and pending, dispatch in IRQ number order
+*          after SysTick. SysTick counts HFCORECLK
+*   CMU    oscillators ready at once, HFCLKSEL commands, HFCLK back on
+*          HFRCO after EM2 and EM3
+*   RTC    prescaled counter, compare and overflow flags
+*   TIMER  HFPERCLK prescaled up counter to TOP, START/STOP commands,
+*          compare and overflow flags
+*   GPIO   DOUTSET/CLR/TGL, input levels set by SIM_gpioSet(), EXTI flags
+*   DMA    basic, ping-pong and scatter-gather cycles, software and
+*          peripheral requests
+*   LEUART TXDATA written by the DMA paced at the baud rate or by the
+*          software at the next sync point into SIM_tx,
+*          bytes received from SIM_leuartRx() taken by the RXDATAV DMA
+*          request, receiver and transmitter enable commands
+*   USART1 synchronous master, TXDATA/TXDOUBLE written by the
+*          software or on the TXBL and TXEMPTY DMA requests, frames sent at
+*          the bit rate of CLKDIV into SIM_usartTx. the frames of
+*          SIM_usartSlave received, taken by the RXDATAV DMA request
+*   I2C0   single master at the SCL rate of CLKDIV and CLHR, START, STOP,
+*          ACK and NACK commands, TXDATA written by the software or on the
+*          TXBL DMA request, one slave and lost arbitration from the test,
+*          the bus into SIM_i2cLog
+*   ADC0   scan results from SIM_adcScan()
+* interrupt flags are kept in IF, writes to IFS and IFC take effect at the
+* next sync point: unmasking, enabling or pending an interrupt, WFI and
+* every step of simulated time. registers have no other side effects, a
+* counter enable and disable without a sync point in between is not seen.
+* time is counted in LFCLK ticks and in HFCLK cycles within them, from the
+* HFCLK frequency at the start of each tick. it only advances in WFI (the
+* core sleeps until an interrupt is pending, in EM2 and EM3 the HF clocks
+* stop) and in SIM_advance() and SIM_cycles() */
+
+#define SIM_LFCLK_HZ 32768U
+#define SIM_TX_SIZE  4096U
+
+/* reset all registers and time, map the peripherals on first use */
+void SIM_init(void);
+
+uint64_t SIM_now(void);
+
+/* let time pass with the core running, interrupts are dispatched as they
+* fire */
+void SIM_advance(uint32_t ticks);
+
+/* the same in HFCLK cycles, e.g. the run time of code under test */
+void SIM_cycles(uint32_t cycles);
+
+/* HFCLK cycles passed since SIM_init() */
+uint64_t SIM_cycleNow(void);
+
+/* run a call that sleeps in WFI until ticks have passed, e.g. a scheduler
+* loop that never returns. the call is left with longjmp */
+#define SIM_RUN(ticks, call) do { \
+    SIM_runStart(ticks); \
+    if (setjmp(SIM_stop) == 0) { \
+      call; \
+    } \
+    SIM_runEnd(); \
+  } while (0)
+
+extern jmp_buf SIM_stop;
+void SIM_runStart(uint32_t ticks);
+void SIM_runEnd(void);
+
+/* drive an input pin, raises the external interrupt flag of its edge */
+void SIM_gpioSet(GPIO_Port_TypeDef port, unsigned int pin, bool level);
+
+/* complete one ADC0 scan with the results for the enabled inputs */
+void SIM_adcScan(uint16_t const *results, unsigned int count);
+
+/* bytes received by LEUART0 with the receiver enabled, a sync point before
+* each. RXOF if the byte before was not taken */
+void SIM_leuartRx(uint8_t const *data, unsigned int count);
+
+/* bytes sent by LEUART0 since SIM_init() */
+extern uint8_t SIM_tx[SIM_TX_SIZE];
+extern uint32_t SIM_txLen;
+
+/* frames sent by USART1 since SIM_init(), in HFCLK cycles. with AUTOCS
+* CS rises after a frame with csEnd, no frame followed it at once */
+typedef struct {
+    uint16_t frame;
+    bool csEnd;
+    uint64_t start;
+    uint64_t end;
+} SIM_UsartFrame;
+
+#define SIM_USART_TX_SIZE 256U
+extern SIM_UsartFrame SIM_usartTx[SIM_USART_TX_SIZE];
+extern uint32_t SIM_usartTxLen;
+
+/* the slave on USART1: the frame it shifts out while frame is shifted in,
+* called at the end of each frame. NULL, reset by SIM_init(), sends all
+* ones */
+extern uint16_t (*SIM_usartSlave)(uint16_t frame);
+
+/* the I2C0 bus since SIM_init(), in HFCLK cycles. a byte takes 9 SCL
+* periods with its ACK bit, START and STOP one each */
+typedef enum {
+  SIM_I2C_START,
+  SIM_I2C_STOP,
+  SIM_I2C_TX,
+  SIM_I2C_RX
+} SIM_I2cKind;
+
+typedef struct {
+    SIM_I2cKind kind;
+    uint8_t byte;
+    bool addr;    /* the address after a START */
+    bool ack;
+    uint64_t start;
+    uint64_t end;
+} SIM_I2cEvent;
+
+#define SIM_I2C_LOG_SIZE 512U
+extern SIM_I2cEvent SIM_i2cLog[SIM_I2C_LOG_SIZE];
+extern uint32_t SIM_i2cLogLen;
+
+/* a slave on the bus, addr in bits 7:1. write returns the ACK bit of a
+* byte, read gives the next byte, NULL hooks ACK and read 0xFF */
+typedef struct {
+    uint8_t addr;
+    void (*start)(bool read);
+    bool (*write)(uint8_t byte);
+    uint8_t (*read)(void);
+    void (*stop)(void);
+} SIM_I2cSlave;
+
+void SIM_i2cAttach(SIM_I2cSlave const *slave);
+
+/* another master wins the arbitration of the next byte out and keeps the
+* bus busy until SIM_i2cRelease() */
+void SIM_i2cArbLost(void);
+void SIM_i2cRelease(void);
+
+/* a CMD write taking effect at once, see i2cdrv_probe.h */
+uint32_t SIM_i2cCmd(uint32_t cmd);
+
+/* a LEUART0 CMD write taking effect at once, see uartdrv_probe.h */
+uint32_t SIM_leuartCmd(uint32_t cmd);
+
+/* the HFCLKSEL command written taking effect at once, see cmu_probe.h */
+void SIM_cmuSync(void);
+
+/* interrupt handlers run, indexed by IRQ number */
+extern uint32_t SIM_irqCount[32];
+
+/* preemption point of an instrumented build, see rtcdrv_probe.h. calls
+* SIM_probeHook, which can raise interrupts and let time pass, not
+* recursively */
+void SIM_probe(void);
+extern void (*SIM_probeHook)(void);
+
+#endif // __EFM32SIM_H__
@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "em_emu.h"
+#include "em_cmu.h"
+
+/* energy mode entry of the host simulation, in place of em_emu.c: its EM2
+* and EM3 entry reads address 4 after WFI (errata EMU_E110), which the
+* host cannot map. every mode sleeps in WFI. the core wakes up from EM2 and
+* EM3 on HFRCO, restore selects the HF clock of before again as em_emu.c
+* does, otherwise the change is announced to the CMU */
+
+void EMU_EnterEM2(bool restore) {
+  CMU_Select_TypeDef hfClock = CMU_ClockSelectGet(cmuClock_HF);
+
+  SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+#if defined(CORE_PROFILE)
+  CORE_ProfileSuspend();
+  __WFI();
+  CORE_ProfileResume();
+#else
+  __WFI();
+#endif
+  SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+  if (restore) {
+    if (hfClock != cmuSelect_HFRCO) {
+      CMU_ClockSelectSet(cmuClock_HF, hfClock);
+    }
+  } else {
+    SystemCoreClockUpdate();
+    CMU_ClockFreqInvalidate();
+  }
+}
+
+void EMU_EnterEM3(bool restore) {
+  EMU_EnterEM2(restore);
+}
+
+void EMU_EnterEM4(void) {
+  fprintf(stderr, "sim: EM4 entry\n");
+  abort();
+}
+
+void EMU_Save(void) {
+}
+
+void EMU_Restore(void) {
+}
+
+void EMU_UpdateOscConfig(void) {
+}
@@ -0,0 +1,67 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "ht16k33_sim.h"
+
+SIM_Ht16k33 SIM_ht16k33;
+
+static bool l_command;       /* the next byte written is a command */
+static bool l_ramWrite;      /* the bytes after it go into the RAM */
+static unsigned int l_nackAt;
+
+static void start(bool read) {
+  l_command = !read;
+  l_ramWrite = false;
+  if (!read) {
+    SIM_ht16k33.writes++;
+  }
+}
+
+static bool write(uint8_t byte) {
+  if (l_nackAt != 0U && --l_nackAt == 0U) {
+    return false;
+  }
+  if (l_command) {
+    l_command = false;
+    switch (byte & 0xF0U) {
+      case 0x00U:
+        SIM_ht16k33.ptr = byte & 0x0FU;
+        l_ramWrite = true;
+        break;
+      case 0x20U:
+        SIM_ht16k33.osc = (byte & 1U) != 0U;
+        break;
+      case 0x80U:
+        SIM_ht16k33.display = byte & 0x07U;
+        break;
+      case 0xE0U:
+        SIM_ht16k33.dimming = byte & 0x0FU;
+        break;
+      default:
+        break;
+    }
+  } else if (l_ramWrite) {
+    SIM_ht16k33.ram[SIM_ht16k33.ptr] = byte;
+    SIM_ht16k33.ptr = (SIM_ht16k33.ptr + 1U) & 0x0FU;
+  }
+  return true;
+}
+
+static uint8_t read(void) {
+  uint8_t byte = SIM_ht16k33.ram[SIM_ht16k33.ptr];
+
+  SIM_ht16k33.ptr = (SIM_ht16k33.ptr + 1U) & 0x0FU;
+  return byte;
+}
+
+static SIM_I2cSlave l_slave = { 0U, start, write, read, NULL };
+
+void SIM_ht16k33Attach(uint8_t addr) {
+  memset(&SIM_ht16k33, 0, sizeof(SIM_ht16k33));
+  l_nackAt = 0U;
+  l_slave.addr = addr;
+  SIM_i2cAttach(&l_slave);
+}
+
+void SIM_ht16k33NackAt(unsigned int n) {
+  l_nackAt = n;
+}
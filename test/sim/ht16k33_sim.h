@@ -0,0 +1,33 @@
+#ifndef __HT16K33_SIM_H__
+#define __HT16K33_SIM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* HT16K33 LED controller as a slave on the simulated I2C0 bus. the first
+* byte after the address is a command:
+*   0x0X  display RAM address X, the bytes after it written from there
+*         with auto increment, a read starts there
+*   0x2X  system setup, oscillator on in bit 0
+*   0x8X  display setup, display on in bit 0, blink in bits 2:1
+*   0xEX  dimming, duty in bits 3:0
+* each write transfer counts in writes */
+
+typedef struct {
+    uint8_t ram[16];
+    uint8_t ptr;
+    bool osc;
+    uint8_t display;
+    uint8_t dimming;
+    unsigned int writes;
+} SIM_Ht16k33;
+
+extern SIM_Ht16k33 SIM_ht16k33;
+
+/* reset the controller and attach it at addr, in bits 7:1 */
+void SIM_ht16k33Attach(uint8_t addr);
+
+/* NACK the n-th byte written from now, counted from 1, 0 never */
+void SIM_ht16k33NackAt(unsigned int n);
+
+#endif // __HT16K33_SIM_H__
@@ -0,0 +1,28 @@
+#ifndef __I2CDRV_PROBE_H__
+#define __I2CDRV_PROBE_H__
+
+#include "em_device.h"
+#include "efm32sim.h"
+
+/* forced into the build of i2cdrv.c (-include): the driver writes CMD
+* several times between two sync points, e.g. ACK and NACK of the last two
+* bytes in, and polls STATE right after ABORT. every command written takes
+* effect in SIM_i2cCmd(), which leaves CMD zero */
+
+#undef I2C_CMD_START
+#undef I2C_CMD_STOP
+#undef I2C_CMD_ACK
+#undef I2C_CMD_NACK
+#undef I2C_CMD_ABORT
+#undef I2C_CMD_CLEARTX
+#undef I2C_CMD_CLEARPC
+
+#define I2C_CMD_START   SIM_i2cCmd(0x1UL << 0)
+#define I2C_CMD_STOP    SIM_i2cCmd(0x1UL << 1)
+#define I2C_CMD_ACK     SIM_i2cCmd(0x1UL << 2)
+#define I2C_CMD_NACK    SIM_i2cCmd(0x1UL << 3)
+#define I2C_CMD_ABORT   SIM_i2cCmd(0x1UL << 5)
+#define I2C_CMD_CLEARTX SIM_i2cCmd(0x1UL << 6)
+#define I2C_CMD_CLEARPC SIM_i2cCmd(0x1UL << 7)
+
+#endif // __I2CDRV_PROBE_H__
@@ -0,0 +1 @@
+/* the IAR intrinsics are provided by the virtual core, core_cm0plus.h */
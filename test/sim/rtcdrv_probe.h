@@ -0,0 +1,31 @@
+#ifndef __RTCDRV_PROBE_H__
+#define __RTCDRV_PROBE_H__
+
+#include "em_device.h"
+#include "em_rtc.h"
+#include "efm32sim.h"
+
+/* forced into an instrumented build of rtcdriver.c (-include): every RTC
+* register access of the driver is a preemption point first, where
+* SIM_probe() lets the test raise interrupts and let time pass. the code
+* between two accesses runs in no time, as everywhere in the simulation.
+* RTC_probeIntSets counts the driver setting a compare flag by itself,
+* defined by the test */
+
+extern unsigned int RTC_probeIntSets;
+
+#define RTC_CounterGet()        (SIM_probe(), RTC_CounterGet())
+#define RTC_CounterReset()      (SIM_probe(), RTC_CounterReset())
+#define RTC_CompareGet(c)       (SIM_probe(), RTC_CompareGet(c))
+#define RTC_CompareSet(c, v)    (SIM_probe(), RTC_CompareSet((c), (v)))
+#define RTC_IntClear(f)         (SIM_probe(), RTC_IntClear(f))
+#define RTC_IntDisable(f)       (SIM_probe(), RTC_IntDisable(f))
+#define RTC_IntEnable(f)        (SIM_probe(), RTC_IntEnable(f))
+#define RTC_IntGetEnabled()     (SIM_probe(), RTC_IntGetEnabled())
+#define RTC_IntSet(f)           (SIM_probe(), RTC_probeIntSets++, \
+                                 RTC_IntSet(f))
+
+/* the test starts and stops timers from GPIO_EVEN_IRQHandler() */
+#define EMDRV_RTCDRV_SECTION_EXTRA_IRQS(X, w) X(GPIO_EVEN_IRQn, w)
+
+#endif // __RTCDRV_PROBE_H__
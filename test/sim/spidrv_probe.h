@@ -0,0 +1,15 @@
+#ifndef __SPIDRV_PROBE_H__
+#define __SPIDRV_PROBE_H__
+
+#include "em_device.h"
+#include "dmadrv.h"
+#include "efm32sim.h"
+
+/* forced into the build of spidrv.c (-include): the driver starts the RX
+* channel and then the TX channel, two writes to CHENS without a sync point
+* in between. a sync point after the RX channel is started */
+
+#define DMADRV_PeripheralMemory(...) \
+  ((void)DMADRV_PeripheralMemory(__VA_ARGS__), SIM_sync())
+
+#endif // __SPIDRV_PROBE_H__
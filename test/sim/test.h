@@ -0,0 +1,39 @@
+#ifndef __TEST_H__
+#define __TEST_H__
+
+#include <stdio.h>
+
+/* checks of the host tests, a test returns TEST_RESULT() from main */
+
+static int l_testFailed;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      l_testFailed++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(a, b) do { \
+    long long a_ = (long long)(a); \
+    long long b_ = (long long)(b); \
+    if (a_ != b_) { \
+      printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+             __FILE__, __LINE__, #a, #b, a_, b_); \
+      l_testFailed++; \
+    } \
+  } while (0)
+
+/* lo <= a <= hi */
+#define CHECK_RANGE(a, lo, hi) do { \
+    long long a_ = (long long)(a); \
+    if (a_ < (long long)(lo) || a_ > (long long)(hi)) { \
+      printf("%s:%d: CHECK_RANGE(%s, %s, %s) failed: %lld\n", \
+             __FILE__, __LINE__, #a, #lo, #hi, a_); \
+      l_testFailed++; \
+    } \
+  } while (0)
+
+#define TEST_RESULT() (l_testFailed != 0 ? 1 : 0)
+
+#endif // __TEST_H__
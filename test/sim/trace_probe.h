@@ -0,0 +1,14 @@
+#ifndef __TRACE_PROBE_H__
+#define __TRACE_PROBE_H__
+
+#include "em_device.h"
+#include "em_leuart.h"
+#include "efm32sim.h"
+
+/* forced into the build of bsp.c (-include): BSP_traceDump() writes the
+* dump byte by byte with LEUART_Tx(), which polls TXBL and SYNCBUSY without
+* a sync point in between. each byte is taken into SIM_tx before the next */
+
+#define LEUART_Tx(leuart, data) (LEUART_Tx((leuart), (data)), SIM_sync())
+
+#endif // __TRACE_PROBE_H__
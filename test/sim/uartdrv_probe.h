@@ -0,0 +1,27 @@
+#ifndef __UARTDRV_PROBE_H__
+#define __UARTDRV_PROBE_H__
+
+#include "em_device.h"
+#include "em_leuart.h"
+#include "efm32sim.h"
+
+/* forced into the build of uartdrv.c (-include): the driver polls STATUS
+* for RXENS and TXENS right after writing the enable commands, without a
+* sync point in between. every LEUART command written takes effect in
+* SIM_leuartCmd(), which leaves CMD zero */
+
+#undef LEUART_CMD_RXEN
+#undef LEUART_CMD_RXDIS
+#undef LEUART_CMD_TXEN
+#undef LEUART_CMD_TXDIS
+#undef LEUART_CMD_CLEARTX
+#undef LEUART_CMD_CLEARRX
+
+#define LEUART_CMD_RXEN    SIM_leuartCmd(0x1UL << 0)
+#define LEUART_CMD_RXDIS   SIM_leuartCmd(0x1UL << 1)
+#define LEUART_CMD_TXEN    SIM_leuartCmd(0x1UL << 2)
+#define LEUART_CMD_TXDIS   SIM_leuartCmd(0x1UL << 3)
+#define LEUART_CMD_CLEARTX SIM_leuartCmd(0x1UL << 6)
+#define LEUART_CMD_CLEARRX SIM_leuartCmd(0x1UL << 7)
+
+#endif // __UARTDRV_PROBE_H__
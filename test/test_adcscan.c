@@ -0,0 +1,176 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_cmu.h"
+#include "em_dma.h"
+#include "bsp.h"
+#include "sched.h"
+#include "adcscan.h"
+
+/* ring halves from simulated ADC0 scans through the DMA to ADCSCAN_task() */
+
+static DMA_DESCRIPTOR_TypeDef l_dmaCtrl[DMA_CHAN_COUNT * 2]
+__attribute__((aligned(256)));
+
+#define SCRIPT_HALVES 4U
+#define SCRIPT_SCANS  (SCRIPT_HALVES * ADCSCAN_HALF_SCANS)
+#define SCRIPT_FRAMES (SCRIPT_SCANS / ADCSCAN_DECIMATION)
+/* impulse response of the CIC filter: ADCSCAN_CIC_ORDER boxcars of
+* ADCSCAN_DECIMATION taps convolved */
+#define CIC_TAPS      (ADCSCAN_CIC_ORDER * (ADCSCAN_DECIMATION - 1U) + 1U)
+
+static unsigned int l_frames;
+static uint16_t l_frame[ADC_SCAN_CHANNELS];
+static uint16_t l_out[SCRIPT_FRAMES][ADC_SCAN_CHANNELS];
+
+static void output(uint16_t const *frame) {
+  memcpy(l_frame, frame, sizeof(l_frame));
+  if (l_frames < SCRIPT_FRAMES) {
+    memcpy(l_out[l_frames], frame, sizeof(l_frame));
+  }
+  l_frames++;
+}
+
+/* one ring half of scans with the same results */
+static void half(uint16_t ch5, uint16_t ch6) {
+  uint16_t const results[ADC_SCAN_CHANNELS] = { ch5, ch6 };
+  unsigned int i;
+
+  for (i = 0U; i < ADCSCAN_HALF_SCANS; i++) {
+    SIM_adcScan(results, ADC_SCAN_CHANNELS);
+  }
+}
+
+static void dispatch(void) {
+  SIM_RUN(SIM_LFCLK_HZ / 100U, SCHED_run());
+}
+
+static void setup(void) {
+  DMA_Init_TypeDef dmaInit;
+
+  SIM_init();
+  SCHED_init();
+  CMU_ClockEnable(cmuClock_DMA, true);
+  dmaInit.hprot = 0;
+  dmaInit.controlBlock = l_dmaCtrl;
+  DMA_Init(&dmaInit);
+  SCHED_taskStart(TASK_ADC, ADCSCAN_task);
+}
+
+/* a CIC filter of constant input outputs the input once settled */
+static void testFrames(void) {
+  unsigned int i;
+
+  CHECK(ADCSCAN_start(1000U, output));
+  for (i = 1U; i <= 3U; i++) {
+    half(100U, 2000U);
+    dispatch();
+    CHECK_EQ(l_frames, i);
+  }
+  CHECK_EQ(l_frame[0], 100U);
+  CHECK_EQ(l_frame[1], 2000U);
+  CHECK_EQ(ADCSCAN_overruns(), 0U);
+
+  /* the DMA refills a half the task has not processed yet */
+  half(100U, 2000U);
+  half(100U, 2000U);
+  dispatch();
+  CHECK_EQ(ADCSCAN_overruns(), 1U);
+  ADCSCAN_stop();
+}
+
+/* an event queued across ADCSCAN_stop() and a new start is dropped */
+static void testStaleEvent(void) {
+  l_frames = 0U;
+  CHECK(ADCSCAN_start(1000U, output));
+  half(1U, 1U);
+  ADCSCAN_stop();
+  CHECK(ADCSCAN_start(1000U, output));
+  dispatch();
+  CHECK_EQ(l_frames, 0U);
+
+  half(7U, 7U);
+  dispatch();
+  CHECK_EQ(l_frames, 1U);
+  half(7U, 7U);
+  dispatch();
+  CHECK_EQ(l_frames, 2U);
+  CHECK_EQ(ADCSCAN_overruns(), 0U);
+  ADCSCAN_stop();
+}
+
+/* the output of the decimating CIC filter as the FIR filter it is: the
+* input convolved with the impulse response, taken at every
+* ADCSCAN_DECIMATION-th scan and divided by the gain */
+static uint16_t reference(uint16_t const *x, unsigned int frame) {
+  uint32_t h[CIC_TAPS];
+  uint32_t next[CIC_TAPS];
+  uint32_t sum = 0U;
+  unsigned int len = 1U;
+  unsigned int n = (frame + 1U) * ADCSCAN_DECIMATION - 1U;
+  unsigned int i;
+  unsigned int j;
+  unsigned int k;
+
+  memset(h, 0, sizeof(h));
+  h[0] = 1U;
+  for (i = 0U; i < ADCSCAN_CIC_ORDER; i++) {
+    memset(next, 0, sizeof(next));
+    for (k = 0U; k < len; k++) {
+      for (j = 0U; j < ADCSCAN_DECIMATION; j++) {
+        next[k + j] += h[k];
+      }
+    }
+    len += ADCSCAN_DECIMATION - 1U;
+    memcpy(h, next, sizeof(h));
+  }
+  for (k = 0U; k < CIC_TAPS && k <= n; k++) {
+    sum += h[k] * x[n - k];
+  }
+  return (uint16_t)(sum >> (ADCSCAN_CIC_ORDER * ADCSCAN_DECIMATION_LOG2));
+}
+
+/* an impulse on one channel and a ramp on the other, scan by scan, give
+* the frames of the reference filter, including the settling ones */
+static void testResponse(void) {
+  static uint16_t x[ADC_SCAN_CHANNELS][SCRIPT_SCANS];
+  uint16_t results[ADC_SCAN_CHANNELS];
+  unsigned int n;
+  unsigned int f;
+
+  memset(x, 0, sizeof(x));
+  x[0][21] = 4095U;
+  for (n = 0U; n < SCRIPT_SCANS; n++) {
+    x[1][n] = (uint16_t)(n * 61U);
+  }
+
+  l_frames = 0U;
+  CHECK(ADCSCAN_start(1000U, output));
+  for (n = 0U; n < SCRIPT_SCANS; n++) {
+    results[0] = x[0][n];
+    results[1] = x[1][n];
+    SIM_adcScan(results, ADC_SCAN_CHANNELS);
+    if ((n + 1U) % ADCSCAN_HALF_SCANS == 0U) {
+      dispatch();
+    }
+  }
+  CHECK_EQ(l_frames, SCRIPT_FRAMES);
+  for (f = 0U; f < SCRIPT_FRAMES; f++) {
+    CHECK_EQ(l_out[f][0], reference(x[0], f));
+    CHECK_EQ(l_out[f][1], reference(x[1], f));
+  }
+  /* the impulse reaches two frames, the ramp is delayed by the filter */
+  CHECK(l_out[1][0] != 0U && l_out[2][0] != 0U);
+  CHECK_EQ(l_out[0][0] + l_out[3][0], 0U);
+  CHECK(l_out[3][1] < x[1][SCRIPT_SCANS - 1U]);
+  CHECK_EQ(ADCSCAN_overruns(), 0U);
+  ADCSCAN_stop();
+}
+
+int main(void) {
+  setup();
+  testFrames();
+  testStaleEvent();
+  testResponse();
+  return TEST_RESULT();
+}
@@ -0,0 +1,54 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "bsp.h"
+#include "inmon.h"
+
+/* BSP bench results as JSON, built with BSP_BENCH */
+
+int DELAY;
+
+/* the display and input monitor are not part of this test */
+void updateMatrix(float number, char *matrix) {
+  (void)number;
+  (void)matrix;
+}
+
+void drawMatrix(char *matrix) {
+  (void)matrix;
+}
+
+void INMON_irq(uint32_t flags) {
+  (void)flags;
+}
+
+static void testJson(void) {
+  char full[448];
+  char buf[448];
+  int len;
+  int size;
+
+  BSP_benchAdd(&BSP_bench[BSP_BENCH_UPDATE_MATRIX], BSP_cycleCtr());
+  len = BSP_benchJson(full, sizeof(full));
+  CHECK_EQ(len, strlen(full));
+  CHECK(len < (int)sizeof(full));
+  CHECK(strncmp(full, "{\"clock\":", 9) == 0);
+  CHECK(strstr(full, "\"name\":\"irqRam\"") != NULL);
+  CHECK_EQ(strcmp(&full[len - 2], "]}"), 0);
+
+  /* every cut is a terminated prefix of the full output */
+  CHECK_EQ(BSP_benchJson(buf, 0), 0);
+  for (size = 1; size <= len + 1; size++) {
+    memset(buf, 'x', sizeof(buf));
+    CHECK_EQ(BSP_benchJson(buf, size), size - 1 < len ? size - 1 : len);
+    CHECK_EQ(strlen(buf), size - 1 < len ? size - 1 : len);
+    CHECK(strncmp(buf, full, strlen(buf)) == 0);
+    CHECK_EQ(buf[size], 'x');
+  }
+}
+
+int main(void) {
+  SIM_init();
+  testJson();
+  return TEST_RESULT();
+}
@@ -0,0 +1,316 @@
+#include "efm32sim.h"
+#include "test.h"
+#include "em_cmu.h"
+#include "em_emu.h"
+#include "rtcdriver.h"
+
+/* the frequency cache and the clock change subscribers of em_cmu.c, built
+* again with the HFCLKSEL commands taking effect at once and a preemption
+* point at every core clock read, see sim/cmu_probe.h. every frequency
+* served is compared with one computed from the registers. HFXO runs at
+* 24 MHz, HFRCO in its 14 MHz band, LFRCO and LFXO at 32768 Hz */
+
+#define HFXO_HZ  24000000U
+#define HFRCO_HZ 14000000U
+#define LF_HZ    32768U
+#define WAKE_MS  5U
+
+/* a clock of each branch, and more of the HFPER and HFCORE branches */
+static CMU_Clock_TypeDef const l_clocks[] = {
+  cmuClock_HF, cmuClock_CORE, cmuClock_DMA, cmuClock_HFPER, cmuClock_TIMER0,
+  cmuClock_USART1, cmuClock_I2C0, cmuClock_LFA, cmuClock_RTC, cmuClock_LFB,
+  cmuClock_LEUART0,
+};
+
+static CMU_ClockChangeSubscriber_TypeDef l_sub[2];
+static unsigned int l_changes[2];
+static bool l_stale;                   /* a subscriber saw an old frequency */
+static void (*l_preempt)(void);        /* run once at the next probe */
+static unsigned int l_preempted;
+
+static uint32_t lfFreq(uint32_t sel) {
+  switch (sel) {
+    case _CMU_LFCLKSEL_LFA_LFRCO:
+    case _CMU_LFCLKSEL_LFA_LFXO:
+      return LF_HZ;
+    case _CMU_LFCLKSEL_LFA_HFCORECLKLEDIV2:
+      return (SystemHFClockGet()
+              >> (CMU->HFCORECLKDIV & _CMU_HFCORECLKDIV_HFCORECLKDIV_MASK))
+             / 2U;
+    default:
+      return 0U;
+  }
+}
+
+/* the frequency of clock from the registers, without em_cmu.c */
+static uint32_t reference(CMU_Clock_TypeDef clock) {
+  uint32_t hf = SystemHFClockGet();
+  uint32_t lfa = lfFreq((CMU->LFCLKSEL & _CMU_LFCLKSEL_LFA_MASK)
+                        >> _CMU_LFCLKSEL_LFA_SHIFT);
+  uint32_t lfb = lfFreq((CMU->LFCLKSEL & _CMU_LFCLKSEL_LFB_MASK)
+                        >> _CMU_LFCLKSEL_LFB_SHIFT);
+
+  switch (clock) {
+    case cmuClock_HF:
+      return hf;
+    case cmuClock_CORE:
+    case cmuClock_DMA:
+      return hf >> (CMU->HFCORECLKDIV & _CMU_HFCORECLKDIV_HFCORECLKDIV_MASK);
+    case cmuClock_HFPER:
+    case cmuClock_TIMER0:
+    case cmuClock_USART1:
+    case cmuClock_I2C0:
+      return hf >> (CMU->HFPERCLKDIV & _CMU_HFPERCLKDIV_HFPERCLKDIV_MASK);
+    case cmuClock_LFA:
+      return lfa;
+    case cmuClock_RTC:
+      return lfa >> ((CMU->LFAPRESC0 & _CMU_LFAPRESC0_RTC_MASK)
+                     >> _CMU_LFAPRESC0_RTC_SHIFT);
+    case cmuClock_LFB:
+      return lfb;
+    case cmuClock_LEUART0:
+      return lfb >> ((CMU->LFBPRESC0 & _CMU_LFBPRESC0_LEUART0_MASK)
+                     >> _CMU_LFBPRESC0_LEUART0_SHIFT);
+    default:
+      return 0U;
+  }
+}
+
+/* every clock twice, the second time from the cache */
+static void checkClocks(int line) {
+  unsigned int i;
+  unsigned int n;
+
+  for (n = 0U; n < 2U; n++) {
+    for (i = 0U; i < sizeof(l_clocks) / sizeof(l_clocks[0]); i++) {
+      if (CMU_ClockFreqGet(l_clocks[i]) != reference(l_clocks[i])) {
+        printf("%s:%d: clock %u: %u Hz, %u Hz from the registers\n",
+               __FILE__, line, i, (unsigned int)CMU_ClockFreqGet(l_clocks[i]),
+               (unsigned int)reference(l_clocks[i]));
+        l_testFailed++;
+      }
+    }
+  }
+}
+
+#define CHECK_CLOCKS() checkClocks(__LINE__)
+
+/* a change notifies each subscriber once, which sees the new frequencies */
+static void changed(void *user) {
+  unsigned int *changes = user;
+  unsigned int i;
+
+  (*changes)++;
+  for (i = 0U; i < sizeof(l_clocks) / sizeof(l_clocks[0]); i++) {
+    if (CMU_ClockFreqGet(l_clocks[i]) != reference(l_clocks[i])) {
+      l_stale = true;
+    }
+  }
+}
+
+static void checkChanges(unsigned int n, int line) {
+  unsigned int i;
+
+  for (i = 0U; i < 2U; i++) {
+    if (l_changes[i] != n) {
+      printf("%s:%d: subscriber %u notified %u times, not %u\n",
+             __FILE__, line, i, l_changes[i], n);
+      l_testFailed++;
+    }
+    l_changes[i] = 0U;
+  }
+  if (l_stale) {
+    printf("%s:%d: a subscriber saw an old frequency\n", __FILE__, line);
+    l_testFailed++;
+    l_stale = false;
+  }
+}
+
+#define CHECK_CHANGES(n) checkChanges((n), __LINE__)
+
+static void probe(void) {
+  void (*preempt)(void) = l_preempt;
+
+  if (preempt != NULL) {
+    l_preempt = NULL;
+    l_preempted++;
+    preempt();
+  }
+}
+
+static void setup(void) {
+  unsigned int i;
+
+  SIM_init();
+  SIM_probeHook = probe;
+  l_preempt = NULL;
+  l_preempted = 0U;
+  l_stale = false;
+  for (i = 0U; i < 2U; i++) {
+    CMU_ClockChangeSubscribe(&l_sub[i], changed, &l_changes[i]);
+    l_changes[i] = 0U;
+  }
+  CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFRCO);
+  CMU_ClockSelectSet(cmuClock_LFB, cmuSelect_LFXO);
+  CHECK_CHANGES(2U);
+  CHECK_CLOCKS();
+}
+
+static void teardown(void) {
+  CMU_ClockChangeUnsubscribe(&l_sub[0]);
+  CMU_ClockChangeUnsubscribe(&l_sub[1]);
+}
+
+/* each setter changing the clocks, from a full cache every time. the
+* prescalers of the LF clocks are set with CMU_ClockDivSet() on series 0 */
+static void testSetters(void) {
+  setup();
+  CMU_ClockSelectSet(cmuClock_HF, cmuSelect_HFXO);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+  CHECK_EQ(CMU_ClockFreqGet(cmuClock_HF), HFXO_HZ);
+  CHECK_EQ(SystemCoreClock, HFXO_HZ);
+
+  CMU_ClockSelectSet(cmuClock_HF, cmuSelect_HFRCO);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+  CHECK_EQ(CMU_ClockFreqGet(cmuClock_HF), HFRCO_HZ);
+
+  CMU_HFRCOBandSet(cmuHFRCOBand_21MHz);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+  CHECK_EQ(CMU_ClockFreqGet(cmuClock_TIMER0), 21000000U);
+  CMU_HFRCOBandSet(cmuHFRCOBand_7MHz);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+
+  CMU_ClockDivSet(cmuClock_HFPER, cmuClkDiv_4);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+  CMU_ClockDivSet(cmuClock_CORE, cmuClkDiv_2);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+  CMU_ClockDivSet(cmuClock_RTC, cmuClkDiv_8);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+  CMU_ClockDivSet(cmuClock_LEUART0, cmuClkDiv_4);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+  CHECK_EQ(CMU_ClockFreqGet(cmuClock_LEUART0), LF_HZ / 4U);
+
+  CMU_ClockSelectSet(cmuClock_LFB, cmuSelect_CORELEDIV2);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+  CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFXO);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+
+  /* the oscillators in use cannot be disabled, no frequency changes */
+  CMU_OscillatorEnable(cmuOsc_AUXHFRCO, false, false);
+  CMU_OscillatorEnable(cmuOsc_HFXO, true, true);
+  CHECK_CHANGES(0U);
+  CHECK_CLOCKS();
+
+  CMU_ClockChangeUnsubscribe(&l_sub[1]);
+  CMU_ClockDivSet(cmuClock_HFPER, cmuClkDiv_1);
+  CHECK_EQ(l_changes[0], 1U);
+  CHECK_EQ(l_changes[1], 0U);
+  teardown();
+}
+
+static void divHfper(void) {
+  CMU_ClockDivSet(cmuClock_HFPER, cmuClkDiv_2);
+  CHECK_EQ(CMU_ClockFreqGet(cmuClock_HFPER), reference(cmuClock_HFPER));
+}
+
+static void divCore(void) {
+  CMU_ClockDivSet(cmuClock_CORE, cmuClkDiv_4);
+}
+
+static void bandSet(void) {
+  CMU_HFRCOBandSet(cmuHFRCOBand_11MHz);
+}
+
+/* changes nested in a change, as from an interrupt handler: one
+* notification at the end of the outer one. a change during a frequency
+* computation keeps its result out of the cache */
+static void testNested(void) {
+  setup();
+  l_preempt = divHfper;
+  CMU_ClockSelectSet(cmuClock_HF, cmuSelect_HFXO);
+  CHECK_EQ(l_preempted, 1U);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+  CHECK_EQ(CMU_ClockFreqGet(cmuClock_HFPER), HFXO_HZ / 2U);
+
+  l_preempt = bandSet;
+  CMU_ClockDivSet(cmuClock_CORE, cmuClkDiv_2);
+  CHECK_EQ(l_preempted, 2U);
+  CHECK_CHANGES(1U);
+  CHECK_CLOCKS();
+
+  CMU_ClockSelectSet(cmuClock_HF, cmuSelect_HFRCO);
+  CHECK_CHANGES(1U);
+  CHECK_EQ(CMU_ClockFreqGet(cmuClock_HF), 11000000U);
+
+  /* the core clock read by the computation is stale when it returns. the
+  * subscribers would fill the cache */
+  teardown();
+  CMU_ClockFreqInvalidate();
+  l_preempt = divCore;
+  CHECK_EQ(CMU_ClockFreqGet(cmuClock_CORE), 11000000U / 2U);
+  CHECK_EQ(l_preempted, 3U);
+  CHECK_CLOCKS();
+  CHECK_EQ(CMU_ClockFreqGet(cmuClock_CORE), 11000000U / 4U);
+}
+
+static void woken(RTCDRV_TimerID_t id, void *user) {
+  (void)id;
+  (void)user;
+}
+
+/* the core wakes up from EM2 and EM3 on HFRCO: without restore the
+* frequencies of HFRCO are served and the subscribers notified, with
+* restore HFXO is selected again */
+static void testWakeup(void) {
+  RTCDRV_TimerID_t id;
+  unsigned int i;
+
+  setup();
+  CHECK_EQ(RTCDRV_Init(), ECODE_EMDRV_RTCDRV_OK);
+  CHECK_EQ(RTCDRV_AllocateTimer(&id), ECODE_EMDRV_RTCDRV_OK);
+  for (i = 0U; i < 3U; i++) {
+    CMU_ClockSelectSet(cmuClock_HF, cmuSelect_HFXO);
+    CMU_ClockDivSet(cmuClock_HFPER, cmuClkDiv_2);
+    CHECK_CLOCKS();
+    CHECK_EQ(CMU_ClockFreqGet(cmuClock_HFPER), HFXO_HZ / 2U);
+    l_changes[0] = 0U;
+    l_changes[1] = 0U;
+
+    RTCDRV_StartTimer(id, rtcdrvTimerTypeOneshot, WAKE_MS, woken, NULL);
+    if (i == 0U) {
+      EMU_EnterEM2(false);
+    } else if (i == 1U) {
+      EMU_EnterEM3(false);
+    } else {
+      EMU_EnterEM2(true);
+    }
+    CHECK_CHANGES(1U);
+    CHECK_CLOCKS();
+    CHECK_EQ(CMU_ClockSelectGet(cmuClock_HF),
+             i < 2U ? cmuSelect_HFRCO : cmuSelect_HFXO);
+    CHECK_EQ(CMU_ClockFreqGet(cmuClock_HFPER),
+             (i < 2U ? HFRCO_HZ : HFXO_HZ) / 2U);
+    CHECK_EQ(SystemCoreClock, i < 2U ? HFRCO_HZ : HFXO_HZ);
+  }
+  RTCDRV_FreeTimer(id);
+  RTCDRV_DeInit();
+  teardown();
+}
+
+int main(void) {
+  testSetters();
+  testNested();
+  testWakeup();
+  return TEST_RESULT();
+}
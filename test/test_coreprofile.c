@@ -0,0 +1,216 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_core.h"
+#include "sleep.h"
+#include "rtcdriver.h"
+#include "sched.h"
+
+/* critical section profiler of em_core.c on the simulated SysTick, built
+* with CORE_PROFILE together with the energy mode entries, SLEEP and the
+* scheduler. code under test takes SIM_cycles(), HFCORECLK is HFCLK */
+
+#define PRIO      0U
+#define SIG_TICK  1U
+#define TICKS     5U
+#define TICK_MS   10U
+
+static CORE_ProfileSite_t l_sites[CORE_PROFILE_SITES];
+static unsigned int l_ticks;
+static bool l_woken;
+
+/* free running at the maximum reload, as BSP_cycleInit() */
+static void setup(void) {
+  SIM_init();
+  SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL = 0U;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+  SLEEP_Init(NULL, NULL);
+  RTCDRV_Init();
+  CORE_ProfileReset();
+}
+
+static void teardown(void) {
+  RTCDRV_DeInit();
+}
+
+/* the record of a call site, NULL if it has none */
+static CORE_ProfileSite_t *site(char const *file, uint32_t line) {
+  uint32_t n = CORE_ProfileGet(l_sites, CORE_PROFILE_SITES);
+  uint32_t i;
+
+  for (i = 0U; i < n; i++) {
+    if (strstr(l_sites[i].file, file) != NULL
+        && (line == 0U || l_sites[i].line == line)) {
+      return &l_sites[i];
+    }
+  }
+  return NULL;
+}
+
+/* the masked time of the outermost section, at its entry line */
+static void testDuration(void) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ProfileSite_t *s;
+  uint32_t line;
+  unsigned int i;
+
+  setup();
+  for (i = 1U; i <= 2U; i++) {
+    line = __LINE__ + 1U;
+    CORE_ENTER_ATOMIC();
+    SIM_cycles(1000U * i);
+    CORE_CRITICAL_SECTION(SIM_cycles(500U); )
+    CORE_EXIT_ATOMIC();
+  }
+  CHECK_EQ(CORE_ProfileGet(l_sites, CORE_PROFILE_SITES), 1U);
+  s = site(__FILE__, line);
+  CHECK(s != NULL);
+  if (s != NULL) {
+    CHECK_EQ(s->count, 2U);
+    CHECK_EQ(s->max, 2500U);
+    CHECK_EQ(s->total, 1500U + 2500U);
+    CHECK_EQ(s->wrapped, 0U);
+  }
+  CHECK_EQ(CORE_ProfileDropped(), 0U);
+  teardown();
+}
+
+static void woken(RTCDRV_TimerID_t id, void *user) {
+  (void)id;
+  (void)user;
+  l_woken = true;
+}
+
+/* a section that sleeps is timed up to WFI and from the wakeup, in EM1
+* SysTick keeps counting, in EM2 it stops */
+static void testSleep(void) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ProfileSite_t *s;
+  RTCDRV_TimerID_t id;
+  uint32_t line;
+  uint64_t slept;
+  unsigned int i;
+
+  setup();
+  CHECK_EQ(RTCDRV_AllocateTimer(&id), ECODE_EMDRV_RTCDRV_OK);
+  for (i = 0U; i < 2U; i++) {
+    if (i == 0U) {
+      SLEEP_SleepBlockBegin(sleepEM2);
+    }
+    l_woken = false;
+    RTCDRV_StartTimer(id, rtcdrvTimerTypeOneshot, TICK_MS, woken, NULL);
+    slept = SIM_cycleNow();
+    line = __LINE__ + 1U;
+    CORE_ENTER_CRITICAL();
+    SIM_cycles(300U);
+    CHECK_EQ(SLEEP_Sleep(), i == 0U ? sleepEM1 : sleepEM2);
+    SIM_cycles(200U);
+    CORE_EXIT_CRITICAL();
+    CHECK(l_woken);
+    slept = SIM_cycleNow() - slept;
+    if (i == 0U) {
+      SLEEP_SleepBlockEnd(sleepEM2);
+      /* SysTick ran through the sleep */
+      CHECK(slept > 100000U);
+    }
+    s = site(__FILE__, line);
+    CHECK(s != NULL);
+    if (s != NULL) {
+      CHECK_EQ(s->count, i + 1U);
+      CHECK_EQ(s->max, 500U);
+      CHECK_EQ(s->total, 500U * (i + 1U));
+    }
+    /* the section around the WFI of the EM2 entry is not recorded */
+    CHECK(site("em_emu", 0U) == NULL);
+  }
+  RTCDRV_FreeTimer(id);
+  teardown();
+}
+
+static void task(uint8_t sig) {
+  if (sig == SIG_TICK) {
+    SIM_cycles(1000U);
+    if (++l_ticks == TICKS) {
+      longjmp(SIM_stop, 1);
+    }
+  }
+}
+
+/* the scheduler idles in EM1 inside its critical section, which masks
+* no time of its own */
+static void testSchedIdle(void) {
+  CORE_ProfileSite_t *s;
+  SCHED_Timer timer;
+
+  setup();
+  SCHED_init();
+  SCHED_taskStart(PRIO, task);
+  CHECK(SCHED_timerInit(&timer, PRIO, SIG_TICK));
+  CHECK(SCHED_timerArm(&timer, TICK_MS, true));
+  SLEEP_SleepBlockBegin(sleepEM2);
+  l_ticks = 0U;
+  SIM_RUN(SIM_LFCLK_HZ, SCHED_run());
+  SLEEP_SleepBlockEnd(sleepEM2);
+  SCHED_timerDisarm(&timer);
+  CHECK_EQ(l_ticks, TICKS);
+
+  s = site("sched.c", 0U);
+  CHECK(s != NULL);
+  if (s != NULL) {
+    printf("sched.c:%u %u sections, max %u cycles, %u in total\n",
+           (unsigned int)s->line, (unsigned int)s->count,
+           (unsigned int)s->max, (unsigned int)s->total);
+    CHECK(s->count >= TICKS);
+    CHECK_EQ(s->max, 0U);
+  }
+  teardown();
+}
+
+/* TS of the profiler */
+static uint32_t timestamp(void) {
+  return SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+}
+
+/* a section across the counter wrap is timed, one over 2^24 cycles is
+* flagged and saturated */
+static void testWrap(void) {
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ProfileSite_t *s;
+  uint32_t line;
+
+  setup();
+  SIM_cycles((SysTick_LOAD_RELOAD_Msk - 100U - timestamp())
+             & SysTick_LOAD_RELOAD_Msk);
+  CHECK_EQ(timestamp(), SysTick_LOAD_RELOAD_Msk - 100U);
+  line = __LINE__ + 1U;
+  CORE_ENTER_ATOMIC();
+  SIM_cycles(1000U);
+  CORE_EXIT_ATOMIC();
+  s = site(__FILE__, line);
+  CHECK(s != NULL);
+  if (s != NULL) {
+    CHECK_EQ(s->max, 1000U);
+    CHECK_EQ(s->wrapped, 0U);
+  }
+
+  line = __LINE__ + 1U;
+  CORE_ENTER_ATOMIC();
+  SIM_cycles(SysTick_LOAD_RELOAD_Msk + 5000U);
+  CORE_EXIT_ATOMIC();
+  s = site(__FILE__, line);
+  CHECK(s != NULL);
+  if (s != NULL) {
+    CHECK_EQ(s->max, SysTick_LOAD_RELOAD_Msk);
+    CHECK_EQ(s->wrapped, 1U);
+  }
+  teardown();
+}
+
+int main(void) {
+  testDuration();
+  testSleep();
+  testSchedIdle();
+  testWrap();
+  return TEST_RESULT();
+}
@@ -0,0 +1,91 @@
+#include <string.h>
+#include "test.h"
+#include "display.h"
+
+/* dirty row tracking of DISPLAY_flush() against a recording backend */
+
+static unsigned int l_flushes;
+static uint8_t l_first;
+static uint8_t l_last;
+static bool l_busy;
+
+static void fakeInit(void) {
+}
+
+static bool fakeFlush(uint8_t const *fb, uint8_t first, uint8_t last) {
+  (void)fb;
+  if (l_busy) {
+    return false;
+  }
+  l_flushes++;
+  l_first = first;
+  l_last = last;
+  return true;
+}
+
+static void fakeBrightness(uint8_t level) {
+  (void)level;
+}
+
+static DISPLAY_Backend const l_fake = {
+  fakeInit, fakeFlush, fakeBrightness, NULL
+};
+
+static void testDirtyRows(void) {
+  uint8_t fb[DISPLAY_ROWS];
+
+  memset(fb, 0, sizeof(fb));
+  DISPLAY_init(&l_fake);
+  DISPLAY_flush(fb);
+  CHECK_EQ(l_flushes, 1U);
+  CHECK_EQ(l_first, 0U);
+  CHECK_EQ(l_last, DISPLAY_ROWS - 1);
+
+  DISPLAY_flush(fb);
+  CHECK_EQ(l_flushes, 1U);
+
+  fb[2] = 0x18U;
+  fb[5] = 0x3CU;
+  DISPLAY_flush(fb);
+  CHECK_EQ(l_flushes, 2U);
+  CHECK_EQ(l_first, 2U);
+  CHECK_EQ(l_last, 5U);
+
+  /* a busy backend keeps the rows dirty */
+  fb[7] = 0xFFU;
+  l_busy = true;
+  DISPLAY_flush(fb);
+  l_busy = false;
+  DISPLAY_flush(fb);
+  CHECK_EQ(l_flushes, 3U);
+  CHECK_EQ(l_first, 7U);
+  CHECK_EQ(l_last, 7U);
+}
+
+/* a flush lost on the way to the display is sent again in full */
+static void testInvalidate(void) {
+  uint8_t fb[DISPLAY_ROWS];
+
+  memset(fb, 0x81, sizeof(fb));
+  DISPLAY_init(&l_fake);
+  l_flushes = 0U;
+  DISPLAY_flush(fb);
+  fb[3] = 0U;
+  DISPLAY_flush(fb);
+  CHECK_EQ(l_flushes, 2U);
+  DISPLAY_invalidate();
+  CHECK_EQ(DISPLAY_lost(), 1U);
+
+  DISPLAY_flush(fb);
+  CHECK_EQ(l_flushes, 3U);
+  CHECK_EQ(l_first, 0U);
+  CHECK_EQ(l_last, DISPLAY_ROWS - 1);
+  DISPLAY_flush(fb);
+  CHECK_EQ(l_flushes, 3U);
+}
+
+int main(void) {
+  testDirtyRows();
+  testInvalidate();
+  return TEST_RESULT();
+}
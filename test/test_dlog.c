@@ -0,0 +1,197 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_cmu.h"
+#include "em_core.h"
+#include "em_dma.h"
+#include "sleep.h"
+#include "rtcdriver.h"
+#include "bsp.h"
+#include "dlog.h"
+#include "dlog_decode.h"
+
+/* deferred log records decoded from the bytes LEUART0 sent, and formatted
+* as dlogview does with this test as the ELF image: it is built without
+* position independence, the strings are at their link addresses */
+
+static DMA_DESCRIPTOR_TypeDef l_dmaCtrl[DMA_CHAN_COUNT * 2]
+__attribute__((aligned(256)));
+
+typedef struct {
+    uint8_t argc;
+    uint16_t id;
+    uint32_t time;
+    uint32_t args[DLOG_MAX_ARGS];
+} Record;
+
+static uint32_t le32(uint8_t const *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16)
+         | ((uint32_t)p[3] << 24);
+}
+
+/* decode the record at *at of SIM_tx, returns false on a framing error */
+static bool decode(uint32_t *at, Record *r) {
+  uint8_t const *p = &SIM_tx[*at];
+  uint8_t i;
+
+  if (*at + 8U > SIM_txLen || p[0] != DLOG_SYNC || p[1] > DLOG_MAX_ARGS
+      || *at + 8U + 4U * p[1] > SIM_txLen) {
+    return false;
+  }
+  r->argc = p[1];
+  r->id = (uint16_t)(p[2] | (p[3] << 8));
+  r->time = le32(&p[4]);
+  for (i = 0U; i < r->argc; i++) {
+    r->args[i] = le32(&p[8U + 4U * i]);
+  }
+  *at += 8U + 4U * r->argc;
+  return true;
+}
+
+static void idle(void) {
+  for (;;) {
+    __WFI();
+  }
+}
+
+static void setup(void) {
+  DMA_Init_TypeDef dmaInit;
+
+  SIM_init();
+  SLEEP_Init(NULL, NULL);
+  RTCDRV_Init();
+  CMU_ClockEnable(cmuClock_DMA, true);
+  dmaInit.hprot = 0;
+  dmaInit.controlBlock = l_dmaCtrl;
+  DMA_Init(&dmaInit);
+  DLOG_init();
+}
+
+static void testRecords(void) {
+  Record r;
+  uint32_t at = 0U;
+
+  DLOG1(DLOG_BOOT, 14000000U);
+  DLOG0(DLOG_CAPTURE_LOST);
+  /* 4096 LFCLK ticks are 512 RTC counts */
+  SIM_advance(4096U);
+  /* the record carries its own argument count */
+  DLOG3(DLOG_CAPTURE, 1U, 2U, 0xDEADBEEFU);
+  SIM_RUN(SIM_LFCLK_HZ, idle());
+
+  CHECK(decode(&at, &r));
+  CHECK_EQ(r.id, DLOG_BOOT);
+  CHECK_EQ(r.argc, 1U);
+  CHECK_EQ(r.args[0], 14000000U);
+  CHECK_EQ(r.time >> 24, 0U);
+
+  CHECK(decode(&at, &r));
+  CHECK_EQ(r.id, DLOG_CAPTURE_LOST);
+  CHECK_EQ(r.argc, 0U);
+  CHECK_EQ(r.time >> 24, 1U);
+
+  CHECK(decode(&at, &r));
+  CHECK_EQ(r.id, DLOG_CAPTURE);
+  CHECK_EQ(r.argc, 3U);
+  CHECK_EQ(r.args[2], 0xDEADBEEFU);
+  CHECK_EQ(r.time >> 24, 2U);
+  CHECK_RANGE(r.time & 0xFFFFFFU, 512U, 513U);
+
+  CHECK_EQ(at, SIM_txLen);
+  CHECK_EQ(DLOG_lost(), 0U);
+}
+
+/* records dropped on a full ring show as a sequence gap */
+static void testFull(void) {
+  Record r;
+  uint32_t start = SIM_txLen;
+  uint32_t at = start;
+  uint32_t seq = 3U; /* after testRecords() */
+  unsigned int i;
+
+  for (i = 0U; i < 25U; i++) {
+    DLOG1(DLOG_CAPTURE, i);
+  }
+  /* 12 byte records in the 256 byte ring */
+  CHECK_EQ(DLOG_lost(), 4U);
+  /* 9600 baud, 10 bits per byte: 96 bytes in 100 ms */
+  SIM_advance(SIM_LFCLK_HZ / 10U);
+  CHECK_RANGE(SIM_txLen - start, 95U, 97U);
+  DLOG1(DLOG_CAPTURE, 25U);
+  SIM_RUN(SIM_LFCLK_HZ, idle());
+
+  for (i = 0U; i < 21U; i++) {
+    CHECK(decode(&at, &r));
+    CHECK_EQ(r.args[0], i);
+    CHECK_EQ(r.time >> 24, seq + i);
+  }
+  CHECK(decode(&at, &r));
+  CHECK_EQ(r.args[0], 25U);
+  CHECK_EQ(r.time >> 24, seq + 25U);
+  CHECK_EQ(at, SIM_txLen);
+}
+
+/* the text of the records, a %s argument read from the ELF file */
+static void testText(void) {
+  static char const file[] = "adcscan.c";
+  DECODE_Record r;
+  ELF_Image image;
+  char text[64];
+  uint32_t at = SIM_txLen;
+  long used;
+
+  CHECK(ELF_load("/proc/self/exe", &image));
+  DLOG3(DLOG_CORE_SITE, (uintptr_t)file, 42U, 17U);
+  DLOG3(DLOG_CORE_SITE, 0x10U, 7U, 1U);
+  DLOG1(DLOG_BOOT, 14000000U);
+  DLOG2(DLOG_FORMAT_COUNT, 1U, 0xABCDU);
+  SIM_RUN(SIM_LFCLK_HZ, idle());
+
+  used = DECODE_record(&SIM_tx[at], SIM_txLen - at, &r);
+  CHECK_EQ(used, 8U + 3U * 4U);
+  CHECK_EQ(r.seq, 3U + 26U); /* after testFull() */
+  CHECK_EQ(DECODE_format(&r, &image, text, sizeof(text)),
+           strlen("critical section adcscan.c:42, max 17 cycles"));
+  CHECK_EQ(strcmp(text, "critical section adcscan.c:42, max 17 cycles"), 0);
+  /* cut as snprintf() */
+  CHECK_EQ(DECODE_format(&r, &image, text, 20U), 44);
+  CHECK_EQ(strcmp(text, "critical section ad"), 0);
+  /* without the image the address shows */
+  DECODE_format(&r, NULL, text, sizeof(text));
+  CHECK(strncmp(text, "critical section <0x", 20) == 0);
+  at += (uint32_t)used;
+
+  /* an address outside the image */
+  used = DECODE_record(&SIM_tx[at], SIM_txLen - at, &r);
+  CHECK_EQ(used, 8U + 3U * 4U);
+  DECODE_format(&r, &image, text, sizeof(text));
+  CHECK_EQ(strcmp(text, "critical section <0x00000010>:7, max 1 cycles"), 0);
+  at += (uint32_t)used;
+
+  used = DECODE_record(&SIM_tx[at], SIM_txLen - at, &r);
+  CHECK_EQ(used, 8U + 4U);
+  CHECK_EQ(r.seq, 3U + 26U + 2U);
+  DECODE_format(&r, &image, text, sizeof(text));
+  CHECK_EQ(strcmp(text, "boot, core clock 14000000 Hz"), 0);
+  at += (uint32_t)used;
+
+  /* an ID newer than the formats of the decoder */
+  used = DECODE_record(&SIM_tx[at], SIM_txLen - at, &r);
+  CHECK_EQ(used, 8U + 2U * 4U);
+  DECODE_format(&r, &image, text, sizeof(text));
+  CHECK_EQ(strcmp(text, "unknown record 5 0x00000001 0x0000abcd"), 0);
+  at += (uint32_t)used;
+  CHECK_EQ(at, SIM_txLen);
+
+  /* a record cut short does not decode */
+  CHECK_EQ(DECODE_record(&SIM_tx[at - 16U], 15U, &r), -1);
+  ELF_free(&image);
+}
+
+int main(void) {
+  setup();
+  testRecords();
+  testFull();
+  testText();
+  return TEST_RESULT();
+}
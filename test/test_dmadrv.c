@@ -0,0 +1,179 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_cmu.h"
+#include "em_usart.h"
+#include "dmadrv.h"
+
+/* DMADRV scatter-gather transfers on the simulated DMA: a list of buffers
+* sent to USART1 on TXBL, and ADC0 scan results spread over a list of
+* buffers. each list runs as one cycle with one callback at its end.
+* USART_InitSync() sets 1 MHz from the 14 MHz HFRCO, 8 bit frames. the DMA
+* descriptors hold 32 bit pointers: the buffers are statics */
+
+#define BIT_CYCLES 14U
+
+typedef struct {
+    unsigned int calls;
+    unsigned int channel;
+    unsigned int sequenceNo;
+} Done;
+
+static unsigned int l_ch;
+static Done l_done;
+
+static uint8_t l_tx0[] = { 0x11U, 0x22U, 0x33U };
+static uint8_t l_tx1[] = { 0x44U };
+static uint8_t l_tx2[] = { 0x55U, 0x66U, 0x77U, 0x88U, 0x99U };
+static uint16_t l_rx0[2];
+static uint16_t l_rx1[3];
+static uint16_t l_rx2[4];
+
+static bool done(unsigned int channel, unsigned int sequenceNo, void *user) {
+  Done *d = user;
+
+  d->calls++;
+  d->channel = channel;
+  d->sequenceNo = sequenceNo;
+  return false;
+}
+
+static void setup(void) {
+  SIM_init();
+  CHECK_EQ(DMADRV_Init(), ECODE_EMDRV_DMADRV_OK);
+  CHECK_EQ(DMADRV_AllocateChannel(&l_ch, NULL), ECODE_EMDRV_DMADRV_OK);
+  memset(&l_done, 0, sizeof(l_done));
+}
+
+static void teardown(void) {
+  CHECK_EQ(DMADRV_FreeChannel(l_ch), ECODE_EMDRV_DMADRV_OK);
+  CHECK_EQ(DMADRV_DeInit(), ECODE_EMDRV_DMADRV_OK);
+}
+
+/* the buffers of the list in order on the bus, the callback once after the
+* last byte was taken */
+static void testMemoryPeripheral(void) {
+  USART_InitSync_TypeDef init = USART_INITSYNC_DEFAULT;
+  DMADRV_Buffer_t list[] = {
+    { l_tx0, sizeof(l_tx0) },
+    { l_tx1, sizeof(l_tx1) },
+    { l_tx2, sizeof(l_tx2) },
+  };
+  uint8_t sent[sizeof(l_tx0) + sizeof(l_tx1) + sizeof(l_tx2)];
+  bool active;
+  unsigned int i;
+
+  setup();
+  CMU_ClockEnable(cmuClock_USART1, true);
+  USART_InitSync(USART1, &init);
+  CHECK_EQ(DMADRV_MemoryPeripheralScatterGather(
+             l_ch, dmadrvPeripheralSignal_USART1_TXBL, (void *)&USART1->TXDATA,
+             list, 3, dmadrvDataSize1, done, &l_done),
+           ECODE_EMDRV_DMADRV_OK);
+  for (i = 0U; i < 1000U && l_done.calls == 0U; i++) {
+    SIM_cycles(BIT_CYCLES);
+  }
+  CHECK_EQ(l_done.calls, 1U);
+  CHECK_EQ(l_done.channel, l_ch);
+  CHECK_EQ(l_done.sequenceNo, 1U);
+  CHECK_EQ(DMADRV_TransferActive(l_ch, &active), ECODE_EMDRV_DMADRV_OK);
+  CHECK(!active);
+
+  for (i = 0U; i < 64U && (USART1->STATUS & USART_STATUS_TXC) == 0U; i++) {
+    SIM_cycles(BIT_CYCLES);
+  }
+  memcpy(sent, l_tx0, sizeof(l_tx0));
+  memcpy(sent + sizeof(l_tx0), l_tx1, sizeof(l_tx1));
+  memcpy(sent + sizeof(l_tx0) + sizeof(l_tx1), l_tx2, sizeof(l_tx2));
+  CHECK_EQ(SIM_usartTxLen, sizeof(sent));
+  for (i = 0U; i < SIM_usartTxLen && i < sizeof(sent); i++) {
+    CHECK_EQ(SIM_usartTx[i].frame, sent[i]);
+  }
+  CHECK_EQ(USART1->IF & USART_IF_TXOF, 0U);
+  CHECK_EQ(l_done.calls, 1U);
+  teardown();
+}
+
+/* the scan results fill the buffers in list order, the callback comes with
+* the last one and not before */
+static void testPeripheralMemory(void) {
+  DMADRV_Buffer_t list[] = {
+    { l_rx0, 2 },
+    { l_rx1, 3 },
+    { l_rx2, 4 },
+  };
+  uint16_t scan[2 + 3 + 4 + 1];
+  unsigned int i;
+
+  setup();
+  for (i = 0U; i < sizeof(scan) / sizeof(scan[0]); i++) {
+    scan[i] = (uint16_t)(0x100U + i);
+  }
+  memset(l_rx0, 0, sizeof(l_rx0));
+  memset(l_rx1, 0, sizeof(l_rx1));
+  memset(l_rx2, 0, sizeof(l_rx2));
+  CHECK_EQ(DMADRV_PeripheralMemoryScatterGather(
+             l_ch, dmadrvPeripheralSignal_ADC0_SCAN, list, 3,
+             (void *)&ADC0->SCANDATA, dmadrvDataSize2, done, &l_done),
+           ECODE_EMDRV_DMADRV_OK);
+
+  SIM_adcScan(scan, 2U + 3U + 3U);
+  CHECK_EQ(l_done.calls, 0U);
+  SIM_adcScan(&scan[8], 1U);
+  CHECK_EQ(l_done.calls, 1U);
+  CHECK_EQ(l_done.sequenceNo, 1U);
+  for (i = 0U; i < 2U; i++) {
+    CHECK_EQ(l_rx0[i], scan[i]);
+  }
+  for (i = 0U; i < 3U; i++) {
+    CHECK_EQ(l_rx1[i], scan[2U + i]);
+  }
+  for (i = 0U; i < 4U; i++) {
+    CHECK_EQ(l_rx2[i], scan[5U + i]);
+  }
+
+  /* the channel is done, the next result stays in the ADC */
+  SIM_adcScan(&scan[9], 1U);
+  CHECK(ADC0->STATUS & ADC_STATUS_SCANDV);
+  CHECK_EQ(l_rx2[3], scan[8]);
+  CHECK_EQ(l_done.calls, 1U);
+  teardown();
+}
+
+/* lists that do not fit the descriptor table or hold an empty buffer */
+static void testParams(void) {
+  DMADRV_Buffer_t list[EMDRV_DMADRV_SG_MAX_BUFFERS + 1];
+  unsigned int i;
+
+  setup();
+  for (i = 0U; i < EMDRV_DMADRV_SG_MAX_BUFFERS + 1U; i++) {
+    list[i].buf = l_tx2;
+    list[i].len = 1;
+  }
+  CHECK_EQ(DMADRV_MemoryPeripheralScatterGather(
+             l_ch, dmadrvPeripheralSignal_USART1_TXBL, (void *)&USART1->TXDATA,
+             list, EMDRV_DMADRV_SG_MAX_BUFFERS + 1, dmadrvDataSize1, done,
+             &l_done),
+           ECODE_EMDRV_DMADRV_PARAM_ERROR);
+  CHECK_EQ(DMADRV_MemoryPeripheralScatterGather(
+             l_ch, dmadrvPeripheralSignal_USART1_TXBL, (void *)&USART1->TXDATA,
+             list, 0, dmadrvDataSize1, done, &l_done),
+           ECODE_EMDRV_DMADRV_PARAM_ERROR);
+  list[1].len = 0;
+  CHECK_EQ(DMADRV_PeripheralMemoryScatterGather(
+             l_ch, dmadrvPeripheralSignal_ADC0_SCAN, list, 2,
+             (void *)&ADC0->SCANDATA, dmadrvDataSize1, done, &l_done),
+           ECODE_EMDRV_DMADRV_PARAM_ERROR);
+  CHECK_EQ(DMADRV_PeripheralMemoryScatterGather(
+             DMA_CHAN_COUNT, dmadrvPeripheralSignal_ADC0_SCAN, list, 1,
+             (void *)&ADC0->SCANDATA, dmadrvDataSize1, done, &l_done),
+           ECODE_EMDRV_DMADRV_PARAM_ERROR);
+  teardown();
+}
+
+int main(void) {
+  testMemoryPeripheral();
+  testPeripheralMemory();
+  testParams();
+  return TEST_RESULT();
+}
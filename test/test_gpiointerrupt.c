@@ -0,0 +1,116 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_cmu.h"
+#include "em_core.h"
+#include "gpiointerrupt.h"
+
+/* the GPIOINT dispatcher on the simulated GPIO: edges of several pins at
+* one sync point, the callbacks run in IRQ number order (GPIO_EVEN before
+* GPIO_ODD) and by pin number within a handler. pins 1 and 2 are on port
+* C, pin 8 on port A */
+
+#define CALLS 8U
+
+static uint8_t l_calls[CALLS];
+static unsigned int l_count;
+
+static void called(uint8_t pin) {
+  if (l_count < CALLS) {
+    l_calls[l_count] = pin;
+  }
+  l_count++;
+}
+
+/* a callback that raises the edge of pin 1 on the odd handler */
+static void chained(uint8_t pin) {
+  called(pin);
+  SIM_gpioSet(gpioPortC, 1U, true);
+}
+
+static void setup(void) {
+  SIM_init();
+  CMU_ClockEnable(cmuClock_GPIO, true);
+  GPIOINT_Init();
+  GPIO_IntConfig(gpioPortC, 1U, true, false, true);
+  GPIO_IntConfig(gpioPortC, 2U, true, false, true);
+  GPIO_IntConfig(gpioPortA, 8U, false, true, true);
+  SIM_gpioSet(gpioPortA, 8U, true);
+  memset(l_calls, 0, sizeof(l_calls));
+  l_count = 0U;
+}
+
+static void teardown(void) {
+  CHECK_EQ(GPIO->IF, 0U);
+  GPIOINT_CallbackUnRegister(1U);
+  GPIOINT_CallbackUnRegister(2U);
+  GPIOINT_CallbackUnRegister(8U);
+}
+
+/* edges taken together, one callback each */
+static void testOrder(void) {
+  setup();
+  GPIOINT_CallbackRegister(1U, called);
+  GPIOINT_CallbackRegister(2U, called);
+  GPIOINT_CallbackRegister(8U, called);
+
+  __disable_irq();
+  SIM_gpioSet(gpioPortC, 1U, true);
+  SIM_gpioSet(gpioPortA, 8U, false);
+  SIM_gpioSet(gpioPortC, 2U, true);
+  CHECK_EQ(l_count, 0U);
+  __enable_irq();
+  CHECK_EQ(l_count, 3U);
+  CHECK_EQ(l_calls[0], 2U);
+  CHECK_EQ(l_calls[1], 8U);
+  CHECK_EQ(l_calls[2], 1U);
+  CHECK_EQ(SIM_irqCount[GPIO_EVEN_IRQn], 1U);
+  CHECK_EQ(SIM_irqCount[GPIO_ODD_IRQn], 1U);
+
+  /* the other edges of the pins are not enabled */
+  SIM_gpioSet(gpioPortC, 1U, false);
+  SIM_gpioSet(gpioPortA, 8U, true);
+  CHECK_EQ(l_count, 3U);
+  teardown();
+}
+
+/* a pin without a callback has its flag cleared all the same */
+static void testUnregistered(void) {
+  setup();
+  GPIOINT_CallbackRegister(2U, called);
+  GPIOINT_CallbackRegister(8U, called);
+  GPIOINT_CallbackUnRegister(8U);
+
+  SIM_gpioSet(gpioPortA, 8U, false);
+  SIM_gpioSet(gpioPortC, 1U, true);
+  CHECK_EQ(l_count, 0U);
+  CHECK_EQ(GPIO->IF, 0U);
+  CHECK_EQ(SIM_irqCount[GPIO_EVEN_IRQn], 1U);
+  CHECK_EQ(SIM_irqCount[GPIO_ODD_IRQn], 1U);
+
+  SIM_gpioSet(gpioPortC, 2U, true);
+  CHECK_EQ(l_count, 1U);
+  CHECK_EQ(l_calls[0], 2U);
+  teardown();
+}
+
+/* an edge raised by a callback is taken after its handler returns */
+static void testChained(void) {
+  setup();
+  GPIOINT_CallbackRegister(1U, called);
+  GPIOINT_CallbackRegister(2U, chained);
+
+  SIM_gpioSet(gpioPortC, 2U, true);
+  CHECK_EQ(l_count, 2U);
+  CHECK_EQ(l_calls[0], 2U);
+  CHECK_EQ(l_calls[1], 1U);
+  CHECK_EQ(SIM_irqCount[GPIO_ODD_IRQn], 1U);
+  teardown();
+}
+
+int main(void) {
+  testOrder();
+  testUnregistered();
+  testChained();
+  return TEST_RESULT();
+}
@@ -0,0 +1,234 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "ht16k33_sim.h"
+#include "test.h"
+#include "em_cmu.h"
+#include "em_dma.h"
+#include "bsp.h"
+#include "sleep.h"
+#include "display.h"
+#include "max7129.h"
+
+/* the HT16K33 backend on the simulated I2C0 with the HT16K33 slave model,
+* and the same frames through the MAX7219 backend on the simulated USART1.
+* both controllers must end up showing the framebuffer, the bus time of a
+* frame on each is reported against the frame pause of main.c. HFCLK is
+* the 14 MHz HFRCO */
+
+#define HFCLK_HZ       14000000U
+#define FRAME_PAUSE_MS 30U          /* FRAME_PAUSE_MS of main.c */
+#define FRAME_CYCLES   ((uint64_t)HFCLK_HZ / 1000U * FRAME_PAUSE_MS)
+#define IDLE_CYCLES    100U         /* over an SCL period at 350 kHz */
+#define BIT_CYCLES     14U          /* SPI bit at 1 MHz */
+
+static DMA_DESCRIPTOR_TypeDef l_dmaCtrl[DMA_CHAN_COUNT * 2]
+__attribute__((aligned(256)));
+
+static uint8_t l_max7219[16];   /* MAX7219 register file */
+static uint32_t l_decoded;      /* SIM_usartTx frames decoded */
+static uint32_t l_logged;       /* SIM_i2cLog events seen */
+
+static void setup(void) {
+  DMA_Init_TypeDef dmaInit;
+
+  SIM_init();
+  SLEEP_Init(NULL, NULL);
+  CMU_ClockEnable(cmuClock_DMA, true);
+  dmaInit.hprot = 0;
+  dmaInit.controlBlock = l_dmaCtrl;
+  DMA_Init(&dmaInit);
+  initSpi3Wire();
+  SIM_ht16k33Attach(HT16K33_ADDR);
+  memset(l_max7219, 0, sizeof(l_max7219));
+  l_decoded = 0U;
+  l_logged = 0U;
+}
+
+/* run until the bus stays idle, the transfers queued are done */
+static void i2cDrain(void) {
+  uint32_t len;
+  unsigned int i;
+
+  for (i = 0U; i < 1000U; i++) {
+    len = SIM_i2cLogLen;
+    SIM_cycles(IDLE_CYCLES);
+    if (len == SIM_i2cLogLen && I2C0->STATE == 0U) {
+      break;
+    }
+  }
+  CHECK(i < 1000U);
+}
+
+/* the I2C transfers since the last call: their number, the bus time from
+* the first START to the last STOP */
+static unsigned int i2cTransfers(uint64_t *busy) {
+  SIM_I2cEvent const *e;
+  unsigned int n = 0U;
+
+  *busy = 0U;
+  if (l_logged < SIM_i2cLogLen) {
+    *busy = SIM_i2cLog[SIM_i2cLogLen - 1U].end - SIM_i2cLog[l_logged].start;
+  }
+  for (; l_logged < SIM_i2cLogLen; l_logged++) {
+    e = &SIM_i2cLog[l_logged];
+    if (e->kind == SIM_I2C_STOP) {
+      n++;
+    }
+  }
+  return n;
+}
+
+/* the script sent and its last frame, decoded into the register file.
+* returns the bus time from the first frame to the last */
+static uint64_t maxDrain(void) {
+  SIM_UsartFrame const *f;
+  uint64_t busy = 0U;
+  unsigned int i;
+
+  MAX7219_scriptWait();
+  for (i = 0U; i < 64U && (USART1->STATUS & USART_STATUS_TXC) == 0U; i++) {
+    SIM_cycles(BIT_CYCLES);
+  }
+  CHECK(i < 64U);
+  if (l_decoded < SIM_usartTxLen) {
+    busy = SIM_usartTx[SIM_usartTxLen - 1U].end - SIM_usartTx[l_decoded].start;
+  }
+  for (; l_decoded < SIM_usartTxLen; l_decoded++) {
+    f = &SIM_usartTx[l_decoded];
+    CHECK(f->csEnd);
+    l_max7219[f->frame >> 8] = (uint8_t)f->frame;
+  }
+  return busy;
+}
+
+static void report(char const *what, uint64_t cycles) {
+  printf("%-28s %6u us, %5.2f %% of the %u ms frame pause\n", what,
+         (unsigned int)(cycles * 1000000U / HFCLK_HZ),
+         100.0 * (double)cycles / (double)FRAME_CYCLES, FRAME_PAUSE_MS);
+  CHECK(cycles < FRAME_CYCLES);
+}
+
+/* both controllers show fb, and the RAM payload on the bus from the log
+* entry from on holds the MAX7219 digits */
+static void checkShown(uint8_t const *fb, uint32_t from) {
+  SIM_I2cEvent const *e;
+  unsigned int row;
+  uint32_t i;
+  int ram = -1;   /* RAM address of the next byte sent, -1 before 0x00 */
+
+  for (row = 0U; row < DISPLAY_ROWS; row++) {
+    CHECK_EQ(SIM_ht16k33.ram[2U * row], fb[row]);
+    CHECK_EQ(SIM_ht16k33.ram[2U * row + 1U], 0U);
+    CHECK_EQ(l_max7219[MAX7219_DIGIT0 + row], fb[row]);
+  }
+  for (i = from; i < SIM_i2cLogLen; i++) {
+    e = &SIM_i2cLog[i];
+    if (e->kind == SIM_I2C_TX && e->addr) {
+      ram = -1;
+    } else if (e->kind == SIM_I2C_TX && ram < 0 && e->byte == 0x00U) {
+      ram = 0;
+    } else if (e->kind == SIM_I2C_TX && ram >= 0) {
+      if ((ram & 1) == 0) {
+        CHECK_EQ(e->byte, l_max7219[MAX7219_DIGIT0 + ram / 2]);
+      }
+      ram++;
+    }
+  }
+}
+
+/* one frame through both backends: a full frame, then one row changed */
+static void testSameFrame(void) {
+  uint8_t fb[DISPLAY_ROWS] = { 0x3CU, 0x42U, 0xA5U, 0x81U,
+                               0xA5U, 0x99U, 0x42U, 0x3CU };
+  uint64_t maxFull;
+  uint64_t maxRow;
+  uint64_t i2cFull;
+  uint64_t i2cRow;
+  uint32_t from;
+
+  setup();
+  DISPLAY_init(&DISPLAY_max7219);
+  (void)maxDrain();
+  DISPLAY_flush(fb);
+  maxFull = maxDrain();
+  fb[3] = 0xFFU;
+  DISPLAY_flush(fb);
+  maxRow = maxDrain();
+
+  fb[3] = 0x81U;
+  DISPLAY_init(&DISPLAY_ht16k33);
+  i2cDrain();
+  CHECK_EQ(i2cTransfers(&i2cFull), 1U);
+  CHECK(SIM_ht16k33.osc);
+  DISPLAY_flush(fb);
+  i2cDrain();
+  CHECK_EQ(i2cTransfers(&i2cFull), 1U);
+  fb[3] = 0xFFU;
+  from = SIM_i2cLogLen;
+  DISPLAY_flush(fb);
+  i2cDrain();
+  CHECK_EQ(i2cTransfers(&i2cRow), 1U);
+  checkShown(fb, from);
+
+  report("MAX7219 full frame", maxFull);
+  report("MAX7219 one row", maxRow);
+  report("HT16K33 full frame", i2cFull);
+  report("HT16K33 one row (full RAM)", i2cRow);
+  /* the HT16K33 sends the whole RAM every time */
+  CHECK_EQ(i2cRow, i2cFull);
+  CHECK(maxRow < maxFull);
+}
+
+/* a NACKed command is marked dirty, sent again with the next frame */
+static void testCommandNack(void) {
+  uint8_t fb[DISPLAY_ROWS] = { 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U };
+  unsigned int i;
+
+  setup();
+  DISPLAY_init(&DISPLAY_ht16k33);
+  i2cDrain();
+  CHECK_EQ(SIM_ht16k33.dimming, DISPLAY_BRIGHT_MAX);
+
+  SIM_ht16k33NackAt(1U);
+  DISPLAY_brightness(5U);
+  i2cDrain();
+  CHECK_EQ(SIM_ht16k33.dimming, DISPLAY_BRIGHT_MAX);
+  /* not from the failed transfer's callback. the setup took three */
+  CHECK_EQ(SIM_ht16k33.writes, 3U + 1U);
+
+  DISPLAY_flush(fb);
+  i2cDrain();
+  CHECK_EQ(SIM_ht16k33.dimming, 5U);
+  CHECK_EQ(SIM_ht16k33.writes, 3U + 1U + 2U);
+  for (i = 0U; i < DISPLAY_ROWS; i++) {
+    CHECK_EQ(SIM_ht16k33.ram[2U * i], fb[i]);
+  }
+  CHECK_EQ(DISPLAY_lost(), 0U);
+}
+
+/* a command the full queue refused is sent again once a transfer is done,
+* without another frame */
+static void testQueueFull(void) {
+  uint8_t fb[DISPLAY_ROWS] = { 0U };
+  unsigned int i;
+
+  setup();
+  DISPLAY_init(&DISPLAY_ht16k33);
+  i2cDrain();
+  DISPLAY_flush(fb);
+  for (i = 0U; i < 3U; i++) {
+    DISPLAY_brightness((uint8_t)(8U + i));
+  }
+  CHECK(DISPLAY_blink(2U));
+  i2cDrain();
+  CHECK_EQ(SIM_ht16k33.dimming, 10U);
+  CHECK_EQ(SIM_ht16k33.display, 1U | (2U << 1));
+  CHECK_EQ(SIM_ht16k33.writes, 3U + 1U + 3U + 1U);
+}
+
+int main(void) {
+  testSameFrame();
+  testCommandNack();
+  testQueueFull();
+  return TEST_RESULT();
+}
@@ -0,0 +1,377 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "ht16k33_sim.h"
+#include "test.h"
+#include "em_cmu.h"
+#include "sleep.h"
+#include "i2cdrv.h"
+
+/* I2CDRV on the simulated I2C0 with an HT16K33 at its address. built twice:
+* test_i2cdrv sends every byte from the I2C interrupt, test_i2cdrv_dma with
+* EMDRV_I2CDRV_DMA_THRESHOLD 4 lets DMADRV write the longer segments.
+* HFPERCLK is the 14 MHz HFRCO, the bus log of the simulation is checked
+* byte by byte. the DMA descriptors hold 32 bit pointers: the buffers sent
+* are statics */
+
+#define ADDR      (0x70U << 1)
+#define ADDR_NONE (0x38U << 1)  /* no slave there */
+#define HFPER_HZ  14000000U
+
+typedef struct {
+    unsigned int calls;
+    Ecode_t status;
+    unsigned int order;  /* completion order among the transfers */
+} Done;
+
+static I2CDRV_HandleData_t l_i2c;
+static unsigned int l_completed;
+static uint32_t l_logged;   /* SIM_i2cLog entries checked */
+
+static void done(I2CDRV_Handle_t handle, Ecode_t status, void *user) {
+  Done *d = user;
+
+  CHECK(handle == &l_i2c);
+  d->calls++;
+  d->status = status;
+  d->order = l_completed++;
+}
+
+static void setup(uint32_t bitRate, I2C_ClockHLR_TypeDef clhr) {
+  I2CDRV_Init_t init = I2CDRV_MASTER_I2C0;
+
+  SIM_init();
+  SLEEP_Init(NULL, NULL);
+  SIM_ht16k33Attach(ADDR);
+  init.bitRate = bitRate;
+  init.clhr = clhr;
+  CHECK_EQ(I2CDRV_Init(&l_i2c, &init), ECODE_EMDRV_I2CDRV_OK);
+  l_completed = 0U;
+  l_logged = 0U;
+}
+
+static void teardown(void) {
+  CHECK_EQ(I2CDRV_DeInit(&l_i2c), ECODE_EMDRV_I2CDRV_OK);
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+  CHECK_EQ(DMADRV_DeInit(), ECODE_EMDRV_DMADRV_OK);
+#endif
+  CHECK_EQ(I2C0->IF & I2C_IF_TXOF, 0U);
+}
+
+/* HFCLK cycles of an SCL period, from the divider I2C_BusFreqSet() chose */
+static uint32_t period(void) {
+  static uint8_t const nSum[] = { 4 + 4, 6 + 3, 11 + 6, 4 + 4 };
+
+  return nSum[(I2C0->CTRL & _I2C_CTRL_CLHR_MASK) >> _I2C_CTRL_CLHR_SHIFT]
+         * (I2C0->CLKDIV + 1U) + 4U;
+}
+
+/* wait until the transfers queued are done, at most cycles */
+static void drain(uint32_t cycles) {
+  int count = 1;
+
+  while (cycles > 0U && count > 0) {
+    SIM_cycles(period());
+    cycles = cycles > period() ? cycles - period() : 0U;
+    CHECK_EQ(I2CDRV_GetQueueCount(&l_i2c, &count), ECODE_EMDRV_I2CDRV_OK);
+  }
+  CHECK_EQ(count, 0);
+}
+
+/* the next bus event, NULL if there is none */
+static SIM_I2cEvent const *next(SIM_I2cKind kind) {
+  SIM_I2cEvent const *e;
+
+  CHECK(l_logged < SIM_i2cLogLen);
+  if (l_logged >= SIM_i2cLogLen) {
+    return NULL;
+  }
+  e = &SIM_i2cLog[l_logged++];
+  CHECK_EQ(e->kind, kind);
+  return e;
+}
+
+static void expectStart(uint8_t addr, bool ack) {
+  SIM_I2cEvent const *e;
+
+  (void)next(SIM_I2C_START);
+  e = next(SIM_I2C_TX);
+  if (e != NULL) {
+    CHECK(e->addr);
+    CHECK_EQ(e->byte, addr);
+    CHECK_EQ(e->ack, ack);
+  }
+}
+
+static void expectTx(uint8_t const *data, unsigned int n, unsigned int nackAt) {
+  SIM_I2cEvent const *e;
+  unsigned int i;
+
+  for (i = 0U; i < n; i++) {
+    e = next(SIM_I2C_TX);
+    if (e != NULL) {
+      CHECK(!e->addr);
+      CHECK_EQ(e->byte, data[i]);
+      CHECK_EQ(e->ack, i + 1U != nackAt);
+    }
+  }
+}
+
+/* bytes in, the master ACKs all but the last */
+static void expectRx(uint8_t const *data, unsigned int n) {
+  SIM_I2cEvent const *e;
+  unsigned int i;
+
+  for (i = 0U; i < n; i++) {
+    e = next(SIM_I2C_RX);
+    if (e != NULL) {
+      CHECK_EQ(e->byte, data[i]);
+      CHECK_EQ(e->ack, i + 1U < n);
+    }
+  }
+}
+
+static void expectEnd(void) {
+  (void)next(SIM_I2C_STOP);
+  CHECK_EQ(l_logged, SIM_i2cLogLen);
+}
+
+/* the display RAM in one burst, then three commands with repeated STARTs */
+static void testWrite(void) {
+  static uint8_t const setup3[] = { 0x21U, 0x81U, 0xEFU };
+  static uint8_t ram[17];
+  I2CDRV_Transfer_t t = {
+    ADDR, i2cdrvTransferWrite, ram, sizeof(ram), 0U, NULL, 0U, NULL, NULL
+  };
+  unsigned int i;
+
+  setup(I2C_FREQ_FAST_MAX, i2cClockHLRAsymetric);
+  ram[0] = 0x00U;
+  for (i = 1U; i < sizeof(ram); i++) {
+    ram[i] = (uint8_t)(0x11U * i);
+  }
+  CHECK_EQ(I2CDRV_TransferB(&l_i2c, &t), ECODE_EMDRV_I2CDRV_OK);
+  CHECK(memcmp(SIM_ht16k33.ram, &ram[1], sizeof(SIM_ht16k33.ram)) == 0);
+#if (EMDRV_I2CDRV_DMA_THRESHOLD > 0)
+  CHECK(SIM_irqCount[DMA_IRQn] > 0U);
+#else
+  CHECK_EQ(SIM_irqCount[DMA_IRQn], 0U);
+#endif
+  expectStart(ADDR, true);
+  expectTx(ram, sizeof(ram), 0U);
+  expectEnd();
+
+  t.txBuffer = setup3;
+  t.txCount = sizeof(setup3);
+  t.txSegment = 1U;
+  CHECK_EQ(I2CDRV_TransferB(&l_i2c, &t), ECODE_EMDRV_I2CDRV_OK);
+  for (i = 0U; i < sizeof(setup3); i++) {
+    expectStart(ADDR, true);
+    expectTx(&setup3[i], 1U, 0U);
+  }
+  expectEnd();
+  CHECK(SIM_ht16k33.osc);
+  CHECK_EQ(SIM_ht16k33.display, 1U);
+  CHECK_EQ(SIM_ht16k33.dimming, 15U);
+  CHECK_EQ(SIM_ht16k33.writes, 4U);
+  /* EM2 is blocked only while transfers are queued */
+  CHECK_EQ(SLEEP_LowestEnergyModeGet(), sleepEM3);
+  teardown();
+}
+
+/* the RAM address, a repeated START and the RAM read back. a one byte read
+* is NACKed at once */
+static void testRead(void) {
+  static uint8_t const ptr[] = { 0x02U };
+  uint8_t rx[4];
+  I2CDRV_Transfer_t t = {
+    ADDR, i2cdrvTransferWriteRead, ptr, sizeof(ptr), 0U, rx, sizeof(rx),
+    NULL, NULL
+  };
+  unsigned int i;
+
+  setup(I2C_FREQ_FAST_MAX, i2cClockHLRAsymetric);
+  for (i = 0U; i < sizeof(SIM_ht16k33.ram); i++) {
+    SIM_ht16k33.ram[i] = (uint8_t)(0xA0U + i);
+  }
+  CHECK_EQ(I2CDRV_TransferB(&l_i2c, &t), ECODE_EMDRV_I2CDRV_OK);
+  CHECK(memcmp(rx, &SIM_ht16k33.ram[2], sizeof(rx)) == 0);
+  expectStart(ADDR, true);
+  expectTx(ptr, sizeof(ptr), 0U);
+  expectStart(ADDR | 1U, true);
+  expectRx(rx, sizeof(rx));
+  expectEnd();
+
+  t.type = i2cdrvTransferRead;
+  t.rxCount = 1U;
+  CHECK_EQ(I2CDRV_TransferB(&l_i2c, &t), ECODE_EMDRV_I2CDRV_OK);
+  CHECK_EQ(rx[0], SIM_ht16k33.ram[6]);
+  expectStart(ADDR | 1U, true);
+  expectRx(rx, 1U);
+  expectEnd();
+  teardown();
+}
+
+/* no slave at the address, a byte NACKed in the middle of a burst. the
+* transfer ends with STOP, the next one runs */
+static void testNack(void) {
+  static uint8_t const data[8] = { 0x00U, 1U, 2U, 3U, 4U, 5U, 6U, 7U };
+  I2CDRV_Transfer_t t = {
+    ADDR_NONE, i2cdrvTransferWrite, data, sizeof(data), 0U, NULL, 0U,
+    NULL, NULL
+  };
+
+  setup(I2C_FREQ_FAST_MAX, i2cClockHLRAsymetric);
+  CHECK_EQ(I2CDRV_TransferB(&l_i2c, &t), ECODE_EMDRV_I2CDRV_NACK);
+  expectStart(ADDR_NONE, false);
+  expectEnd();
+
+  t.addr = ADDR;
+  SIM_ht16k33NackAt(4U);
+  CHECK_EQ(I2CDRV_TransferB(&l_i2c, &t), ECODE_EMDRV_I2CDRV_NACK);
+  expectStart(ADDR, true);
+  expectTx(data, 4U, 4U);
+  expectEnd();
+  CHECK_EQ(SIM_ht16k33.ram[1], 2U);
+  CHECK_EQ(SIM_ht16k33.ram[2], 0U);
+
+  CHECK_EQ(I2CDRV_TransferB(&l_i2c, &t), ECODE_EMDRV_I2CDRV_OK);
+  expectStart(ADDR, true);
+  expectTx(data, sizeof(data), 0U);
+  expectEnd();
+  CHECK_EQ(SIM_ht16k33.ram[6], 7U);
+  teardown();
+}
+
+/* another master wins the address byte and keeps the bus. the abort from
+* the interrupt handler returns, the next transfer waits for the bus */
+static void testArbLost(void) {
+  static uint8_t const data[] = { 0x00U, 0x55U, 0xAAU, 0x55U, 0xAAU };
+  I2CDRV_Transfer_t t = {
+    ADDR, i2cdrvTransferWrite, data, sizeof(data), 0U, NULL, 0U, done, NULL
+  };
+  Done lost = { 0U, ECODE_OK, 0U };
+  Done waited = { 0U, ECODE_OK, 0U };
+  uint32_t logged;
+
+  setup(I2C_FREQ_FAST_MAX, i2cClockHLRAsymetric);
+  SIM_i2cArbLost();
+  t.userParam = &lost;
+  CHECK_EQ(I2CDRV_QueueTransfer(&l_i2c, &t), ECODE_EMDRV_I2CDRV_OK);
+  t.userParam = &waited;
+  CHECK_EQ(I2CDRV_QueueTransfer(&l_i2c, &t), ECODE_EMDRV_I2CDRV_OK);
+  SIM_cycles(100U * period());
+  CHECK_EQ(lost.calls, 1U);
+  CHECK_EQ(lost.status, ECODE_EMDRV_I2CDRV_ARB_LOST);
+  CHECK_EQ(waited.calls, 0U);
+  (void)next(SIM_I2C_START);
+  (void)next(SIM_I2C_TX);
+  /* no START while the other master holds the bus */
+  logged = SIM_i2cLogLen;
+  CHECK_EQ(l_logged, logged);
+  CHECK(I2C0->STATE & I2C_STATE_BUSY);
+
+  SIM_i2cRelease();
+  drain(100U * period());
+  CHECK_EQ(waited.calls, 1U);
+  CHECK_EQ(waited.status, ECODE_EMDRV_I2CDRV_OK);
+  expectStart(ADDR, true);
+  expectTx(data, sizeof(data), 0U);
+  expectEnd();
+  teardown();
+}
+
+/* EMDRV_I2CDRV_QUEUE_SIZE transfers queued, one more is refused. they
+* complete in order */
+static void testQueueFull(void) {
+  static uint8_t const cmd[EMDRV_I2CDRV_QUEUE_SIZE] = { 0xE0U, 0xE1U, 0xE2U, 0xE3U };
+  I2CDRV_Transfer_t t = {
+    ADDR, i2cdrvTransferWrite, NULL, 1U, 0U, NULL, 0U, done, NULL
+  };
+  Done d[EMDRV_I2CDRV_QUEUE_SIZE + 1U];
+  unsigned int i;
+  int count;
+
+  setup(I2C_FREQ_FAST_MAX, i2cClockHLRAsymetric);
+  memset(d, 0, sizeof(d));
+  for (i = 0U; i <= EMDRV_I2CDRV_QUEUE_SIZE; i++) {
+    t.txBuffer = &cmd[i % EMDRV_I2CDRV_QUEUE_SIZE];
+    t.userParam = &d[i];
+    CHECK_EQ(I2CDRV_QueueTransfer(&l_i2c, &t),
+             i < EMDRV_I2CDRV_QUEUE_SIZE ? ECODE_EMDRV_I2CDRV_OK
+                                         : ECODE_EMDRV_I2CDRV_QUEUE_FULL);
+  }
+  CHECK_EQ(I2CDRV_GetQueueCount(&l_i2c, &count), ECODE_EMDRV_I2CDRV_OK);
+  CHECK_EQ(count, EMDRV_I2CDRV_QUEUE_SIZE);
+  CHECK_EQ(SLEEP_LowestEnergyModeGet(), sleepEM1);
+  drain(EMDRV_I2CDRV_QUEUE_SIZE * 20U * period());
+  for (i = 0U; i < EMDRV_I2CDRV_QUEUE_SIZE; i++) {
+    CHECK_EQ(d[i].calls, 1U);
+    CHECK_EQ(d[i].status, ECODE_EMDRV_I2CDRV_OK);
+    CHECK_EQ(d[i].order, i);
+    expectStart(ADDR, true);
+    expectTx(&cmd[i], 1U, 0U);
+    (void)next(SIM_I2C_STOP);
+  }
+  CHECK_EQ(l_logged, SIM_i2cLogLen);
+  CHECK_EQ(d[EMDRV_I2CDRV_QUEUE_SIZE].calls, 0U);
+  CHECK_EQ(SIM_ht16k33.dimming, 3U);
+  CHECK_EQ(SLEEP_LowestEnergyModeGet(), sleepEM3);
+  teardown();
+}
+
+/* START, STOP and a byte with its ACK bit take 1, 1 and 9 SCL periods. the
+* divider is rounded so the bus is not faster than asked for */
+static void testTiming(void) {
+  static struct {
+    uint32_t hz;
+    I2C_ClockHLR_TypeDef clhr;
+  } const rate[] = {
+    { 100000U, i2cClockHLRStandard },
+    { I2C_FREQ_FAST_MAX, i2cClockHLRAsymetric },
+    { I2C_FREQ_FASTPLUS_MAX, i2cClockHLRAsymetric }
+  };
+  static uint8_t const data[] = { 0x00U, 0x01U, 0x02U, 0x04U, 0x08U };
+  I2CDRV_Transfer_t t = {
+    ADDR, i2cdrvTransferWrite, data, sizeof(data), 0U, NULL, 0U, NULL, NULL
+  };
+  SIM_I2cEvent const *e;
+  uint64_t begin;
+  uint32_t p;
+  uint32_t i;
+  unsigned int r;
+
+  for (r = 0U; r < sizeof(rate) / sizeof(rate[0]); r++) {
+    setup(rate[r].hz, rate[r].clhr);
+    p = period();
+    CHECK_EQ(I2C_BusFreqGet(I2C0), HFPER_HZ / p);
+    CHECK(HFPER_HZ / p <= rate[r].hz);
+    begin = SIM_cycleNow();
+    CHECK_EQ(I2CDRV_TransferB(&l_i2c, &t), ECODE_EMDRV_I2CDRV_OK);
+    printf("%u Hz asked for, %u Hz: %u bytes in %llu cycles\n",
+           (unsigned int)rate[r].hz, (unsigned int)(HFPER_HZ / p),
+           (unsigned int)sizeof(data) + 1U,
+           (unsigned long long)(SIM_cycleNow() - begin));
+    for (i = 0U; i < SIM_i2cLogLen; i++) {
+      e = &SIM_i2cLog[i];
+      CHECK_EQ(e->end - e->start, (e->kind == SIM_I2C_TX ? 9U : 1U) * p);
+      if (i > 0U) {
+        CHECK(e->start >= SIM_i2cLog[i - 1U].end);
+      }
+    }
+    /* the bytes follow each other without a gap */
+    CHECK_EQ(SIM_i2cLogLen, sizeof(data) + 3U);
+    CHECK_EQ(SIM_i2cLog[SIM_i2cLogLen - 1U].end - SIM_i2cLog[0].start,
+             (2U + 9U * (sizeof(data) + 1U)) * p);
+    teardown();
+  }
+}
+
+int main(void) {
+  testWrite();
+  testRead();
+  testNack();
+  testArbLost();
+  testQueueFull();
+  testTiming();
+  return TEST_RESULT();
+}
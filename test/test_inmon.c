@@ -0,0 +1,211 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_core.h"
+#include "em_cmu.h"
+#include "em_gpio.h"
+#include "em_rtc.h"
+#include "rtcdriver.h"
+#include "sched.h"
+#include "inmon.h"
+
+/* input monitor decoding simulated GPIO edges, events to a task */
+
+#define PRIO 0U
+#define SIG  7U
+
+static INMON_Input const l_inputs[] = {
+  { gpioPortC, 1U, INMON_EDGE_RISING }
+};
+
+static INMON_Transition const l_transitions[] = {
+  { 0U, 0U, INMON_EDGE_RISING, 0U, INMON_START, 1U }
+};
+
+static INMON_Config const l_config = {
+  l_inputs, 1U, l_transitions, 1U, 1U, PRIO, SIG
+};
+
+/* a button A and a sensor B: B rising while A is held, A released with
+* or without B seen. durations from the press of A */
+enum { IN_A, IN_B };
+enum { IDLE, HELD, BOTH };
+enum { EV_B = 1U, EV_SHORT, EV_LONG };
+
+static INMON_Input const l_inputs2[] = {
+  { gpioPortC, 1U, INMON_EDGE_ANY },
+  { gpioPortC, 0U, INMON_EDGE_ANY },
+};
+
+static INMON_Transition const l_transitions3[] = {
+  { IDLE, IN_A, INMON_EDGE_RISING,  HELD, INMON_START, INMON_NO_EVENT },
+  { HELD, IN_B, INMON_EDGE_RISING,  BOTH, 0U,          EV_B },
+  { HELD, IN_A, INMON_EDGE_FALLING, IDLE, 0U,          EV_SHORT },
+  { BOTH, IN_B, INMON_EDGE_FALLING, HELD, 0U,          INMON_NO_EVENT },
+  { BOTH, IN_A, INMON_EDGE_FALLING, IDLE, 0U,          EV_LONG },
+};
+
+static INMON_Config const l_config3 = {
+  l_inputs2, 2U, l_transitions3, 5U, 2U, PRIO, SIG
+};
+
+/* an edge delay RTC counts after the one before, the event it records and
+* its duration */
+typedef struct {
+    uint32_t delay;
+    uint8_t input;
+    bool level;
+    uint8_t event;
+    uint32_t duration;
+} Step;
+
+static Step const l_script[] = {
+  { 5U,  IN_B, true,  INMON_NO_EVENT, 0U },  /* no transition in IDLE */
+  { 3U,  IN_B, false, INMON_NO_EVENT, 0U },
+  { 10U, IN_A, true,  INMON_NO_EVENT, 0U },
+  { 7U,  IN_B, true,  EV_B,           7U },
+  { 4U,  IN_B, false, INMON_NO_EVENT, 0U },
+  { 6U,  IN_B, true,  EV_B,           17U },
+  { 9U,  IN_A, false, EV_LONG,        26U },
+  { 20U, IN_A, true,  INMON_NO_EVENT, 0U },
+  { 12U, IN_A, false, EV_SHORT,       12U },
+};
+
+#define SCRIPT_EVENTS 4U
+
+static unsigned int l_posts;  /* SIG dispatched */
+static unsigned int l_events; /* events read */
+static INMON_Event l_log[INMON_MAX_EVENTS];
+
+void GPIO_ODD_IRQHandler(void) {
+  INMON_irq(GPIO_IntGetEnabled() & 0xAAAAU);
+}
+
+void GPIO_EVEN_IRQHandler(void) {
+  INMON_irq(GPIO_IntGetEnabled() & 0x5555U);
+}
+
+static void task(uint8_t sig) {
+  INMON_Event e;
+
+  if (sig != SIG) {
+    return;
+  }
+  l_posts++;
+  while (INMON_read(&e)) {
+    if (l_events < INMON_MAX_EVENTS) {
+      l_log[l_events] = e;
+    }
+    l_events++;
+  }
+}
+
+static void pulse(void) {
+  SIM_gpioSet(gpioPortC, 1U, true);
+  SIM_gpioSet(gpioPortC, 1U, false);
+}
+
+static void dispatch(void) {
+  SIM_RUN(1U, SCHED_run());
+}
+
+static void setup(INMON_Config const *config) {
+  SIM_init();
+  SCHED_init();
+  SCHED_taskStart(PRIO, task);
+  l_posts = 0U;
+  l_events = 0U;
+  CHECK(INMON_start(config));
+}
+
+/* SCHED_init() starts RTCDRV once */
+static void teardown(void) {
+  RTCDRV_DeInit();
+}
+
+/* a rising edge only input reads as rising even when the pin is low
+* again by the time the interrupt runs */
+static void testSingleEdge(void) {
+  CORE_DECLARE_IRQ_STATE;
+
+  setup(&l_config);
+  pulse();
+  CORE_ENTER_ATOMIC();
+  pulse();
+  CORE_EXIT_ATOMIC();
+  dispatch();
+  /* one post, the task reads both */
+  CHECK_EQ(l_posts, 1U);
+  CHECK_EQ(l_events, 2U);
+  CHECK_EQ(l_log[0].event, 1U);
+  CHECK_EQ(l_log[1].event, 1U);
+  CHECK_EQ(INMON_lost(), 0U);
+  teardown();
+}
+
+/* the batch post refused by the full task queue goes out with the next
+* event */
+static void testPostRetry(void) {
+  unsigned int i;
+
+  setup(&l_config);
+  for (i = 0U; i < SCHED_QUEUE_LEN; i++) {
+    CHECK(SCHED_post(PRIO, 0U));
+  }
+  pulse();
+  dispatch();
+  CHECK_EQ(l_posts, 0U);
+
+  pulse();
+  dispatch();
+  CHECK_EQ(l_posts, 1U);
+  CHECK_EQ(l_events, 2U);
+  teardown();
+}
+
+/* the script through the three state decoder: the events of the
+* transitions taken, at the RTC count of their edge, with the time since
+* the press of A. one post for the batch of two, the task reads all */
+static void testStates(void) {
+  uint32_t ticks;   /* LFCLK ticks per RTC count */
+  uint32_t at[SCRIPT_EVENTS];
+  Step const *step;
+  unsigned int n = 0U;
+  unsigned int i;
+
+  setup(&l_config3);
+  ticks = SIM_LFCLK_HZ / CMU_ClockFreqGet(cmuClock_RTC);
+  for (i = 0U; i < sizeof(l_script) / sizeof(l_script[0]); i++) {
+    step = &l_script[i];
+    SIM_advance(step->delay * ticks);
+    SIM_gpioSet(gpioPortC, l_inputs2[step->input].pin, step->level);
+    if (step->event != INMON_NO_EVENT && n < SCRIPT_EVENTS) {
+      at[n++] = RTC_CounterGet();
+    }
+  }
+  CHECK_EQ(n, SCRIPT_EVENTS);
+  dispatch();
+  CHECK_EQ(l_posts, 1U);
+  CHECK_EQ(l_events, SCRIPT_EVENTS);
+
+  n = 0U;
+  for (i = 0U; i < sizeof(l_script) / sizeof(l_script[0]); i++) {
+    step = &l_script[i];
+    if (step->event == INMON_NO_EVENT || n >= SCRIPT_EVENTS) {
+      continue;
+    }
+    CHECK_EQ(l_log[n].event, step->event);
+    CHECK_EQ(l_log[n].time, at[n]);
+    CHECK_EQ(l_log[n].duration, step->duration);
+    n++;
+  }
+  CHECK_EQ(INMON_lost(), 0U);
+  teardown();
+}
+
+int main(void) {
+  testSingleEdge();
+  testPostRetry();
+  testStates();
+  return TEST_RESULT();
+}
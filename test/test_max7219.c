@@ -0,0 +1,128 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_cmu.h"
+#include "em_dma.h"
+#include "bsp.h"
+#include "sleep.h"
+#include "display.h"
+#include "max7129.h"
+
+/* the MAX7219 backend through the DMA and the simulated USART1. the frames
+* sent are decoded back into the register file of the MAX7219, which
+* latches the 16 bit shift register when CS rises. USART_InitSync() sets
+* 1 MHz from the 14 MHz HFRCO: a bit takes 14 HFCLK cycles */
+
+#define BIT_CYCLES   14U
+#define FRAME_CYCLES (16U * BIT_CYCLES)
+#define UNSET        0xFFFFU
+
+static DMA_DESCRIPTOR_TypeDef l_dmaCtrl[DMA_CHAN_COUNT * 2]
+__attribute__((aligned(256)));
+
+static uint16_t l_reg[16];
+static uint32_t l_decoded;   /* frames of SIM_usartTx decoded */
+
+/* wait for the script and its last frame, which is still sent when the
+* DMA cycle is done */
+static void drain(void) {
+  unsigned int i;
+
+  MAX7219_scriptWait();
+  for (i = 0U; i < 64U && (USART1->STATUS & USART_STATUS_TXC) == 0U; i++) {
+    SIM_cycles(BIT_CYCLES);
+  }
+  CHECK(i < 64U);
+}
+
+/* the register writes of the frames sent since the last call, returns
+* their number. every frame is latched on its own */
+static unsigned int decode(void) {
+  SIM_UsartFrame const *f;
+  unsigned int n = 0U;
+
+  for (; l_decoded < SIM_usartTxLen; l_decoded++, n++) {
+    f = &SIM_usartTx[l_decoded];
+    CHECK(f->csEnd);
+    CHECK_EQ(f->end - f->start, FRAME_CYCLES);
+    if (l_decoded > 0U) {
+      CHECK(f->start >= SIM_usartTx[l_decoded - 1U].end);
+    }
+    if (f->csEnd) {
+      l_reg[f->frame >> 8] = f->frame & 0xFFU;
+    }
+  }
+  return n;
+}
+
+static void setup(void) {
+  DMA_Init_TypeDef dmaInit;
+
+  SIM_init();
+  SLEEP_Init(NULL, NULL);
+  CMU_ClockEnable(cmuClock_DMA, true);
+  dmaInit.hprot = 0;
+  dmaInit.controlBlock = l_dmaCtrl;
+  DMA_Init(&dmaInit);
+  initSpi3Wire();
+  memset(l_reg, 0xFF, sizeof(l_reg));
+  l_decoded = 0U;
+}
+
+/* the init script and full brightness, then a change of brightness */
+static void testInit(void) {
+  setup();
+  DISPLAY_init(&DISPLAY_max7219);
+  drain();
+  CHECK_EQ(decode(), 5U);
+  CHECK_EQ(l_reg[MAX7219_DISPLAY_TEST], 0U);
+  CHECK_EQ(l_reg[MAX7219_DECODE_MODE], 0U);
+  CHECK_EQ(l_reg[MAX7219_SCAN_LIMIT], 7U);
+  CHECK_EQ(l_reg[MAX7219_SHUTDOWN], 1U);
+  CHECK_EQ(l_reg[MAX7219_INTENSITY], DISPLAY_BRIGHT_MAX);
+  CHECK_EQ(l_reg[MAX7219_DIGIT0], UNSET);
+
+  DISPLAY_brightness(6U);
+  drain();
+  CHECK_EQ(decode(), 1U);
+  CHECK_EQ(l_reg[MAX7219_INTENSITY], 6U);
+  DISPLAY_brightness(DISPLAY_BRIGHT_MAX + 1U);
+  drain();
+  CHECK_EQ(decode(), 1U);
+  CHECK_EQ(l_reg[MAX7219_INTENSITY], DISPLAY_BRIGHT_MAX);
+}
+
+/* a frame sends every row, the next one the rows that changed */
+static void testFrame(void) {
+  uint8_t fb[DISPLAY_ROWS] = { 0x81U, 0x42U, 0x24U, 0x18U,
+                               0x18U, 0x24U, 0x42U, 0x81U };
+  unsigned int row;
+
+  setup();
+  DISPLAY_init(&DISPLAY_max7219);
+  drain();
+  (void)decode();
+
+  DISPLAY_flush(fb);
+  drain();
+  CHECK_EQ(decode(), DISPLAY_ROWS);
+  for (row = 0U; row < DISPLAY_ROWS; row++) {
+    CHECK_EQ(l_reg[MAX7219_DIGIT0 + row], fb[row]);
+  }
+
+  fb[2] = 0xFFU;
+  fb[5] = 0x00U;
+  DISPLAY_flush(fb);
+  drain();
+  CHECK_EQ(decode(), 4U);
+  for (row = 0U; row < DISPLAY_ROWS; row++) {
+    CHECK_EQ(l_reg[MAX7219_DIGIT0 + row], fb[row]);
+  }
+  CHECK_EQ(USART1->IF & USART_IF_TXOF, 0U);
+}
+
+int main(void) {
+  testInit();
+  testFrame();
+  return TEST_RESULT();
+}
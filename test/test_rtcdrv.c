@@ -0,0 +1,85 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_core.h"
+#include "sleep.h"
+#include "rtcdriver.h"
+
+/* RTCDRV timers in simulated time, the core sleeps in between */
+
+static uint64_t l_fired[4];
+static unsigned int l_count[4];
+
+static void expired(RTCDRV_TimerID_t id, void *user) {
+  unsigned int i = (unsigned int)(uintptr_t)user;
+
+  (void)id;
+  l_fired[i] = SIM_now();
+  l_count[i]++;
+}
+
+static void idle(void) {
+  for (;;) {
+    SLEEP_Sleep();
+  }
+}
+
+static void setup(void) {
+  SIM_init();
+  SLEEP_Init(NULL, NULL);
+  RTCDRV_Init();
+  memset(l_fired, 0, sizeof(l_fired));
+  memset(l_count, 0, sizeof(l_count));
+}
+
+static void teardown(void) {
+  RTCDRV_TimerID_t id;
+
+  for (id = 0U; id < EMDRV_RTCDRV_NUM_TIMERS; id++) {
+    (void)RTCDRV_FreeTimer(id);
+  }
+  RTCDRV_DeInit();
+}
+
+static void testOneshot(void) {
+  RTCDRV_TimerID_t id;
+
+  setup();
+  CHECK_EQ(RTCDRV_AllocateTimer(&id), ECODE_EMDRV_RTCDRV_OK);
+  CHECK_EQ(RTCDRV_StartTimer(id, rtcdrvTimerTypeOneshot, 100U, expired,
+                             (void *)0), ECODE_EMDRV_RTCDRV_OK);
+  SIM_RUN(SIM_LFCLK_HZ, idle());
+  CHECK_EQ(l_count[0], 1U);
+  /* 100 ms, within one prescaled tick */
+  CHECK_RANGE(l_fired[0], 3277U - 8U, 3277U + 8U);
+  teardown();
+}
+
+static void testPeriodic(void) {
+  RTCDRV_TimerID_t fast;
+  RTCDRV_TimerID_t slow;
+
+  setup();
+  CHECK_EQ(RTCDRV_AllocateTimer(&fast), ECODE_EMDRV_RTCDRV_OK);
+  CHECK_EQ(RTCDRV_AllocateTimer(&slow), ECODE_EMDRV_RTCDRV_OK);
+  CHECK_EQ(RTCDRV_StartTimer(fast, rtcdrvTimerTypePeriodic, 10U, expired,
+                             (void *)0), ECODE_EMDRV_RTCDRV_OK);
+  CHECK_EQ(RTCDRV_StartTimer(slow, rtcdrvTimerTypePeriodic, 250U, expired,
+                             (void *)1), ECODE_EMDRV_RTCDRV_OK);
+  /* the 10 ms period is 41 prescaled ticks, 10.01 ms */
+  SIM_RUN(SIM_LFCLK_HZ + SIM_LFCLK_HZ / 100U, idle());
+  CHECK_EQ(l_count[0], 100U);
+  CHECK_EQ(l_count[1], 4U);
+
+  RTCDRV_StopTimer(fast);
+  SIM_RUN(SIM_LFCLK_HZ, idle());
+  CHECK_EQ(l_count[0], 100U);
+  CHECK_EQ(l_count[1], 8U);
+  teardown();
+}
+
+int main(void) {
+  testOneshot();
+  testPeriodic();
+  return TEST_RESULT();
+}
@@ -0,0 +1,193 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_gpio.h"
+#include "sleep.h"
+#include "rtcdriver.h"
+
+/* RTCDRV built with EMDRV_NVIC_SECTIONS, instrumented by rtcdrv_probe.h.
+* at random RTC accesses of the driver a GPIO interrupt is raised:
+*   GPIO_ODD  outside the driver sections, runs at once and takes time, so
+*             the driver may set a compare value that has passed already
+*   GPIO_EVEN listed in EMDRV_RTCDRV_SECTION_EXTRA_IRQS, starts and stops
+*             a timer of its own and must wait for the section to end
+* every timer fires once in time, a stopped timer does not fire */
+
+#define ODD_PIN   1U
+#define EVEN_PIN  2U
+#define BURN_MAX  64U  /* LFCLK ticks GPIO_ODD_IRQHandler() takes at most */
+#define TIMERS    3U   /* two started from main, one from GPIO_EVEN */
+#define ROUNDS    2000U
+
+/* ms timeout to LFCLK ticks, RTCDRV counts in LFCLK / 8 */
+#define MS_TO_LF(ms) ((uint64_t)(ms) * SIM_LFCLK_HZ / 1000U)
+#define SLACK        16U
+
+typedef struct {
+    RTCDRV_TimerID_t id;
+    bool armed;
+    uint64_t expiry;   /* start of the call plus the timeout */
+    unsigned int fired;
+} Timer;
+
+unsigned int RTC_probeIntSets;
+
+static Timer l_timer[TIMERS];
+static uint32_t l_seed = 1U;
+static unsigned int l_late;
+static uint64_t l_lateMax;
+static uint64_t l_callMax; /* longest driver call, preempted by GPIO_ODD */
+static unsigned int l_stray;
+static unsigned int l_evenRuns;
+
+static uint32_t rnd(void) {
+  l_seed = l_seed * 1103515245U + 12345U;
+  return l_seed >> 16;
+}
+
+static void expired(RTCDRV_TimerID_t id, void *user) {
+  Timer *t = user;
+  uint64_t now = SIM_now();
+
+  (void)id;
+  if (!t->armed) {
+    l_stray++;
+    return;
+  }
+  /* the RTC interrupt waits for a GPIO_ODD handler, or for the section of
+  * a call GPIO_ODD preempted. a compare set in the past would only match
+  * after the 24 bit counter wrapped */
+  if (now + SLACK < t->expiry
+      || now > t->expiry + SLACK + BURN_MAX + l_callMax) {
+    printf("timer %u fired at %llu, expiry %llu\n",
+           (unsigned int)(t - l_timer), (unsigned long long)now,
+           (unsigned long long)t->expiry);
+    l_late++;
+  }
+  if (now > t->expiry && now - t->expiry > l_lateMax) {
+    l_lateMax = now - t->expiry;
+  }
+  t->armed = false;
+  t->fired++;
+}
+
+static void callEnd(uint64_t begin) {
+  if (SIM_now() - begin > l_callMax) {
+    l_callMax = SIM_now() - begin;
+  }
+}
+
+static void start(Timer *t, uint32_t ms) {
+  uint64_t begin = SIM_now();
+
+  t->armed = true;
+  t->expiry = begin + MS_TO_LF(ms);
+  CHECK_EQ(RTCDRV_StartTimer(t->id, rtcdrvTimerTypeOneshot, ms, expired, t),
+           ECODE_EMDRV_RTCDRV_OK);
+  callEnd(begin);
+}
+
+static void stop(Timer *t) {
+  uint64_t begin = SIM_now();
+
+  CHECK_EQ(RTCDRV_StopTimer(t->id), ECODE_EMDRV_RTCDRV_OK);
+  t->armed = false;
+  callEnd(begin);
+}
+
+/* takes time while the RTC interrupt waits */
+void GPIO_ODD_IRQHandler(void) {
+  GPIO_IntClear(1U << ODD_PIN);
+  SIM_advance(1U + rnd() % BURN_MAX);
+}
+
+void GPIO_EVEN_IRQHandler(void) {
+  Timer *t = &l_timer[TIMERS - 1U];
+
+  GPIO_IntClear(1U << EVEN_PIN);
+  /* a driver section disables the RTC interrupt */
+  CHECK(NVIC_GetEnableIRQ(RTC_IRQn));
+  l_evenRuns++;
+  if (t->armed) {
+    stop(t);
+  } else {
+    start(t, 1U + rnd() % 8U);
+  }
+}
+
+static void pulse(unsigned int pin) {
+  SIM_gpioSet(gpioPortC, pin, true);
+  SIM_gpioSet(gpioPortC, pin, false);
+}
+
+/* the preemption points of the driver */
+static void preempt(void) {
+  switch (rnd() % 6U) {
+    case 0:
+      pulse(ODD_PIN);
+      break;
+    case 1:
+      pulse(EVEN_PIN);
+      break;
+    default:
+      break;
+  }
+}
+
+static void mainCall(Timer *t) {
+  if (t->armed && rnd() % 3U == 0U) {
+    stop(t);
+  } else {
+    start(t, 1U + rnd() % 8U);
+  }
+}
+
+static void setup(void) {
+  unsigned int i;
+
+  SIM_init();
+  SLEEP_Init(NULL, NULL);
+  RTCDRV_Init();
+  memset(l_timer, 0, sizeof(l_timer));
+  for (i = 0U; i < TIMERS; i++) {
+    CHECK_EQ(RTCDRV_AllocateTimer(&l_timer[i].id), ECODE_EMDRV_RTCDRV_OK);
+  }
+  GPIO_ExtIntConfig(gpioPortC, ODD_PIN, ODD_PIN, true, false, true);
+  GPIO_ExtIntConfig(gpioPortC, EVEN_PIN, EVEN_PIN, true, false, true);
+  NVIC_EnableIRQ(GPIO_ODD_IRQn);
+  NVIC_EnableIRQ(GPIO_EVEN_IRQn);
+}
+
+static void testInjected(void) {
+  unsigned int fired = 0U;
+  unsigned int i;
+
+  setup();
+  SIM_probeHook = preempt;
+  for (i = 0U; i < ROUNDS; i++) {
+    mainCall(&l_timer[rnd() % (TIMERS - 1U)]);
+    SIM_advance(rnd() % 300U);
+  }
+  SIM_probeHook = NULL;
+  SIM_advance((uint32_t)MS_TO_LF(50U));
+
+  for (i = 0U; i < TIMERS; i++) {
+    CHECK(!l_timer[i].armed);
+    fired += l_timer[i].fired;
+  }
+  CHECK_EQ(l_late, 0U);
+  CHECK_EQ(l_stray, 0U);
+  printf("%u timers fired, %u GPIO_EVEN runs, %u compare flags set, "
+         "late %llu ticks at most, calls %llu ticks at most\n",
+         fired, l_evenRuns, RTC_probeIntSets, (unsigned long long)l_lateMax,
+         (unsigned long long)l_callMax);
+  CHECK(fired > ROUNDS / 4U);
+  CHECK(l_evenRuns > 0U);
+  /* the compare was set in the past and the driver raised its flag */
+  CHECK(RTC_probeIntSets > 0U);
+}
+
+int main(void) {
+  testInjected();
+  return TEST_RESULT();
+}
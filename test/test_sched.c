@@ -0,0 +1,272 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_rtc.h"
+#include "sleep.h"
+#include "sched.h"
+
+/* scheduler dispatch order, timers and a synthetic load in simulated
+* time */
+
+typedef struct {
+    uint8_t prio;
+    uint8_t sig;
+    uint64_t now;
+    uint32_t rtcMs; /* RTC count in ms */
+} Dispatch;
+
+static Dispatch l_log[32];
+static unsigned int l_logLen;
+
+static void record(uint8_t prio, uint8_t sig) {
+  if (l_logLen < sizeof(l_log) / sizeof(l_log[0])) {
+    l_log[l_logLen].prio = prio;
+    l_log[l_logLen].sig = sig;
+    l_log[l_logLen].now = SIM_now();
+    l_log[l_logLen].rtcMs = RTCDRV_TicksToMsec(RTC_CounterGet());
+    l_logLen++;
+  }
+}
+
+static void task0(uint8_t sig) {
+  record(0U, sig);
+}
+
+static void task1(uint8_t sig) {
+  record(1U, sig);
+}
+
+/* posts to task 0 and 1, they run once it returned */
+static void task3(uint8_t sig) {
+  record(3U, sig);
+  if (sig == 0U) {
+    SCHED_post(0U, 9U);
+    SCHED_post(1U, 9U);
+  }
+}
+
+static void run(uint32_t ticks) {
+  l_logLen = 0U;
+  SIM_RUN(ticks, SCHED_run());
+}
+
+/* the highest priority first, events of a task in order */
+static void testOrder(void) {
+  static uint8_t const expect[][2] = {
+    { 3, 0 }, { 3, 1 }, { 1, 0 }, { 1, 1 }, { 1, 9 }, { 0, 0 }, { 0, 9 },
+  };
+  unsigned int i;
+
+  CHECK(SCHED_post(0U, 0U));
+  CHECK(SCHED_post(1U, 0U));
+  CHECK(SCHED_post(3U, 0U));
+  CHECK(SCHED_post(1U, 1U));
+  CHECK(SCHED_post(3U, 1U));
+  run(1U);
+  CHECK_EQ(l_logLen, sizeof(expect) / sizeof(expect[0]));
+  for (i = 0U; i < l_logLen; i++) {
+    CHECK_EQ(l_log[i].prio, expect[i][0]);
+    CHECK_EQ(l_log[i].sig, expect[i][1]);
+  }
+}
+
+static void testQueueFull(void) {
+  unsigned int i;
+
+  for (i = 0U; i < SCHED_QUEUE_LEN; i++) {
+    CHECK(SCHED_post(0U, (uint8_t)i));
+  }
+  CHECK(!SCHED_post(0U, 0xFFU));
+  /* other tasks have their own queue */
+  CHECK(SCHED_post(1U, 0U));
+  run(1U);
+  CHECK_EQ(l_logLen, SCHED_QUEUE_LEN + 1U);
+  CHECK_EQ(l_log[SCHED_QUEUE_LEN].sig, SCHED_QUEUE_LEN - 1U);
+}
+
+/* timer events at their time, the RTC count converts to ms */
+static void testTimers(void) {
+  SCHED_Timer oneshot;
+  SCHED_Timer periodic;
+  uint64_t start = SIM_now();
+  uint32_t startMs = RTCDRV_TicksToMsec(RTC_CounterGet());
+  unsigned int i;
+
+  CHECK(SCHED_timerInit(&oneshot, 1U, 5U));
+  CHECK(SCHED_timerInit(&periodic, 0U, 6U));
+  CHECK(SCHED_timerArm(&oneshot, 100U, false));
+  CHECK(SCHED_timerArm(&periodic, 250U, true));
+  run(SIM_LFCLK_HZ + SIM_LFCLK_HZ / 100U);
+  SCHED_timerDisarm(&periodic);
+
+  CHECK_EQ(l_logLen, 5U);
+  CHECK_EQ(l_log[0].sig, 5U);
+  CHECK_RANGE(l_log[0].now - start, 3277U - 8U, 3277U + 8U);
+  CHECK_RANGE(l_log[0].rtcMs - startMs, 99U, 101U);
+  for (i = 1U; i < 5U; i++) {
+    CHECK_EQ(l_log[i].sig, 6U);
+    /* RTCDRV periods run up to one prescaled tick long */
+    CHECK_RANGE(l_log[i].now - start, 8192U * i - 8U, 8200U * i + 8U);
+    CHECK_RANGE(l_log[i].rtcMs - startMs, 250U * i - 1U, 250U * i + 1U);
+  }
+
+  /* nothing left armed */
+  run(SIM_LFCLK_HZ);
+  CHECK_EQ(l_logLen, 0U);
+  (void)RTCDRV_FreeTimer(oneshot.id);
+  (void)RTCDRV_FreeTimer(periodic.id);
+}
+
+/* synthetic load: periodic sources post from RTCDRV callbacks, each
+* event keeps its task busy for work ticks */
+typedef struct {
+    uint8_t prio;
+    uint32_t periodMs;
+    uint32_t work;
+    RTCDRV_TimerID_t id;
+    uint64_t posted[SCHED_QUEUE_LEN]; /* post times of the queued events */
+    unsigned int head;
+    unsigned int tail;
+    unsigned int lost;
+    uint64_t latencyMax;
+    uint64_t latencyTotal;
+} Load;
+
+static Load l_load[] = {
+  { 3U, 5U, 10U },
+  { 1U, 7U, 60U },
+  { 0U, 20U, 200U },
+};
+
+#define LOADS     (sizeof(l_load) / sizeof(l_load[0]))
+#define LOAD_STOP LOADS /* signal of the last event */
+
+static void loadPost(RTCDRV_TimerID_t id, void *user) {
+  Load *l = user;
+
+  (void)id;
+  if (SCHED_post(l->prio, (uint8_t)(l - l_load))) {
+    l->posted[l->head++ % SCHED_QUEUE_LEN] = SIM_now();
+  } else {
+    l->lost++;
+  }
+}
+
+/* the sources stop, the last event goes behind the ones queued */
+static void loadStop(RTCDRV_TimerID_t id, void *user) {
+  unsigned int i;
+
+  (void)id;
+  (void)user;
+  for (i = 0U; i < LOADS; i++) {
+    (void)RTCDRV_StopTimer(l_load[i].id);
+  }
+  CHECK(SCHED_post(0U, LOAD_STOP));
+}
+
+static void loadTask(uint8_t sig) {
+  Load *l = &l_load[sig];
+  uint64_t latency;
+
+  /* the run ends awake, so the statistics hold no sleep cut short */
+  if (sig == LOAD_STOP) {
+    longjmp(SIM_stop, 1);
+  }
+  latency = SIM_now() - l->posted[l->tail++ % SCHED_QUEUE_LEN];
+
+  if (latency > l->latencyMax) {
+    l->latencyMax = latency;
+  }
+  l->latencyTotal += latency;
+  SIM_advance(l->work);
+}
+
+static uint32_t ticks(void) {
+  return (uint32_t)SIM_now();
+}
+
+static uint32_t ticksToUs(uint64_t ticks) {
+  return (uint32_t)(ticks * 1000000U / SIM_LFCLK_HZ);
+}
+
+/* one second of load: wakeups, time per energy mode and event latency */
+static void testLoad(void) {
+  SLEEP_StatsInit_t statsConfig = {
+    .tickGet = ticks,
+    .tickMask = 0xFFFFFFFFUL,
+    .currentUa = { 1500, 600, 2, 1, 0 }
+  };
+  SLEEP_Stats_t const *stats;
+  RTCDRV_TimerID_t stop;
+  uint64_t start;
+  uint64_t busy = 0U;
+  uint64_t maxWork = 0U;
+  unsigned int i;
+  Load *l;
+
+  for (i = 0U; i < LOADS; i++) {
+    l = &l_load[i];
+    SCHED_taskStart(l->prio, loadTask);
+    CHECK_EQ(RTCDRV_AllocateTimer(&l->id), ECODE_EMDRV_RTCDRV_OK);
+    CHECK_EQ(RTCDRV_StartTimer(l->id, rtcdrvTimerTypePeriodic, l->periodMs,
+                               loadPost, l), ECODE_EMDRV_RTCDRV_OK);
+    if (l->work > maxWork) {
+      maxWork = l->work;
+    }
+  }
+  CHECK_EQ(RTCDRV_AllocateTimer(&stop), ECODE_EMDRV_RTCDRV_OK);
+  CHECK_EQ(RTCDRV_StartTimer(stop, rtcdrvTimerTypeOneshot, 1000U, loadStop,
+                             NULL), ECODE_EMDRV_RTCDRV_OK);
+  start = SIM_now();
+  SLEEP_StatsInit(&statsConfig);
+  run(2U * SIM_LFCLK_HZ);
+  stats = SLEEP_StatsGet();
+
+  printf("load: %lu wakeups, EM0 %lu us, EM1 %lu us, EM2 %lu us, %lu uA\n",
+         (unsigned long)stats->entries[sleepEM0],
+         (unsigned long)ticksToUs(stats->residencyTicks[sleepEM0]),
+         (unsigned long)ticksToUs(stats->residencyTicks[sleepEM1]),
+         (unsigned long)ticksToUs(stats->residencyTicks[sleepEM2]),
+         (unsigned long)SLEEP_StatsAverageCurrentGet());
+  for (i = 0U; i < LOADS; i++) {
+    l = &l_load[i];
+    printf("load: task %u, %u events, latency avg %lu us, max %lu us\n",
+           l->prio, l->tail,
+           (unsigned long)ticksToUs(l->tail != 0U ? l->latencyTotal / l->tail : 0U),
+           (unsigned long)ticksToUs(l->latencyMax));
+
+    CHECK_EQ(l->lost, 0U);
+    CHECK_EQ(l->tail, l->head);
+    CHECK_RANGE(l->tail, 1000U / l->periodMs - 1U, 1000U / l->periodMs + 1U);
+    /* no preemption: an event waits for the handler running and at most
+    * one event of every task */
+    CHECK(l->latencyMax <= maxWork + l_load[0].work + l_load[1].work
+                           + l_load[2].work);
+    busy += (uint64_t)l->tail * l->work;
+  }
+  /* the core is awake only for the work, and sleeps in EM2 otherwise */
+  CHECK_EQ(stats->residencyTicks[sleepEM0], busy);
+  CHECK_EQ(stats->residencyTicks[sleepEM1], 0U);
+  CHECK_EQ(stats->residencyTicks[sleepEM0] + stats->residencyTicks[sleepEM2],
+           SIM_now() - start);
+  CHECK_EQ(stats->entries[sleepEM2], stats->entries[sleepEM0]);
+  CHECK_EQ(stats->wakeSource[RTC_IRQn], stats->entries[sleepEM0]);
+
+  for (i = 0U; i < LOADS; i++) {
+    (void)RTCDRV_FreeTimer(l_load[i].id);
+  }
+  (void)RTCDRV_FreeTimer(stop);
+}
+
+int main(void) {
+  SIM_init();
+  SCHED_init();
+  SCHED_taskStart(0U, task0);
+  SCHED_taskStart(1U, task1);
+  SCHED_taskStart(3U, task3);
+  testOrder();
+  testQueueFull();
+  testTimers();
+  testLoad();
+  return TEST_RESULT();
+}
@@ -0,0 +1,182 @@
+#include "efm32sim.h"
+#include "test.h"
+#include "sleep.h"
+#include "rtcdriver.h"
+
+/* sleep block statistics per requester and energy mode residency, built
+* with SLEEP_STATS_ENABLED. the statistics tick is the LFCLK tick of the
+* simulation */
+
+#define TAG_A SLEEP_TAG('A', ' ', ' ', ' ')
+#define TAG_B SLEEP_TAG('B', ' ', ' ', ' ')
+
+static uint32_t ticks(void) {
+  return (uint32_t)SIM_now();
+}
+
+static SLEEP_StatsRequester_t const *requester(uint32_t tag,
+                                               SLEEP_EnergyMode_t eMode) {
+  SLEEP_Stats_t const *stats = SLEEP_StatsGet();
+  unsigned int i;
+
+  for (i = 0U; i < SLEEP_STATS_REQUESTERS; i++) {
+    if (stats->requester[i].tag == tag && stats->requester[i].eMode == eMode) {
+      return &stats->requester[i];
+    }
+  }
+  return NULL;
+}
+
+/* A holds 0..300, B 100..400: each end is charged to its own begin */
+static void testInterleaved(void) {
+  SLEEP_StatsRequester_t const *a;
+  SLEEP_StatsRequester_t const *b;
+
+  SLEEP_SleepBlockBeginTagged(sleepEM2, TAG_A);
+  SIM_advance(100U);
+  SLEEP_SleepBlockBeginTagged(sleepEM2, TAG_B);
+  SIM_advance(200U);
+  SLEEP_SleepBlockEndTagged(sleepEM2, TAG_A);
+  CHECK_EQ(SLEEP_LowestEnergyModeGet(), sleepEM1);
+  SIM_advance(100U);
+  SLEEP_SleepBlockEndTagged(sleepEM2, TAG_B);
+  CHECK_EQ(SLEEP_LowestEnergyModeGet(), sleepEM3);
+
+  a = requester(TAG_A, sleepEM2);
+  b = requester(TAG_B, sleepEM2);
+  CHECK(a != NULL && b != NULL);
+  if (a != NULL && b != NULL) {
+    CHECK_EQ(a->begins, 1U);
+    CHECK_EQ(a->held, 0U);
+    CHECK_EQ(a->heldTicks, 300U);
+    CHECK_EQ(b->begins, 1U);
+    CHECK_EQ(b->held, 0U);
+    CHECK_EQ(b->heldTicks, 300U);
+  }
+}
+
+/* nested blocks of one requester, the hold time runs until the last end */
+static void testNested(void) {
+  SLEEP_StatsRequester_t const *a;
+
+  SLEEP_SleepBlockBeginTagged(sleepEM3, TAG_A);
+  SIM_advance(10U);
+  SLEEP_SleepBlockBeginTagged(sleepEM3, TAG_A);
+  SLEEP_SleepBlockBegin(sleepEM3);
+  SIM_advance(10U);
+  SLEEP_SleepBlockEndTagged(sleepEM3, TAG_A);
+  SLEEP_SleepBlockEnd(sleepEM3);
+  SIM_advance(10U);
+  a = requester(TAG_A, sleepEM3);
+  CHECK(a != NULL);
+  if (a != NULL) {
+    CHECK_EQ(a->held, 1U);
+    CHECK_EQ(a->heldTicks, 30U);
+  }
+  SLEEP_SleepBlockEndTagged(sleepEM3, TAG_A);
+  CHECK_EQ(SLEEP_LowestEnergyModeGet(), sleepEM3);
+
+  /* the untagged block under tag 0 */
+  a = requester(0U, sleepEM3);
+  CHECK(a != NULL);
+  if (a != NULL) {
+    CHECK_EQ(a->begins, 1U);
+    CHECK_EQ(a->held, 0U);
+    CHECK_EQ(a->heldTicks, 10U);
+  }
+}
+
+/* an end without a block of the tag is ignored, it releases neither the
+* block of another requester nor its hold time */
+static void testUnmatched(void) {
+  SLEEP_StatsRequester_t const *a;
+
+  SLEEP_SleepBlockBeginTagged(sleepEM2, TAG_A);
+  SLEEP_SleepBlockBeginTagged(sleepEM2, TAG_B);
+  SLEEP_SleepBlockEndTagged(sleepEM2, TAG_B);
+  SLEEP_SleepBlockEndTagged(sleepEM2, TAG_B);
+  CHECK_EQ(SLEEP_LowestEnergyModeGet(), sleepEM1);
+  a = requester(TAG_A, sleepEM2);
+  CHECK(a != NULL);
+  if (a != NULL) {
+    CHECK_EQ(a->held, 1U);
+  }
+  SLEEP_SleepBlockEndTagged(sleepEM2, TAG_A);
+  CHECK_EQ(SLEEP_LowestEnergyModeGet(), sleepEM3);
+  SLEEP_SleepBlockEndTagged(sleepEM2, TAG_A);
+  CHECK_EQ(SLEEP_LowestEnergyModeGet(), sleepEM3);
+}
+
+static void expired(RTCDRV_TimerID_t id, void *user) {
+  (void)id;
+  (void)user;
+}
+
+/* sleep until an RTCDRV timer of ms expires, returns the ticks slept */
+static uint32_t sleepFor(RTCDRV_TimerID_t id, uint32_t ms,
+                         SLEEP_EnergyMode_t eMode) {
+  uint64_t start = SIM_now();
+  uint32_t rtcTicks = (uint32_t)RTCDRV_MsecsToTicks(ms);
+  uint32_t slept;
+
+  CHECK_EQ(RTCDRV_StartTimer(id, rtcdrvTimerTypeOneshot, ms, expired, NULL),
+           ECODE_EMDRV_RTCDRV_OK);
+  CHECK_EQ(SLEEP_Sleep(), eMode);
+  slept = (uint32_t)(SIM_now() - start);
+  /* RTCDRV counts the LFCLK / 8, within one prescaled tick */
+  CHECK_RANGE(slept, 8U * rtcTicks - 8U, 8U * rtcTicks + 8U);
+  return slept;
+}
+
+/* 100 ticks in EM0, 10 ms in EM1 and 20 ms in EM2, the lowest mode with
+* the RTC */
+static void testResidency(void) {
+  SLEEP_Stats_t const *stats;
+  RTCDRV_TimerID_t id;
+  uint32_t em1;
+  uint32_t em2;
+  uint64_t charge;
+
+  RTCDRV_Init();
+  CHECK_EQ(RTCDRV_AllocateTimer(&id), ECODE_EMDRV_RTCDRV_OK);
+  SLEEP_StatsClear();
+
+  SIM_advance(100U);
+  SLEEP_SleepBlockBegin(sleepEM2);
+  em1 = sleepFor(id, 10U, sleepEM1);
+  SLEEP_SleepBlockEnd(sleepEM2);
+  em2 = sleepFor(id, 20U, sleepEM2);
+
+  stats = SLEEP_StatsGet();
+  CHECK_EQ(stats->residencyTicks[sleepEM0], 100U);
+  CHECK_EQ(stats->residencyTicks[sleepEM1], em1);
+  CHECK_EQ(stats->residencyTicks[sleepEM2], em2);
+  CHECK_EQ(stats->entries[sleepEM1], 1U);
+  CHECK_EQ(stats->entries[sleepEM2], 1U);
+  CHECK_EQ(stats->entries[sleepEM0], 2U);
+  CHECK_EQ(stats->wakeSource[RTC_IRQn], 2U);
+  CHECK_EQ(stats->wakeSourceUnknown, 0U);
+
+  charge = 1500U * 100U + 600U * (uint64_t)em1 + 2U * (uint64_t)em2;
+  CHECK_EQ(SLEEP_StatsAverageCurrentGet(), charge / (100U + em1 + em2));
+
+  (void)RTCDRV_FreeTimer(id);
+  RTCDRV_DeInit();
+}
+
+int main(void) {
+  SLEEP_StatsInit_t statsConfig = {
+    .tickGet = ticks,
+    .tickMask = 0xFFFFFFFFUL,
+    .currentUa = { 1500, 600, 2, 1, 0 }
+  };
+
+  SIM_init();
+  SLEEP_Init(NULL, NULL);
+  SLEEP_StatsInit(&statsConfig);
+  testInterleaved();
+  testNested();
+  testUnmatched();
+  testResidency();
+  return TEST_RESULT();
+}
@@ -0,0 +1,279 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_usart.h"
+#include "em_gpio.h"
+#include "sleep.h"
+#include "spidrv.h"
+
+/* SPIDRV master transfers on the simulated USART1 with a slave that
+* answers each frame: blocking transfers waiting in EM1, a receive with its
+* progress, a chain of segments under one CS, and queued transactions of
+* two devices selected by the application. 1 MHz from the 14 MHz HFRCO,
+* 8 bit frames of 112 cycles. the DMA descriptors hold 32 bit pointers:
+* the buffers are statics */
+
+#define FRAME_CYCLES 112U
+#define FRAMES       32U
+#define DEV_A_PORT   gpioPortC
+#define DEV_A_PIN    14U
+#define DEV_B_PORT   gpioPortC
+#define DEV_B_PIN    15U
+
+/* a frame on the bus and the selects at its end */
+typedef struct {
+    uint16_t mosi;
+    bool autoCs;
+    bool cs;     /* the SPIDRV CS pin, PB8 */
+    bool devA;
+    bool devB;
+} Frame;
+
+typedef struct {
+    unsigned int calls;
+    Ecode_t status;
+    int items;
+    uintptr_t order[4];
+} Done;
+
+static SPIDRV_HandleData_t l_spi;
+static Frame l_frames[FRAMES];
+static unsigned int l_frameCount;
+static Done l_done;
+
+static uint8_t l_tx[8];
+static uint8_t l_rx[8];
+static uint8_t l_rx2[8];
+
+static bool low(GPIO_Port_TypeDef port, unsigned int pin) {
+  return (GPIO->P[port].DOUT & (1UL << pin)) == 0U;
+}
+
+/* the slave answers a frame with its complement */
+static uint16_t slave(uint16_t frame) {
+  if (l_frameCount < FRAMES) {
+    l_frames[l_frameCount].mosi = frame;
+    l_frames[l_frameCount].autoCs = (USART1->CTRL & USART_CTRL_AUTOCS) != 0U;
+    l_frames[l_frameCount].cs = low(gpioPortB, 8U);
+    l_frames[l_frameCount].devA = low(DEV_A_PORT, DEV_A_PIN);
+    l_frames[l_frameCount].devB = low(DEV_B_PORT, DEV_B_PIN);
+  }
+  l_frameCount++;
+  return (uint16_t)~frame;
+}
+
+static void done(SPIDRV_Handle_t handle, Ecode_t status, int items) {
+  CHECK(handle == &l_spi);
+  l_done.calls++;
+  l_done.status = status;
+  l_done.items = items;
+}
+
+static void transactionDone(SPIDRV_Handle_t handle, Ecode_t status,
+                            int items, void *user) {
+  CHECK(handle == &l_spi);
+  CHECK_EQ(status, ECODE_EMDRV_SPIDRV_OK);
+  if (l_done.calls < 4U) {
+    l_done.order[l_done.calls] = (uintptr_t)user;
+  }
+  l_done.calls++;
+  l_done.items += items;
+}
+
+static void setup(SPIDRV_CsControl_t cs) {
+  SPIDRV_Init_t init = {
+    .port = USART1,
+    .portLocation = 0,
+    .bitRate = 1000000,
+    .frameLength = 8,
+    .dummyTxValue = 0xA5,
+    .type = spidrvMaster,
+    .bitOrder = spidrvBitOrderMsbFirst,
+    .clockMode = spidrvClockMode0,
+    .csControl = cs,
+    .slaveStartMode = spidrvSlaveStartImmediate,
+  };
+  unsigned int i;
+
+  SIM_init();
+  SLEEP_Init(NULL, NULL);
+  CHECK_EQ(SPIDRV_Init(&l_spi, &init), ECODE_EMDRV_SPIDRV_OK);
+  /* both selects high in one write of DOUTSET, the sim only sees the last
+  * write before a sync point */
+  GPIO_PinModeSet(DEV_A_PORT, DEV_A_PIN, gpioModePushPull, 1);
+  GPIO_PinModeSet(DEV_B_PORT, DEV_B_PIN, gpioModePushPull, 1);
+  GPIO_PortOutSet(DEV_A_PORT, (1UL << DEV_A_PIN) | (1UL << DEV_B_PIN));
+  SIM_usartSlave = slave;
+  memset(l_frames, 0, sizeof(l_frames));
+  l_frameCount = 0U;
+  memset(&l_done, 0, sizeof(l_done));
+  for (i = 0U; i < sizeof(l_tx); i++) {
+    l_tx[i] = (uint8_t)(0x10U + i);
+  }
+  memset(l_rx, 0, sizeof(l_rx));
+  memset(l_rx2, 0, sizeof(l_rx2));
+}
+
+static void teardown(void) {
+  CHECK_EQ(USART1->IF & (USART_IF_TXOF | USART_IF_RXOF), 0U);
+  CHECK_EQ(SPIDRV_DeInit(&l_spi), ECODE_EMDRV_SPIDRV_OK);
+}
+
+/* run until the callbacks came or a frame time per frame has passed */
+static void runFrames(unsigned int frames, unsigned int calls) {
+  unsigned int i;
+
+  for (i = 0U; i < 4U * frames && l_done.calls < calls; i++) {
+    SIM_cycles(FRAME_CYCLES / 2U);
+  }
+}
+
+/* the frames out and the answers in, AUTOCS raises CS after the last */
+static void testTransferB(void) {
+  unsigned int i;
+
+  setup(spidrvCsControlAuto);
+  CHECK_EQ(SPIDRV_MTransferB(&l_spi, l_tx, l_rx, 6), ECODE_EMDRV_SPIDRV_OK);
+  CHECK_EQ(l_frameCount, 6U);
+  CHECK_EQ(SIM_usartTxLen, 6U);
+  for (i = 0U; i < 6U; i++) {
+    CHECK(l_frames[i].autoCs);
+    CHECK_EQ(l_frames[i].mosi, l_tx[i]);
+    CHECK_EQ(l_rx[i], (uint8_t)~l_tx[i]);
+    CHECK_EQ(SIM_usartTx[i].csEnd, i == 5U);
+    CHECK_EQ(SIM_usartTx[i].end - SIM_usartTx[i].start, FRAME_CYCLES);
+  }
+  CHECK_EQ(l_rx[6], 0U);
+  CHECK_EQ(SPIDRV_MTransferB(&l_spi, l_tx, l_rx, 0),
+           ECODE_EMDRV_SPIDRV_PARAM_ERROR);
+  teardown();
+}
+
+/* a receive sends the dummy value, its progress while it runs */
+static void testReceive(void) {
+  int sent;
+  int remaining;
+  unsigned int i;
+
+  setup(spidrvCsControlAuto);
+  CHECK_EQ(SPIDRV_MReceive(&l_spi, l_rx, 8, done), ECODE_EMDRV_SPIDRV_OK);
+  CHECK_EQ(SPIDRV_MTransmit(&l_spi, l_tx, 1, done), ECODE_EMDRV_SPIDRV_BUSY);
+  SIM_cycles(3U * FRAME_CYCLES + FRAME_CYCLES / 2U);
+  CHECK_EQ(SPIDRV_GetTransferStatus(&l_spi, &sent, &remaining),
+           ECODE_EMDRV_SPIDRV_OK);
+  CHECK_EQ(sent, 3);
+  CHECK_EQ(remaining, 5);
+
+  runFrames(8U, 1U);
+  CHECK_EQ(l_done.calls, 1U);
+  CHECK_EQ(l_done.status, ECODE_EMDRV_SPIDRV_OK);
+  CHECK_EQ(l_done.items, 8);
+  for (i = 0U; i < 8U; i++) {
+    CHECK_EQ(l_frames[i].mosi, 0xA5U);
+    CHECK_EQ(l_rx[i], 0x5AU);
+  }
+  teardown();
+}
+
+/* the segments back to back with CS held low on its pin, not by AUTOCS */
+static void testChain(void) {
+  SPIDRV_Segment_t chain[] = {
+    { l_tx, NULL, 2 },
+    { NULL, l_rx, 3 },
+    { &l_tx[2], l_rx2, 2 },
+  };
+  unsigned int i;
+
+  setup(spidrvCsControlAuto);
+  CHECK_EQ(SPIDRV_MTransferChainB(&l_spi, chain, 3), ECODE_EMDRV_SPIDRV_OK);
+  CHECK_EQ(l_frameCount, 7U);
+  for (i = 0U; i < 7U; i++) {
+    CHECK(l_frames[i].cs);
+    CHECK(!l_frames[i].autoCs);
+  }
+  CHECK(!low(gpioPortB, 8U));
+  CHECK(USART1->CTRL & USART_CTRL_AUTOCS);
+
+  CHECK_EQ(l_frames[1].mosi, l_tx[1]);
+  for (i = 0U; i < 3U; i++) {
+    CHECK_EQ(l_frames[2U + i].mosi, 0xA5U);
+    CHECK_EQ(l_rx[i], 0x5AU);
+  }
+  CHECK_EQ(l_frames[5].mosi, l_tx[2]);
+  CHECK_EQ(l_rx2[0], (uint8_t)~l_tx[2]);
+  CHECK_EQ(l_rx2[1], (uint8_t)~l_tx[3]);
+  CHECK_EQ(l_rx2[2], 0U);
+  teardown();
+}
+
+/* transactions queued behind a transfer of the application start once it
+* has released its CS, by priority and then in order, each with its own CS
+* and bitrate. the instance bitrate is back after them */
+static void testQueue(void) {
+  SPIDRV_Transaction_t slow = {
+    .txBuffer = l_tx, .count = 2, .csPort = DEV_A_PORT, .csPin = DEV_A_PIN,
+    .bitRate = 500000, .priority = 0, .callback = transactionDone,
+    .userParam = (void *)1,
+  };
+  SPIDRV_Transaction_t b = {
+    .txBuffer = &l_tx[4], .rxBuffer = l_rx, .count = 2, .csPort = DEV_B_PORT,
+    .csPin = DEV_B_PIN, .priority = 0, .callback = transactionDone,
+    .userParam = (void *)2,
+  };
+  SPIDRV_Transaction_t low1 = {
+    .rxBuffer = l_rx2, .count = 1, .csPort = DEV_A_PORT, .csPin = DEV_A_PIN,
+    .priority = 1, .callback = transactionDone, .userParam = (void *)3,
+  };
+  uint32_t clkDiv;
+  unsigned int i;
+
+  setup(spidrvCsControlApplication);
+  clkDiv = USART1->CLKDIV;
+  GPIO_PinOutClear(DEV_B_PORT, DEV_B_PIN);
+  CHECK_EQ(SPIDRV_MTransmit(&l_spi, l_tx, 2, done), ECODE_EMDRV_SPIDRV_OK);
+  CHECK_EQ(SPIDRV_MQueueTransfer(&l_spi, &low1), ECODE_EMDRV_SPIDRV_OK);
+  CHECK_EQ(SPIDRV_MQueueTransfer(&l_spi, &slow), ECODE_EMDRV_SPIDRV_OK);
+  CHECK_EQ(SPIDRV_MQueueTransfer(&l_spi, &b), ECODE_EMDRV_SPIDRV_OK);
+  runFrames(2U, 1U);
+  CHECK_EQ(l_done.calls, 1U);
+
+  /* nothing starts while the application holds CS */
+  SIM_cycles(4U * FRAME_CYCLES);
+  CHECK_EQ(l_frameCount, 2U);
+  GPIO_PinOutSet(DEV_B_PORT, DEV_B_PIN);
+  CHECK_EQ(SPIDRV_QueueResume(&l_spi), ECODE_EMDRV_SPIDRV_OK);
+  runFrames(2U * 2U + 2U + 1U, 4U);
+  CHECK_EQ(l_done.calls, 4U);
+  CHECK_EQ(l_done.order[1], 1U);
+  CHECK_EQ(l_done.order[2], 2U);
+  CHECK_EQ(l_done.order[3], 3U);
+  CHECK_EQ(l_frameCount, 7U);
+
+  for (i = 0U; i < 2U; i++) {
+    CHECK(!l_frames[i].devA && l_frames[i].devB);
+  }
+  for (i = 2U; i < 4U; i++) {
+    CHECK(l_frames[i].devA && !l_frames[i].devB);
+    CHECK_EQ(SIM_usartTx[i].end - SIM_usartTx[i].start, 2U * FRAME_CYCLES);
+  }
+  for (i = 4U; i < 6U; i++) {
+    CHECK(!l_frames[i].devA && l_frames[i].devB);
+    CHECK_EQ(SIM_usartTx[i].end - SIM_usartTx[i].start, FRAME_CYCLES);
+  }
+  CHECK_EQ(l_rx[0], (uint8_t)~l_tx[4]);
+  CHECK_EQ(l_rx[1], (uint8_t)~l_tx[5]);
+  CHECK(l_frames[6].devA && !l_frames[6].devB);
+  CHECK_EQ(l_rx2[0], 0x5AU);
+  CHECK(!low(DEV_A_PORT, DEV_A_PIN));
+  CHECK(!low(DEV_B_PORT, DEV_B_PIN));
+  CHECK_EQ(USART1->CLKDIV, clkDiv);
+  teardown();
+}
+
+int main(void) {
+  testTransferB();
+  testReceive();
+  testChain();
+  testQueue();
+  return TEST_RESULT();
+}
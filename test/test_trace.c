@@ -0,0 +1,144 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "em_cmu.h"
+#include "sleep.h"
+#include "rtcdriver.h"
+#include "bsp.h"
+#include "inmon.h"
+#include "trace_report.h"
+
+/* the trace of bsp.c built with EMDRV_TRACE, dumped by BSP_traceDump() into
+* SIM_tx and analyzed as traceview does: a 10 ms RTCDRV timer wakes the
+* core from EM2, it works 1 ms and then takes a capture edge whose handler
+* runs 100 cycles longer each time. the core runs at 14 MHz from HFRCO, the
+* RTC counts the LFCLK / 8 */
+
+#define LOOPS      20U
+#define PERIOD_MS  10U
+#define WORK       14000U  /* 1 ms */
+#define BURN_STEP  100U
+#define EXC_GPIO   (16U + GPIO_ODD_IRQn)
+#define EXC_RTC    (16U + RTC_IRQn)
+
+int DELAY;
+
+static uint32_t l_burn;
+
+/* the display is not part of this test */
+void updateMatrix(float number, char *matrix) {
+  (void)number;
+  (void)matrix;
+}
+
+void drawMatrix(char *matrix) {
+  (void)matrix;
+}
+
+/* the decoding of the capture edge, l_burn cycles long */
+void INMON_irq(uint32_t flags) {
+  SIM_cycles(l_burn);
+  GPIO_IntClear(flags);
+}
+
+static void expired(RTCDRV_TimerID_t id, void *user) {
+  (void)id;
+  (void)user;
+}
+
+static void setup(void) {
+  SIM_init();
+  BSP_cycleInit();
+  SLEEP_Init(NULL, NULL);
+  SLEEP_SleepBlockBegin(sleepEM3);
+  RTCDRV_Init();
+  CMU_ClockEnable(cmuClock_GPIO, true);
+  GPIO_IntConfig(gpioPortC, 1U, true, false, true);
+  NVIC_EnableIRQ(GPIO_ODD_IRQn);
+}
+
+static void teardown(void) {
+  RTCDRV_DeInit();
+  SLEEP_SleepBlockEnd(sleepEM3);
+}
+
+/* the stats of an exception number, NULL if it has none */
+static TRACE_IrqStats const *irq(TRACE_Report const *report, uint8_t id) {
+  unsigned int i;
+
+  for (i = 0U; i < report->irqs; i++) {
+    if (report->irq[i].id == id) {
+      return &report->irq[i];
+    }
+  }
+  return NULL;
+}
+
+/* the handler percentiles, the sleeps and the load of the dumped trace */
+static void testReport(void) {
+  TRACE_Report report;
+  TRACE_IrqStats const *s;
+  RTCDRV_TimerID_t id;
+  unsigned int i;
+
+  setup();
+  memset(&report, 0, sizeof(report));
+  CHECK_EQ(RTCDRV_AllocateTimer(&id), ECODE_EMDRV_RTCDRV_OK);
+  CHECK_EQ(RTCDRV_StartTimer(id, rtcdrvTimerTypePeriodic, PERIOD_MS, expired,
+                             NULL), ECODE_EMDRV_RTCDRV_OK);
+  for (i = 1U; i <= LOOPS; i++) {
+    CHECK_EQ(SLEEP_Sleep(), sleepEM2);
+    SIM_cycles(WORK);
+    l_burn = i * BURN_STEP;
+    SIM_gpioSet(gpioPortC, 1U, true);
+    SIM_gpioSet(gpioPortC, 1U, false);
+  }
+  CHECK_EQ(RTCDRV_StopTimer(id), ECODE_EMDRV_RTCDRV_OK);
+
+  BSP_traceDump();
+  CHECK_EQ(SIM_txLen, TRACE_HEADER + 3U * LOOPS * TRACE_RECORD);
+  CHECK_EQ(TRACE_analyze(SIM_tx, SIM_txLen, &report), (long)SIM_txLen);
+  CHECK_EQ(report.records, 3U * LOOPS);
+  CHECK_EQ(report.clock, SystemCoreClock);
+  CHECK_EQ(report.rtcHz, SIM_LFCLK_HZ / 8U);
+  CHECK_EQ(report.irqs, 2U);
+
+  s = irq(&report, EXC_GPIO);
+  CHECK(s != NULL);
+  if (s != NULL) {
+    CHECK_EQ(s->count, LOOPS);
+    CHECK_EQ(s->p50, 10U * BURN_STEP);
+    CHECK_EQ(s->p90, 18U * BURN_STEP);
+    CHECK_EQ(s->p99, 20U * BURN_STEP);
+    CHECK_EQ(s->max, 20U * BURN_STEP);
+    CHECK_EQ(s->total, LOOPS * (LOOPS + 1U) / 2U * BURN_STEP);
+    CHECK_EQ(s->saturated, 0U);
+  }
+  s = irq(&report, EXC_RTC);
+  CHECK(s != NULL);
+  if (s != NULL) {
+    CHECK_EQ(s->count, LOOPS);
+  }
+  CHECK_EQ(report.sleeps[sleepEM2], LOOPS);
+
+  /* 1.05 ms of 10 ms awake, 0.075 ms of it in the edge handler, in 1/100
+  * percent */
+  CHECK_RANGE(100.0 * report.busyPct, 900, 1300);
+  CHECK_RANGE(100.0 * report.irqPct, 60, 90);
+  TRACE_print(stdout, &report);
+
+  /* the dump emptied the trace */
+  SIM_txLen = 0U;
+  BSP_traceDump();
+  CHECK_EQ(SIM_txLen, TRACE_HEADER);
+  CHECK_EQ(TRACE_analyze(SIM_tx, SIM_txLen, &report), (long)TRACE_HEADER);
+  CHECK_EQ(report.records, 0U);
+  CHECK_EQ(TRACE_analyze(SIM_tx, SIM_txLen - 1U, &report), -1);
+  (void)RTCDRV_FreeTimer(id);
+  teardown();
+}
+
+int main(void) {
+  testReport();
+  return TEST_RESULT();
+}
@@ -0,0 +1,171 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "uartdrv.h"
+
+/* the UARTDRV receive stream on the simulated LEUART0: the DMA ping-pong
+* over the two halves of the stream buffer, the bytes read in place through
+* Peek and released by Consume, Poll for a half not yet full, and the
+* oldest half dropped when the consumer falls behind. the bytes come from
+* SIM_leuartRx(), the DMA interrupt runs between two of them. the DMA
+* descriptors hold 32 bit pointers: the stream buffers are statics */
+
+#define HALF 8U
+
+DEFINE_BUF_QUEUE(EMDRV_UARTDRV_MAX_CONCURRENT_RX_BUFS, l_rxQueue);
+DEFINE_BUF_QUEUE(EMDRV_UARTDRV_MAX_CONCURRENT_TX_BUFS, l_txQueue);
+
+typedef struct {
+    unsigned int calls;
+    Ecode_t status;
+    UARTDRV_Count_t available;
+} Notified;
+
+static UARTDRV_HandleData_t l_uart;
+static Notified l_notified;
+static uint8_t l_stream[2U * HALF];
+static uint8_t l_sent[64];
+
+static void notify(UARTDRV_Handle_t handle, Ecode_t status,
+                   UARTDRV_Count_t available) {
+  CHECK(handle == &l_uart);
+  l_notified.calls++;
+  l_notified.status = status;
+  l_notified.available = available;
+}
+
+static void setup(void) {
+  UARTDRV_InitLeuart_t init = {
+    .port = LEUART0,
+    .baudRate = 9600,
+    .portLocation = 0,
+    .stopBits = leuartStopbits1,
+    .parity = leuartNoParity,
+    .fcType = uartdrvFlowControlNone,
+    .rxQueue = (UARTDRV_Buffer_FifoQueue_t *)&l_rxQueue,
+    .txQueue = (UARTDRV_Buffer_FifoQueue_t *)&l_txQueue,
+  };
+  unsigned int i;
+
+  SIM_init();
+  CHECK_EQ(UARTDRV_InitLeuart(&l_uart, &init), ECODE_EMDRV_UARTDRV_OK);
+  memset(l_stream, 0, sizeof(l_stream));
+  memset(&l_notified, 0, sizeof(l_notified));
+  for (i = 0U; i < sizeof(l_sent); i++) {
+    l_sent[i] = (uint8_t)(0x40U + i);
+  }
+}
+
+static void teardown(void) {
+  CHECK_EQ(LEUART0->IF & LEUART_IF_RXOF, 0U);
+  CHECK_EQ(UARTDRV_DeInit(&l_uart), ECODE_EMDRV_UARTDRV_OK);
+}
+
+/* the spans of the unconsumed bytes hold sent[from] on */
+static void checkPeek(UARTDRV_Count_t used, UARTDRV_Count_t first,
+                      unsigned int from) {
+  UARTDRV_Span_t spans[2];
+  UARTDRV_Count_t i;
+
+  CHECK_EQ(UARTDRV_ReceiveStreamPeek(&l_uart, spans), used);
+  CHECK_EQ(spans[0].length, first);
+  CHECK_EQ(spans[1].length, used - first);
+  for (i = 0U; i < spans[0].length; i++) {
+    CHECK_EQ(spans[0].data[i], l_sent[from + i]);
+  }
+  for (i = 0U; i < spans[1].length; i++) {
+    CHECK_EQ(spans[1].data[i], l_sent[from + first + i]);
+  }
+  if (spans[1].length != 0U) {
+    CHECK(spans[1].data == l_stream);
+  }
+}
+
+/* a callback per half and on Poll, the data in place across the wrap of
+* the stream buffer */
+static void testHalves(void) {
+  setup();
+  CHECK_EQ(UARTDRV_ReceiveStreamStart(&l_uart, l_stream, sizeof(l_stream),
+                                      notify),
+           ECODE_EMDRV_UARTDRV_OK);
+  CHECK(LEUART0->STATUS & LEUART_STATUS_RXENS);
+
+  /* a message shorter than a half: only Poll reports it, once */
+  SIM_leuartRx(l_sent, 5U);
+  CHECK_EQ(l_notified.calls, 0U);
+  CHECK_EQ(UARTDRV_ReceiveStreamPoll(&l_uart), ECODE_EMDRV_UARTDRV_OK);
+  CHECK_EQ(l_notified.calls, 1U);
+  CHECK_EQ(l_notified.status, ECODE_EMDRV_UARTDRV_OK);
+  CHECK_EQ(l_notified.available, 5U);
+  CHECK_EQ(UARTDRV_ReceiveStreamPoll(&l_uart), ECODE_EMDRV_UARTDRV_IDLE);
+  CHECK_EQ(l_notified.calls, 1U);
+  checkPeek(5U, 5U, 0U);
+  CHECK_EQ(UARTDRV_ReceiveStreamConsume(&l_uart, 5U), ECODE_EMDRV_UARTDRV_OK);
+
+  /* the first half fills up after 3 more, the rest goes to the second */
+  SIM_leuartRx(&l_sent[5], 8U);
+  CHECK_EQ(l_notified.calls, 2U);
+  CHECK_EQ(l_notified.status, ECODE_EMDRV_UARTDRV_OK);
+  CHECK_EQ(l_notified.available, 3U);
+  checkPeek(8U, 8U, 5U);
+  CHECK_EQ(UARTDRV_ReceiveStreamConsume(&l_uart, 8U), ECODE_EMDRV_UARTDRV_OK);
+
+  /* the second half fills up, the stream goes on at the start */
+  SIM_leuartRx(&l_sent[13], 6U);
+  CHECK_EQ(l_notified.calls, 3U);
+  CHECK_EQ(l_notified.available, 3U);
+  checkPeek(6U, 3U, 13U);
+  CHECK_EQ(UARTDRV_ReceiveStreamConsume(&l_uart, 7U),
+           ECODE_EMDRV_UARTDRV_PARAM_ERROR);
+  CHECK_EQ(UARTDRV_ReceiveStreamConsume(&l_uart, 4U), ECODE_EMDRV_UARTDRV_OK);
+  checkPeek(2U, 2U, 17U);
+
+  /* stopped, the bytes left can still be read and nothing more comes */
+  CHECK_EQ(UARTDRV_ReceiveStreamStop(&l_uart), ECODE_EMDRV_UARTDRV_OK);
+  CHECK_EQ((LEUART0->STATUS & LEUART_STATUS_RXENS), 0U);
+  SIM_leuartRx(&l_sent[19], 2U);
+  checkPeek(2U, 2U, 17U);
+  CHECK_EQ(UARTDRV_ReceiveStreamPoll(&l_uart),
+           ECODE_EMDRV_UARTDRV_ILLEGAL_OPERATION);
+  CHECK_EQ(l_notified.calls, 3U);
+  teardown();
+}
+
+/* a consumer a full half behind loses the oldest half, the DMA goes on */
+static void testOverrun(void) {
+  setup();
+  CHECK_EQ(UARTDRV_ReceiveStreamStart(&l_uart, l_stream, sizeof(l_stream),
+                                      notify),
+           ECODE_EMDRV_UARTDRV_OK);
+  SIM_leuartRx(l_sent, HALF);
+  CHECK_EQ(l_notified.calls, 1U);
+  CHECK_EQ(l_notified.status, ECODE_EMDRV_UARTDRV_OK);
+  CHECK_EQ(l_notified.available, HALF);
+
+  SIM_leuartRx(&l_sent[HALF], HALF);
+  CHECK_EQ(l_notified.calls, 2U);
+  CHECK_EQ(l_notified.status, ECODE_EMDRV_UARTDRV_OVERRUN);
+  CHECK_EQ(l_notified.available, HALF);
+  checkPeek(HALF, HALF, HALF);
+
+  SIM_leuartRx(&l_sent[2U * HALF], HALF + 3U);
+  CHECK_EQ(l_notified.calls, 3U);
+  CHECK_EQ(l_notified.status, ECODE_EMDRV_UARTDRV_OVERRUN);
+  checkPeek(HALF + 3U, HALF + 3U, 2U * HALF);
+
+  /* caught up, the next half is reported as it is */
+  CHECK_EQ(UARTDRV_ReceiveStreamConsume(&l_uart, HALF + 3U),
+           ECODE_EMDRV_UARTDRV_OK);
+  SIM_leuartRx(&l_sent[3U * HALF + 3U], HALF - 3U);
+  CHECK_EQ(l_notified.calls, 4U);
+  CHECK_EQ(l_notified.status, ECODE_EMDRV_UARTDRV_OK);
+  CHECK_EQ(l_notified.available, HALF - 3U);
+  checkPeek(HALF - 3U, HALF - 3U, 3U * HALF + 3U);
+  teardown();
+}
+
+int main(void) {
+  testHalves();
+  testOverrun();
+  return TEST_RESULT();
+}
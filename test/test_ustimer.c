@@ -0,0 +1,193 @@
+#include <string.h>
+#include "efm32sim.h"
+#include "test.h"
+#include "ustimer.h"
+
+/* USTIMER callback timers and delays on the simulated TIMER0. HFRCO runs
+* at 14 MHz, the driver prescales HFPERCLK by 8 to 1.75 MHz: a tick is 8
+* HFCLK cycles. a match falls on a tick edge, up to a tick after the
+* start call */
+
+#define TICK_CYCLES 8U
+#define TICK_HZ     1750000U
+#define CAP_TICKS   65000U
+/* the driver sets a compare at least minTicks ahead: 13 us of 48 MHz core
+* cycles at 14 MHz, at 1.75 MHz */
+#define MIN_TICKS   23U
+
+/* us to ticks as the driver rounds them */
+#define US_TICKS(us) (((uint64_t)TICK_HZ * (us) + 500000U) / 1000000U)
+
+#define FIRES_MAX 16U
+
+typedef struct {
+    USTIMER_TimerID_t id;
+    uint64_t start;
+    unsigned int fired;
+    uint64_t at[FIRES_MAX];
+    void (*action)(unsigned int fired);
+} Timer;
+
+static Timer l_timer[USTIMER_NUM_TIMERS];
+
+static void expired(USTIMER_TimerID_t id, void *user) {
+  Timer *t = user;
+
+  CHECK_EQ(id, t->id);
+  if (t->fired < FIRES_MAX) {
+    t->at[t->fired] = SIM_cycleNow();
+  }
+  t->fired++;
+  if (t->action != NULL) {
+    t->action(t->fired);
+  }
+}
+
+static void start(Timer *t, USTIMER_TimerType_t type, uint32_t us) {
+  t->start = SIM_cycleNow();
+  CHECK_EQ(USTIMER_StartTimer(t->id, type, us, expired, t),
+           ECODE_EMDRV_USTIMER_OK);
+}
+
+/* the n-th expiry, from 1, is n periods of us after the start, up to
+* late ticks later */
+static void checkLate(Timer const *t, unsigned int n, uint32_t us,
+                      uint32_t late) {
+  uint64_t due = t->start + n * US_TICKS(us) * TICK_CYCLES;
+
+  CHECK(n <= t->fired);
+  if (n <= t->fired && n <= FIRES_MAX) {
+    CHECK_RANGE(t->at[n - 1U], due - TICK_CYCLES, due + late * TICK_CYCLES);
+  }
+}
+
+static void checkFire(Timer const *t, unsigned int n, uint32_t us) {
+  checkLate(t, n, us, 0U);
+}
+
+static void setup(void) {
+  unsigned int i;
+
+  SIM_init();
+  memset(l_timer, 0, sizeof(l_timer));
+  CHECK_EQ(USTIMER_Init(), ECODE_EMDRV_USTIMER_OK);
+  for (i = 0U; i < USTIMER_NUM_TIMERS; i++) {
+    CHECK_EQ(USTIMER_AllocateTimer(&l_timer[i].id), ECODE_EMDRV_USTIMER_OK);
+  }
+}
+
+static void teardown(void) {
+  unsigned int i;
+
+  for (i = 0U; i < USTIMER_NUM_TIMERS; i++) {
+    CHECK_EQ(USTIMER_FreeTimer(l_timer[i].id), ECODE_EMDRV_USTIMER_OK);
+  }
+  CHECK_EQ(USTIMER_DeInit(), ECODE_EMDRV_USTIMER_OK);
+}
+
+/* oneshot and periodic timers on the one compare channel */
+static void testOverlap(void) {
+  unsigned int n;
+
+  setup();
+  start(&l_timer[0], ustimerTimerTypePeriodic, 300U);
+  SIM_cycles(1000U);
+  start(&l_timer[1], ustimerTimerTypeOneshot, 1000U);
+  start(&l_timer[2], ustimerTimerTypeOneshot, 2500U);
+  SIM_cycles(3000U * 14U + 1000U);
+
+  CHECK_EQ(l_timer[0].fired, 10U);
+  for (n = 1U; n <= 10U; n++) {
+    checkFire(&l_timer[0], n, 300U);
+  }
+  CHECK_EQ(l_timer[1].fired, 1U);
+  checkFire(&l_timer[1], 1U, 1000U);
+  CHECK_EQ(l_timer[2].fired, 1U);
+  checkFire(&l_timer[2], 1U, 2500U);
+  CHECK_EQ(USTIMER_StopTimer(l_timer[0].id), ECODE_EMDRV_USTIMER_OK);
+  teardown();
+}
+
+/* 100 ms are 175000 ticks, compare laps of at most 65000 ticks */
+static void testLong(void) {
+  uint64_t ticks = US_TICKS(100000U);
+  uint32_t irqs;
+
+  setup();
+  irqs = SIM_irqCount[TIMER0_IRQn];
+  start(&l_timer[0], ustimerTimerTypeOneshot, 100000U);
+  SIM_cycles(101000U * 14U);
+  CHECK_EQ(l_timer[0].fired, 1U);
+  checkFire(&l_timer[0], 1U, 100000U);
+  CHECK_EQ(SIM_irqCount[TIMER0_IRQn] - irqs, (ticks + CAP_TICKS - 1U) / CAP_TICKS);
+  teardown();
+}
+
+/* the second expiry of timer 0 stops timer 1, which would expire next.
+* timer 2 stops timer 0 and restarts itself */
+static void stopNext(unsigned int fired) {
+  if (fired == 2U) {
+    CHECK_EQ(USTIMER_StopTimer(l_timer[1].id), ECODE_EMDRV_USTIMER_OK);
+  }
+}
+
+static void stopPeriodic(unsigned int fired) {
+  CHECK_EQ(USTIMER_StopTimer(l_timer[0].id), ECODE_EMDRV_USTIMER_OK);
+  if (fired == 1U) {
+    start(&l_timer[2], ustimerTimerTypeOneshot, 500U);
+  }
+}
+
+static void testCancel(void) {
+  bool running;
+
+  setup();
+  l_timer[0].action = stopNext;
+  l_timer[2].action = stopPeriodic;
+  start(&l_timer[0], ustimerTimerTypePeriodic, 200U);
+  start(&l_timer[1], ustimerTimerTypeOneshot, 450U);
+  start(&l_timer[2], ustimerTimerTypeOneshot, 1100U);
+  SIM_cycles(2000U * 14U);
+
+  CHECK_EQ(l_timer[0].fired, 5U);
+  checkFire(&l_timer[0], 5U, 200U);
+  CHECK_EQ(l_timer[1].fired, 0U);
+  CHECK_EQ(l_timer[2].fired, 2U);
+  CHECK_EQ(USTIMER_IsRunning(l_timer[0].id, &running), ECODE_EMDRV_USTIMER_OK);
+  CHECK(!running);
+  CHECK_EQ(USTIMER_IsRunning(l_timer[2].id, &running), ECODE_EMDRV_USTIMER_OK);
+  CHECK(!running);
+  teardown();
+}
+
+/* EM1 waits for a oneshot while a periodic timer and a delay share the
+* counter. an expiry close after another one waits for minTicks */
+static void testWait(void) {
+  uint64_t begin;
+
+  setup();
+  start(&l_timer[0], ustimerTimerTypePeriodic, 70U);
+  start(&l_timer[1], ustimerTimerTypeOneshot, 500U);
+  CHECK_EQ(USTIMER_WaitTimer(l_timer[1].id), ECODE_EMDRV_USTIMER_OK);
+  CHECK_EQ(l_timer[1].fired, 1U);
+  /* due 14 ticks after an expiry of the periodic timer */
+  checkLate(&l_timer[1], 1U, 500U, MIN_TICKS);
+  CHECK_EQ(l_timer[1].at[0], SIM_cycleNow());
+  CHECK_EQ(USTIMER_WaitTimer(l_timer[0].id), ECODE_EMDRV_USTIMER_PARAM_ERROR);
+
+  begin = SIM_cycleNow();
+  CHECK_EQ(USTIMER_Delay(1000U), ECODE_EMDRV_USTIMER_OK);
+  CHECK_RANGE(SIM_cycleNow() - begin, US_TICKS(1000U) * TICK_CYCLES - TICK_CYCLES,
+              US_TICKS(1000U) * TICK_CYCLES);
+  CHECK_EQ(USTIMER_StopTimer(l_timer[0].id), ECODE_EMDRV_USTIMER_OK);
+  CHECK_RANGE(l_timer[0].fired, 21U, 22U);
+  teardown();
+}
+
+int main(void) {
+  testOverlap();
+  testLong();
+  testCancel();
+  testWait();
+  return TEST_RESULT();
+}
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <string.h>
+#include "dlog_decode.h"
+
+static char const *const l_formats[] = {
+#define DLOG_FORMAT(id, format) format,
+#include "dlog_formats.h"
+#undef DLOG_FORMAT
+};
+
+#define SPEC_SIZE 16U
+
+static uint32_t le32(uint8_t const *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16)
+         | ((uint32_t)p[3] << 24);
+}
+
+long DECODE_record(uint8_t const *data, size_t len, DECODE_Record *r) {
+  uint32_t time;
+  uint8_t i;
+
+  if (len < 8U || data[0] != DLOG_SYNC || data[1] > DLOG_MAX_ARGS
+      || len < 8U + 4U * (size_t)data[1]) {
+    return -1;
+  }
+  r->argc = data[1];
+  r->id = (uint16_t)(data[2] | (data[3] << 8));
+  time = le32(&data[4]);
+  r->rtc = time & 0xFFFFFFU;
+  r->seq = (uint8_t)(time >> 24);
+  for (i = 0U; i < r->argc; i++) {
+    r->args[i] = le32(&data[8U + 4U * i]);
+  }
+  return 8L + 4L * r->argc;
+}
+
+/* append to buf as snprintf() does, len counts the full text */
+static void put(char *buf, size_t size, int *len, char const *spec,
+                uint32_t arg, char const *str) {
+  size_t at = (size_t)*len < size ? (size_t)*len : size;
+  int n;
+
+  if (str != NULL) {
+    n = snprintf(&buf[at], size - at, spec, str);
+  } else {
+    n = snprintf(&buf[at], size - at, spec, arg);
+  }
+  if (n > 0) {
+    *len += n;
+  }
+}
+
+int DECODE_format(DECODE_Record const *r, ELF_Image const *image, char *buf,
+                  size_t size) {
+  char spec[SPEC_SIZE];
+  char addr[16];
+  char const *f;
+  char const *str;
+  size_t n;
+  uint32_t arg;
+  uint8_t next = 0U;
+  int len = 0;
+
+  if (size != 0U) {
+    buf[0] = '\0';
+  }
+  if (r->id >= sizeof(l_formats) / sizeof(l_formats[0])) {
+    put(buf, size, &len, "unknown record %u", r->id, NULL);
+    for (next = 0U; next < r->argc; next++) {
+      put(buf, size, &len, " 0x%08x", r->args[next], NULL);
+    }
+    return len;
+  }
+
+  for (f = l_formats[r->id]; *f != '\0'; f++) {
+    if (f[0] != '%' || f[1] == '%') {
+      put(buf, size, &len, "%c", (uint8_t)*f, NULL);
+      f += f[0] == '%';
+      continue;
+    }
+    /* flags and width up to the conversion */
+    n = strspn(&f[1], "-+ #0123456789") + 2U;
+    if (n >= SPEC_SIZE || f[n - 1U] == '\0') {
+      put(buf, size, &len, "%s", 0U, f);
+      break;
+    }
+    memcpy(spec, f, n);
+    spec[n] = '\0';
+    f += n - 1U;
+    if (next >= r->argc) {
+      put(buf, size, &len, "%s", 0U, "<?>");
+      continue;
+    }
+    arg = r->args[next++];
+    switch (*f) {
+      case 's':
+        str = image != NULL ? ELF_string(image, arg) : NULL;
+        if (str == NULL) {
+          snprintf(addr, sizeof(addr), "<0x%08x>", arg);
+          str = addr;
+        }
+        put(buf, size, &len, spec, 0U, str);
+        break;
+
+      case 'c':
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'x':
+      case 'X':
+        put(buf, size, &len, spec, arg, NULL);
+        break;
+
+      default:
+        put(buf, size, &len, "<%s>", 0U, spec);
+        break;
+    }
+  }
+  return len;
+}
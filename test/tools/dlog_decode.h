@@ -0,0 +1,33 @@
+#ifndef __DLOG_DECODE_H__
+#define __DLOG_DECODE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dlog.h"
+#include "elf_image.h"
+
+/* the deferred log of dlog.h on the host: records parsed from the bytes
+* TRACE_LEUART sent and formatted with the strings of dlog_formats.h. a %s
+* argument is read from the ELF file of the image that logged it */
+
+#define DECODE_RTC_HZ (32768U / 8U)  /* RTCDRV tick rate, bits 23..0 of time */
+
+typedef struct {
+    uint16_t id;
+    uint8_t argc;
+    uint8_t seq;
+    uint32_t rtc;
+    uint32_t args[DLOG_MAX_ARGS];
+} DECODE_Record;
+
+/* parse the record at the start of data. returns the bytes it takes, or -1
+* if data does not start with a complete record */
+long DECODE_record(uint8_t const *data, size_t len, DECODE_Record *r);
+
+/* the text of a record into buf of size bytes, cut and terminated as
+* snprintf(). image can be NULL, %s then shows the address. returns the
+* length of the full text */
+int DECODE_format(DECODE_Record const *r, ELF_Image const *image, char *buf,
+                  size_t size);
+
+#endif // __DLOG_DECODE_H__
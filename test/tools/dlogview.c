@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "dlog_decode.h"
+
+/* print the records of a deferred log capture of TRACE_LEUART as text, %s
+* arguments read from the ELF file of the image that logged them:
+*   dlogview image.elf capture.bin
+* bytes that do not frame a record are skipped, sequence gaps are shown */
+
+#define CAPTURE_MAX (1UL << 20)
+#define TEXT_SIZE   256U
+
+int main(int argc, char **argv) {
+  static uint8_t data[CAPTURE_MAX];
+  static char text[TEXT_SIZE];
+  DECODE_Record r;
+  ELF_Image image;
+  FILE *in = stdin;
+  size_t len;
+  size_t at = 0U;
+  size_t skipped = 0U;
+  long used;
+  unsigned int records = 0U;
+  uint8_t seq = 0U;
+
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s image.elf [capture]\n", argv[0]);
+    return 2;
+  }
+  if (!ELF_load(argv[1], &image)) {
+    fprintf(stderr, "%s: no little endian ELF file\n", argv[1]);
+    return 2;
+  }
+  if (argc == 3 && (in = fopen(argv[2], "rb")) == NULL) {
+    perror(argv[2]);
+    ELF_free(&image);
+    return 2;
+  }
+  len = fread(data, 1U, sizeof(data), in);
+  if (in != stdin) {
+    fclose(in);
+  }
+
+  while (at < len) {
+    used = DECODE_record(&data[at], len - at, &r);
+    if (used < 0) {
+      at++;
+      skipped++;
+      continue;
+    }
+    if (skipped != 0U) {
+      printf("-- %lu bytes skipped\n", (unsigned long)skipped);
+      skipped = 0U;
+    }
+    if (records++ != 0U && r.seq != seq) {
+      printf("-- %u records lost\n", (uint8_t)(r.seq - seq));
+    }
+    seq = (uint8_t)(r.seq + 1U);
+    DECODE_format(&r, &image, text, sizeof(text));
+    printf("%10.4f %3u %s\n", (double)r.rtc / DECODE_RTC_HZ, r.seq, text);
+    at += (size_t)used;
+  }
+  if (skipped != 0U) {
+    printf("-- %lu bytes skipped\n", (unsigned long)skipped);
+  }
+  ELF_free(&image);
+  return 0;
+}
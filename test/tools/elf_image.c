@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "elf_image.h"
+
+#define EI_CLASS      4U
+#define EI_DATA       5U
+#define ELFCLASS32    1U
+#define ELFCLASS64    2U
+#define ELFDATA2LSB   1U
+#define SHT_NOBITS    8U
+#define SHF_ALLOC     0x2U
+
+typedef struct {
+    uint32_t type;
+    uint64_t flags;
+    uint64_t addr;
+    uint64_t offset;
+    uint64_t size;
+} Section;
+
+static uint64_t le(uint8_t const *p, unsigned int bytes) {
+  uint64_t value = 0U;
+
+  while (bytes-- != 0U) {
+    value = (value << 8) | p[bytes];
+  }
+  return value;
+}
+
+/* section header i, false if it lies outside the file */
+static bool section(ELF_Image const *image, unsigned int i, Section *s) {
+  uint8_t const *h = image->data;
+  bool wide = h[EI_CLASS] == ELFCLASS64;
+  uint64_t shoff = wide ? le(&h[0x28], 8U) : le(&h[0x20], 4U);
+  uint64_t entsize = le(&h[wide ? 0x3AU : 0x2EU], 2U);
+  uint8_t const *p;
+
+  if (shoff + (i + 1U) * entsize > image->size
+      || entsize < (wide ? 0x40U : 0x28U)) {
+    return false;
+  }
+  p = &h[shoff + i * entsize];
+  s->type = (uint32_t)le(&p[4], 4U);
+  if (wide) {
+    s->flags = le(&p[8], 8U);
+    s->addr = le(&p[16], 8U);
+    s->offset = le(&p[24], 8U);
+    s->size = le(&p[32], 8U);
+  } else {
+    s->flags = le(&p[8], 4U);
+    s->addr = le(&p[12], 4U);
+    s->offset = le(&p[16], 4U);
+    s->size = le(&p[20], 4U);
+  }
+  return s->offset <= image->size && s->size <= image->size - s->offset;
+}
+
+bool ELF_load(char const *path, ELF_Image *image) {
+  FILE *in = fopen(path, "rb");
+  size_t got;
+  uint8_t *more;
+
+  image->data = NULL;
+  image->size = 0U;
+  if (in == NULL) {
+    return false;
+  }
+  /* /proc/self/exe has no size up front, read it in chunks */
+  for (;;) {
+    more = realloc(image->data, image->size + 65536U);
+    if (more == NULL) {
+      break;
+    }
+    image->data = more;
+    got = fread(&image->data[image->size], 1U, 65536U, in);
+    image->size += got;
+    if (got < 65536U) {
+      break;
+    }
+  }
+  fclose(in);
+
+  if (image->size < 0x40U || memcmp(image->data, "\177ELF", 4U) != 0
+      || (image->data[EI_CLASS] != ELFCLASS32
+          && image->data[EI_CLASS] != ELFCLASS64)
+      || image->data[EI_DATA] != ELFDATA2LSB) {
+    ELF_free(image);
+    return false;
+  }
+  return true;
+}
+
+void ELF_free(ELF_Image *image) {
+  free(image->data);
+  image->data = NULL;
+  image->size = 0U;
+}
+
+char const *ELF_string(ELF_Image const *image, uint64_t addr) {
+  unsigned int count;
+  unsigned int i;
+  Section s;
+  char const *str;
+
+  if (image->data == NULL) {
+    return NULL;
+  }
+  count = (unsigned int)le(
+    &image->data[image->data[EI_CLASS] == ELFCLASS64 ? 0x3CU : 0x30U], 2U);
+  for (i = 0U; i < count; i++) {
+    if (!section(image, i, &s) || (s.flags & SHF_ALLOC) == 0U
+        || s.type == SHT_NOBITS || addr < s.addr
+        || addr - s.addr >= s.size) {
+      continue;
+    }
+    str = (char const *)&image->data[s.offset + (addr - s.addr)];
+    if (memchr(str, '\0', s.size - (addr - s.addr)) != NULL) {
+      return str;
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,25 @@
+#ifndef __ELF_IMAGE_H__
+#define __ELF_IMAGE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* the allocated sections of a little endian ELF file, 32 or 64 bit, read
+* by address: the image built for the board, or a host test itself */
+
+typedef struct {
+    uint8_t *data;
+    size_t size;
+} ELF_Image;
+
+/* read the file, false if it is no little endian ELF file */
+bool ELF_load(char const *path, ELF_Image *image);
+
+void ELF_free(ELF_Image *image);
+
+/* the string at addr of the image, NULL if no section holds it with its
+* terminating 0 */
+char const *ELF_string(ELF_Image const *image, uint64_t addr);
+
+#endif // __ELF_IMAGE_H__
@@ -0,0 +1,158 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace_report.h"
+
+/* record types of emdrv_trace.h that BSP_traceDump() sends */
+#define EVENT_IRQ_EXIT 1U
+#define EVENT_WAKE     3U
+
+#define RTC_MASK 0xFFFFFFU
+
+static uint32_t le16(uint8_t const *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static uint32_t le32(uint8_t const *p) {
+  return le16(p) | (le16(p + 2) << 16);
+}
+
+static int compare(void const *a, void const *b) {
+  uint32_t x = *(uint32_t const *)a;
+  uint32_t y = *(uint32_t const *)b;
+
+  return (x > y) - (x < y);
+}
+
+/* nearest rank of the sorted durations */
+static uint32_t percentile(uint32_t const *sorted, unsigned int n,
+                           unsigned int pct) {
+  unsigned int rank = (n * pct + 99U) / 100U;
+
+  return sorted[rank > 0U ? rank - 1U : 0U];
+}
+
+static void irqStats(uint8_t const *records, unsigned int n, uint8_t id,
+                     uint32_t *buf, TRACE_IrqStats *s) {
+  uint8_t const *r;
+  unsigned int i;
+
+  memset(s, 0, sizeof(*s));
+  s->id = id;
+  for (i = 0U; i < n; i++) {
+    r = &records[i * TRACE_RECORD];
+    if (r[6] == EVENT_IRQ_EXIT && r[7] == id) {
+      buf[s->count++] = le16(&r[4]);
+      s->total += le16(&r[4]);
+      s->saturated += le16(&r[4]) == TRACE_SATURATED;
+    }
+  }
+  qsort(buf, s->count, sizeof(buf[0]), compare);
+  s->p50 = percentile(buf, s->count, 50U);
+  s->p90 = percentile(buf, s->count, 90U);
+  s->p99 = percentile(buf, s->count, 99U);
+  s->max = buf[s->count - 1U];
+}
+
+long TRACE_analyze(uint8_t const *data, size_t len, TRACE_Report *report) {
+  uint8_t const *records = data + TRACE_HEADER;
+  uint8_t const *r;
+  bool seen[TRACE_IDS] = { false };
+  uint32_t *buf;
+  uint32_t t0;
+  uint64_t end;
+  uint64_t ticks;
+  uint64_t asleep = 0U;
+  uint64_t cycles = 0U;
+  unsigned int n;
+  unsigned int i;
+
+  if (len < TRACE_HEADER || data[0] != 'T' || data[1] != 'R') {
+    return -1;
+  }
+  n = le16(&data[2]);
+  if (len < TRACE_HEADER + (size_t)n * TRACE_RECORD) {
+    return -1;
+  }
+  memset(report, 0, sizeof(*report));
+  report->clock = le32(&data[4]);
+  report->rtcHz = le32(&data[8]);
+  report->records = n;
+  if (n == 0U || report->clock == 0U || report->rtcHz == 0U) {
+    return TRACE_HEADER + (long)n * TRACE_RECORD;
+  }
+
+  /* the window, the sleeps by energy mode */
+  t0 = le32(&records[0]);
+  end = 0U;
+  for (i = 0U; i < n; i++) {
+    r = &records[i * TRACE_RECORD];
+    ticks = le16(&r[4]);
+    if (r[6] == EVENT_IRQ_EXIT && r[7] < TRACE_IDS) {
+      seen[r[7]] = true;
+      ticks = (ticks * report->rtcHz + report->clock - 1U) / report->clock;
+    } else if (r[6] == EVENT_WAKE && r[7] < TRACE_MODES) {
+      report->sleeps[r[7]]++;
+      report->sleepTicks[r[7]] += ticks;
+      asleep += ticks;
+    }
+    ticks += (le32(&r[0]) - t0) & RTC_MASK;
+    if (ticks > end) {
+      end = ticks;
+    }
+  }
+  report->window = end;
+
+  buf = malloc(n * sizeof(buf[0]));
+  if (buf == NULL) {
+    return -1;
+  }
+  for (i = 0U; i < TRACE_IDS; i++) {
+    if (seen[i]) {
+      irqStats(records, n, (uint8_t)i, buf, &report->irq[report->irqs]);
+      cycles += report->irq[report->irqs].total;
+      report->irqs++;
+    }
+  }
+  free(buf);
+
+  /* a nested handler counts again in the one it interrupted */
+  if (end != 0U) {
+    report->busyPct = 100.0 * (double)(end - (asleep < end ? asleep : end))
+                      / (double)end;
+    report->irqPct = 100.0 * (double)cycles * report->rtcHz
+                     / ((double)report->clock * (double)end);
+  }
+  return TRACE_HEADER + (long)n * TRACE_RECORD;
+}
+
+static double us(TRACE_Report const *report, uint32_t cycles) {
+  return 1e6 * cycles / report->clock;
+}
+
+void TRACE_print(FILE *out, TRACE_Report const *report) {
+  TRACE_IrqStats const *s;
+  unsigned int i;
+
+  fprintf(out, "%u records, core %u Hz, RTC %u Hz, %.1f ms\n",
+          report->records, report->clock, report->rtcHz,
+          report->rtcHz != 0U ? 1e3 * report->window / report->rtcHz : 0.0);
+  if (report->irqs != 0U) {
+    fprintf(out, "exc  irq  count   p50 us   p90 us   p99 us   max us\n");
+  }
+  for (i = 0U; i < report->irqs; i++) {
+    s = &report->irq[i];
+    fprintf(out, "%3u  %3d  %5u %8.1f %8.1f %8.1f %c%7.1f\n",
+            s->id, s->id - 16, s->count, us(report, s->p50),
+            us(report, s->p90), us(report, s->p99),
+            s->saturated != 0U ? '>' : ' ', us(report, s->max));
+  }
+  for (i = 0U; i < TRACE_MODES; i++) {
+    if (report->sleeps[i] != 0U) {
+      fprintf(out, "sleep EM%u: %u times, %.1f ms\n", i, report->sleeps[i],
+              1e3 * report->sleepTicks[i] / report->rtcHz);
+    }
+  }
+  fprintf(out, "cpu busy %.1f %%, in handlers %.1f %%\n", report->busyPct,
+          report->irqPct);
+}
@@ -0,0 +1,51 @@
+#ifndef __TRACE_REPORT_H__
+#define __TRACE_REPORT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* analysis of a BSP_traceDump() dump, see BSP_TraceRecord in bsp.h:
+* handler durations per exception number as percentiles, and the CPU load
+* over the time the records span. the RTC count is 24 bits, a dump must
+* span less than 2^24 RTC ticks */
+
+#define TRACE_IDS     48U  /* exception numbers, 16 + 32 interrupts */
+#define TRACE_MODES   5U   /* energy modes EM0 to EM4 */
+#define TRACE_HEADER  12U
+#define TRACE_RECORD  8U
+#define TRACE_SATURATED 0xFFFFU
+
+/* the handler durations of one exception number [core clock cycles],
+* nearest rank percentiles */
+typedef struct {
+    uint8_t id;
+    unsigned int count;
+    unsigned int saturated;  /* durations of 0xFFFF cycles or longer */
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+    uint64_t total;
+} TRACE_IrqStats;
+
+typedef struct {
+    uint32_t clock;            /* SystemCoreClock [Hz] */
+    uint32_t rtcHz;            /* RTC count rate [Hz] */
+    unsigned int records;
+    unsigned int irqs;         /* entries in irq[], by exception number */
+    TRACE_IrqStats irq[TRACE_IDS];
+    unsigned int sleeps[TRACE_MODES];
+    uint64_t sleepTicks[TRACE_MODES];
+    uint64_t window;           /* first record to the end of the last [RTC ticks] */
+    double busyPct;            /* window not spent asleep */
+    double irqPct;             /* window spent in the traced handlers */
+} TRACE_Report;
+
+/* analyze the dump at the start of data. returns the bytes it takes, or
+* -1 if data holds no complete dump */
+long TRACE_analyze(uint8_t const *data, size_t len, TRACE_Report *report);
+
+void TRACE_print(FILE *out, TRACE_Report const *report);
+
+#endif // __TRACE_REPORT_H__
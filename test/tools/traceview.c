@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "trace_report.h"
+
+/* print the handler durations and the CPU load of the trace dumps in a
+* capture of TRACE_LEUART, bytes before a dump are skipped:
+*   traceview capture.bin */
+
+#define CAPTURE_MAX (1UL << 20)
+
+int main(int argc, char **argv) {
+  static uint8_t data[CAPTURE_MAX];
+  TRACE_Report report;
+  FILE *in = stdin;
+  size_t len;
+  size_t at = 0U;
+  long used;
+  unsigned int dumps = 0U;
+
+  if (argc > 2) {
+    fprintf(stderr, "usage: %s [capture]\n", argv[0]);
+    return 2;
+  }
+  if (argc == 2 && (in = fopen(argv[1], "rb")) == NULL) {
+    perror(argv[1]);
+    return 2;
+  }
+  len = fread(data, 1U, sizeof(data), in);
+  if (in != stdin) {
+    fclose(in);
+  }
+
+  while (at < len) {
+    used = TRACE_analyze(&data[at], len - at, &report);
+    if (used < 0) {
+      at++;
+      continue;
+    }
+    if (dumps++ != 0U) {
+      printf("\n");
+    }
+    TRACE_print(stdout, &report);
+    at += (size_t)used;
+  }
+  if (dumps == 0U) {
+    fprintf(stderr, "no trace dump found\n");
+    return 1;
+  }
+  return 0;
+}